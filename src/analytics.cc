@@ -157,6 +157,7 @@ void GoogleAnalyticsEvent::runTask() {
     HTTPRequest req;
     req.host = "https://ssl.google-analytics.com";
     req.relative_url = relativeURL();
+    req.priority = kRequestPriorityBackground;
 
     HTTPResponse resp = TogglClient::GetInstance().silentGet(req);
     if (resp.err != noError) {
@@ -321,6 +322,7 @@ void GoogleAnalyticsSettingsEvent::makeReq() {
     HTTPRequest req;
     req.host = "https://ssl.google-analytics.com";
     req.relative_url = relativeURL();
+    req.priority = kRequestPriorityBackground;
 
     HTTPResponse resp = TogglClient::GetInstance().silentGet(req);
     if (resp.err != noError) {
@@ -12,20 +12,41 @@
 
 #define kMaxTimeEntryDurationSeconds 3596400
 #define kHTTPClientTimeoutSeconds 30
-#define kSyncIntervalRangeSeconds 900
+#define kRequestBodyGzipThresholdBytes 1024
+#define kSyncDebounceMillis 750
+#define kRenderFrameMillis 16
+#define kTimeEntryListWindowRows 50
+#define kTimeEntryListWindowMargin 20
+#define kViewArenaBlockBytes 4096
+#define kSyncIntervalMinSeconds 60
+#define kSyncIntervalMaxSeconds 1800
+#define kSyncRetryMinSeconds 15
 #define kWebsocketRestartRangeSeconds 45
+#define kWebsocketMaxMessageBytes (16 * 1024 * 1024)
+#define kWebsocketUpdateBatchMillis 100
 #define kCheckUpdateIntervalSeconds 86400
 #define kCheckInAppMessageIntervalSeconds 14400
 #define kRequestThrottleSeconds 2
 #define kTimerStartInterval 10
+#define kReminderRecheckSeconds 60
+#define kExecutorWorkers 3
+#define kExecutorTickMillis 10
+#define kExecutorWheelBits 6
+#define kExecutorWheelLevels 4
+#define kThreadNamePrefix "toggl:"
 #define kTimelineSecondsToKeep 604800
 #define kWindowFocusThresholdSeconds 10
 #define kAutotrackerThresholdSeconds 10
+#define kAutotrackerCacheSize 256
+#define kLockStatsBuckets 8
+#define kLockStatsHolders 5
+#define kLockStatsSlowWaitMillis 100
 #define kBetaChannelPercentage 25
 #define kTimelineChunkSeconds 900
 #define kEnterpriseInstall false
 #define kDebianPackage (TOGGL_BUILD_TYPE == std::string("deb"))
 #define kTimelineUploadIntervalSeconds 60
+#define kTimelineEventBatchMillis 1000
 #define kTimelineUploadMaxBackoffSeconds (kTimelineUploadIntervalSeconds * 10)  // NOLINT
 #define kMaxFileSize 5242880  // 5MB
 #define kMaxDurationSeconds (999 * 3600)
@@ -19,14 +19,16 @@
 #include "database/database.h"
 #include "error.h"
 #include "util/formatter.h"
+#include "util/thread_name.h"
 #include "https_client.h"
+#include "netconf.h"
 #include "model/project.h"
-#include "util/random.h"
 #include "model/settings.h"
 #include "model/task.h"
 #include "model/time_entry.h"
 #include "timeline_uploader.h"
 #include "urls.h"
+#include "view_arena.h"
 #include "window_change_recorder.h"
 #include "onboarding_service.h"
 
@@ -64,6 +66,7 @@ std::string Context::log_path_ = "";
 Context::Context(const std::string &app_name, const std::string &app_version)
     : db_(nullptr)
 , user_(nullptr)
+, timeline_uid_(0)
 , timeline_uploader_(nullptr)
 , window_change_recorder_(nullptr)
 , next_sync_at_(0)
@@ -74,15 +77,17 @@ Context::Context(const std::string &app_name, const std::string &app_version)
 , time_entry_editor_guid_("")
 , environment_(APP_ENVIRONMENT)
 , idle_(&ui_)
-, last_sync_started_(0)
-, sync_interval_seconds_(0)
 , update_check_disabled_(UPDATE_CHECK_DISABLED)
 , trigger_sync_(false)
 , trigger_push_(false)
 , trigger_full_sync_(false)
+, outbox_seeded_uid_(0)
 , quit_(false)
-, ui_updater_(this, &Context::uiUpdaterActivity)
-, reminder_(this, &Context::reminderActivity)
+, ui_updater_started_(false)
+, ui_updater_guid_("")
+, ui_updater_date_duration_("")
+, renderer_(this, &Context::rendererActivity)
+, reminders_started_(false)
 , syncer_(this, &Context::syncerActivityWrapper)
 , update_path_("")
 , overlay_visible_(false)
@@ -107,15 +112,11 @@ Context::Context(const std::string &app_name, const std::string &app_version)
 
     startPeriodicUpdateCheck();
 
-    startPeriodicSync();
+    startUIUpdater();
 
-    if (!ui_updater_.isRunning()) {
-        ui_updater_.start();
-    }
+    startReminders();
 
-    if (!reminder_.isRunning()) {
-        reminder_.start();
-    }
+    renderer_.start();
 
     resetLastTrackingReminderTime();
 
@@ -132,10 +133,22 @@ Context::Context(const std::string &app_name, const std::string &app_version)
 Context::~Context() {
     SetQuit();
 
+    // Whatever is still to be rendered is rendered by the caller now
+    render_dispatcher_.Stop();
+    try {
+        renderer_.stop();
+        renderer_.wait(2000);
+    } catch(const Poco::Exception& exc) {
+        logger.debug(exc.displayText());
+    }
+
     stopActivities();
 
+    // No task may run anymore once the database and user are gone
+    executor_.Stop();
+
     {
-        Poco::Mutex::ScopedLock lock(window_change_recorder_m_);
+        InstrumentedMutex::ScopedLock lock(window_change_recorder_m_);
         if (window_change_recorder_) {
             delete window_change_recorder_;
             window_change_recorder_ = nullptr;
@@ -143,7 +156,7 @@ Context::~Context() {
     }
 
     {
-        Poco::Mutex::ScopedLock lock(timeline_uploader_m_);
+        InstrumentedMutex::ScopedLock lock(timeline_uploader_m_);
         if (timeline_uploader_) {
             delete timeline_uploader_;
             timeline_uploader_ = nullptr;
@@ -151,7 +164,7 @@ Context::~Context() {
     }
 
     {
-        Poco::Mutex::ScopedLock lock(db_m_);
+        InstrumentedMutex::ScopedLock lock(db_m_);
         if (db_) {
             delete db_;
             db_ = nullptr;
@@ -159,7 +172,7 @@ Context::~Context() {
     }
 
     {
-        Poco::Mutex::ScopedLock lock(user_m_);
+        InstrumentedMutex::ScopedLock lock(user_m_);
         if (user_) {
             delete user_;
             user_ = nullptr;
@@ -167,7 +180,7 @@ Context::~Context() {
     }
 
     {
-        Poco::Mutex::ScopedLock lock(onboarding_service_m_);
+        InstrumentedMutex::ScopedLock lock(onboarding_service_m_);
         OnboardingService::getInstance()->Reset();
     }
 
@@ -176,25 +189,13 @@ Context::~Context() {
 
 void Context::stopActivities() {
     try {
-        {
-            Poco::Mutex::ScopedLock lock(reminder_m_);
-            if (reminder_.isRunning()) {
-                reminder_.stop();
-                reminder_.wait(2000);
-            }
-        }
-
-        {
-            Poco::Mutex::ScopedLock lock(ui_updater_m_);
-            if (ui_updater_.isRunning()) {
-                ui_updater_.stop();
-                ui_updater_.wait(2000);
-            }
-        }
+        stopReminders();
 
+        stopUIUpdater();
 
         {
-            Poco::Mutex::ScopedLock lock(syncer_m_);
+            InstrumentedMutex::ScopedLock lock(syncer_m_);
+            sync_scheduler_.Stop();
             if (syncer_.isRunning()) {
                 syncer_.stop();
                 syncer_.wait(2000);
@@ -209,19 +210,19 @@ void Context::stopActivities() {
     }
 
     {
-        Poco::Mutex::ScopedLock lock(window_change_recorder_m_);
+        InstrumentedMutex::ScopedLock lock(window_change_recorder_m_);
         if (window_change_recorder_) {
             window_change_recorder_->Shutdown();
         }
     }
 
     {
-        Poco::Mutex::ScopedLock lock(ws_client_m_);
+        InstrumentedMutex::ScopedLock lock(ws_client_m_);
         ws_client_.Shutdown();
     }
 
     {
-        Poco::Mutex::ScopedLock lock(timeline_uploader_m_);
+        InstrumentedMutex::ScopedLock lock(timeline_uploader_m_);
         if (timeline_uploader_) {
             timeline_uploader_->Shutdown();
         }
@@ -233,15 +234,24 @@ void Context::stopActivities() {
 void Context::Shutdown() {
     stopActivities();
 
+    // The recorder is stopped, store what it left in the queue
+    // before the tasks that would have done so are cancelled
+    applyTimelineEvents();
+
     // cancel tasks but allow them finish
     {
-        Poco::Mutex::ScopedLock lock(timer_m_);
-        timer_.cancel(false);
+        InstrumentedMutex::ScopedLock lock(executor_m_);
+        executor_.CancelAll();
     }
 
     // Stops all running threads and waits
     // for their completion (maximum 10 seconds).
     Poco::ThreadPool::defaultPool().stopAll();
+
+    std::vector<toggl::LockStats> lock_stats = InstrumentedMutex::Snapshot();
+    if (!lock_stats.empty()) {
+        logger.debug("Lock stats: ", LockStatsToJSON(lock_stats));
+    }
 }
 
 error Context::StartEvents() {
@@ -249,7 +259,7 @@ error Context::StartEvents() {
         logger.debug("StartEvents");
 
         {
-            Poco::Mutex::ScopedLock lock(user_m_);
+            InstrumentedMutex::ScopedLock lock(user_m_);
             if (user_) {
                 return displayError("Cannot start UI, user already logged in!");
             }
@@ -324,27 +334,37 @@ error Context::save(const bool push_changes) {
         std::vector<ModelChange> changes;
 
         {
-            Poco::Mutex::ScopedLock lock(user_m_);
+            InstrumentedMutex::ScopedLock lock(user_m_);
             error err = db()->SaveUser(user_, true, &changes);
             if (err != noError) {
                 return err;
             }
+            for (std::size_t i = 0; i < changes.size(); i++) {
+                if (changes[i].ModelType() == kModelProject
+                        || changes[i].ModelType() == kModelTask) {
+                    user_->related.ProjectsChanged();
+                    break;
+                }
+            }
+        }
+
+        std::string editor_guid("");
+        {
+            InstrumentedMutex::ScopedLock lock(time_entry_editor_m_);
+            editor_guid = time_entry_editor_guid_;
         }
 
         UIElements render;
         render.display_unsynced_items = true;
         render.display_timer_state = true;
-        render.ApplyChanges(time_entry_editor_guid_, changes);
+        render.ApplyChanges(editor_guid, changes);
         updateUI(render);
 
         if (push_changes) {
             logger.debug("onPushChanges executing");
 
             // Always sync asyncronously with syncerActivity
-            trigger_push_ = true;
-            if (!syncer_.isRunning()) {
-                syncer_.start();
-            }
+            requestSync(kSyncWorkPush);
         }
     } catch(const Poco::Exception& exc) {
         return exc.displayText();
@@ -356,165 +376,54 @@ error Context::save(const bool push_changes) {
     return noError;
 }
 
-UIElements UIElements::Reset() {
-    UIElements render;
-    render.first_load = true;
-    render.display_time_entries = true;
-    render.display_time_entry_autocomplete = true;
-    render.display_mini_timer_autocomplete = true;
-    render.display_project_autocomplete = true;
-    render.display_client_select = true;
-    render.display_workspace_select = true;
-    render.display_timer_state = true;
-    render.display_time_entry_editor = true;
-    render.display_autotracker_rules = true;
-    render.display_settings = true;
-    render.display_unsynced_items = true;
+void Context::OpenTimeEntryList() {
+    logger.debug("OpenTimeEntryList");
 
+    UIElements render;
     render.open_time_entry_list = true;
-    render.display_timeline = true;
-
-    return render;
+    render.display_time_entries = true;
+    updateUI(render);
 }
 
-std::string UIElements::String() const {
-    std::stringstream ss;
-    if (display_time_entries) {
-        ss << "display_time_entries ";
-    }
-    if (display_time_entry_autocomplete) {
-        ss << "display_time_entry_autocomplete ";
-    }
-    if (display_mini_timer_autocomplete) {
-        ss << "display_mini_timer_autocomplete ";
-    }
-    if (display_project_autocomplete) {
-        ss << "display_project_autocomplete ";
-    }
-    if (display_client_select) {
-        ss << "display_client_select ";
-    }
-    if (display_client_select) {
-        ss << "display_client_select ";
-    }
-    if (display_workspace_select) {
-        ss << "display_workspace_select ";
-    }
-    if (display_timer_state) {
-        ss << "display_timer_state ";
-    }
-    if (display_time_entry_editor) {
-        ss << "display_time_entry_editor ";
-    }
-    if (open_settings) {
-        ss << "open_settings ";
-    }
-    if (open_time_entry_list) {
-        ss << "open_time_entry_list ";
-    }
-    if (open_time_entry_editor) {
-        ss << "open_time_entry_editor ";
-    }
-    if (display_autotracker_rules) {
-        ss << "display_autotracker_rules ";
-    }
-    if (display_settings) {
-        ss << "display_settings ";
-    }
-    if (!time_entry_editor_guid.empty()) {
-        ss << "time_entry_editor_guid=" << time_entry_editor_guid << " ";
-    }
-    if (!time_entry_editor_field.empty()) {
-        ss << "time_entry_editor_field=" << time_entry_editor_field << " ";
-    }
-    if (display_unsynced_items) {
-        ss << "display_unsynced_items ";
-    }
-    if (display_timeline) {
-        ss << " display_timeline=" << display_timeline;
-    }
-    if (open_timeline) {
-        ss << " open_timeline=" << open_timeline;
+void Context::SetTimeEntryListWindow(
+    const uint64_t first_row,
+    const uint64_t count) {
+    if (!UI()->SetTimeEntryListWindow(first_row, count)) {
+        return;
     }
-    return ss.str();
-}
 
-void UIElements::ApplyChanges(
-    const std::string &editor_guid,
-    const std::vector<ModelChange> &changes) {
-
-    time_entry_editor_guid = editor_guid;
-
-    // Check what needs to be updated in UI
-    for (std::vector<ModelChange>::const_iterator it =
-        changes.begin();
-            it != changes.end();
-            ++it) {
-        ModelChange ch = *it;
-
-        if (ch.ModelType() == kModelWorkspace
-                || ch.ModelType() == kModelClient
-                || ch.ModelType() == kModelProject
-                || ch.ModelType() == kModelTask
-                || ch.ModelType() == kModelTimeEntry) {
-            display_time_entry_autocomplete = true;
-            display_time_entries = true;
-            display_mini_timer_autocomplete = true;
-        }
-
-        if (ch.ModelType() == kModelWorkspace
-                || ch.ModelType() == kModelClient
-                || ch.ModelType() == kModelProject
-                || ch.ModelType() == kModelTask) {
-            display_project_autocomplete = true;
-        }
-
-        if (ch.ModelType() == kModelClient
-                || ch.ModelType() == kModelWorkspace) {
-            display_client_select = true;
-        }
-
-        // Check if time entry editor needs to be updated
-        if (ch.ModelType() == kModelTimeEntry) {
-            display_timer_state = true;
-            // If time entry was edited, check further
-            if (time_entry_editor_guid == ch.GUID()) {
-                // If time entry was deleted, close editor
-                // and open list view
-                if (ch.ChangeType() == kChangeTypeDelete) {
-                    open_time_entry_list = true;
-                    display_time_entries = true;
-                } else {
-                    display_time_entry_editor = true;
-                }
-            }
-        }
-
-        if (ch.ModelType() == kModelAutotrackerRule) {
-            display_autotracker_rules = true;
-        }
+    UIElements render;
+    render.display_time_entry_list_window = true;
+    updateUI(render);
+}
 
-        if (ch.ModelType() == kModelSettings) {
-            display_settings = true;
+void Context::updateUI(const UIElements &what) {
+    {
+        InstrumentedMutex::ScopedLock lock(time_entry_editor_m_);
+        if (what.open_time_entry_editor
+                && !what.time_entry_editor_guid.empty()) {
+            time_entry_editor_guid_ = what.time_entry_editor_guid;
+        } else if (what.open_time_entry_list) {
+            time_entry_editor_guid_ = "";
         }
+    }
 
-        if (ch.ModelType() == kModelTimelineEvent && ch.ChangeType() == kChangeTypeInsert) {
-            display_timeline = true;
-        }
+    if (render_dispatcher_.Request(what)) {
+        renderUI(what);
     }
 }
 
-void Context::OpenTimeEntryList() {
-    logger.debug("OpenTimeEntryList");
+void Context::rendererActivity() {
+    ScopedThreadName name("render");
 
-    UIElements render;
-    render.open_time_entry_list = true;
-    render.display_time_entries = true;
-    updateUI(render);
+    UIElements frame;
+    while (render_dispatcher_.Wait(&frame)) {
+        renderUI(frame);
+    }
 }
 
-void Context::updateUI(const UIElements &what) {
-    logger.debug("updateUI " + what.String());
+void Context::renderUI(const UIElements &what) {
+    logger.debug("renderUI " + what.String());
 
     view::TimeEntry editor_time_entry_view;
 
@@ -544,16 +453,12 @@ void Context::updateUI(const UIElements &what) {
 
     // Collect data
     {
-        Poco::Mutex::ScopedLock lock(user_m_);
+        InstrumentedMutex::ScopedLock lock(user_m_);
 
         if (what.display_time_entry_editor && user_) {
             TimeEntry *editor_time_entry =
                 user_->related.TimeEntryByGUID(what.time_entry_editor_guid);
             if (editor_time_entry) {
-                if (what.open_time_entry_editor) {
-                    time_entry_editor_guid_ = editor_time_entry->GUID();
-                }
-
                 editor_time_entry_view.Fill(editor_time_entry);
                 if (editor_time_entry->IsTracking()) {
                     editor_time_entry_view.Duration =
@@ -668,10 +573,6 @@ void Context::updateUI(const UIElements &what) {
         }
 
         if (what.display_time_entries && user_) {
-            if (what.open_time_entry_list) {
-                time_entry_editor_guid_ = "";
-            }
-
             // Get a sorted list of time entries
             std::vector<TimeEntry *> time_entries =
                 user_->related.VisibleTimeEntries();
@@ -809,6 +710,8 @@ void Context::updateUI(const UIElements &what) {
                 displayError(err);
                 return;
             }
+            // Reminders may have been switched on or off
+            scheduleReminders(Poco::Timestamp());
             err = db()->LoadProxySettings(&use_proxy, &proxy);
             if (err != noError) {
                 setUser(nullptr);
@@ -820,9 +723,14 @@ void Context::updateUI(const UIElements &what) {
             }
             idle_.SetSettings(settings_);
 
-            HTTPClient::Config.UseProxy = use_proxy;
-            HTTPClient::Config.ProxySettings = proxy;
-            HTTPClient::Config.AutodetectProxy = settings_.autodetect_proxy;
+            if (HTTPClient::Config.UseProxy != use_proxy
+                    || HTTPClient::Config.AutodetectProxy != settings_.autodetect_proxy
+                    || HTTPClient::Config.ProxySettings.String() != proxy.String()) {
+                HTTPClient::Config.UseProxy = use_proxy;
+                HTTPClient::Config.ProxySettings = proxy;
+                HTTPClient::Config.AutodetectProxy = settings_.autodetect_proxy;
+                Netconf::InvalidateProxyCache();
+            }
             TogglClient::GetInstance().SetIgnoreCert(("development" == environment_) || settings_.force_ignore_cert);
         }
 
@@ -917,6 +825,8 @@ void Context::updateUI(const UIElements &what) {
             time_entry_views,
             !user_->HasLoadedMore());
         last_time_entry_list_render_at_ = Poco::LocalDateTime();
+    } else if (what.display_time_entry_list_window) {
+        UI()->DisplayTimeEntryListWindow();
     }
 
     if (what.display_timeline) {
@@ -932,7 +842,7 @@ void Context::updateUI(const UIElements &what) {
         } else {
             Poco::Util::TimerTask::Ptr teTask =
                 new Poco::Util::TimerTaskAdapter<Context>(*this, &Context::onTimeEntryAutocompletes);
-            timer_.schedule(teTask, Poco::Timestamp());
+            executor_.Schedule(teTask, Poco::Timestamp());
         }
     }
 
@@ -945,7 +855,7 @@ void Context::updateUI(const UIElements &what) {
         } else {
             Poco::Util::TimerTask::Ptr mtTask =
                 new Poco::Util::TimerTaskAdapter<Context>(*this, &Context::onMiniTimerAutocompletes);
-            timer_.schedule(mtTask, Poco::Timestamp());
+            executor_.Schedule(mtTask, Poco::Timestamp());
         }
     }
 
@@ -963,6 +873,10 @@ void Context::updateUI(const UIElements &what) {
         } else {
             UI()->DisplayEmptyTimerState();
         }
+        scheduleUIUpdate(Poco::Timestamp());
+
+        // The running entry may have changed, so may the next reminder
+        scheduleReminders(Poco::Timestamp());
     }
 
     if (what.display_autotracker_rules) {
@@ -1000,7 +914,7 @@ void Context::updateUI(const UIElements &what) {
         } else {
             Poco::Util::TimerTask::Ptr prTask =
                 new Poco::Util::TimerTaskAdapter<Context>(*this, &Context::onProjectAutocompletes);
-            timer_.schedule(prTask, Poco::Timestamp());
+            executor_.Schedule(prTask, Poco::Timestamp());
         }
     }
 
@@ -1061,28 +975,17 @@ error Context::displayError(const error &err) {
     return UI()->DisplayError(err);
 }
 
-int Context::nextSyncIntervalSeconds() const {
-    int n = static_cast<int>(Random::next(kSyncIntervalRangeSeconds)) + kSyncIntervalRangeSeconds;
-    logger.trace("Next autosync in ", n, " seconds");
-    return n;
-}
-
-void Context::scheduleSync() {
-    Poco::Int64 elapsed_seconds = Poco::Int64(time(nullptr)) - last_sync_started_;
-    logger.debug("scheduleSync elapsed_seconds=", elapsed_seconds);
+void Context::FullSync() {
+    logger.debug("FullSync");
 
-    if (elapsed_seconds < sync_interval_seconds_) {
-        logger.trace("Last sync attempt less than ", sync_interval_seconds_, " seconds ago, chill");
+    if (!user_) {
         return;
     }
 
-    Sync();
-}
+    overlay_visible_ = false;
 
-void Context::FullSync() {
-    trigger_full_sync_ = true;
     user_->SetSince(0);
-    Sync();
+    requestSync(kSyncWorkPull | kSyncWorkFull);
 }
 
 void Context::Sync() {
@@ -1094,17 +997,14 @@ void Context::Sync() {
 
     overlay_visible_ = false;
 
-    Poco::Int64 elapsed_seconds = Poco::Int64(time(nullptr)) - last_sync_started_;
-
-    // 2 seconds backoff to avoid too many sync requests
-    if (elapsed_seconds < kRequestThrottleSeconds) {
-        return;
-    }
+    requestSync(kSyncWorkPull);
+}
 
-    last_sync_started_ = time(nullptr);
+void Context::requestSync(const int work) {
+    // Requests coming in quick succession end up in the same cycle
+    sync_scheduler_.Request(work);
 
     // Always sync asyncronously with syncerActivity
-    trigger_sync_ = true;
     if (!syncer_.isRunning()) {
         syncer_.start();
     }
@@ -1142,8 +1042,6 @@ void Context::setOnline(const std::string &reason) {
     }
 
     UI()->DisplayOnlineState(kOnlineStateOnline);
-
-    scheduleSync();
 }
 
 void Context::switchWebSocketOff() {
@@ -1153,31 +1051,111 @@ void Context::switchWebSocketOff() {
         new Poco::Util::TimerTaskAdapter<Context>(
             *this, &Context::onSwitchWebSocketOff);
 
-    Poco::Mutex::ScopedLock lock(timer_m_);
-    timer_.schedule(ptask, Poco::Timestamp());
+    InstrumentedMutex::ScopedLock lock(executor_m_);
+    executor_.Schedule(ptask, Poco::Timestamp());
 }
 
 void Context::onSwitchWebSocketOff(Poco::Util::TimerTask&) {  // NOLINT
     logger.debug("onSwitchWebSocketOff");
 
-    Poco::Mutex::ScopedLock lock(ws_client_m_);
+    InstrumentedMutex::ScopedLock lock(ws_client_m_);
     ws_client_.Shutdown();
 }
 
 error Context::LoadUpdateFromJSONString(const std::string &json) {
     logger.debug("LoadUpdateFromJSONString json=", json);
 
-    Poco::Mutex::ScopedLock lock(user_m_);
+    if (json.empty()) {
+        return noError;
+    }
+
+    Json::Value root;
+    Json::Reader reader;
+    if (!reader.parse(json, root)) {
+        return displayError("Failed to LoadUpdateFromJSONString");
+    }
+
+    return LoadUpdateFromJSON(root);
+}
+
+error Context::LoadUpdateFromJSON(const Json::Value &root) {
+    Poco::UInt64 user_id(0);
+    {
+        InstrumentedMutex::ScopedLock lock(user_m_);
+        if (user_) {
+            user_id = user_->ID();
+        }
+    }
+    return applyUpdates(std::vector<Json::Value>(1, root), user_id);
+}
+
+void Context::QueueUpdateFromJSON(const Json::Value &root) {
+    Poco::UInt64 user_id(0);
+    {
+        InstrumentedMutex::ScopedLock lock(user_m_);
+        if (!user_) {
+            logger.warning("User is logged out, cannot update");
+            return;
+        }
+        user_id = user_->ID();
+    }
+
+    std::size_t pending = websocket_updates_.Add(root, user_id);
+
+    // The first update of a batch gives the rest of the burst a moment
+    // to arrive, a full batch is applied right away
+    Poco::Timestamp apply_at;
+    if (1 == pending) {
+        apply_at += kWebsocketUpdateBatchMillis * 1000;
+    } else if (pending != websocket_updates_.MaxBatchSize()) {
+        return;
+    }
+
+    Poco::Util::TimerTask::Ptr ptask =
+        new Poco::Util::TimerTaskAdapter<Context>(
+            *this, &Context::onApplyWebSocketUpdates);
+
+    InstrumentedMutex::ScopedLock lock(executor_m_);
+    executor_.Schedule(ptask, apply_at);
+}
+
+void Context::onApplyWebSocketUpdates(Poco::Util::TimerTask&) {  // NOLINT
+    Poco::UInt64 user_id(0);
+    std::vector<Json::Value> updates = websocket_updates_.Take(&user_id);
+    if (updates.empty()) {
+        return;
+    }
+
+    UpdateBatchStats stats = websocket_updates_.Stats();
+    logger.debug("Applying ", updates.size(), " websocket updates, ",
+                 "oldest waited ", stats.LastBatchLatencyMicros / 1000, " ms, ",
+                 stats.Updates, " updates in ", stats.Batches, " batches so far");
+
+    applyUpdates(updates, user_id);
+
+    // Things are happening on the server, pull sooner
+    sync_scheduler_.Activity();
+}
+
+error Context::applyUpdates(
+    const std::vector<Json::Value> &updates,
+    const Poco::UInt64 user_id) {
+    InstrumentedMutex::ScopedLock lock(user_m_);
     if (!user_) {
         logger.warning("User is logged out, cannot update");
         return noError;
     }
+    if (user_->ID() != user_id) {
+        logger.warning("Dropping ", updates.size(),
+                       " updates received for another user");
+        return noError;
+    }
 
     TimeEntry *running_entry = user_->RunningTimeEntry();
 
-    error err = user_->LoadUserUpdateFromJSONString(json);
-    if (err != noError) {
-        return displayError(err);
+    for (std::vector<Json::Value>::const_iterator it = updates.begin();
+            it != updates.end(); ++it) {
+        user_->LoadUserUpdateFromJSON(*it);
     }
 
     TimeEntry *new_running_entry = user_->RunningTimeEntry();
@@ -1197,8 +1175,8 @@ void Context::switchWebSocketOn() {
         new Poco::Util::TimerTaskAdapter<Context>(
             *this, &Context::onSwitchWebSocketOn);
 
-    Poco::Mutex::ScopedLock lock(timer_m_);
-    timer_.schedule(ptask, Poco::Timestamp());
+    InstrumentedMutex::ScopedLock lock(executor_m_);
+    executor_.Schedule(ptask, Poco::Timestamp());
 }
 
 void Context::onSwitchWebSocketOn(Poco::Util::TimerTask&) {  // NOLINT
@@ -1207,7 +1185,7 @@ void Context::onSwitchWebSocketOn(Poco::Util::TimerTask&) {  // NOLINT
     std::string apitoken("");
 
     {
-        Poco::Mutex::ScopedLock lock(user_m_);
+        InstrumentedMutex::ScopedLock lock(user_m_);
         if (user_) {
             apitoken = user_->APIToken();
         }
@@ -1219,7 +1197,7 @@ void Context::onSwitchWebSocketOn(Poco::Util::TimerTask&) {  // NOLINT
     }
 
     {
-        Poco::Mutex::ScopedLock lock(ws_client_m_);
+        InstrumentedMutex::ScopedLock lock(ws_client_m_);
         ws_client_.Start(this, apitoken, on_websocket_message);
     }
 }
@@ -1232,15 +1210,15 @@ void Context::switchTimelineOff() {
         new Poco::Util::TimerTaskAdapter<Context>(
             *this, &Context::onSwitchTimelineOff);
 
-    Poco::Mutex::ScopedLock lock(timer_m_);
-    timer_.schedule(ptask, Poco::Timestamp());
+    InstrumentedMutex::ScopedLock lock(executor_m_);
+    executor_.Schedule(ptask, Poco::Timestamp());
 }
 
 void Context::onSwitchTimelineOff(Poco::Util::TimerTask&) {  // NOLINT
     logger.debug("onSwitchTimelineOff");
 
     {
-        Poco::Mutex::ScopedLock lock(timeline_uploader_m_);
+        InstrumentedMutex::ScopedLock lock(timeline_uploader_m_);
         if (timeline_uploader_) {
             delete timeline_uploader_;
             timeline_uploader_ = nullptr;
@@ -1259,8 +1237,8 @@ void Context::switchTimelineOn() {
         return;
     }
 
-    Poco::Mutex::ScopedLock lock(timer_m_);
-    timer_.schedule(ptask, Poco::Timestamp());
+    InstrumentedMutex::ScopedLock lock(executor_m_);
+    executor_.Schedule(ptask, Poco::Timestamp());
 }
 
 void Context::onSwitchTimelineOn(Poco::Util::TimerTask&) {  // NOLINT
@@ -1271,19 +1249,19 @@ void Context::onSwitchTimelineOn(Poco::Util::TimerTask&) {  // NOLINT
     }
 
     {
-        Poco::Mutex::ScopedLock lock(user_m_);
+        InstrumentedMutex::ScopedLock lock(user_m_);
         if (!user_ || !user_->RecordTimeline()) {
             return;
         }
     }
 
     {
-        Poco::Mutex::ScopedLock lock(timeline_uploader_m_);
+        InstrumentedMutex::ScopedLock lock(timeline_uploader_m_);
         if (timeline_uploader_) {
             delete timeline_uploader_;
             timeline_uploader_ = nullptr;
         }
-        timeline_uploader_ = new TimelineUploader(this);
+        timeline_uploader_ = new TimelineUploader(this, &executor_);
     }
 }
 
@@ -1296,8 +1274,8 @@ void Context::fetchUpdates() {
         new Poco::Util::TimerTaskAdapter<Context>(
             *this, &Context::onFetchUpdates);
 
-    Poco::Mutex::ScopedLock lock(timer_m_);
-    timer_.schedule(ptask, next_fetch_updates_at_);
+    InstrumentedMutex::ScopedLock lock(executor_m_);
+    executor_.Schedule(ptask, next_fetch_updates_at_);
 
     logger.debug("Next update fetch at ", Formatter::Format8601(next_fetch_updates_at_));
 }
@@ -1312,31 +1290,6 @@ void Context::onFetchUpdates(Poco::Util::TimerTask&) {  // NOLINT
     executeUpdateCheck();
 }
 
-void Context::startPeriodicSync() {
-    logger.trace("startPeriodicSync");
-
-    Poco::Util::TimerTask::Ptr ptask =
-        new Poco::Util::TimerTaskAdapter<Context>
-    (*this, &Context::onPeriodicSync);
-
-    sync_interval_seconds_ = nextSyncIntervalSeconds();
-
-    Poco::Timestamp next_periodic_sync_at_ =
-        Poco::Timestamp() + (sync_interval_seconds_ * kOneSecondInMicros);
-    Poco::Mutex::ScopedLock lock(timer_m_);
-    timer_.schedule(ptask, next_periodic_sync_at_);
-
-    logger.debug("Next periodic sync at ", Formatter::Format8601(next_periodic_sync_at_));
-}
-
-void Context::onPeriodicSync(Poco::Util::TimerTask&) {  // NOLINT
-    logger.debug("onPeriodicSync");
-
-    scheduleSync();
-
-    startPeriodicSync();
-}
-
 void Context::startPeriodicUpdateCheck() {
     logger.debug("startPeriodicUpdateCheck");
 
@@ -1347,8 +1300,8 @@ void Context::startPeriodicUpdateCheck() {
     Poco::Int64 micros = kCheckUpdateIntervalSeconds *
                          Poco::Int64(kOneSecondInMicros);
     Poco::Timestamp next_periodic_check_at = Poco::Timestamp() + micros;
-    Poco::Mutex::ScopedLock lock(timer_m_);
-    timer_.schedule(ptask, next_periodic_check_at);
+    InstrumentedMutex::ScopedLock lock(executor_m_);
+    executor_.Schedule(ptask, next_periodic_check_at);
 
     logger.debug("Next periodic update check at ", Formatter::Format8601(next_periodic_check_at));
 }
@@ -1371,8 +1324,8 @@ void Context::startPeriodicInAppMessageCheck() {
     Poco::Int64 micros = kCheckInAppMessageIntervalSeconds *
                          Poco::Int64(kOneSecondInMicros);
     Poco::Timestamp next_periodic_check_at = Poco::Timestamp() + micros;
-    Poco::Mutex::ScopedLock lock(timer_m_);
-    timer_.schedule(ptask, next_periodic_check_at);
+    InstrumentedMutex::ScopedLock lock(executor_m_);
+    executor_.Schedule(ptask, next_periodic_check_at);
 
     logger.debug("Next periodic in-app message check at ", Formatter::Format8601(next_periodic_check_at));
 }
@@ -1396,7 +1349,7 @@ error Context::UpdateChannel(
 }
 
 std::string Context::UserFullName() {
-    Poco::Mutex::ScopedLock lock(user_m_);
+    InstrumentedMutex::ScopedLock lock(user_m_);
     if (!user_) {
         return "";
     }
@@ -1404,7 +1357,7 @@ std::string Context::UserFullName() {
 }
 
 std::string Context::UserEmail() {
-    Poco::Mutex::ScopedLock lock(user_m_);
+    InstrumentedMutex::ScopedLock lock(user_m_);
     if (!user_) {
         return "";
     }
@@ -1447,6 +1400,7 @@ error Context::downloadUpdate() {
             HTTPRequest req;
             req.host = "https://toggl.github.io";
             req.relative_url = "/toggldesktop/assets/updates-link.txt";
+            req.priority = kRequestPriorityBackground;
 
             TogglClient client = TogglClient::GetInstance();
             HTTPResponse resp = client.silentGet(req);
@@ -1588,6 +1542,7 @@ error Context::fetchMessage(const bool periodic) {
         std::string appversion("");
         {
             HTTPRequest req;
+            req.priority = kRequestPriorityBackground;
             if ("production" != environment_) {
                 // testing location
                 req.host = "https://raw.githubusercontent.com";
@@ -1786,8 +1741,8 @@ void Context::TimelineUpdateServerSettings() {
         new Poco::Util::TimerTaskAdapter<Context>(*this,
                 &Context::onTimelineUpdateServerSettings);
 
-    Poco::Mutex::ScopedLock lock(timer_m_);
-    timer_.schedule(ptask, next_update_timeline_settings_at_);
+    InstrumentedMutex::ScopedLock lock(executor_m_);
+    executor_.Schedule(ptask, next_update_timeline_settings_at_);
 
     logger.debug("Next timeline settings update at ", Formatter::Format8601(next_update_timeline_settings_at_));
 }
@@ -1808,7 +1763,7 @@ void Context::onTimelineUpdateServerSettings(Poco::Util::TimerTask&) {  // NOLIN
     std::string json(kRecordTimelineDisabledJSON);
 
     {
-        Poco::Mutex::ScopedLock lock(user_m_);
+        InstrumentedMutex::ScopedLock lock(user_m_);
         if (!user_) {
             return;
         }
@@ -1852,8 +1807,8 @@ error Context::SendFeedback(const Feedback &fb) {
             *this, &Context::onSendFeedback);
 
     {
-        Poco::Mutex::ScopedLock lock(timer_m_);
-        timer_.schedule(ptask, Poco::Timestamp());
+        InstrumentedMutex::ScopedLock lock(executor_m_);
+        executor_.Schedule(ptask, Poco::Timestamp());
     }
 
     return noError;
@@ -1866,7 +1821,7 @@ void Context::onSendFeedback(Poco::Util::TimerTask&) {  // NOLINT
     std::string api_token_name("");
 
     {
-        Poco::Mutex::ScopedLock lock(user_m_);
+        InstrumentedMutex::ScopedLock lock(user_m_);
         if (user_) {
             api_token_value = user_->APIToken();
             api_token_name = "api_token";
@@ -2342,7 +2297,7 @@ error Context::SetDBPath(
     try {
         logger.debug("SetDBPath ", path);
 
-        Poco::Mutex::ScopedLock lock(db_m_);
+        InstrumentedMutex::ScopedLock lock(db_m_);
         if (db_) {
             logger.debug("delete db_ from SetDBPath()");
             delete db_;
@@ -2360,6 +2315,11 @@ error Context::SetDBPath(
     return noError;
 }
 
+void Context::SetWebSocketClientURL(const std::string &value) {
+    logger.debug("SetWebSocketClientURL " + value);
+    urls::SetWebSocket(value);
+}
+
 void Context::SetEnvironment(const std::string &value) {
     if (!("production" == value ||
             "development" == value ||
@@ -2375,12 +2335,8 @@ void Context::SetEnvironment(const std::string &value) {
 
     // stopping heavy tasks for better unit tests performance/speed
     if (value == "test") {
-        if (ui_updater_.isRunning()) {
-            ui_updater_.stop();
-        }
-        if (reminder_.isRunning()) {
-            reminder_.stop();
-        }
+        stopUIUpdater();
+        stopReminders();
     }
 }
 
@@ -2664,7 +2620,7 @@ error Context::Login(
         }
 
         {
-            Poco::Mutex::ScopedLock lock(user_m_);
+            InstrumentedMutex::ScopedLock lock(user_m_);
             if (!user_) {
                 logger.error("cannot enable offline login, no user");
                 return noError;
@@ -2772,14 +2728,22 @@ void Context::setUser(User *value, const bool logged_in) {
     Poco::UInt64 user_id(0);
 
     {
-        Poco::Mutex::ScopedLock lock(user_m_);
+        InstrumentedMutex::ScopedLock lock(user_m_);
         if (user_) {
             delete user_;
         }
         user_ = value;
+
+        // Updates of the previous user must not reach the next one
+        websocket_updates_.Clear();
         if (user_) {
             user_id = user_->ID();
         }
+        timeline_uid_ = user_id;
+        if (user_) {
+            // Pick up the chunks of a previous session
+            user_->CompressTimeline();
+        }
     }
 
     if (quit_) {
@@ -2789,8 +2753,10 @@ void Context::setUser(User *value, const bool logged_in) {
     if (!user_id) {
         UI()->DisplayLogin(true, 0);
 
+        pull_cache_.Clear();
+
         {
-            Poco::Mutex::ScopedLock l(window_change_recorder_m_);
+            InstrumentedMutex::ScopedLock l(window_change_recorder_m_);
             if (window_change_recorder_) {
                 delete window_change_recorder_;
                 window_change_recorder_ = nullptr;
@@ -2815,7 +2781,7 @@ void Context::setUser(User *value, const bool logged_in) {
     UI()->DisplayLogin(false, user_id);
 
     {
-        Poco::Mutex::ScopedLock l(window_change_recorder_m_);
+        InstrumentedMutex::ScopedLock l(window_change_recorder_m_);
         if (window_change_recorder_) {
             delete window_change_recorder_;
             window_change_recorder_ = nullptr;
@@ -2835,13 +2801,9 @@ void Context::setUser(User *value, const bool logged_in) {
 
     fetchMessage(0);
 
-    if (!ui_updater_.isRunning()) {
-        ui_updater_.start();
-    }
+    startUIUpdater();
 
-    if (!reminder_.isRunning()) {
-        reminder_.start();
-    }
+    startReminders();
 
     // Offer beta channel, if not offered yet
     bool did_offer_beta_channel(false);
@@ -2952,7 +2914,7 @@ error Context::ClearCache() {
         }
 
         {
-            Poco::Mutex::ScopedLock lock(user_m_);
+            InstrumentedMutex::ScopedLock lock(user_m_);
             if (!user_) {
                 logger.warning("User is logged out, cannot clear cache");
                 return noError;
@@ -3002,7 +2964,7 @@ TimeEntry *Context::Start(
     TimeEntry *te = nullptr;
 
     {
-        Poco::Mutex::ScopedLock lock(user_m_);
+        InstrumentedMutex::ScopedLock lock(user_m_);
         if (!user_) {
             logger.warning("Cannot start tracking, user logged out");
             return nullptr;
@@ -3076,7 +3038,7 @@ void Context::OpenTimeEntryEditor(
     TimeEntry *te = nullptr;
 
     {
-        Poco::Mutex::ScopedLock lock(user_m_);
+        InstrumentedMutex::ScopedLock lock(user_m_);
         if (!user_) {
             logger.warning("Cannot edit time entry, user logged out");
             return;
@@ -3100,9 +3062,15 @@ void Context::OpenTimeEntryEditor(
     render.time_entry_editor_guid = te->GUID();
     render.time_entry_editor_field = focused_field_name;
 
+    std::string editor_guid("");
+    {
+        InstrumentedMutex::ScopedLock lock(time_entry_editor_m_);
+        editor_guid = time_entry_editor_guid_;
+    }
+
     // If user is already editing the time entry, toggle the editor
     // instead of doing nothing
-    if (time_entry_editor_guid_ == te->GUID()) {
+    if (editor_guid == te->GUID()) {
         render.open_time_entry_editor = false;
         render.display_time_entry_editor = false;
         render.time_entry_editor_guid = "";
@@ -3136,7 +3104,7 @@ TimeEntry *Context::ContinueLatest(const bool prevent_on_app) {
     TimeEntry *result = nullptr;
 
     {
-        Poco::Mutex::ScopedLock lock(user_m_);
+        InstrumentedMutex::ScopedLock lock(user_m_);
         if (!user_) {
             logger.warning("Cannot continue tracking, user logged out");
             return nullptr;
@@ -3210,7 +3178,7 @@ TimeEntry *Context::Continue(
     TimeEntry *result = nullptr;
 
     {
-        Poco::Mutex::ScopedLock lock(user_m_);
+        InstrumentedMutex::ScopedLock lock(user_m_);
         if (!user_) {
             logger.warning("Cannot continue time entry, user logged out");
             return nullptr;
@@ -3255,7 +3223,7 @@ error Context::DeleteTimeEntryByGUID(const std::string &GUID) {
     TimeEntry *te = nullptr;
 
     {
-        Poco::Mutex::ScopedLock lock(user_m_);
+        InstrumentedMutex::ScopedLock lock(user_m_);
         if (!user_) {
             logger.warning("Cannot delete time entry, user logged out");
             return noError;
@@ -3299,7 +3267,7 @@ error Context::SetTimeEntryDuration(
         return displayError(std::string(__FUNCTION__) + ": Missing GUID");
     }
 
-    Poco::Mutex::ScopedLock lock(user_m_);
+    InstrumentedMutex::ScopedLock lock(user_m_);
     if (!user_) {
         logger.warning("Cannot set duration, user logged out");
         return noError;
@@ -3340,7 +3308,7 @@ error Context::SetTimeEntryProject(
             return displayError(std::string(__FUNCTION__) + ": Missing GUID");
         }
 
-        Poco::Mutex::ScopedLock lock(user_m_);
+        InstrumentedMutex::ScopedLock lock(user_m_);
         if (!user_) {
             logger.warning("Cannot set project, user logged out");
             return noError;
@@ -3432,7 +3400,7 @@ error Context::SetTimeEntryDate(
     Poco::LocalDateTime dt;
 
     {
-        Poco::Mutex::ScopedLock lock(user_m_);
+        InstrumentedMutex::ScopedLock lock(user_m_);
         if (!user_) {
             logger.warning("Cannot change date, user logged out");
             return noError;
@@ -3490,7 +3458,7 @@ error Context::SetTimeEntryStartWithOption(const std::string GUID,
     TimeEntry *te = nullptr;
 
     {
-        Poco::Mutex::ScopedLock lock(user_m_);
+        InstrumentedMutex::ScopedLock lock(user_m_);
         if (!user_) {
             logger.warning("Cannot change start time, user logged out");
             return noError;
@@ -3524,7 +3492,7 @@ error Context::SetTimeEntryStart(
     TimeEntry *te = nullptr;
 
     {
-        Poco::Mutex::ScopedLock lock(user_m_);
+        InstrumentedMutex::ScopedLock lock(user_m_);
         if (!user_) {
             logger.warning("Cannot change start time, user logged out");
             return noError;
@@ -3582,7 +3550,7 @@ error Context::SetTimeEntryStop(const std::string GUID,
     TimeEntry *te = nullptr;
 
     {
-        Poco::Mutex::ScopedLock lock(user_m_);
+        InstrumentedMutex::ScopedLock lock(user_m_);
         if (!user_) {
             logger.warning("Cannot change stop time, user logged out");
             return noError;
@@ -3615,7 +3583,7 @@ error Context::SetTimeEntryStop(
     TimeEntry *te = nullptr;
 
     {
-        Poco::Mutex::ScopedLock lock(user_m_);
+        InstrumentedMutex::ScopedLock lock(user_m_);
         if (!user_) {
             logger.warning("Cannot change stop time, user logged out");
             return noError;
@@ -3678,7 +3646,7 @@ error Context::SetTimeEntryTags(
     TimeEntry *te = nullptr;
 
     {
-        Poco::Mutex::ScopedLock lock(user_m_);
+        InstrumentedMutex::ScopedLock lock(user_m_);
         if (!user_) {
             logger.warning("Cannot set tags, user logged out");
             return noError;
@@ -3715,7 +3683,7 @@ error Context::SetTimeEntryBillable(
     TimeEntry *te = nullptr;
 
     {
-        Poco::Mutex::ScopedLock lock(user_m_);
+        InstrumentedMutex::ScopedLock lock(user_m_);
         if (!user_) {
             logger.warning("Cannot set billable, user logged out");
             return noError;
@@ -3752,7 +3720,7 @@ error Context::SetTimeEntryDescription(
     TimeEntry *te = nullptr;
 
     {
-        Poco::Mutex::ScopedLock lock(user_m_);
+        InstrumentedMutex::ScopedLock lock(user_m_);
         if (!user_) {
             logger.warning("Cannot set description, user logged out");
             return noError;
@@ -3797,7 +3765,7 @@ error Context::Stop(const bool prevent_on_app) {
     std::vector<TimeEntry *> stopped;
 
     {
-        Poco::Mutex::ScopedLock lock(user_m_);
+        InstrumentedMutex::ScopedLock lock(user_m_);
         if (!user_) {
             logger.warning("Cannot stop tracking, user logged out");
             return noError;
@@ -3850,7 +3818,7 @@ error Context::DiscardTimeAt(
     TimeEntry *split = nullptr;
 
     {
-        Poco::Mutex::ScopedLock lock(user_m_);
+        InstrumentedMutex::ScopedLock lock(user_m_);
         if (!user_) {
             logger.warning("Cannot stop time entry, user logged out");
             return noError;
@@ -3890,7 +3858,7 @@ TimeEntry *Context::DiscardTimeAndContinue(
     }
 
     {
-        Poco::Mutex::ScopedLock lock(user_m_);
+        InstrumentedMutex::ScopedLock lock(user_m_);
         if (!user_) {
             logger.warning("Cannot stop time entry, user logged out");
             return nullptr;
@@ -3908,7 +3876,7 @@ TimeEntry *Context::DiscardTimeAndContinue(
 }
 
 TimeEntry *Context::RunningTimeEntry() {
-    Poco::Mutex::ScopedLock lock(user_m_);
+    InstrumentedMutex::ScopedLock lock(user_m_);
     if (!user_) {
         logger.warning("Cannot fetch time entry, user logged out");
         return nullptr;
@@ -3947,7 +3915,7 @@ void Context::FetchTags(const Poco::UInt64 workspaceID) {
 }
 
 error Context::ToggleTimelineRecording(const bool record_timeline) {
-    Poco::Mutex::ScopedLock lock(user_m_);
+    InstrumentedMutex::ScopedLock lock(user_m_);
     if (!user_) {
         logger.warning("Cannot toggle timeline, user logged out");
         return noError;
@@ -4000,7 +3968,7 @@ error Context::SetDefaultProject(
     const Poco::UInt64 tid) {
     try {
         {
-            Poco::Mutex::ScopedLock lock(user_m_);
+            InstrumentedMutex::ScopedLock lock(user_m_);
             if (!user_) {
                 logger.warning("Cannot set default PID, user logged out");
                 return noError;
@@ -4057,7 +4025,7 @@ error Context::DefaultProjectName(std::string *name) {
         Project *p = nullptr;
         Task *t = nullptr;
         {
-            Poco::Mutex::ScopedLock lock(user_m_);
+            InstrumentedMutex::ScopedLock lock(user_m_);
             if (!user_) {
                 logger.warning("Cannot get default PID, user logged out");
                 return noError;
@@ -4085,7 +4053,7 @@ error Context::DefaultPID(Poco::UInt64 *result) {
         poco_check_ptr(result);
         *result = 0;
         {
-            Poco::Mutex::ScopedLock lock(user_m_);
+            InstrumentedMutex::ScopedLock lock(user_m_);
             if (!user_) {
                 logger.warning("Cannot get default PID, user logged out");
                 return noError;
@@ -4107,7 +4075,7 @@ error Context::DefaultTID(Poco::UInt64 *result) {
         poco_check_ptr(result);
         *result = 0;
         {
-            Poco::Mutex::ScopedLock lock(user_m_);
+            InstrumentedMutex::ScopedLock lock(user_m_);
             if (!user_) {
                 logger.warning("Cannot get default PID, user logged out");
                 return noError;
@@ -4129,7 +4097,7 @@ error Context::DefaultOrFirstWID(Poco::UInt64 *result) {
         poco_check_ptr(result);
         *result = 0;
         {
-            Poco::Mutex::ScopedLock lock(user_m_);
+            InstrumentedMutex::ScopedLock lock(user_m_);
             if (!user_) {
                 logger.warning("Cannot get default PID, user logged out");
                 return noError;
@@ -4177,7 +4145,7 @@ error Context::AddAutotrackerRule(
     AutotrackerRule *rule = nullptr;
 
     {
-        Poco::Mutex::ScopedLock lock(user_m_);
+        InstrumentedMutex::ScopedLock lock(user_m_);
         if (!user_) {
             logger.warning("cannot add autotracker rule, user logged out");
             return noError;
@@ -4220,6 +4188,7 @@ error Context::AddAutotrackerRule(
         }
         rule->SetUID(user_->ID());
         user_->related.AutotrackerRules.push_back(rule);
+        user_->related.AutotrackerRulesChanged();
     }
 
     error err = save(false);
@@ -4242,7 +4211,7 @@ error Context::DeleteAutotrackerRule(
     }
 
     {
-        Poco::Mutex::ScopedLock lock(user_m_);
+        InstrumentedMutex::ScopedLock lock(user_m_);
         if (!user_) {
             logger.warning("cannot delete rule, user is logged out");
             return noError;
@@ -4284,7 +4253,7 @@ Project *Context::CreateProject(
     Project *result = nullptr;
 
     {
-        Poco::Mutex::ScopedLock lock(user_m_);
+        InstrumentedMutex::ScopedLock lock(user_m_);
         if (!user_) {
             logger.warning("Cannot add project, user logged out");
             return nullptr;
@@ -4377,7 +4346,7 @@ Client *Context::CreateClient(
     Client *result = nullptr;
 
     {
-        Poco::Mutex::ScopedLock lock(user_m_);
+        InstrumentedMutex::ScopedLock lock(user_m_);
         if (!user_) {
             logger.warning("Cannot create a client, user logged out");
             return nullptr;
@@ -4437,7 +4406,7 @@ error Context::OpenReportsInBrowser() {
     std::string apitoken("");
 
     {
-        Poco::Mutex::ScopedLock lock(user_m_);
+        InstrumentedMutex::ScopedLock lock(user_m_);
         if (!user_) {
             return displayError("You must log in to view reports");
         }
@@ -4545,8 +4514,8 @@ void Context::SetWake() {
     Poco::Util::TimerTask::Ptr ptask =
         new Poco::Util::TimerTaskAdapter<Context>(*this, &Context::onWake);
 
-    Poco::Mutex::ScopedLock lock(timer_m_);
-    timer_.schedule(ptask, next_wake_at_);
+    InstrumentedMutex::ScopedLock lock(executor_m_);
+    executor_.Schedule(ptask, next_wake_at_);
 
     logger.debug("Next wake at ", Formatter::Format8601(next_wake_at_));
 }
@@ -4603,6 +4572,10 @@ void Context::SetUnlocked() {
 
 void Context::SetOnline() {
     logger.debug("SetOnline");
+
+    // Network has changed, proxies might have as well
+    Netconf::InvalidateProxyCache();
+
     Sync();
 }
 
@@ -4627,7 +4600,7 @@ void Context::displayReminder() {
     }
 
     {
-        Poco::Mutex::ScopedLock lock(user_m_);
+        InstrumentedMutex::ScopedLock lock(user_m_);
         if (!user_) {
             return;
         }
@@ -4689,6 +4662,91 @@ void Context::resetLastTrackingReminderTime() {
     last_tracking_reminder_time_ = time(nullptr);
 }
 
+void Context::startReminders() {
+    {
+        InstrumentedMutex::ScopedLock lock(reminder_m_);
+        reminders_started_ = true;
+    }
+
+    Poco::Int64 at = nextReminderAt();
+    if (at) {
+        scheduleReminders(Poco::Timestamp::fromEpochTime(at));
+    }
+}
+
+void Context::stopReminders() {
+    InstrumentedMutex::ScopedLock lock(reminder_m_);
+    reminders_started_ = false;
+    if (!reminder_task_.isNull()) {
+        InstrumentedMutex::ScopedLock executor_lock(executor_m_);
+        executor_.Cancel(reminder_task_);
+        reminder_task_ = nullptr;
+    }
+}
+
+void Context::scheduleReminders(const Poco::Timestamp &at) {
+    InstrumentedMutex::ScopedLock lock(reminder_m_);
+    if (!reminders_started_) {
+        return;
+    }
+
+    InstrumentedMutex::ScopedLock executor_lock(executor_m_);
+    if (!reminder_task_.isNull()) {
+        executor_.Cancel(reminder_task_);
+    }
+    reminder_task_ = new Poco::Util::TimerTaskAdapter<Context>(
+        *this, &Context::onCheckReminders);
+    executor_.Schedule(reminder_task_, at);
+}
+
+Poco::Int64 Context::nextReminderAt() {
+    InstrumentedMutex::ScopedLock lock(user_m_);
+    if (!user_) {
+        return 0;
+    }
+    return NextReminderAt(settings_,
+                          user_->RunningTimeEntry(),
+                          pomodoro_break_entry_,
+                          last_tracking_reminder_time_,
+                          time(nullptr));
+}
+
+Poco::Int64 Context::NextReminderAt(
+    const Settings &settings,
+    TimeEntry *running,
+    TimeEntry *pomodoro_break_entry,
+    const Poco::Int64 last_tracking_reminder_time,
+    const Poco::Int64 now) {
+
+    Poco::Int64 at(0);
+    if (!running) {
+        if (settings.reminder) {
+            at = last_tracking_reminder_time
+                 + static_cast<Poco::Int64>(settings.reminder_minutes) * 60;
+        }
+    } else if (pomodoro_break_entry != nullptr
+               && !running->GUID().empty()
+               && running->GUID() == pomodoro_break_entry->GUID()) {
+        if (settings.pomodoro_break) {
+            at = running->StartTime()
+                 + static_cast<Poco::Int64>(settings.pomodoro_break_minutes) * 60;
+        }
+    } else if (settings.pomodoro && !running->SkipPomodoro()) {
+        Poco::Int64 started = running->StartTime();
+        if (running->DurOnly() && running->LastStartAt() != 0) {
+            started = running->LastStartAt();
+        }
+        at = started + static_cast<Poco::Int64>(settings.pomodoro_minutes) * 60;
+    }
+
+    // Overdue after a check means the reminder is not allowed
+    // on this weekday or at this hour, so look again later
+    if (at && at <= now) {
+        at = now + kReminderRecheckSeconds;
+    }
+    return at;
+}
+
 void Context::displayPomodoro() {
     if (!settings_.pomodoro) {
         return;
@@ -4697,7 +4755,7 @@ void Context::displayPomodoro() {
     Poco::UInt64 wid(0);
 
     {
-        Poco::Mutex::ScopedLock lock(user_m_);
+        InstrumentedMutex::ScopedLock lock(user_m_);
         if (!user_) {
             return;
         }
@@ -4761,7 +4819,7 @@ void Context::displayPomodoroBreak() {
     }
 
     {
-        Poco::Mutex::ScopedLock lock(user_m_);
+        InstrumentedMutex::ScopedLock lock(user_m_);
         if (!user_) {
             return;
         }
@@ -4792,9 +4850,64 @@ void Context::displayPomodoroBreak() {
     UI()->DisplayPomodoroBreak(settings_.pomodoro_break_minutes);
 }
 
-error Context::StartAutotrackerEvent(const TimelineEvent &event) {
-    Poco::Mutex::ScopedLock lock(user_m_);
+AutotrackerCacheStats Context::AutotrackerStats() {
+    InstrumentedMutex::ScopedLock lock(user_m_);
     if (!user_) {
+        return AutotrackerCacheStats();
+    }
+    return user_->related.AutotrackerStats();
+}
+
+error Context::StartAutotrackerEvent(const TimelineEvent &event) {
+    // Called from the recorder thread, which must not wait for the
+    // user lock. Only the latest window matters, one still waiting
+    // to be matched is replaced.
+    TimelineEvent *pending = new TimelineEvent();
+    pending->SetUID(timeline_uid_);
+    pending->SetTitle(event.Title());
+    pending->SetFilename(event.Filename());
+    pending->SetStartTime(event.StartTime());
+    pending->SetEndTime(event.EndTime());
+    pending->SetIdle(event.Idle());
+
+    {
+        InstrumentedMutex::ScopedLock lock(autotracker_event_m_);
+        bool scheduled = autotracker_event_ != nullptr;
+        autotracker_event_.reset(pending);
+        if (scheduled) {
+            return noError;
+        }
+    }
+
+    Poco::Util::TimerTask::Ptr ptask =
+        new Poco::Util::TimerTaskAdapter<Context>(
+            *this, &Context::onMatchAutotrackerEvent);
+
+    InstrumentedMutex::ScopedLock lock(executor_m_);
+    executor_.Schedule(ptask, Poco::Timestamp());
+
+    return noError;
+}
+
+void Context::onMatchAutotrackerEvent(Poco::Util::TimerTask&) {  // NOLINT
+    std::unique_ptr<TimelineEvent> event;
+    {
+        InstrumentedMutex::ScopedLock lock(autotracker_event_m_);
+        event.swap(autotracker_event_);
+    }
+    if (!event) {
+        return;
+    }
+
+    error err = matchAutotrackerEvent(*event);
+    if (err != noError) {
+        logger.warning(err);
+    }
+}
+
+error Context::matchAutotrackerEvent(const TimelineEvent &event) {
+    InstrumentedMutex::ScopedLock lock(user_m_);
+    if (!user_ || user_->ID() != event.UID()) {
         return noError;
     }
 
@@ -4806,23 +4919,18 @@ error Context::StartAutotrackerEvent(const TimelineEvent &event) {
     if (user_ && user_->RunningTimeEntry()) {
         return noError;
     }
-    AutotrackerRule *rule = user_->related.FindAutotrackerRule(event);
+    AutotrackerMatch match = user_->related.MatchAutotrackerEvent(event);
+    AutotrackerRule *rule = match.Rule;
     if (!rule) {
         return noError;
     }
 
-    Project *p = nullptr;
-    if (rule->PID()) {
-        p = user_->related.ProjectByID(rule->PID());
-    }
+    Project *p = match.RuleProject;
     if (rule->PID() && !p) {
         return error("autotracker project not found");
     }
 
-    Task *t = nullptr;
-    if (rule->TID()) {
-        t = user_->related.TaskByID(rule->TID());
-    }
+    Task *t = match.RuleTask;
     if (rule->TID() && !t) {
         return error("autotracker task not found");
     }
@@ -4838,7 +4946,7 @@ error Context::StartAutotrackerEvent(const TimelineEvent &event) {
 
 error Context::CreateCompressedTimelineBatchForUpload(TimelineBatch *batch) {
     try {
-        Poco::Mutex::ScopedLock lock(user_m_);
+        InstrumentedMutex::ScopedLock lock(user_m_);
         if (!user_) {
             logger.warning("cannot create timeline batch, user logged out");
             return noError;
@@ -4850,10 +4958,11 @@ error Context::CreateCompressedTimelineBatchForUpload(TimelineBatch *batch) {
             return noError;
         }
 
-        user_->CompressTimeline();
-        error err = save(false);
-        if (err != noError) {
-            return displayError(err);
+        if (user_->CloseTimelineChunks()) {
+            error err = save(false);
+            if (err != noError) {
+                return displayError(err);
+            }
         }
 
         batch->SetEvents(user_->CompressedTimelineForUpload());
@@ -4877,16 +4986,33 @@ error Context::StartTimelineEvent(TimelineEvent *event) {
     try {
         poco_check_ptr(event);
 
-        Poco::Mutex::ScopedLock lock(user_m_);
-        if (!user_) {
+        // Called from the recorder thread, which must not wait for
+        // the user lock. The events are stored by an executor_ task
+        // later, for the user they were recorded for only.
+        event->SetUID(timeline_uid_);
+        std::size_t pending = timeline_events_.Push(event);
+        if (!pending) {
+            logger.warning("Timeline event queue is full, dropping ",
+                           event->String());
             return noError;
         }
+        handler.release();
 
-        if (user_ && user_->RecordTimeline()) {
-            event->SetUID(static_cast<unsigned int>(user_->ID()));
-            user_->related.TimelineEvents.push_back(handler.release());
-            return displayError(save(false));
+        // The first event of a batch waits for more to come,
+        // a half full queue is stored right away
+        Poco::Timestamp apply_at;
+        if (1 == pending) {
+            apply_at += kTimelineEventBatchMillis * 1000;
+        } else if (pending != timeline_events_.Capacity() / 2) {
+            return noError;
         }
+
+        Poco::Util::TimerTask::Ptr ptask =
+            new Poco::Util::TimerTaskAdapter<Context>(
+                *this, &Context::onApplyTimelineEvents);
+
+        InstrumentedMutex::ScopedLock lock(executor_m_);
+        executor_.Schedule(ptask, apply_at);
     } catch(const Poco::Exception& exc) {
         return displayError(exc.displayText());
     } catch(const std::exception& ex) {
@@ -4897,9 +5023,72 @@ error Context::StartTimelineEvent(TimelineEvent *event) {
     return noError;
 }
 
+void Context::onApplyTimelineEvents(Poco::Util::TimerTask&) {  // NOLINT
+    applyTimelineEvents();
+
+    // Events pushed while taking are applied by the next task
+    if (timeline_events_.Depth()) {
+        Poco::Util::TimerTask::Ptr ptask =
+            new Poco::Util::TimerTaskAdapter<Context>(
+                *this, &Context::onApplyTimelineEvents);
+
+        InstrumentedMutex::ScopedLock lock(executor_m_);
+        executor_.Schedule(ptask, Poco::Timestamp());
+    }
+}
+
+void Context::applyTimelineEvents() {
+    InstrumentedMutex::ScopedLock events_lock(timeline_events_m_);
+
+    std::vector<TimelineEvent *> events = timeline_events_.Take();
+    if (events.empty()) {
+        return;
+    }
+
+    std::vector<std::unique_ptr<TimelineEvent> > handlers;
+    for (std::size_t i = 0; i < events.size(); i++) {
+        handlers.emplace_back(events[i]);
+    }
+
+    try {
+        InstrumentedMutex::ScopedLock lock(user_m_);
+        if (!user_ || !user_->RecordTimeline()) {
+            return;
+        }
+
+        TimelineEventQueueStats stats = timeline_events_.Stats();
+        logger.debug("Storing ", events.size(), " timeline events, ",
+                     stats.Queued, " queued and ", stats.Dropped,
+                     " dropped so far");
+
+        std::size_t stored(0);
+        for (std::size_t i = 0; i < handlers.size(); i++) {
+            // Recorded before another user logged in
+            if (handlers[i]->UID() != user_->ID()) {
+                continue;
+            }
+            user_->AddTimelineEvent(handlers[i].release());
+            stored++;
+        }
+        if (stored != handlers.size()) {
+            logger.warning("Dropped ", handlers.size() - stored,
+                           " timeline events of a previous user");
+        }
+        if (stored) {
+            displayError(save(false));
+        }
+    } catch(const Poco::Exception& exc) {
+        displayError(exc.displayText());
+    } catch(const std::exception& ex) {
+        displayError(ex.what());
+    } catch(const std::string & ex) {
+        displayError(ex);
+    }
+}
+
 error Context::MarkTimelineBatchAsUploaded(const std::vector<const TimelineEvent*> &events) {
     try {
-        Poco::Mutex::ScopedLock lock(user_m_);
+        InstrumentedMutex::ScopedLock lock(user_m_);
         if (!user_) {
             logger.warning("cannot mark timeline events as uploaded, "
                            "user is already logged out");
@@ -4927,42 +5116,96 @@ error Context::SetPromotionResponse(
     return noError;
 }
 
-void Context::uiUpdaterActivity() {
-    std::string running_time("");
-    while (!ui_updater_.isStopped()) {
-        // Sleep in increments for faster shutdown.
-        for (unsigned int i = 0; i < 4*10; i++) {
-            if (ui_updater_.isStopped()) {
-                return;
-            }
-            Poco::Thread::sleep(250);
-        }
+void Context::startUIUpdater() {
+    {
+        InstrumentedMutex::ScopedLock lock(ui_updater_m_);
+        ui_updater_started_ = true;
+    }
+    scheduleUIUpdate(Poco::Timestamp());
+}
 
-        TimeEntry *te = nullptr;
-        Poco::Int64 duration(0);
-        {
-            Poco::Mutex::ScopedLock lock(user_m_);
-            if (!user_) {
-                continue;
-            }
-            te = user_->RunningTimeEntry();
-            if (!te) {
-                continue;
+void Context::stopUIUpdater() {
+    InstrumentedMutex::ScopedLock lock(ui_updater_m_);
+    ui_updater_started_ = false;
+    if (!ui_updater_task_.isNull()) {
+        InstrumentedMutex::ScopedLock executor_lock(executor_m_);
+        executor_.Cancel(ui_updater_task_);
+        ui_updater_task_ = nullptr;
+    }
+}
+
+void Context::scheduleUIUpdate(const Poco::Timestamp &at) {
+    InstrumentedMutex::ScopedLock lock(ui_updater_m_);
+    if (!ui_updater_started_) {
+        return;
+    }
+
+    InstrumentedMutex::ScopedLock executor_lock(executor_m_);
+    if (!ui_updater_task_.isNull()) {
+        executor_.Cancel(ui_updater_task_);
+    }
+    ui_updater_task_ = new Poco::Util::TimerTaskAdapter<Context>(
+        *this, &Context::onUpdateRunningTimer);
+    executor_.Schedule(ui_updater_task_, at);
+}
+
+void Context::onUpdateRunningTimer(Poco::Util::TimerTask& task) {  // NOLINT
+    std::string guid("");
+    Poco::Int64 started(0);
+    Poco::Int64 duration(0);
+    {
+        InstrumentedMutex::ScopedLock lock(user_m_);
+        if (user_) {
+            TimeEntry *te = user_->RunningTimeEntry();
+            if (te) {
+                guid = te->GUID();
+                started = te->StartTime();
+                duration = user_->related.TotalDurationForDate(te);
             }
-            duration = user_->related.TotalDurationForDate(te);
         }
+    }
 
-        std::string date_duration =
-            Formatter::FormatDurationForDateHeader(duration);
+    std::string date_duration("");
+    if (!guid.empty()) {
+        date_duration = Formatter::FormatDurationForDateHeader(duration);
+    }
 
-        if (running_time != date_duration) {
-            UIElements render;
-            render.display_time_entries = true;
-            updateUI(render);
+    std::string running_guid("");
+    std::string running_time("");
+    {
+        InstrumentedMutex::ScopedLock lock(ui_updater_m_);
+        // An update scheduled in the meantime takes over
+        if (ui_updater_task_.get() != &task) {
+            return;
         }
+        running_guid = ui_updater_guid_;
+        running_time = ui_updater_date_duration_;
+        ui_updater_guid_ = guid;
+        ui_updater_date_duration_ = date_duration;
+    }
 
-        running_time = date_duration;
+    if (UI()->CanDisplayRunningTimer()) {
+        if (guid != running_guid || date_duration != running_time) {
+            UI()->DisplayRunningTimer(guid, started, duration);
+        }
+    } else if (!guid.empty() && running_time != date_duration) {
+        UIElements render;
+        render.display_time_entries = true;
+        updateUI(render);
+    }
+
+    InstrumentedMutex::ScopedLock lock(ui_updater_m_);
+    if (ui_updater_task_.get() != &task) {
+        return;
     }
+    if (guid.empty()) {
+        // Nothing runs, renderUI schedules the next update when it starts
+        ui_updater_task_ = nullptr;
+        return;
+    }
+    // Date headers show minutes, so update when the next one starts
+    scheduleUIUpdate(
+        Poco::Timestamp() + (60 - duration % 60) * Poco::Timespan::SECONDS);
 }
 
 void Context::checkReminders() {
@@ -4971,21 +5214,26 @@ void Context::checkReminders() {
     displayPomodoroBreak();
 }
 
-void Context::reminderActivity() {
-    while (true) {
-        // Sleep in increments for faster shutdown.
-        for (int i = 0; i < 4; i++) {
-            if (reminder_.isStopped()) {
-                return;
-            }
-            Poco::Thread::sleep(250);
-        }
+void Context::onCheckReminders(Poco::Util::TimerTask& task) {  // NOLINT
+    checkReminders();
+
+    Poco::Int64 at = nextReminderAt();
 
-        checkReminders();
+    InstrumentedMutex::ScopedLock lock(reminder_m_);
+    // A check scheduled in the meantime takes over
+    if (reminder_task_.get() != &task) {
+        return;
+    }
+    if (!at) {
+        reminder_task_ = nullptr;
+        return;
     }
+    scheduleReminders(Poco::Timestamp::fromEpochTime(at));
 }
 
 void Context::syncerActivityWrapper() {
+    ScopedThreadName name("syncer");
+
     enum {
         STARTUP,
         LEGACY,
@@ -5004,40 +5252,66 @@ void Context::syncerActivityWrapper() {
 #endif
 
     while (true) {
-        // Sleep in increments for faster shutdown.
-        for (int i = 0; i < 4; i++) {
-            if (syncer_.isStopped()) {
-                return;
+        // Sleeps until a sync was requested or a periodic one is due
+        int work = sync_scheduler_.Wait();
+        if (kSyncWorkNone == work || syncer_.isStopped()) {
+            return;
+        }
+
+        if (STARTUP == state) {
+            logger.log("Syncer bootup, will attempt to determine which protocol to use");
+            //Do it here to know the type of syncing before syncerActivityWrapper() pulls the preferences
+            auto error = pullUserPreferences();
+            if (error != noError) {
+                sync_scheduler_.CycleFinished(work);
+                continue;
             }
-            Poco::Thread::sleep(250);
+            state = user_->AlphaFeatureSettings->IsSyncEnabled() ? BATCHED : LEGACY;
+            logger.log("Syncer - Syncing protocol was selected: ", (state == BATCHED ? "BATCHED" : "LEGACY"));
+        }
+
+        {
+            InstrumentedMutex::ScopedLock lock(syncer_m_);
+            trigger_sync_ = work & kSyncWorkPull;
+            trigger_push_ = work & kSyncWorkPush;
+            trigger_full_sync_ = work & kSyncWorkFull;
         }
 
         switch (state) {
-            case STARTUP: {
-                logger.log("Syncer bootup, will attempt to determine which protocol to use");
-                //Do it here to know the type of syncing before syncerActivityWrapper() pulls the preferences
-                auto error = pullUserPreferences();
-                if (error != noError)
-                    break;
-                state = user_->AlphaFeatureSettings->IsSyncEnabled() ? state = BATCHED : LEGACY;
-                logger.log("Syncer - Syncing protocol was selected: ", (state == BATCHED ? "BATCHED" : "LEGACY"));
-                break;
-            }
             case LEGACY:
                 legacySyncerActivity();
                 break;
             case BATCHED:
                 batchedSyncerActivity();
                 break;
+            default:
+                break;
+        }
+
+        // Whatever is still flagged failed and gets retried later
+        int unfinished = kSyncWorkNone;
+        {
+            InstrumentedMutex::ScopedLock lock(syncer_m_);
+            if (trigger_sync_) {
+                unfinished |= kSyncWorkPull;
+            }
+            if (trigger_push_) {
+                unfinished |= kSyncWorkPush;
+            }
+            if (trigger_full_sync_) {
+                unfinished |= kSyncWorkFull;
+            }
         }
+        sync_scheduler_.CycleFinished(unfinished);
     }
 }
 
 void Context::legacySyncerActivity() {
     {
-        Poco::Mutex::ScopedLock lock(syncer_m_);
+        InstrumentedMutex::ScopedLock lock(syncer_m_);
 
         if (trigger_sync_) {
+            pull_cache_.StartCycle();
 
             error err = pullAllUserData();
             if (err != noError) {
@@ -5052,6 +5326,8 @@ void Context::legacySyncerActivity() {
                 trigger_full_sync_ = false;
             }
 
+            logPullCacheStats();
+
             setOnline("Data pulled");
 
             err = pushChanges(&trigger_sync_);
@@ -5071,7 +5347,7 @@ void Context::legacySyncerActivity() {
     }
 
     {
-        Poco::Mutex::ScopedLock lock(syncer_m_);
+        InstrumentedMutex::ScopedLock lock(syncer_m_);
 
         if (trigger_push_) {
             error err = pushChanges(&trigger_sync_);
@@ -5080,6 +5356,12 @@ void Context::legacySyncerActivity() {
                 displayError(err);
             } else {
                 setOnline("Data pushed");
+
+                // Pull what the server made of the pushed changes
+                if (trigger_sync_) {
+                    trigger_sync_ = false;
+                    sync_scheduler_.Request(kSyncWorkPull);
+                }
             }
             trigger_push_ = false;
 
@@ -5090,9 +5372,10 @@ void Context::legacySyncerActivity() {
 
 void Context::batchedSyncerActivity() {
     {
-        Poco::Mutex::ScopedLock lock(syncer_m_);
+        InstrumentedMutex::ScopedLock lock(syncer_m_);
 
         if (trigger_sync_ || trigger_push_) {
+            pull_cache_.StartCycle();
 
             error err = pullBatchedUserData();
             if (err != noError) {
@@ -5107,6 +5390,8 @@ void Context::batchedSyncerActivity() {
                 trigger_full_sync_ = false;
             }
 
+            logPullCacheStats();
+
             setOnline("Data pulled");
 
             err = pushBatchedChanges(&trigger_sync_);
@@ -5128,7 +5413,7 @@ void Context::batchedSyncerActivity() {
 
 void Context::LoadMore() {
     {
-        Poco::Mutex::ScopedLock lock(user_m_);
+        InstrumentedMutex::ScopedLock lock(user_m_);
         if (!user_ || user_->HasLoadedMore()) {
             return;
         }
@@ -5137,8 +5422,8 @@ void Context::LoadMore() {
         Poco::Util::TimerTask::Ptr task =
             new Poco::Util::TimerTaskAdapter<Context>(*this,
                     &Context::onLoadMore);
-        Poco::Mutex::ScopedLock lock(timer_m_);
-        timer_.schedule(task, postpone(0));
+        InstrumentedMutex::ScopedLock lock(executor_m_);
+        executor_.Schedule(task, postpone(0));
     }
 }
 
@@ -5146,7 +5431,7 @@ void Context::onLoadMore(Poco::Util::TimerTask&) {
     bool needs_render = !user_->HasLoadedMore();
     std::string api_token;
     {
-        Poco::Mutex::ScopedLock lock(user_m_);
+        InstrumentedMutex::ScopedLock lock(user_m_);
         if (!user_ || user_->HasLoadedMore()) {
             return;
         }
@@ -5180,7 +5465,7 @@ void Context::onLoadMore(Poco::Util::TimerTask&) {
         std::string json = resp.body;
 
         {
-            Poco::Mutex::ScopedLock lock(user_m_);
+            InstrumentedMutex::ScopedLock lock(user_m_);
             if (!user_)
                 return;
             error err = user_->LoadTimeEntriesFromJSONString(json);
@@ -5244,7 +5529,7 @@ error Context::pullAllUserData() {
     std::string api_token("");
     Poco::Int64 since(0);
     {
-        Poco::Mutex::ScopedLock lock(user_m_);
+        InstrumentedMutex::ScopedLock lock(user_m_);
         if (!user_) {
             logger.warning("cannot pull user data when logged out");
             return noError;
@@ -5274,7 +5559,7 @@ error Context::pullAllUserData() {
         }
 
         {
-            Poco::Mutex::ScopedLock lock(user_m_);
+            InstrumentedMutex::ScopedLock lock(user_m_);
             if (!user_) {
                 return error("cannot load user data when logged out");
             }
@@ -5315,7 +5600,7 @@ error Context::pullBatchedUserData() {
     std::string api_token("");
     Poco::Int64 since(0);
     {
-        Poco::Mutex::ScopedLock lock(user_m_);
+        InstrumentedMutex::ScopedLock lock(user_m_);
         if (!user_) {
             logger.warning("cannot pull user data when logged out");
             return noError;
@@ -5360,7 +5645,7 @@ error Context::pullBatchedUserData() {
         }
 
         {
-            Poco::Mutex::ScopedLock lock(user_m_);
+            InstrumentedMutex::ScopedLock lock(user_m_);
             if (!user_) {
                 return error("cannot load user data when logged out");
             }
@@ -5410,14 +5695,16 @@ error Context::pushBatchedChanges(
 
         std::map<std::string, BaseModel *> models;
 
+        std::vector<OutboxEntry> outbox;
         std::vector<TimeEntry *> time_entries;
         std::vector<Project *> projects;
         std::vector<Client *> clients;
 
         std::string api_token("");
+        Poco::UInt64 user_id(0);
 
         {
-            Poco::Mutex::ScopedLock lock(user_m_);
+            InstrumentedMutex::ScopedLock lock(user_m_);
             if (!user_) {
                 logger.warning("cannot push changes when logged out");
                 return noError;
@@ -5428,18 +5715,16 @@ error Context::pushBatchedChanges(
                 return error("cannot push changes without API token");
             }
 
-            collectPushableModels(
-                user_->related.TimeEntries,
+            user_id = user_->ID();
+            error err = collectOutboxModels(
+                &outbox,
                 &time_entries,
-                &models);
-            collectPushableModels(
-                user_->related.Projects,
                 &projects,
-                &models);
-            collectPushableModels(
-                user_->related.Clients,
                 &clients,
                 &models);
+            if (err != noError) {
+                return err;
+            }
             if (time_entries.empty()
                     && projects.empty()
                     && clients.empty()) {
@@ -5490,7 +5775,7 @@ error Context::pushBatchedChanges(
             std::cerr << "RESPONSE: " << responseJson.toStyledString() << std::endl;
             logger.debug("Sync response to request ", lastRequestUUID_, ": ", responseJson.toStyledString());
 
-            error err = syncHandleResponse(responseJson["clients"], clients);
+            err = syncHandleResponse(responseJson["clients"], clients);
             if (err != noError)
                 return err;
             updateProjectClients(clients, projects);
@@ -5501,6 +5786,10 @@ error Context::pushBatchedChanges(
             err = syncHandleResponse(responseJson["time_entries"], time_entries);
             if (err != noError)
                 return err;
+
+            err = acknowledgeOutboxModels(user_id, outbox, models);
+            if (err != noError)
+                return err;
         }
 
         stopwatch.stop();
@@ -5527,14 +5816,16 @@ error Context::pushChanges(
 
         std::map<std::string, BaseModel *> models;
 
+        std::vector<OutboxEntry> outbox;
         std::vector<TimeEntry *> time_entries;
         std::vector<Project *> projects;
         std::vector<Client *> clients;
 
         std::string api_token("");
+        Poco::UInt64 user_id(0);
 
         {
-            Poco::Mutex::ScopedLock lock(user_m_);
+            InstrumentedMutex::ScopedLock lock(user_m_);
             if (!user_) {
                 logger.warning("cannot push changes when logged out");
                 return noError;
@@ -5545,18 +5836,16 @@ error Context::pushChanges(
                 return error("cannot push changes without API token");
             }
 
-            collectPushableModels(
-                user_->related.TimeEntries,
+            user_id = user_->ID();
+            error err = collectOutboxModels(
+                &outbox,
                 &time_entries,
-                &models);
-            collectPushableModels(
-                user_->related.Projects,
                 &projects,
-                &models);
-            collectPushableModels(
-                user_->related.Clients,
                 &clients,
                 &models);
+            if (err != noError) {
+                return err;
+            }
             if (time_entries.empty()
                     && projects.empty()
                     && clients.empty()) {
@@ -5618,8 +5907,13 @@ error Context::pushChanges(
                 time_entries,
                 api_token);
             if (err != noError) {
-                // Hide load more button when offline
-                user_->ConfirmLoadedMore();
+                {
+                    // Hide load more button when offline
+                    InstrumentedMutex::ScopedLock lock(user_m_);
+                    if (user_ && user_->ID() == user_id) {
+                        user_->ConfirmLoadedMore();
+                    }
+                }
                 // Reload list to show unsynced icons in items
                 UIElements render;
                 render.display_time_entries = true;
@@ -5632,6 +5926,14 @@ error Context::pushChanges(
                << entry_stopwatch.elapsed() / 1000 << " ms";
         }
 
+        {
+            InstrumentedMutex::ScopedLock lock(user_m_);
+            error err = acknowledgeOutboxModels(user_id, outbox, models);
+            if (err != noError) {
+                return err;
+            }
+        }
+
         stopwatch.stop();
         ss << ") Total = " << stopwatch.elapsed() / 1000 << " ms";
         logger.debug(ss.str());
@@ -5802,7 +6104,7 @@ error Context::pushEntries(
             continue;
         }
 
-        Json::Value entryJson = (*it)->SaveToJSON();
+        Json::Value entryJson = (*it)->SaveChangesToJSON();
 
         Json::StyledWriter writer;
         entry_json = writer.write(entryJson);
@@ -5855,10 +6157,6 @@ error Context::pushEntries(
 
             offline = IsNetworkingError(resp.err);
 
-            if (offline) {
-                trigger_sync_ = false;
-            }
-
             if (kBadRequestError == resp.err) {
                 error_message = resp.body;
             }
@@ -6044,6 +6342,8 @@ error Context::pullWorkspaces() {
         req.relative_url = "/api/v9/me/workspaces";
         req.basic_auth_username = api_token;
         req.basic_auth_password = "api_token";
+        req.priority = kRequestPrioritySync;
+        req.cache = &pull_cache_;
 
         HTTPResponse resp = TogglClient::GetInstance().Get(req);
         if (resp.err != noError) {
@@ -6074,7 +6374,7 @@ error Context::pullWorkspaces() {
 error Context::pullWorkspacePreferences() {
     std::vector<Workspace*> workspaces;
     {
-        Poco::Mutex::ScopedLock lock(user_m_);
+        InstrumentedMutex::ScopedLock lock(user_m_);
         logger.debug("user mutex lock success - c:pullWorkspacePreferences");
 
         user_->related.WorkspaceList(&workspaces);
@@ -6131,6 +6431,8 @@ error Context::pullWorkspacePreferences(
         req.relative_url = ss.str();
         req.basic_auth_username = api_token;
         req.basic_auth_password = "api_token";
+        req.priority = kRequestPrioritySync;
+        req.cache = &pull_cache_;
 
         HTTPResponse resp = TogglClient::GetInstance().Get(req);
         if (resp.err != noError) {
@@ -6166,6 +6468,8 @@ error Context::pullUserPreferences() {
         req.relative_url = "/api/v9/me/preferences/desktop";
         req.basic_auth_username = api_token;
         req.basic_auth_password = "api_token";
+        req.priority = kRequestPrioritySync;
+        req.cache = &pull_cache_;
 
         HTTPResponse resp = TogglClient::GetInstance().Get(req);
         if (resp.err != noError) {
@@ -6212,9 +6516,19 @@ error Context::pullUserPreferences() {
     return noError;
 }
 
+void Context::logPullCacheStats() {
+    ResponseCacheStats stats = pull_cache_.Cycle();
+    if (!stats.Requests) {
+        return;
+    }
+    logger.debug("Revalidated ", stats.Requests, " documents, ",
+                 stats.NotModified, " not modified, ",
+                 stats.BytesSaved, " bytes not downloaded again");
+}
+
 error Context::pullAllPreferencesData() {
     {
-        Poco::Mutex::ScopedLock lock(user_m_);
+        InstrumentedMutex::ScopedLock lock(user_m_);
         if (!user_) {
             logger.warning("cannot pull preferences data when logged out");
             return noError;
@@ -6653,18 +6967,14 @@ error Context::PullCountries() {
             return error("Error parsing countries response body");
         }
 
+        ViewArena arena;
         std::vector<TogglCountryView> countries;
-        TogglCountryView *first = nullptr;
         for (unsigned int i = root.size(); i > 0; i--) {
-            TogglCountryView *item = country_view_item_init(root[i - 1]);
-            countries.push_back(*item);
-            item->Next = first;
-            first = item;
+            countries.push_back(country_view_item_init(root[i - 1], &arena));
         }
 
         // update country selectbox
         UI()->DisplayCountries(&countries);
-        country_list_delete_item(first);
     } catch(const Poco::Exception& exc) {
         return exc.displayText();
     } catch(const std::exception& ex) {
@@ -6700,18 +7010,201 @@ void Context::collectPushableModels(
     }
 }
 
+template<typename T>
+void Context::collectQueuedModels(
+    const std::vector<T *> &list,
+    const std::map<std::string, Poco::Int64> &queued,
+    std::vector<T *> *result,
+    std::map<std::string, BaseModel *> *models) const {
+
+    poco_check_ptr(result);
+    poco_check_ptr(models);
+
+    if (queued.empty()) {
+        return;
+    }
+
+    std::map<Poco::Int64, T *> ordered;
+    for (typename std::vector<T *>::const_iterator it =
+        list.begin();
+            it != list.end();
+            ++it) {
+        T *model = *it;
+        std::map<std::string, Poco::Int64>::const_iterator seq =
+            queued.find(model->GUID());
+        if (seq == queued.end() || !model->NeedsPush()) {
+            continue;
+        }
+        user_->EnsureWID(model);
+        ordered[seq->second] = model;
+        (*models)[model->GUID()] = model;
+    }
+
+    // Push in the order the user made the changes in
+    for (typename std::map<Poco::Int64, T *>::const_iterator it =
+        ordered.begin();
+            it != ordered.end();
+            ++it) {
+        result->push_back(it->second);
+    }
+}
+
+error Context::seedOutbox() {
+    if (outbox_seeded_uid_ == user_->ID()) {
+        return noError;
+    }
+
+    // Changes made before the outbox existed, or whose entries were
+    // acknowledged right before a crash, are only known from the models
+    std::vector<OutboxEntry> outbox;
+    error err = db()->LoadOutbox(user_->ID(), &outbox);
+    if (err != noError) {
+        return err;
+    }
+    std::set<std::string> queued;
+    for (std::vector<OutboxEntry>::const_iterator it = outbox.begin();
+            it != outbox.end();
+            ++it) {
+        queued.insert(it->GUID);
+    }
+
+    std::map<std::string, BaseModel *> models;
+    std::vector<TimeEntry *> time_entries;
+    std::vector<Project *> projects;
+    std::vector<Client *> clients;
+    collectPushableModels(user_->related.Clients, &clients, &models);
+    collectPushableModels(user_->related.Projects, &projects, &models);
+    collectPushableModels(user_->related.TimeEntries, &time_entries, &models);
+
+    for (std::map<std::string, BaseModel *>::const_iterator it =
+        models.begin();
+            it != models.end();
+            ++it) {
+        if (queued.find(it->first) != queued.end()) {
+            continue;
+        }
+        err = db()->QueueForPush(
+            user_->ID(), it->second->ModelName(), it->first);
+        if (err != noError) {
+            return err;
+        }
+    }
+
+    outbox_seeded_uid_ = user_->ID();
+    return noError;
+}
+
+error Context::collectOutboxModels(
+    std::vector<OutboxEntry> *outbox,
+    std::vector<TimeEntry *> *time_entries,
+    std::vector<Project *> *projects,
+    std::vector<Client *> *clients,
+    std::map<std::string, BaseModel *> *models) {
+
+    poco_check_ptr(outbox);
+
+    error err = seedOutbox();
+    if (err != noError) {
+        return err;
+    }
+
+    err = db()->LoadOutbox(user_->ID(), outbox);
+    if (err != noError) {
+        return err;
+    }
+
+    // Nothing pending, no need to look at the models at all
+    if (outbox->empty()) {
+        return noError;
+    }
+
+    std::map<std::string, Poco::Int64> queued_entries;
+    std::map<std::string, Poco::Int64> queued_projects;
+    std::map<std::string, Poco::Int64> queued_clients;
+    for (std::vector<OutboxEntry>::const_iterator it = outbox->begin();
+            it != outbox->end();
+            ++it) {
+        if (kModelTimeEntry == it->ModelType) {
+            queued_entries[it->GUID] = it->Seq;
+        } else if (kModelProject == it->ModelType) {
+            queued_projects[it->GUID] = it->Seq;
+        } else if (kModelClient == it->ModelType) {
+            queued_clients[it->GUID] = it->Seq;
+        }
+    }
+
+    collectQueuedModels(
+        user_->related.TimeEntries, queued_entries, time_entries, models);
+    collectQueuedModels(
+        user_->related.Projects, queued_projects, projects, models);
+    collectQueuedModels(
+        user_->related.Clients, queued_clients, clients, models);
+
+    // Entries whose models are gone or were pushed already
+    // since they were queued are done with
+    std::vector<OutboxEntry> done;
+    std::vector<OutboxEntry> pending;
+    for (std::vector<OutboxEntry>::const_iterator it = outbox->begin();
+            it != outbox->end();
+            ++it) {
+        if (models->find(it->GUID) == models->end()) {
+            done.push_back(*it);
+        } else {
+            pending.push_back(*it);
+        }
+    }
+    if (!done.empty()) {
+        err = db()->AcknowledgeOutbox(user_->ID(), done);
+        if (err != noError) {
+            return err;
+        }
+    }
+    outbox->swap(pending);
+
+    return noError;
+}
+
+error Context::acknowledgeOutboxModels(
+    const Poco::UInt64 user_id,
+    const std::vector<OutboxEntry> &outbox,
+    const std::map<std::string, BaseModel *> &models) {
+
+    // The models belong to a user that has logged out since
+    if (!user_ || user_->ID() != user_id) {
+        logger.warning("User changed during push, not acknowledging outbox");
+        return noError;
+    }
+
+    std::vector<OutboxEntry> pushed;
+    for (std::vector<OutboxEntry>::const_iterator it = outbox.begin();
+            it != outbox.end();
+            ++it) {
+        std::map<std::string, BaseModel *>::const_iterator model =
+            models.find(it->GUID);
+        if (model != models.end() && model->second->NeedsPush()) {
+            continue;
+        }
+        pushed.push_back(*it);
+    }
+    if (pushed.empty()) {
+        return noError;
+    }
+
+    return db()->AcknowledgeOutbox(user_->ID(), pushed);
+}
+
 void on_websocket_message(
     void *context,
-    std::string json) {
+    const Json::Value &message) {
 
     poco_check_ptr(context);
 
-    if (json.empty()) {
+    if (message.isNull()) {
         return;
     }
 
     Context *ctx = reinterpret_cast<Context *>(context);
-    ctx->LoadUpdateFromJSONString(json);
+    ctx->QueueUpdateFromJSON(message);
 }
 
 void Context::TrackWindowSize(const Poco::UInt64 width,
@@ -6797,7 +7290,7 @@ error Context::UpdateTimeEntry(
         return displayError(std::string(__FUNCTION__) + ": Missing GUID");
     }
 
-    Poco::Mutex::ScopedLock lock(user_m_);
+    InstrumentedMutex::ScopedLock lock(user_m_);
     if (!user_) {
         logger.warning("Cannot set project, user logged out");
         return noError;
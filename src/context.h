@@ -3,6 +3,7 @@
 #ifndef SRC_CONTEXT_H_
 #define SRC_CONTEXT_H_
 
+#include <atomic>
 #include <string>
 #include <vector>
 #include <map>
@@ -12,22 +13,31 @@
 
 #include "analytics.h"
 #include "util/custom_error_handler.h"
+#include "executor.h"
 #include "feedback.h"
 #include "gui.h"
 #include "help_article.h"
 #include "idle.h"
+#include "instrumented_mutex.h"
 #include "util/logger.h"
 #include "model_change.h"
+#include "outbox.h"
 #include "model/timeline_event.h"
+#include "timeline_event_queue.h"
 #include "timeline_notifications.h"
 #include "types.h"
+#include "render_dispatcher.h"
+#include "response_cache.h"
+#include "sync_scheduler.h"
+#include "ui_elements.h"
+#include "update_batcher.h"
 #include "websocket_client.h"
 #include "model/alpha_features.h"
 
 #include <Poco/Activity.h>
+#include <Poco/Event.h>
 #include <Poco/LocalDateTime.h>
 #include <Poco/Timestamp.h>
-#include <Poco/Util/Timer.h>
 
 #ifdef TOGGL_ALLOW_UPDATE_CHECK
 # define UPDATE_CHECK_DISABLED false
@@ -48,58 +58,6 @@ class TimelineUploader;
 class WindowChangeRecorder;
 class OnboardingService;
 
-class TOGGL_INTERNAL_EXPORT UIElements {
- public:
-    UIElements()
-        : first_load(false)
-    , display_time_entries(false)
-    , display_time_entry_autocomplete(false)
-    , display_mini_timer_autocomplete(false)
-    , display_project_autocomplete(false)
-    , display_client_select(false)
-    , display_workspace_select(false)
-    , display_timer_state(false)
-    , display_time_entry_editor(false)
-    , open_settings(false)
-    , open_time_entry_list(false)
-    , open_time_entry_editor(false)
-    , display_autotracker_rules(false)
-    , display_settings(false)
-    , time_entry_editor_guid("")
-    , time_entry_editor_field("")
-    , display_unsynced_items(false)
-    , display_timeline(false)
-    , open_timeline(false) {}
-
-    static UIElements Reset();
-
-    std::string String() const;
-
-    void ApplyChanges(
-        const std::string &editor_guid,
-        const std::vector<ModelChange> &changes);
-
-    bool first_load;
-    bool display_time_entries;
-    bool display_time_entry_autocomplete;
-    bool display_mini_timer_autocomplete;
-    bool display_project_autocomplete;
-    bool display_client_select;
-    bool display_workspace_select;
-    bool display_timer_state;
-    bool display_time_entry_editor;
-    bool open_settings;
-    bool open_time_entry_list;
-    bool open_time_entry_editor;
-    bool display_autotracker_rules;
-    bool display_settings;
-    std::string time_entry_editor_guid;
-    std::string time_entry_editor_field;
-    bool display_unsynced_items;
-    bool display_timeline;
-    bool open_timeline;
-};
-
 class TOGGL_INTERNAL_EXPORT Context : public TimelineDatasource {
  public:
     Context(
@@ -124,9 +82,55 @@ class TOGGL_INTERNAL_EXPORT Context : public TimelineDatasource {
 
     // Load model update from JSON string (from WebSocket)
     error LoadUpdateFromJSONString(const std::string &json);
+    error LoadUpdateFromJSON(const Json::Value &root);
+
+    // Queue a websocket update, updates arriving close to each
+    // other are applied and saved together
+    void QueueUpdateFromJSON(const Json::Value &root);
+
+    UpdateBatchStats WebSocketUpdateStats() {
+        return websocket_updates_.Stats();
+    }
+
+    TimelineEventQueueStats TimelineEventStats() const {
+        return timeline_events_.Stats();
+    }
+
+    AutotrackerCacheStats AutotrackerStats();
+
+    // The statistics of the instrumented locks as JSON,
+    // see InstrumentedMutex
+    std::string LockStats() const {
+        return LockStatsToJSON(InstrumentedMutex::Snapshot());
+    }
 
     void SetWebSocketClientURL(const std::string &value);
 
+    // How long sync requests are collected before a sync cycle starts
+    void SetSyncDebounce(const Poco::Timespan &debounce) {
+        sync_scheduler_.SetDebounce(debounce);
+    }
+
+    // How long render requests are collected into one frame,
+    // zero renders every request right away
+    void SetRenderInterval(const Poco::Timespan &interval) {
+        render_dispatcher_.SetInterval(interval);
+    }
+
+    RenderDispatcherStats RenderStats() {
+        return render_dispatcher_.Stats();
+    }
+
+    bool RenderIdle() {
+        return render_dispatcher_.Idle();
+    }
+
+    // Requests and bytes saved by revalidating workspaces
+    // and preferences during the last sync cycle
+    ResponseCacheStats PullCacheStats() {
+        return pull_cache_.Cycle();
+    }
+
     error SetDBPath(const std::string &path);
 
     void SetUpdatePath(const std::string &path) {
@@ -369,6 +373,11 @@ class TOGGL_INTERNAL_EXPORT Context : public TimelineDatasource {
 
     void OpenTimeEntryList();
 
+    // The UI scrolled the windowed time entry list
+    void SetTimeEntryListWindow(
+        const uint64_t first_row,
+        const uint64_t count);
+
     void OpenTimelineDataView();
 
     void ViewTimelinePrevDay();
@@ -583,10 +592,19 @@ class TOGGL_INTERNAL_EXPORT Context : public TimelineDatasource {
         return user_ ? user_->AlphaFeatureSettings : nullptr;
     }
 
+    // Epoch time the next reminder for the running entry, or for
+    // tracking nothing, can be due at, zero if none is.
+    // Overdue means it wasn't allowed, so it's checked again later.
+    static Poco::Int64 NextReminderAt(
+        const Settings &settings,
+        TimeEntry *running,
+        TimeEntry *pomodoro_break_entry,
+        const Poco::Int64 last_tracking_reminder_time,
+        const Poco::Int64 now);
+
  protected:
-    void uiUpdaterActivity();
+    void rendererActivity();
     void checkReminders();
-    void reminderActivity();
     void syncerActivityWrapper();
     void legacySyncerActivity();
     void batchedSyncerActivity();
@@ -608,17 +626,32 @@ class TOGGL_INTERNAL_EXPORT Context : public TimelineDatasource {
 
     void fetchUpdates();
 
-    // timer_ callbacks
+    // executor_ callbacks
+    void onUpdateRunningTimer(Poco::Util::TimerTask& task);  // NOLINT
     void onSwitchWebSocketOff(Poco::Util::TimerTask& task);  // NOLINT
+    void onApplyWebSocketUpdates(Poco::Util::TimerTask& task);  // NOLINT
+    // Applies the updates received for the user, unless
+    // another one has logged in since
+    error applyUpdates(
+        const std::vector<Json::Value> &updates,
+        const Poco::UInt64 user_id);
     void onSwitchWebSocketOn(Poco::Util::TimerTask& task);  // NOLINT
     void onSwitchTimelineOff(Poco::Util::TimerTask& task);  // NOLINT
     void onSwitchTimelineOn(Poco::Util::TimerTask& task);  // NOLINT
+    void onApplyTimelineEvents(Poco::Util::TimerTask& task);  // NOLINT
+    // Stores the queued timeline events recorded for the current user
+    // and throws away those recorded for a previous one
+    void applyTimelineEvents();
+    void onMatchAutotrackerEvent(Poco::Util::TimerTask& task);  // NOLINT
+    // Shows the autotracker notification for the window the event
+    // was recorded for, if a rule matches and nothing is running
+    error matchAutotrackerEvent(const TimelineEvent &event);
+    void onCheckReminders(Poco::Util::TimerTask& task);  // NOLINT
     void onFetchUpdates(Poco::Util::TimerTask& task);  // NOLINT
     void onPeriodicUpdateCheck(Poco::Util::TimerTask& task);  // NOLINT
     void onPeriodicInAppMessageCheck(Poco::Util::TimerTask& task);  // NOLINT
     void onTimelineUpdateServerSettings(Poco::Util::TimerTask& task);  // NOLINT
     void onSendFeedback(Poco::Util::TimerTask& task);  // NOLINT
-    void onPeriodicSync(Poco::Util::TimerTask& task);  // NOLINT
     void onTrackSettingsUsage(Poco::Util::TimerTask& task);  // NOLINT
     void onWake(Poco::Util::TimerTask& task);  // NOLINT
     void onLoadMore(Poco::Util::TimerTask& task); // NOLINT
@@ -632,8 +665,6 @@ class TOGGL_INTERNAL_EXPORT Context : public TimelineDatasource {
 
     void startPeriodicInAppMessageCheck();
 
-    void startPeriodicSync();
-
     void setUser(User *value, const bool user_logged_in = false);
 
     void switchWebSocketOff();
@@ -649,20 +680,37 @@ class TOGGL_INTERNAL_EXPORT Context : public TimelineDatasource {
     void displayReminder();
     void resetLastTrackingReminderTime();
 
+    // The running timer is shown by an executor_ task, run whenever the
+    // running entry may have changed and every minute while it runs,
+    // see onUpdateRunningTimer
+    void startUIUpdater();
+    void stopUIUpdater();
+    void scheduleUIUpdate(const Poco::Timestamp &at);
+
+    // Reminders are checked by an executor_ task scheduled for when
+    // the next one can be due, see onCheckReminders
+    void startReminders();
+    void stopReminders();
+    void scheduleReminders(const Poco::Timestamp &at);
+    // Epoch time of the next reminder check, zero if none is due
+    Poco::Int64 nextReminderAt();
+
     void displayPomodoro();
 
     void displayPomodoroBreak();
 
+    // Asks for the elements to be rendered with the next frame
     void updateUI(const UIElements &elements);
 
+    // Collects the data of the elements and calls the UI callbacks
+    void renderUI(const UIElements &what);
+
     error displayError(const error &err);
 
-    void scheduleSync();
+    void requestSync(const int work);
 
     void setOnline(const std::string &reason);
 
-    int nextSyncIntervalSeconds() const;
-
     bool isPostponed(
         const Poco::Timestamp value,
         const Poco::Timestamp::TimeDiff throttleMicros) const;
@@ -690,6 +738,7 @@ class TOGGL_INTERNAL_EXPORT Context : public TimelineDatasource {
     error pullChanges();
     error pullUserPreferences();
     error pullAllPreferencesData();
+    void logPullCacheStats();
 
     template <typename T>
     void syncCollectJSON(Json::Value &array, const std::vector<T*> &source);
@@ -767,19 +816,60 @@ class TOGGL_INTERNAL_EXPORT Context : public TimelineDatasource {
         std::vector<T *> *result,
         std::map<std::string, BaseModel *> *models = nullptr) const;
 
-    Poco::Mutex db_m_;
+    template<typename T>
+    void collectQueuedModels(
+        const std::vector<T *> &list,
+        const std::map<std::string, Poco::Int64> &queued,
+        std::vector<T *> *result,
+        std::map<std::string, BaseModel *> *models) const;
+
+    // Picks the models to push from the outbox, user_m_ must be locked
+    error collectOutboxModels(
+        std::vector<OutboxEntry> *outbox,
+        std::vector<TimeEntry *> *time_entries,
+        std::vector<Project *> *projects,
+        std::vector<Client *> *clients,
+        std::map<std::string, BaseModel *> *models);
+
+    // Removes the outbox entries whose models got pushed, unless
+    // the user they were collected for is no longer logged in.
+    // user_m_ must be locked
+    error acknowledgeOutboxModels(
+        const Poco::UInt64 user_id,
+        const std::vector<OutboxEntry> &outbox,
+        const std::map<std::string, BaseModel *> &models);
+
+    error seedOutbox();
+
+    InstrumentedMutex db_m_ { "Context::db_m_" };
     Database *db_;
 
-    Poco::Mutex user_m_;
+    InstrumentedMutex user_m_ { "Context::user_m_" };
     User *user_;
 
-    Poco::Mutex ws_client_m_;
+    InstrumentedMutex ws_client_m_ { "Context::ws_client_m_" };
     WebSocketClient ws_client_;
 
-    Poco::Mutex timeline_uploader_m_;
+    UpdateBatcher websocket_updates_;
+
+    // Timeline events from the recorder, stored in batches
+    TimelineEventQueue timeline_events_;
+    // Only one thread may take events from the queue at a time
+    InstrumentedMutex timeline_events_m_ { "Context::timeline_events_m_" };
+    // The user queued events are recorded for, read without user_m_
+    std::atomic<Poco::UInt64> timeline_uid_;
+    // Latest window the recorder asked the autotracker rules about,
+    // matched by an executor_ task so the recorder doesn't wait for user_m_
+    InstrumentedMutex autotracker_event_m_ { "Context::autotracker_event_m_" };
+    std::unique_ptr<TimelineEvent> autotracker_event_;
+
+    // Last workspaces and preferences documents, pulled again every sync cycle
+    ResponseCache pull_cache_;
+
+    InstrumentedMutex timeline_uploader_m_ { "Context::timeline_uploader_m_" };
     TimelineUploader *timeline_uploader_;
 
-    Poco::Mutex window_change_recorder_m_;
+    InstrumentedMutex window_change_recorder_m_ { "Context::window_change_recorder_m_" };
     WindowChangeRecorder *window_change_recorder_;
 
     custom_error_handler error_handler_;
@@ -793,20 +883,21 @@ class TOGGL_INTERNAL_EXPORT Context : public TimelineDatasource {
     Poco::Timestamp next_update_timeline_settings_at_;
     Poco::Timestamp next_wake_at_;
 
-    // Schedule tasks using a timer:
-    Poco::Mutex timer_m_;
-    Poco::Util::Timer timer_;
+    // Runs the timed and background tasks:
+    InstrumentedMutex executor_m_ { "Context::executor_m_" };
+    Executor executor_;
 
     class GUI ui_;
 
+    // Entry of the editor the UI was last asked to open, updated when
+    // the render is requested so the next request already sees it
+    InstrumentedMutex time_entry_editor_m_ { "Context::time_entry_editor_m_" };
     std::string time_entry_editor_guid_;
 
     std::string environment_;
 
     Idle idle_;
 
-    Poco::Int64 last_sync_started_;
-    Poco::Int64 sync_interval_seconds_;
     Poco::Int64 last_tracking_reminder_time_;
     Poco::Int64 last_pomodoro_reminder_time_;
     Poco::Int64 last_pomodoro_break_reminder_time_;
@@ -817,18 +908,32 @@ class TOGGL_INTERNAL_EXPORT Context : public TimelineDatasource {
     bool trigger_push_;
     bool trigger_full_sync_;
 
+    // User whose pending models were queued into the outbox at startup
+    Poco::UInt64 outbox_seeded_uid_;
+
     Poco::LocalDateTime last_time_entry_list_render_at_;
 
     bool quit_;
 
-    Poco::Mutex ui_updater_m_;
-    Poco::Activity<Context> ui_updater_;
+    InstrumentedMutex ui_updater_m_ { "Context::ui_updater_m_" };
+    bool ui_updater_started_;
+    // Replaced and cancelled whenever the update is scheduled again
+    Poco::Util::TimerTask::Ptr ui_updater_task_;
+    // Running entry and date total the UI was last shown
+    std::string ui_updater_guid_;
+    std::string ui_updater_date_duration_;
+
+    RenderDispatcher render_dispatcher_;
+    Poco::Activity<Context> renderer_;
 
-    Poco::Mutex reminder_m_;
-    Poco::Activity<Context> reminder_;
+    InstrumentedMutex reminder_m_ { "Context::reminder_m_" };
+    bool reminders_started_;
+    // Replaced and cancelled whenever the check is scheduled again
+    Poco::Util::TimerTask::Ptr reminder_task_;
 
-    Poco::Mutex syncer_m_;
+    InstrumentedMutex syncer_m_ { "Context::syncer_m_" };
     Poco::Activity<Context> syncer_;
+    SyncScheduler sync_scheduler_;
     std::string lastRequestUUID_;
 
     Analytics analytics_;
@@ -864,7 +969,7 @@ class TOGGL_INTERNAL_EXPORT Context : public TimelineDatasource {
         TimeEntry *te,
         const std::string &value);
 
-    Poco::Mutex onboarding_service_m_;
+    InstrumentedMutex onboarding_service_m_ { "Context::onboarding_service_m_" };
 
     bool checkIfSkipPomodoro(TimeEntry *te);
 
@@ -881,7 +986,7 @@ class TOGGL_INTERNAL_EXPORT Context : public TimelineDatasource {
 };
 void on_websocket_message(
     void *context,
-    std::string json);
+    const Json::Value &message);
 
 }  // namespace toggl
 
@@ -184,6 +184,14 @@ error Database::DeleteUser(
         if (err != noError) {
             return err;
         }
+        err = deleteAllFromTableByUID("outbox", model->ID());
+        if (err != noError) {
+            return err;
+        }
+        InstrumentedMutex::ScopedLock lock(session_m_);
+        if (outbox_.UID() == model->ID()) {
+            outbox_.Reset(0);
+        }
     }
     return noError;
 }
@@ -201,7 +209,7 @@ error Database::deleteAllFromTableByUID(
     }
 
     try {
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
 
         poco_check_ptr(session_);
 
@@ -230,7 +238,7 @@ error Database::deleteAllFromTableByDate(
     const Poco::Int64 stopTime = time.epochTime();
 
     try {
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
 
         poco_check_ptr(session_);
 
@@ -254,7 +262,7 @@ error Database::deleteAllSyncedTimelineEventsByDate(
     const Poco::Int64 endTime = time.epochTime();
 
     try {
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
 
         poco_check_ptr(session_);
 
@@ -276,7 +284,7 @@ error Database::deleteAllSyncedTimelineEventsByDate(
 
 error Database::journalMode(std::string *mode) {
     try {
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
 
         poco_check_ptr(session_);
         poco_check_ptr(mode);
@@ -302,7 +310,7 @@ error Database::setJournalMode(const std::string &mode) {
 
 
     try {
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
         poco_check_ptr(session_);
 
         *session_ <<
@@ -320,7 +328,7 @@ error Database::setJournalMode(const std::string &mode) {
 
 error Database::vacuum() {
     try {
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
         poco_check_ptr(session_);
 
         *session_ <<
@@ -350,7 +358,7 @@ error Database::DeleteFromTable(
     logger.debug( "Deleting from table ", table_name, ", local ID: ", local_id);
 
     try {
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
         poco_check_ptr(session_);
 
         *session_ <<
@@ -369,7 +377,7 @@ error Database::DeleteFromTable(
 }
 
 error Database::last_error(const std::string &was_doing) {
-    Poco::Mutex::ScopedLock lock(session_m_);
+    InstrumentedMutex::ScopedLock lock(session_m_);
 
     poco_check_ptr(session_);
 
@@ -409,7 +417,7 @@ error Database::LoadCurrentUser(User *user) {
 
 error Database::LoadSettings(Settings *settings) {
     try {
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
 
         poco_check_ptr(session_);
 
@@ -478,7 +486,7 @@ error Database::SaveWindowSettings(
     const Poco::Int64 window_width) {
 
     try {
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
 
         poco_check_ptr(session_);
 
@@ -535,7 +543,7 @@ error Database::LoadWindowSettings(
     Poco::Int64 *window_width) {
 
     try {
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
 
         poco_check_ptr(session_);
 
@@ -570,7 +578,7 @@ error Database::LoadProxySettings(
     Proxy *proxy) {
 
     try {
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
 
         poco_check_ptr(session_);
         poco_check_ptr(use_proxy);
@@ -710,7 +718,7 @@ error Database::SetSettingsRemindTimes(
     const std::string &remind_ends) {
 
     try {
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
 
         poco_check_ptr(session_);
 
@@ -742,7 +750,7 @@ error Database::SetSettingsRemindDays(
     const bool &remind_sun) {
 
     try {
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
 
         poco_check_ptr(session_);
 
@@ -874,7 +882,7 @@ error Database::setSettingsValue(
     try {
         poco_check_ptr(session_);
 
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
 
         *session_ <<
                   "update settings set " + field_name + " = :" + field_name,
@@ -899,7 +907,7 @@ error Database::getSettingsValue(
         poco_check_ptr(session_);
         poco_check_ptr(value);
 
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
 
         *session_ <<
                   "select " + field_name + " from settings limit 1",
@@ -948,7 +956,7 @@ error Database::SaveProxySettings(
     const Proxy &proxy) {
 
     try {
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
 
         poco_check_ptr(session_);
 
@@ -977,7 +985,7 @@ error Database::SaveProxySettings(
 
 error Database::Trim(const std::string &text, std::string *result) {
     try {
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
 
         poco_check_ptr(session_);
         poco_check_ptr(result);
@@ -1002,7 +1010,7 @@ error Database::Trim(const std::string &text, std::string *result) {
 
 error Database::ResetWindow() {
     try {
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
 
         poco_check_ptr(session_);
 
@@ -1034,7 +1042,7 @@ error Database::LoadUpdateChannel(
     std::string *update_channel) {
 
     try {
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
 
         poco_check_ptr(session_);
         poco_check_ptr(update_channel);
@@ -1079,7 +1087,7 @@ error Database::LoadUserByEmail(
     try {
         poco_check_ptr(model);
 
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
 
         poco_check_ptr(session_);
 
@@ -1130,6 +1138,7 @@ error Database::loadUsersRelatedData(User *user) {
     if (err != noError) {
         return err;
     }
+    user->related.ProjectsChanged();
 
     err = loadTags(user->ID(), &user->related.Tags);
     if (err != noError) {
@@ -1145,6 +1154,7 @@ error Database::loadUsersRelatedData(User *user) {
     if (err != noError) {
         return err;
     }
+    user->related.AutotrackerRulesChanged();
 
     err = loadTimelineEvents(user->ID(), &user->related.TimelineEvents);
     if (err != noError) {
@@ -1168,7 +1178,7 @@ error Database::LoadUserByID(
     try {
         poco_check_ptr(user);
 
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
 
         poco_check_ptr(session_);
 
@@ -1263,7 +1273,7 @@ error Database::loadWorkspaces(
 
         list->clear();
 
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
 
         Poco::Data::Statement select(*session_);
         select <<
@@ -1323,7 +1333,7 @@ error Database::loadClients(
 
         list->clear();
 
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
 
         Poco::Data::Statement select(*session_);
         select <<
@@ -1385,7 +1395,7 @@ error Database::loadProjects(
 
         list->clear();
 
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
 
         Poco::Data::Statement select(*session_);
         select <<
@@ -1475,7 +1485,7 @@ error Database::loadTasks(
 
         list->clear();
 
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
 
         Poco::Data::Statement select(*session_);
         select <<
@@ -1537,7 +1547,7 @@ error Database::loadTags(
 
         list->clear();
 
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
 
         Poco::Data::Statement select(*session_);
         select <<
@@ -1598,7 +1608,7 @@ error Database::loadAutotrackerRules(
 
         list->clear();
 
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
 
         Poco::Data::Statement select(*session_);
         select <<
@@ -1652,7 +1662,7 @@ error Database::loadTimelineEvents(
 
         list->clear();
 
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
 
         Poco::Data::Statement select(*session_);
         select <<
@@ -1728,7 +1738,7 @@ error Database::loadTimeEntries(
 
         list->clear();
 
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
 
         Poco::Data::Statement select(*session_);
         select <<
@@ -1923,6 +1933,18 @@ error Database::loadTimeEntriesFromSQLStatement(
     return noError;
 }
 
+namespace {
+
+// Models pushed by the syncer, the rest is never edited
+// offline or is uploaded some other way
+bool isQueuedForPush(const std::string &model_type) {
+    return kModelTimeEntry == model_type
+           || kModelProject == model_type
+           || kModelClient == model_type;
+}
+
+}  // namespace
+
 template <typename T>
 error Database::saveRelatedModels(
     const Poco::UInt64 UID,
@@ -1954,10 +1976,29 @@ error Database::saveRelatedModels(
             continue;
         }
         model->SetUID(UID);
+
+        // Changes the user made are queued for pushing
+        bool queue = model->NeedsToBeSaved() && model->NeedsPush()
+                     && isQueuedForPush(model->ModelName());
+        if (queue) {
+            model->EnsureGUID();
+        }
+
         error err = saveModel(model, changes);
         if (err != noError) {
             return err;
         }
+
+        if (queue) {
+            OutboxEntry entry;
+            entry.ModelType = model->ModelName();
+            entry.GUID = model->GUID();
+            err = appendToOutbox(UID, entry.ModelType, entry.GUID, &entry.Seq);
+            if (err != noError) {
+                return err;
+            }
+            outbox_staged_.push_back(entry);
+        }
     }
 
     // Purge deleted models from memory
@@ -1996,7 +2037,7 @@ error Database::saveModel(
             return noError;
         }
 
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
         poco_check_ptr(session_);
 
         if (model->LocalID()) {
@@ -2279,7 +2320,7 @@ error Database::saveModel(
             return noError;
         }
 
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
         poco_check_ptr(session_);
 
         const int kMaxTimelineStringSize = 300;
@@ -2427,7 +2468,7 @@ error Database::saveModel(
             return noError;
         }
 
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
         poco_check_ptr(session_);
 
         if (model->LocalID()) {
@@ -2516,7 +2557,7 @@ error Database::saveModel(
             return noError;
         }
 
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
         poco_check_ptr(session_);
 
         if (model->LocalID()) {
@@ -2620,7 +2661,7 @@ error Database::saveModel(
             return noError;
         }
 
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
         poco_check_ptr(session_);
 
         if (model->LocalID()) {
@@ -2735,7 +2776,7 @@ error Database::saveModel(
             return noError;
         }
 
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
         poco_check_ptr(session_);
 
         if (model->LocalID()) {
@@ -2966,7 +3007,7 @@ error Database::saveModel(
             return noError;
         }
 
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
         poco_check_ptr(session_);
 
         if (model->LocalID()) {
@@ -3043,7 +3084,7 @@ error Database::saveModel(
             return noError;
         }
 
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
         poco_check_ptr(session_);
 
         if (model->LocalID()) {
@@ -3142,7 +3183,7 @@ error Database::SaveUser(
     const bool with_related_data,
     std::vector<ModelChange> *changes) {
 
-    Poco::Mutex::ScopedLock lock(session_m_);
+    InstrumentedMutex::ScopedLock lock(session_m_);
 
     // Do nothing, if user has already logged out
     if (!user) {
@@ -3168,6 +3209,8 @@ error Database::SaveUser(
 
     session_->begin();
 
+    outbox_staged_.clear();
+
     // Check if we really need to save model,
     // *but* do not return if we don't need to.
     // We might need to save related models, still.
@@ -3399,6 +3442,16 @@ error Database::SaveUser(
 
     session_->commit();
 
+    if (outbox_.UID() == user->ID()) {
+        for (std::vector<OutboxEntry>::const_iterator
+                it = outbox_staged_.begin();
+                it != outbox_staged_.end();
+                ++it) {
+            outbox_.Add(it->Seq, it->ModelType, it->GUID);
+        }
+    }
+    outbox_staged_.clear();
+
     stopwatch.stop();
 
     logger.debug("User with_related_data=", with_related_data, " saved in ", stopwatch.elapsed() / 1000, " ms in thread ", Poco::Thread::currentTid());
@@ -3406,6 +3459,198 @@ error Database::SaveUser(
     return noError;
 }
 
+error Database::ensureOutbox(const Poco::UInt64 &UID) {
+    if (outbox_.UID() == UID) {
+        return noError;
+    }
+
+    outbox_.Reset(UID);
+
+    try {
+        Poco::Data::Statement select(*session_);
+        select <<
+               "SELECT seq, model, guid "
+               "FROM outbox "
+               "WHERE uid = :uid "
+               "ORDER BY seq",
+               useRef(UID);
+        error err = last_error("ensureOutbox");
+        if (err != noError) {
+            outbox_.Reset(0);
+            return err;
+        }
+        Poco::Data::RecordSet rs(select);
+        while (!select.done()) {
+            select.execute();
+            bool more = rs.moveFirst();
+            while (more) {
+                outbox_.Add(rs[0].convert<Poco::Int64>(),
+                            rs[1].convert<std::string>(),
+                            rs[2].convert<std::string>());
+                more = rs.moveNext();
+            }
+        }
+    } catch(const Poco::Exception& exc) {
+        outbox_.Reset(0);
+        return exc.displayText();
+    } catch(const std::exception& ex) {
+        outbox_.Reset(0);
+        return ex.what();
+    } catch(const std::string & ex) {
+        outbox_.Reset(0);
+        return ex;
+    }
+    return noError;
+}
+
+error Database::appendToOutbox(
+    const Poco::UInt64 &UID,
+    const std::string &model_type,
+    const std::string &GUID,
+    Poco::Int64 *seq) {
+
+    poco_check_ptr(seq);
+
+    try {
+        Poco::Int64 queued_at = time(nullptr);
+        *session_ <<
+                  "insert into outbox(uid, model, guid, queued_at) "
+                  "values(:uid, :model, :guid, :queued_at)",
+                  useRef(UID),
+                  useRef(model_type),
+                  useRef(GUID),
+                  useRef(queued_at),
+                  now;
+        error err = last_error("appendToOutbox");
+        if (err != noError) {
+            return err;
+        }
+        *session_ <<
+                  "select last_insert_rowid()",
+                  into(*seq),
+                  now;
+    } catch(const Poco::Exception& exc) {
+        return exc.displayText();
+    } catch(const std::exception& ex) {
+        return ex.what();
+    } catch(const std::string & ex) {
+        return ex;
+    }
+    return last_error("appendToOutbox");
+}
+
+error Database::LoadOutbox(
+    const Poco::UInt64 &UID,
+    std::vector<OutboxEntry> *entries) {
+
+    if (!UID) {
+        return error("Cannot load outbox without an user ID");
+    }
+
+    poco_check_ptr(entries);
+
+    InstrumentedMutex::ScopedLock lock(session_m_);
+
+    poco_check_ptr(session_);
+
+    error err = ensureOutbox(UID);
+    if (err != noError) {
+        return err;
+    }
+
+    *entries = outbox_.Entries();
+
+    return noError;
+}
+
+error Database::QueueForPush(
+    const Poco::UInt64 &UID,
+    const std::string &model_type,
+    const std::string &GUID) {
+
+    if (!UID) {
+        return error("Cannot queue model without an user ID");
+    }
+    if (GUID.empty()) {
+        return error("Cannot queue model without GUID");
+    }
+
+    InstrumentedMutex::ScopedLock lock(session_m_);
+
+    poco_check_ptr(session_);
+
+    error err = ensureOutbox(UID);
+    if (err != noError) {
+        return err;
+    }
+
+    Poco::Int64 seq(0);
+    err = appendToOutbox(UID, model_type, GUID, &seq);
+    if (err != noError) {
+        return err;
+    }
+
+    outbox_.Add(seq, model_type, GUID);
+
+    return noError;
+}
+
+error Database::AcknowledgeOutbox(
+    const Poco::UInt64 &UID,
+    const std::vector<OutboxEntry> &entries) {
+
+    if (!UID) {
+        return error("Cannot acknowledge outbox without an user ID");
+    }
+
+    InstrumentedMutex::ScopedLock lock(session_m_);
+
+    poco_check_ptr(session_);
+
+    error err = ensureOutbox(UID);
+    if (err != noError) {
+        return err;
+    }
+
+    try {
+        session_->begin();
+        for (std::vector<OutboxEntry>::const_iterator it = entries.begin();
+                it != entries.end();
+                ++it) {
+            *session_ <<
+                      "delete from outbox "
+                      "where uid = :uid and guid = :guid and seq <= :seq",
+                      useRef(UID),
+                      useRef(it->GUID),
+                      useRef(it->LastSeq),
+                      now;
+            err = last_error("AcknowledgeOutbox");
+            if (err != noError) {
+                session_->rollback();
+                return err;
+            }
+        }
+        session_->commit();
+    } catch(const Poco::Exception& exc) {
+        session_->rollback();
+        return exc.displayText();
+    } catch(const std::exception& ex) {
+        session_->rollback();
+        return ex.what();
+    } catch(const std::string & ex) {
+        session_->rollback();
+        return ex;
+    }
+
+    for (std::vector<OutboxEntry>::const_iterator it = entries.begin();
+            it != entries.end();
+            ++it) {
+        outbox_.Remove(it->GUID, it->LastSeq);
+    }
+
+    return noError;
+}
+
 error Database::ensureMigrationTable() {
     std::string table_name;
     // Check if we have migrations table
@@ -3443,7 +3688,7 @@ error Database::ensureMigrationTable() {
 }
 
 error Database::initialize_tables() {
-    Poco::Mutex::ScopedLock lock(session_m_);
+    InstrumentedMutex::ScopedLock lock(session_m_);
 
     poco_check_ptr(session_);
 
@@ -3469,7 +3714,7 @@ error Database::CurrentAPIToken(
         poco_check_ptr(uid);
 
         poco_check_ptr(session_);
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
 
         *token = "";
         *uid = 0;
@@ -3493,7 +3738,7 @@ error Database::CurrentAPIToken(
 
 error Database::ClearCurrentAPIToken() {
     try {
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
 
         poco_check_ptr(session_);
 
@@ -3513,7 +3758,7 @@ error Database::SetCurrentAPIToken(
     const std::string &token,
     const Poco::UInt64 &uid) {
     try {
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
 
         if (token.empty()) {
             return error("cannot start session without API token");
@@ -3562,7 +3807,7 @@ error Database::EnsureTimelineGUIDS() {
             }
             std::string guid = GenerateGUID();
 
-            Poco::Mutex::ScopedLock lock(session_m_);
+            InstrumentedMutex::ScopedLock lock(session_m_);
 
             poco_check_ptr(session_);
 
@@ -3628,7 +3873,7 @@ error Database::EnsureDesktopID() {
 
 error Database::saveAnalyticsClientID() {
     try {
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
 
         poco_check_ptr(session_);
 
@@ -3655,7 +3900,7 @@ error Database::LoadMigrations(
 
         list->clear();
 
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
 
         Poco::Data::Statement select(*session_);
         select <<
@@ -3696,7 +3941,7 @@ error Database::Migrate(
     }
 
     try {
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
 
         poco_check_ptr(session_);
 
@@ -3749,7 +3994,7 @@ error Database::execute(
     }
 
     try {
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
 
         poco_check_ptr(session_);
 
@@ -3777,7 +4022,7 @@ error Database::String(
     }
 
     try {
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
 
         poco_check_ptr(session_);
         poco_check_ptr(result);
@@ -3806,7 +4051,7 @@ error Database::UInt(
     }
 
     try {
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
 
         poco_check_ptr(session_);
         poco_check_ptr(result);
@@ -3828,7 +4073,7 @@ error Database::UInt(
 
 error Database::saveDesktopID() {
     try {
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
 
         poco_check_ptr(session_);
 
@@ -3854,7 +4099,7 @@ error Database::LoadOnboardingState(const Poco::UInt64 &UID, OnboardingState *st
     }
 
     try {
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
         poco_check_ptr(session_);
         *session_ <<
                   "select local_id, user_id, created_at, open_timeline_tab_count, edit_timeline_tab_count, is_use_timeline_record, is_use_manual_mode, "
@@ -3897,7 +4142,7 @@ error Database::LoadOnboardingState(const Poco::UInt64 &UID, OnboardingState *st
 
 error Database::SetOnboardingState(const Poco::UInt64 &UID, OnboardingState *state) {
     try {
-        Poco::Mutex::ScopedLock lock(session_m_);
+        InstrumentedMutex::ScopedLock lock(session_m_);
 
         poco_check_ptr(session_);
 
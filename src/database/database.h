@@ -14,8 +14,10 @@
 
 #include <Poco/Data/SQLite/Connector.h>
 
+#include "instrumented_mutex.h"
 #include "model_change.h"
 #include "model/timeline_event.h"
+#include "outbox.h"
 #include "types.h"
 #include "util/logger.h"
 
@@ -232,6 +234,25 @@ class TOGGL_INTERNAL_EXPORT Database {
     error SaveUser(User *user, bool with_related_data,
                    std::vector<ModelChange> *changes);
 
+    // Models the user changed that still need to be pushed,
+    // in the order they were first changed in
+    error LoadOutbox(
+        const Poco::UInt64 &UID,
+        std::vector<OutboxEntry> *entries);
+
+    // Queues a model for pushing, SaveUser does this by itself
+    // for every time entry, project or client that needs a push
+    error QueueForPush(
+        const Poco::UInt64 &UID,
+        const std::string &model_type,
+        const std::string &GUID);
+
+    // Removes pushed models from the outbox. Edits made
+    // after the entries were loaded stay queued.
+    error AcknowledgeOutbox(
+        const Poco::UInt64 &UID,
+        const std::vector<OutboxEntry> &entries);
+
     error LoadTimeEntriesForUpload(User *user);
 
     error CurrentAPIToken(
@@ -330,6 +351,14 @@ class TOGGL_INTERNAL_EXPORT Database {
         Poco::Data::Statement *select,
         std::vector<TimeEntry *> *list);
 
+    error ensureOutbox(const Poco::UInt64 &UID);
+
+    error appendToOutbox(
+        const Poco::UInt64 &UID,
+        const std::string &model_type,
+        const std::string &GUID,
+        Poco::Int64 *seq);
+
     template <typename T>
     error saveRelatedModels(
         const Poco::UInt64 UID,
@@ -395,11 +424,16 @@ class TOGGL_INTERNAL_EXPORT Database {
 
     Logger logger { "database" };
 
-    Poco::Mutex session_m_;
+    InstrumentedMutex session_m_ { "Database::session_m_" };
     Poco::Data::Session *session_;
 
     std::string desktop_id_;
     std::string analytics_client_id_;
+
+    // Outbox of the user last saved or loaded, and the entries
+    // appended by the SaveUser transaction in progress
+    Outbox outbox_;
+    std::vector<OutboxEntry> outbox_staged_;
 };
 
 }  // namespace toggl
@@ -1421,6 +1421,32 @@ error Migrations::migrateOnboardingStates() {
     return noError;
 }
 
+error Migrations::migrateOutbox() {
+    error err = db_->Migrate(
+        "outbox",
+        "create table outbox("
+        "seq integer primary key autoincrement, "
+        "uid integer not null, "
+        "model varchar not null, "
+        "guid varchar not null, "
+        "queued_at integer not null, "
+        "constraint fk_outbox_uid foreign key (uid) "
+        "   references users(id) on delete no action on update no action"
+        "); ");
+    if (err != noError) {
+        return err;
+    }
+
+    err = db_->Migrate(
+        "outbox.uid",
+        "CREATE INDEX id_outbox_uid ON outbox (uid, seq);");
+    if (err != noError) {
+        return err;
+    }
+
+    return noError;
+}
+
 error Migrations::Run() {
     error err = noError;
 
@@ -1472,6 +1498,9 @@ error Migrations::Run() {
     if (noError == err) {
         err = migrateOnboardingStates();
     }
+    if (noError == err) {
+        err = migrateOutbox();
+    }
     return err;
 }
 
@@ -35,6 +35,7 @@ class TOGGL_INTERNAL_EXPORT Migrations {
     error migrateObmActions();
     error migrateObmExperiments();
     error migrateOnboardingStates();
+    error migrateOutbox();
 };
 
 }  // namespace toggl
@@ -0,0 +1,352 @@
+// Copyright 2020 Toggl Desktop developers.
+
+#include "executor.h"
+
+#include <algorithm>
+#include <string>
+
+#include "util/thread_name.h"
+
+#include <Poco/ErrorHandler.h>
+#include <Poco/Exception.h>
+#include <Poco/ScopedUnlock.h>
+
+namespace toggl {
+
+namespace {
+
+const Poco::Int64 kTickMicros = kExecutorTickMillis * 1000;
+const Poco::Int64 kSlots = Poco::Int64(1) << kExecutorWheelBits;
+const Poco::Int64 kSlotMask = kSlots - 1;
+
+int shift(const int level) {
+    return kExecutorWheelBits * level;
+}
+
+}  // namespace
+
+Executor::Executor(const std::size_t workers)
+    : stopped_(false)
+, seq_(0)
+, tick_(currentTick())
+, wake_tick_(-1)
+, wheel_(kExecutorWheelLevels * kSlots)
+, serial_running_(false)
+, dispatcher_runnable_(*this, &Executor::dispatch)
+, worker_runnable_(*this, &Executor::work) {
+    dispatcher_.start(dispatcher_runnable_);
+    for (std::size_t i = 0; i < std::max<std::size_t>(workers, 1); i++) {
+        Poco::Thread *worker = new Poco::Thread();
+        worker->start(worker_runnable_);
+        workers_.push_back(worker);
+    }
+}
+
+Executor::~Executor() {
+    Stop();
+}
+
+Poco::Int64 Executor::currentTick() {
+    return Poco::Timestamp().epochMicroseconds() / kTickMicros;
+}
+
+void Executor::Schedule(
+    Poco::Util::TimerTask::Ptr task,
+    const Poco::Timestamp &at) {
+    schedule(task, at, false);
+}
+
+void Executor::ScheduleBlocking(
+    Poco::Util::TimerTask::Ptr task,
+    const Poco::Timestamp &at) {
+    schedule(task, at, true);
+}
+
+void Executor::schedule(
+    Poco::Util::TimerTask::Ptr task,
+    const Poco::Timestamp &at,
+    const bool blocking) {
+
+    poco_check_ptr(task.get());
+
+    Poco::Mutex::ScopedLock lock(mutex_);
+    if (stopped_) {
+        return;
+    }
+
+    Entry entry;
+    entry.Task = task;
+    // Rounded up, so the task doesn't run before its deadline
+    entry.Tick = (at.epochMicroseconds() + kTickMicros - 1) / kTickMicros;
+    entry.Seq = seq_++;
+    entry.Blocking = blocking;
+
+    stats_.Scheduled++;
+    stats_.Pending++;
+    place(entry);
+
+    // Wake the dispatcher only if it would sleep past the new slot
+    Poco::Int64 next = nextTick();
+    if (next >= 0 && (wake_tick_ < 0 || next < wake_tick_)) {
+        dispatch_wakeup_.signal();
+    }
+}
+
+void Executor::Cancel(Poco::Util::TimerTask::Ptr task) {
+    if (task.isNull()) {
+        return;
+    }
+
+    Poco::Mutex::ScopedLock lock(mutex_);
+    task->cancel();
+    if (remove(task.get())) {
+        stats_.Cancelled++;
+        stats_.Pending--;
+    }
+}
+
+void Executor::CancelAndWait(Poco::Util::TimerTask::Ptr task) {
+    if (task.isNull()) {
+        return;
+    }
+
+    Cancel(task);
+
+    Poco::Mutex::ScopedLock lock(mutex_);
+    while (running(task.get())) {
+        task_finished_.wait(mutex_);
+    }
+}
+
+void Executor::CancelAll() {
+    Poco::Mutex::ScopedLock lock(mutex_);
+    for (std::size_t i = 0; i < wheel_.size(); i++) {
+        for (std::size_t j = 0; j < wheel_[i].size(); j++) {
+            wheel_[i][j].Task->cancel();
+        }
+        stats_.Cancelled += wheel_[i].size();
+        wheel_[i].clear();
+    }
+    for (std::size_t i = 0; i < overflow_.size(); i++) {
+        overflow_[i].Task->cancel();
+    }
+    for (std::size_t i = 0; i < ready_.size(); i++) {
+        ready_[i].Task->cancel();
+    }
+    stats_.Cancelled += overflow_.size() + ready_.size();
+    overflow_.clear();
+    ready_.clear();
+    stats_.Pending = 0;
+}
+
+void Executor::Stop() {
+    CancelAll();
+
+    {
+        Poco::Mutex::ScopedLock lock(mutex_);
+        if (stopped_) {
+            return;
+        }
+        stopped_ = true;
+        dispatch_wakeup_.broadcast();
+        work_ready_.broadcast();
+    }
+
+    dispatcher_.join();
+    for (std::size_t i = 0; i < workers_.size(); i++) {
+        workers_[i]->join();
+        delete workers_[i];
+    }
+    workers_.clear();
+}
+
+ExecutorStats Executor::Stats() {
+    Poco::Mutex::ScopedLock lock(mutex_);
+    return stats_;
+}
+
+void Executor::place(const Entry &entry) {
+    if (entry.Tick <= tick_) {
+        ready(entry);
+        return;
+    }
+
+    // The lowest level where the deadline is in the current turn
+    // of the level above, there its slot is still ahead
+    for (int level = 0; level < kExecutorWheelLevels; level++) {
+        int above = shift(level + 1);
+        if ((entry.Tick >> above) == (tick_ >> above)) {
+            Poco::Int64 slot = (entry.Tick >> shift(level)) & kSlotMask;
+            wheel_[level * kSlots + slot].push_back(entry);
+            return;
+        }
+    }
+    overflow_.push_back(entry);
+}
+
+void Executor::ready(const Entry &entry) {
+    std::vector<Entry>::iterator it = ready_.begin();
+    while (it != ready_.end()
+            && (it->Tick < entry.Tick
+                || (it->Tick == entry.Tick && it->Seq < entry.Seq))) {
+        ++it;
+    }
+    ready_.insert(it, entry);
+    // One task needs one worker, the others sleep on
+    work_ready_.signal();
+}
+
+Poco::Int64 Executor::nextTick() const {
+    // Everything on a level comes before the next slot of the level above
+    for (int level = 0; level < kExecutorWheelLevels; level++) {
+        Poco::Int64 current = (tick_ >> shift(level)) & kSlotMask;
+        Poco::Int64 turn = (tick_ >> shift(level + 1)) << shift(level + 1);
+        for (Poco::Int64 slot = current + 1; slot < kSlots; slot++) {
+            if (!wheel_[level * kSlots + slot].empty()) {
+                return turn + (slot << shift(level));
+            }
+        }
+    }
+    if (!overflow_.empty()) {
+        int top = shift(kExecutorWheelLevels);
+        return ((tick_ >> top) + 1) << top;
+    }
+    return -1;
+}
+
+void Executor::advance(const Poco::Int64 tick) {
+    while (true) {
+        Poco::Int64 next = nextTick();
+        if (next < 0 || next > tick) {
+            tick_ = std::max(tick_, tick);
+            return;
+        }
+        tick_ = next;
+
+        // Everything in the slots starting now moves down, or is due
+        std::vector<Entry> moving;
+        if (!(tick_ & ((Poco::Int64(1) << shift(kExecutorWheelLevels)) - 1))) {
+            moving.swap(overflow_);
+        }
+        for (int level = kExecutorWheelLevels - 1; level >= 0; level--) {
+            if (tick_ & ((Poco::Int64(1) << shift(level)) - 1)) {
+                continue;
+            }
+            std::vector<Entry> &slot =
+                wheel_[level * kSlots + ((tick_ >> shift(level)) & kSlotMask)];
+            if (level > 0) {
+                stats_.Cascaded += slot.size();
+            }
+            moving.insert(moving.end(), slot.begin(), slot.end());
+            slot.clear();
+        }
+        for (std::size_t i = 0; i < moving.size(); i++) {
+            place(moving[i]);
+        }
+    }
+}
+
+bool Executor::remove(Poco::Util::TimerTask *task) {
+    std::vector<std::vector<Entry> *> lists;
+    lists.push_back(&ready_);
+    lists.push_back(&overflow_);
+    for (std::size_t i = 0; i < wheel_.size(); i++) {
+        lists.push_back(&wheel_[i]);
+    }
+
+    for (std::size_t i = 0; i < lists.size(); i++) {
+        std::vector<Entry> &list = *lists[i];
+        for (std::vector<Entry>::iterator it = list.begin();
+                it != list.end(); ++it) {
+            if (it->Task.get() == task) {
+                list.erase(it);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool Executor::running(Poco::Util::TimerTask *task) const {
+    return std::find(running_.begin(), running_.end(), task)
+           != running_.end();
+}
+
+void Executor::dispatch() {
+    ScopedThreadName name("executor");
+
+    Poco::Mutex::ScopedLock lock(mutex_);
+    while (!stopped_) {
+        stats_.Wakeups++;
+
+        advance(currentTick());
+
+        wake_tick_ = nextTick();
+        if (wake_tick_ < 0) {
+            dispatch_wakeup_.wait(mutex_);
+            continue;
+        }
+
+        Poco::Int64 micros =
+            wake_tick_ * kTickMicros - Poco::Timestamp().epochMicroseconds();
+        if (micros > 0) {
+            dispatch_wakeup_.tryWait(
+                mutex_, static_cast<long>(micros / 1000 + 1));  // NOLINT
+        }
+    }
+}
+
+void Executor::work() {
+    ScopedThreadName name("worker");
+
+    Poco::Mutex::ScopedLock lock(mutex_);
+    while (!stopped_) {
+        // The earliest task this worker may run now
+        std::vector<Entry>::iterator it = ready_.begin();
+        while (it != ready_.end() && !it->Blocking && serial_running_) {
+            ++it;
+        }
+        if (it == ready_.end()) {
+            work_ready_.wait(mutex_);
+            continue;
+        }
+
+        Entry entry = *it;
+        ready_.erase(it);
+        stats_.Pending--;
+
+        if (entry.Task->isCancelled()) {
+            stats_.Cancelled++;
+            continue;
+        }
+
+        running_.push_back(entry.Task.get());
+        if (!entry.Blocking) {
+            serial_running_ = true;
+        }
+
+        {
+            Poco::ScopedUnlock<Poco::Mutex> unlock(mutex_);
+            try {
+                entry.Task->run();
+            } catch(const Poco::Exception& exc) {
+                Poco::ErrorHandler::handle(exc);
+            } catch(const std::exception& ex) {
+                Poco::ErrorHandler::handle(ex);
+            } catch(...) {
+                Poco::ErrorHandler::handle();
+            }
+        }
+
+        running_.erase(std::find(running_.begin(), running_.end(),
+                                 entry.Task.get()));
+        if (!entry.Blocking) {
+            // This worker takes the next of them, if one waits for it
+            serial_running_ = false;
+        }
+        stats_.Ran++;
+        task_finished_.broadcast();
+    }
+}
+
+}  // namespace toggl
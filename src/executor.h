@@ -0,0 +1,173 @@
+// Copyright 2020 Toggl Desktop developers.
+
+#ifndef SRC_EXECUTOR_H_
+#define SRC_EXECUTOR_H_
+
+#include <vector>
+
+#include "const.h"
+#include "types.h"
+
+#include <Poco/Condition.h>
+#include <Poco/Mutex.h>
+#include <Poco/RunnableAdapter.h>
+#include <Poco/Thread.h>
+#include <Poco/Timestamp.h>
+#include <Poco/Types.h>
+#include <Poco/Util/TimerTask.h>
+
+namespace toggl {
+
+class TOGGL_INTERNAL_EXPORT ExecutorStats {
+ public:
+    ExecutorStats()
+        : Scheduled(0)
+    , Ran(0)
+    , Cancelled(0)
+    , Wakeups(0)
+    , Cascaded(0)
+    , Pending(0) {}
+
+    Poco::UInt64 Scheduled;
+    Poco::UInt64 Ran;
+    // Tasks cancelled before they ran
+    Poco::UInt64 Cancelled;
+    // Times the dispatcher thread woke up
+    Poco::UInt64 Wakeups;
+    // Tasks moved down a level of the wheel
+    Poco::UInt64 Cascaded;
+    // Tasks waiting for their deadline or a worker right now
+    Poco::UInt64 Pending;
+};
+
+/*
+ * Runs Poco::Util::TimerTasks at their deadlines on a small pool of threads.
+ *
+ * Pending tasks sit in a hierarchical timer wheel. The lowest level has
+ * 2^kExecutorWheelBits slots of kExecutorTickMillis each, every level
+ * above has as many slots as wide as a whole turn of the one below.
+ * A task goes to the lowest level on which its slot lies ahead of now,
+ * and moves down whenever its slot comes up. Tasks beyond the top level
+ * wait in an overflow list until its turn comes.
+ *
+ * The dispatcher thread sleeps on a condition variable until the next
+ * slot holding a task, or until something is scheduled before it, so an
+ * idle executor doesn't wake at all. Due tasks go to the worker threads.
+ * A task never runs before its deadline, and runs within a tick after
+ * it when a worker is free.
+ *
+ * Tasks scheduled with Schedule() run one at a time in the order of
+ * their deadlines, like on a Poco::Util::Timer. Tasks that can block
+ * for long, on the network say, go to ScheduleBlocking() and run beside
+ * them on the other workers.
+ */
+class TOGGL_INTERNAL_EXPORT Executor {
+ public:
+    explicit Executor(const std::size_t workers = kExecutorWorkers);
+    ~Executor();
+
+    void Schedule(
+        Poco::Util::TimerTask::Ptr task,
+        const Poco::Timestamp &at);
+
+    void ScheduleBlocking(
+        Poco::Util::TimerTask::Ptr task,
+        const Poco::Timestamp &at);
+
+    // Drops the task if it hasn't run yet, a run
+    // that already started is left to finish
+    void Cancel(Poco::Util::TimerTask::Ptr task);
+
+    // Cancel(), then waits until a run that already started is over.
+    // Must not be called from the task itself.
+    void CancelAndWait(Poco::Util::TimerTask::Ptr task);
+
+    // Drops all pending tasks, running ones finish
+    void CancelAll();
+
+    // CancelAll() and waits for the threads, nothing runs anymore
+    void Stop();
+
+    ExecutorStats Stats();
+
+ private:
+    Executor(const Executor &);
+    Executor &operator=(const Executor &);
+
+    class Entry {
+     public:
+        Entry()
+            : Tick(0)
+        , Seq(0)
+        , Blocking(false) {}
+
+        Poco::Util::TimerTask::Ptr Task;
+        // Deadline in ticks since the epoch, rounded up
+        Poco::Int64 Tick;
+        // Tasks due in the same tick run in the order they came in
+        Poco::UInt64 Seq;
+        bool Blocking;
+    };
+
+    void schedule(
+        Poco::Util::TimerTask::Ptr task,
+        const Poco::Timestamp &at,
+        const bool blocking);
+
+    // The rest is called with mutex_ locked
+
+    // Puts the entry into the wheel, or hands it out when it is due
+    void place(const Entry &entry);
+    void ready(const Entry &entry);
+
+    // First tick after tick_ at which a slot holding tasks
+    // comes up, -1 when the wheel is empty
+    Poco::Int64 nextTick() const;
+
+    // Moves the wheel forward to the tick, handing out what is due
+    void advance(const Poco::Int64 tick);
+
+    bool remove(Poco::Util::TimerTask *task);
+    bool running(Poco::Util::TimerTask *task) const;
+
+    void dispatch();
+    void work();
+
+    static Poco::Int64 currentTick();
+
+    Poco::Mutex mutex_;
+    // Wakes the dispatcher for a task due before it meant to wake up
+    Poco::Condition dispatch_wakeup_;
+    // Wakes the workers for tasks to run
+    Poco::Condition work_ready_;
+    // Signalled whenever a task finished
+    Poco::Condition task_finished_;
+
+    bool stopped_;
+    Poco::UInt64 seq_;
+
+    // Where the wheel is, in ticks since the epoch
+    Poco::Int64 tick_;
+    // Tick the dispatcher sleeps until, -1 for as long as it's woken up
+    Poco::Int64 wake_tick_;
+
+    std::vector<std::vector<Entry> > wheel_;
+    std::vector<Entry> overflow_;
+
+    // Due tasks by deadline, waiting for a worker
+    std::vector<Entry> ready_;
+    std::vector<Poco::Util::TimerTask *> running_;
+    // One of the tasks that run one at a time is running
+    bool serial_running_;
+
+    ExecutorStats stats_;
+
+    Poco::RunnableAdapter<Executor> dispatcher_runnable_;
+    Poco::RunnableAdapter<Executor> worker_runnable_;
+    Poco::Thread dispatcher_;
+    std::vector<Poco::Thread *> workers_;
+};
+
+}  // namespace toggl
+
+#endif  // SRC_EXECUTOR_H_
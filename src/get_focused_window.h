@@ -11,4 +11,12 @@ int getFocusedWindowInfo(
     std::string *filename,
     bool *idle);
 
+// Blocks until the focused window or its title changes, the wait is
+// interrupted or timeout_millis have passed. Returns false right away
+// where focus changes are not reported, the caller has to poll then.
+bool waitForFocusedWindowChange(const int timeout_millis);
+
+// Makes a waitForFocusedWindowChange in progress return
+void interruptFocusedWindowWait();
+
 #endif  // SRC_GET_FOCUSED_WINDOW_H_
@@ -8,6 +8,7 @@
 
 #include <unistd.h>
 #include <fcntl.h>
+#include <poll.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <errno.h>
@@ -15,6 +16,7 @@
 #include <X11/Xlib.h>
 #include <X11/Xatom.h>
 
+#include <chrono>
 #include <cstring>
 #include <string>
 #include <typeinfo>
@@ -86,6 +88,172 @@ static char *get_property(Display *disp, Window win, Atom xa_prop_type,
     return ret;
 }
 
+namespace {
+
+// Keeps one connection to the X server for the lifetime of the app.
+// The root window reports when another window becomes active and the
+// active window reports when its title changes, so the recorder can
+// sleep on the connection instead of asking the server over and over.
+class FocusTracker {
+ public:
+    FocusTracker()
+        : display_(nullptr)
+    , net_active_window_(None)
+    , net_wm_name_(None)
+    , watched_(None) {
+        wake_[0] = wake_[1] = -1;
+        if (pipe(wake_) == 0) {
+            fcntl(wake_[0], F_SETFL, O_NONBLOCK);
+            fcntl(wake_[1], F_SETFL, O_NONBLOCK);
+        }
+    }
+
+    ~FocusTracker() {
+        if (display_) {
+            XCloseDisplay(display_);
+        }
+        if (wake_[0] >= 0) {
+            close(wake_[0]);
+            close(wake_[1]);
+        }
+    }
+
+    // The connection, opened on first use
+    Display *Connection() {
+        if (!display_) {
+            open();
+        }
+        return display_;
+    }
+
+    // Follows title changes of the active window only
+    void Watch(Window active_window) {
+        if (!display_ || active_window == watched_) {
+            return;
+        }
+        if (watched_ != None) {
+            XSelectInput(display_, watched_, NoEventMask);
+        }
+        if (active_window != None) {
+            XSelectInput(display_, active_window, PropertyChangeMask);
+        }
+        watched_ = active_window;
+    }
+
+    bool Wait(const int timeout_millis) {
+        if (!Connection()) {
+            return false;
+        }
+
+        const std::chrono::steady_clock::time_point deadline =
+            std::chrono::steady_clock::now()
+            + std::chrono::milliseconds(timeout_millis);
+
+        while (!focusChanged()) {
+            const int left = static_cast<int>(
+                std::chrono::duration_cast<std::chrono::milliseconds>(
+                    deadline - std::chrono::steady_clock::now()).count());
+            if (left <= 0) {
+                break;
+            }
+
+            XFlush(display_);
+
+            struct pollfd fds[2];
+            fds[0].fd = ConnectionNumber(display_);
+            fds[0].events = POLLIN;
+            fds[0].revents = 0;
+            fds[1].fd = wake_[0];
+            fds[1].events = POLLIN;
+            fds[1].revents = 0;
+            const int ready = poll(fds, wake_[0] >= 0 ? 2 : 1, left);
+            if (ready < 0 && errno != EINTR) {
+                break;
+            }
+            if (ready > 0 && (fds[1].revents & POLLIN)) {
+                char buf[64];
+                while (read(wake_[0], buf, sizeof(buf)) > 0) {}
+                break;
+            }
+        }
+        return true;
+    }
+
+    void Interrupt() {
+        if (wake_[1] >= 0) {
+            const char byte = 0;
+            HANDLE_EINTR(write(wake_[1], &byte, 1));
+        }
+    }
+
+ private:
+    void open() {
+        display_ = XOpenDisplay(nullptr);
+        if (!display_) {
+            return;
+        }
+        tracked_display_ = display_;
+        previous_error_handler_ = XSetErrorHandler(onError);
+
+        net_active_window_ = XInternAtom(display_, kNetActiveWindow, False);
+        net_wm_name_ = XInternAtom(display_, "_NET_WM_NAME", False);
+        XSelectInput(display_, DefaultRootWindow(display_), PropertyChangeMask);
+    }
+
+    // Handles the events that have arrived, true if any of them
+    // means the focused window or its title is different now
+    bool focusChanged() {
+        bool changed = false;
+        while (XPending(display_)) {
+            XEvent event;
+            XNextEvent(display_, &event);
+            if (event.type != PropertyNotify) {
+                continue;
+            }
+            const XPropertyEvent &property = event.xproperty;
+            if (property.window == DefaultRootWindow(display_)) {
+                changed = changed || property.atom == net_active_window_;
+            } else if (property.window == watched_) {
+                changed = changed
+                          || property.atom == net_wm_name_
+                          || property.atom == XA_WM_NAME;
+            }
+        }
+        return changed;
+    }
+
+    // The active window can be gone by the time its properties are
+    // read, which is not worth aborting the app for as Xlib would
+    static int onError(Display *display, XErrorEvent *event) {
+        if (display == tracked_display_) {
+            return 0;
+        }
+        if (previous_error_handler_) {
+            return previous_error_handler_(display, event);
+        }
+        return 0;
+    }
+
+    static Display *tracked_display_;
+    static XErrorHandler previous_error_handler_;
+
+    Display *display_;
+    Atom net_active_window_;
+    Atom net_wm_name_;
+    Window watched_;
+    int wake_[2];
+};
+
+Display *FocusTracker::tracked_display_ = nullptr;
+XErrorHandler FocusTracker::previous_error_handler_ = nullptr;
+
+FocusTracker &tracker() {
+    static FocusTracker instance;
+    return instance;
+}
+
+}  // namespace
+
 int getFocusedWindowInfo(
     std::string *title,
     std::string *filename,
@@ -94,7 +262,7 @@ int getFocusedWindowInfo(
     *filename = "";
     *idle = false;
 
-    Display *display = XOpenDisplay(nullptr);
+    Display *display = tracker().Connection();
     if (!display) {
         return 1;
     }
@@ -112,6 +280,7 @@ int getFocusedWindowInfo(
         active_window = *(reinterpret_cast<Window *>(prop));
     }
     free(prop);
+    tracker().Watch(active_window);
 
     // get title of active window
     if (active_window) {
@@ -165,8 +334,13 @@ int getFocusedWindowInfo(
         free(pid);
     }
 
-    // Must close display, else max window client count is reached quickly
-    XCloseDisplay(display);
-
     return 0;
 }
+
+bool waitForFocusedWindowChange(const int timeout_millis) {
+    return tracker().Wait(timeout_millis);
+}
+
+void interruptFocusedWindowWait() {
+    tracker().Interrupt();
+}
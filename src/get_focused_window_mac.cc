@@ -89,3 +89,9 @@ int getFocusedWindowInfo(
 
     return 0;
 }
+
+bool waitForFocusedWindowChange(const int) {
+    return false;
+}
+
+void interruptFocusedWindowWait() {}
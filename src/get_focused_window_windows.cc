@@ -81,3 +81,9 @@ int getFocusedWindowInfo(
 
     return 0;
 }
+
+bool waitForFocusedWindowChange(const int) {
+    return false;
+}
+
+void interruptFocusedWindowWait() {}
@@ -3,7 +3,9 @@
 
 #include "gui.h"
 
+#include <algorithm>
 #include <cstdlib>
+#include <map>
 #include <sstream>
 
 #include "model/client.h"
@@ -15,6 +17,7 @@
 #include "model/task.h"
 #include "model/time_entry.h"
 #include "model/user.h"
+#include "view_arena.h"
 #include "model/workspace.h"
 
 #include <Poco/Stopwatch.h>
@@ -23,8 +26,45 @@ namespace toggl {
 
 namespace view {
 
-bool TimeEntry::operator == (const TimeEntry&) const {
-    return false;
+bool TimeEntry::operator == (const TimeEntry& other) const {
+    return ID == other.ID
+           && DurationInSeconds == other.DurationInSeconds
+           && Description == other.Description
+           && ProjectAndTaskLabel == other.ProjectAndTaskLabel
+           && TaskLabel == other.TaskLabel
+           && ProjectLabel == other.ProjectLabel
+           && ClientLabel == other.ClientLabel
+           && WID == other.WID
+           && PID == other.PID
+           && TID == other.TID
+           && Duration == other.Duration
+           && Color == other.Color
+           && GUID == other.GUID
+           && Billable == other.Billable
+           && Tags == other.Tags
+           && Started == other.Started
+           && Ended == other.Ended
+           && StartTimeString == other.StartTimeString
+           && EndTimeString == other.EndTimeString
+           && UpdatedAt == other.UpdatedAt
+           && DurOnly == other.DurOnly
+           && DateHeader == other.DateHeader
+           && DateDuration == other.DateDuration
+           && IsHeader == other.IsHeader
+           && CanAddProjects == other.CanAddProjects
+           && CanSeeBillable == other.CanSeeBillable
+           && DefaultWID == other.DefaultWID
+           && WorkspaceName == other.WorkspaceName
+           && Unsynced == other.Unsynced
+           && Error == other.Error
+           && Locked == other.Locked
+           && Group == other.Group
+           && GroupOpen == other.GroupOpen
+           && GroupName == other.GroupName
+           && GroupDuration == other.GroupDuration
+           && GroupItemCount == other.GroupItemCount
+           && RoundedStart == other.RoundedStart
+           && RoundedEnd == other.RoundedEnd;
 }
 
 void TimeEntry::Fill(toggl::TimeEntry * const model) {
@@ -84,6 +124,126 @@ bool TimelineEvent::operator == (const TimelineEvent&) const {
     return false;
 }
 
+static std::string rowKey(const TimeEntry &row) {
+    if (row.Group) {
+        return row.GroupName;
+    }
+    return row.GUID;
+}
+
+static TimeEntryListChange rowChange(
+    const uint8_t type,
+    const std::vector<TimeEntry> &list,
+    const std::size_t index) {
+    TimeEntryListChange change;
+    change.Type = type;
+    change.Key = rowKey(list[index]);
+    change.Index = index;
+    if (kTimeEntryListChangeDelete != type) {
+        change.Row = &list[index];
+    }
+    return change;
+}
+
+void DiffTimeEntryList(
+    const std::vector<TimeEntry> &previous,
+    const std::vector<TimeEntry> &current,
+    std::vector<TimeEntryListChange> *changes) {
+
+    poco_check_ptr(changes);
+
+    std::map<std::string, std::size_t> previous_index;
+    for (std::size_t i = 0; i < previous.size(); i++) {
+        previous_index[rowKey(previous[i])] = i;
+    }
+    std::map<std::string, std::size_t> current_index;
+    for (std::size_t i = 0; i < current.size(); i++) {
+        current_index[rowKey(current[i])] = i;
+    }
+
+    // Rows can only be told apart by unique keys,
+    // otherwise the whole list is replaced
+    if (previous_index.size() != previous.size()
+            || current_index.size() != current.size()) {
+        for (std::size_t i = previous.size(); i > 0; i--) {
+            changes->push_back(
+                rowChange(kTimeEntryListChangeDelete, previous, i - 1));
+        }
+        for (std::size_t i = 0; i < current.size(); i++) {
+            changes->push_back(
+                rowChange(kTimeEntryListChangeInsert, current, i));
+        }
+        return;
+    }
+
+    for (std::size_t i = previous.size(); i > 0; i--) {
+        if (!current_index.count(rowKey(previous[i - 1]))) {
+            changes->push_back(
+                rowChange(kTimeEntryListChangeDelete, previous, i - 1));
+        }
+    }
+
+    // Where each row was before, if it was there at all
+    std::vector<std::size_t> was(current.size(), previous.size());
+    for (std::size_t i = 0; i < current.size(); i++) {
+        std::map<std::string, std::size_t>::const_iterator it =
+            previous_index.find(rowKey(current[i]));
+        if (it != previous_index.end()) {
+            was[i] = it->second;
+        }
+    }
+
+    // The longest run of kept rows still in their previous order stays,
+    // the rest is moved. tails[k] ends the best run of length k + 1.
+    std::vector<std::size_t> tails;
+    std::vector<std::size_t> before(current.size(), current.size());
+    for (std::size_t i = 0; i < current.size(); i++) {
+        if (was[i] == previous.size()) {
+            continue;
+        }
+        std::size_t lo(0), hi(tails.size());
+        while (lo < hi) {
+            std::size_t mid = (lo + hi) / 2;
+            if (was[tails[mid]] < was[i]) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        if (lo) {
+            before[i] = tails[lo - 1];
+        }
+        if (lo == tails.size()) {
+            tails.push_back(i);
+        } else {
+            tails[lo] = i;
+        }
+    }
+    std::vector<bool> stays(current.size(), false);
+    if (!tails.empty()) {
+        for (std::size_t i = tails.back(); i != current.size(); i = before[i]) {
+            stays[i] = true;
+        }
+    }
+
+    for (std::size_t i = 0; i < current.size(); i++) {
+        if (was[i] == previous.size()) {
+            changes->push_back(
+                rowChange(kTimeEntryListChangeInsert, current, i));
+        } else if (!stays[i]) {
+            changes->push_back(
+                rowChange(kTimeEntryListChangeMove, current, i));
+        }
+    }
+
+    for (std::size_t i = 0; i < current.size(); i++) {
+        if (stays[i] && !(previous[was[i]] == current[i])) {
+            changes->push_back(
+                rowChange(kTimeEntryListChangeUpdate, current, i));
+        }
+    }
+}
+
 }  // namespace view
 
 void GUI::DisplayApp() {
@@ -111,9 +271,9 @@ void GUI::DisplayCountries(
     if (!on_display_countries_) {
         return;
     }
-    TogglCountryView *first = country_list_init(items);
+    ViewArena arena;
+    TogglCountryView *first = country_list_init(items, &arena);
     on_display_countries_(first);
-    country_list_clear(first);
 }
 
 void GUI::DisplaySyncState(const Poco::Int64 state) {
@@ -218,7 +378,9 @@ error GUI::findMissingCallbacks() {
     if (!on_display_reminder_) {
         return error("!on_display_reminder_");
     }
-    if (!on_display_time_entry_list_) {
+    if (!on_display_time_entry_list_
+            && !on_display_time_entry_list_changes_
+            && !on_display_time_entry_list_window_) {
         return error("!on_display_time_entry_list_");
     }
     if (!on_display_time_entry_autocomplete_) {
@@ -364,9 +526,9 @@ void GUI::DisplayTimeEntryAutocomplete(
     std::vector<toggl::view::Autocomplete> *items) {
     logger.debug("DisplayTimeEntryAutocomplete");
 
-    TogglAutocompleteView *first = autocomplete_list_init(items);
+    ViewArena arena;
+    TogglAutocompleteView *first = autocomplete_list_init(items, &arena);
     on_display_time_entry_autocomplete_(first);
-    autocomplete_list_clear(first);
 }
 
 void GUI::DisplayHelpArticles(
@@ -377,27 +539,27 @@ void GUI::DisplayHelpArticles(
         return;
     }
 
-    TogglHelpArticleView *first = help_article_list_init(articles);
+    ViewArena arena;
+    TogglHelpArticleView *first = help_article_list_init(articles, &arena);
     on_display_help_articles_(first);
-    help_article_list_clear(first);
 }
 
 void GUI::DisplayMinitimerAutocomplete(
     std::vector<toggl::view::Autocomplete> *items) {
     logger.debug("DisplayMinitimerAutocomplete");
 
-    TogglAutocompleteView *first = autocomplete_list_init(items);
+    ViewArena arena;
+    TogglAutocompleteView *first = autocomplete_list_init(items, &arena);
     on_display_mini_timer_autocomplete_(first);
-    autocomplete_list_clear(first);
 }
 
 void GUI::DisplayProjectAutocomplete(
     std::vector<toggl::view::Autocomplete> *items) {
     logger.debug("DisplayProjectAutocomplete");
 
-    TogglAutocompleteView *first = autocomplete_list_init(items);
+    ViewArena arena;
+    TogglAutocompleteView *first = autocomplete_list_init(items, &arena);
     on_display_project_autocomplete_(first);
-    autocomplete_list_clear(first);
 }
 
 void GUI::DisplayTimeEntryList(const bool open,
@@ -425,38 +587,124 @@ void GUI::DisplayTimeEntryList(const bool open,
         logger.debug("DisplayTimeEntryList open=", open, ", has items=", renderList.size());
     }
 
+    // Rows in the order they're shown, each date starting with a header
+    std::vector<view::TimeEntry> rows(renderList.rbegin(), renderList.rend());
+    for (std::size_t i = 0; i < rows.size(); i++) {
+        rows[i].IsHeader = !i || rows[i].DateHeader != rows[i - 1].DateHeader;
+    }
+
     // Render
-    TogglTimeEntryView *first = nullptr;
-    for (unsigned int i = 0; i < renderList.size(); i++) {
-        view::TimeEntry te = renderList.at(i);
-        TogglTimeEntryView *item = time_entry_view_item_init(te);
-        item->Next = first;
-        if (first && compare_string(item->DateHeader, first->DateHeader) != 0) {
-            first->IsHeader = true;
+    if (on_display_time_entry_list_window_) {
+        {
+            Poco::Mutex::ScopedLock lock(time_entry_list_m_);
+            lastTimeEntryList.swap(rows);
+            timeEntryListHeaders.clear();
+            for (std::size_t i = 0; i < lastTimeEntryList.size(); i++) {
+                if (lastTimeEntryList[i].IsHeader) {
+                    timeEntryListHeaders.push_back(i);
+                }
+            }
+            timeEntryListShowLoadMore = show_load_more_button;
         }
-        first = item;
+        displayTimeEntryListWindow(open);
+    } else if (on_display_time_entry_list_changes_) {
+        displayTimeEntryListChanges(open, rows, show_load_more_button);
+    } else {
+        ViewArena arena;
+        TogglTimeEntryView *first =
+            time_entry_view_list_init(rows, 0, rows.size(), &arena);
+
+        on_display_time_entry_list_(open, first, show_load_more_button);
     }
 
-    if (first) {
-        first->IsHeader = true;
+    stopwatch.stop();
+    logger.debug("DisplayTimeEntryList done in ", stopwatch.elapsed() / 1000, " ms");
+}
+
+void GUI::displayTimeEntryListChanges(
+    const bool open,
+    const std::vector<view::TimeEntry> &rows,
+    const bool show_load_more_button) {
+
+    std::vector<view::TimeEntryListChange> changes;
+    {
+        Poco::Mutex::ScopedLock lock(time_entry_list_m_);
+        view::DiffTimeEntryList(lastTimeEntryList, rows, &changes);
+        lastTimeEntryList = rows;
     }
 
-    on_display_time_entry_list_(open, first, show_load_more_button);
+    ViewArena arena;
+    TogglTimeEntryListChangeView *first =
+        time_entry_list_change_view_list_init(changes, &arena);
 
-    time_entry_view_list_clear(first);
+    logger.debug("DisplayTimeEntryListChanges changes=", changes.size());
 
-    stopwatch.stop();
-    logger.debug("DisplayTimeEntryList done in ", stopwatch.elapsed() / 1000, " ms");
+    // Lists are only rendered by the render thread, so the
+    // changes reach the UI in the order they were made in
+    on_display_time_entry_list_changes_(open, first, show_load_more_button);
+}
+
+bool GUI::SetTimeEntryListWindow(
+    const uint64_t first_row,
+    const uint64_t count) {
+    Poco::Mutex::ScopedLock lock(time_entry_list_m_);
+    timeEntryListWindowFirst = first_row;
+    timeEntryListWindowCount = count;
+    return on_display_time_entry_list_window_ && !lastTimeEntryList.empty();
+}
+
+void GUI::DisplayTimeEntryListWindow() {
+    if (on_display_time_entry_list_window_) {
+        displayTimeEntryListWindow(false);
+    }
+}
+
+void GUI::displayTimeEntryListWindow(const bool open) {
+    ViewArena arena;
+    TogglTimeEntryView *first(nullptr);
+    uint64_t begin(0);
+    uint64_t total(0);
+    std::vector<uint64_t> headers;
+    bool show_load_more(false);
+    {
+        Poco::Mutex::ScopedLock lock(time_entry_list_m_);
+        total = lastTimeEntryList.size();
+        begin = std::min(timeEntryListWindowFirst, total);
+        uint64_t end =
+            begin + std::min(timeEntryListWindowCount, total - begin);
+
+        // Some more on both sides, so scrolling a bit doesn't show empty rows
+        begin = begin > kTimeEntryListWindowMargin
+                ? begin - kTimeEntryListWindowMargin : 0;
+        end = std::min<uint64_t>(end + kTimeEntryListWindowMargin, total);
+
+        first = time_entry_view_list_init(lastTimeEntryList, begin, end, &arena);
+        headers = timeEntryListHeaders;
+        show_load_more = timeEntryListShowLoadMore;
+
+        logger.debug("DisplayTimeEntryListWindow rows=", begin, "-", end,
+                     " of ", total);
+    }
+
+    on_display_time_entry_list_window_(
+        open,
+        first,
+        begin,
+        total,
+        headers.empty() ? nullptr : &headers[0],
+        headers.size(),
+        show_load_more);
 }
 
 void GUI::DisplayTimeline(const bool open,
-    const std::vector<const TimelineEvent *> list,
+    const std::vector<const TimelineEvent *> &list,
     const std::vector<view::TimeEntry> &entries_list) {
 
     if (!on_display_timeline_) {
         return;
     }
 
+    ViewArena arena;
     TogglTimelineChunkView *first_chunk = nullptr;
     Poco::LocalDateTime datetime(
         TimelineDateAt().year(),
@@ -469,19 +717,28 @@ void GUI::DisplayTimeline(const bool open,
     time_t start_day = datetime.timestamp().epochTime() - tzd;
     time_t end_day = start_day + 86400; // one day
     for (unsigned int i = 0; i < entries_list.size(); i++) {
-        view::TimeEntry te = entries_list.at(i);
-        TogglTimeEntryView *item = time_entry_view_item_init(te);
-        time_t start_time_entry = Poco::Timestamp::fromEpochTime(item->Started).epochTime();
+        const view::TimeEntry &te = entries_list.at(i);
+        time_t start_time_entry = static_cast<time_t>(te.Started);
 
         if (start_time_entry >= start_day && start_time_entry <= end_day) {
+            TogglTimeEntryView *item = time_entry_view_item_init(te, &arena);
             item->Next = first_entry;
             first_entry = item;
-        } else {
-            // Release
-            time_entry_view_item_clear(item);
         }
     }
 
+    // Events of the day by the start of the chunk they fall into,
+    // so each chunk only looks at its own events
+    std::map<time_t, std::vector<const TimelineEvent *> > chunk_events;
+    for (std::vector<const TimelineEvent*>::const_iterator it = list.begin();
+            it != list.end(); it++) {
+        const TimelineEvent *event = *it;
+        time_t chunk_start_time =
+            (event->Start() / kTimelineChunkSeconds)
+            * kTimelineChunkSeconds;
+        chunk_events[chunk_start_time].push_back(event);
+    }
+
     // Get activity
     while (datetime.year() == TimelineDateAt().year()
             && datetime.month() == TimelineDateAt().month()
@@ -491,80 +748,20 @@ void GUI::DisplayTimeline(const bool open,
 
         // Create new chunk
         TogglTimelineChunkView *chunk_view =
-            timeline_chunk_view_init(epoch_time);
+            timeline_chunk_view_init(epoch_time, &arena);
 
         // Attach matching events to chunk
         TogglTimelineEventView *first_event = nullptr;
-        TogglTimelineEventView *ev = nullptr;
-        for (std::vector<const TimelineEvent*>::const_iterator it = list.begin();
-                it != list.end(); it++) {
-            const TimelineEvent *event = *it;
-
-            // Calculate the start time of the chunk
-            // that fits this timeline event
-            time_t chunk_start_time =
-                (event->Start() / kTimelineChunkSeconds)
-                * kTimelineChunkSeconds;
-
-            if (epoch_time != chunk_start_time) {
-                // Skip event if does not match chunk
-                continue;
-            }
-
-            // Grouping the items to parent-event and sub-events
-
-            bool app_present = false;
-            bool item_present = false;
-            TogglTimelineEventView *event_app = first_event;
-            while (event_app) {
-                if (compare_string(event_app->Filename, to_char_t(event->Filename())) == 0) {
-                    timeline_event_view_update_duration(event_app, event_app->Duration + event->Duration());
-                    app_present = true;
-                    item_present = false;
-                    ev = reinterpret_cast<TogglTimelineEventView *>(event_app->Event);
-                    while (ev) {
-                        if (compare_string(ev->Title, to_char_t(event->Title())) == 0) {
-                            timeline_event_view_update_duration(ev, ev->Duration + event->Duration());
-                            item_present = true;
-                        }
-                        ev = reinterpret_cast<TogglTimelineEventView *>(ev->Next);
-                    }
-
-                    if (!item_present) {
-                        TogglTimelineEventView *event_view = timeline_event_view_init(event);
-                        event_view->Next = event_app->Event;
-                        event_app->Event = event_view;
-                    }
-                }
-                event_app = reinterpret_cast<TogglTimelineEventView *>(event_app->Next);
-            }
-
-            if (!app_present) {
-                TogglTimelineEventView *app_event_view = timeline_event_view_init(event);
-                if (event->Duration() > 0) {
-                    app_event_view->Header = true;
-                    if (app_event_view->Title) {
-                        free(app_event_view->Title);
-                        app_event_view->Title = nullptr;
-                    }
-                    app_event_view->Title = copy_string("");
-
-                    TogglTimelineEventView *event_view = timeline_event_view_init(event);
-                    app_event_view->Event = event_view;
-                    app_event_view->Next = first_event;
-                    first_event = app_event_view;
-                }
-            }
+        std::map<time_t, std::vector<const TimelineEvent *> >::const_iterator
+        events = chunk_events.find(epoch_time);
+        if (events != chunk_events.end()) {
+            first_event = timelineChunkEvents(events->second, &arena);
         }
 
         chunk_view->Ended = epoch_time_end;
 
         // Update endtime
-        if (chunk_view->EndTimeString) {
-            free(chunk_view->EndTimeString);
-            chunk_view->EndTimeString = nullptr;
-        }
-        chunk_view->EndTimeString = copy_string(toggl::Formatter::FormatTimeForTimeEntryEditor(chunk_view->Ended));
+        chunk_view->EndTimeString = arena.String(toggl::Formatter::FormatTimeForTimeEntryEditor(chunk_view->Ended));
 
         // Sort the list by duration descending
         if (first_event != NULL) {
@@ -577,11 +774,73 @@ void GUI::DisplayTimeline(const bool open,
     }
 
     std::string formatted_date = Formatter::FormatDateHeader(TimelineDateAt());
-    char_t *date = copy_string(formatted_date.c_str());
+    char_t *date = arena.String(formatted_date);
     on_display_timeline_(open, date, first_chunk, first_entry, start_day, end_day);
-    free(date);
-    time_entry_view_list_clear(first_entry);
-    timeline_chunk_view_list_clear(first_chunk);
+}
+
+TogglTimelineEventView *GUI::timelineChunkEvents(
+    const std::vector<const TimelineEvent *> &events,
+    ViewArena *arena) {
+    // Grouping the items to parent-event and sub-events,
+    // by app and by window title
+    TogglTimelineEventView *first_event = nullptr;
+    std::map<std::string, TogglTimelineEventView *> apps;
+    std::map<std::pair<std::string, std::string>,
+        TogglTimelineEventView *> titles;
+    for (std::vector<const TimelineEvent *>::const_iterator it = events.begin();
+            it != events.end(); it++) {
+        const TimelineEvent *event = *it;
+
+        std::map<std::string, TogglTimelineEventView *>::iterator app =
+            apps.find(event->Filename());
+        if (app != apps.end()) {
+            TogglTimelineEventView *event_app = app->second;
+            event_app->Duration += event->Duration();
+
+            std::pair<std::string, std::string> key(
+                event->Filename(), event->Title());
+            std::map<std::pair<std::string, std::string>,
+                TogglTimelineEventView *>::iterator title = titles.find(key);
+            if (title != titles.end()) {
+                title->second->Duration += event->Duration();
+            } else {
+                TogglTimelineEventView *event_view =
+                    timeline_event_view_init(event, arena);
+                event_view->Next = event_app->Event;
+                event_app->Event = event_view;
+                titles[key] = event_view;
+            }
+        } else if (event->Duration() > 0) {
+            TogglTimelineEventView *app_event_view =
+                timeline_event_view_init(event, arena);
+            app_event_view->Header = true;
+            app_event_view->Title = arena->String("");
+
+            TogglTimelineEventView *event_view =
+                timeline_event_view_init(event, arena);
+            app_event_view->Event = event_view;
+            app_event_view->Next = first_event;
+            first_event = app_event_view;
+
+            apps[event->Filename()] = app_event_view;
+            titles[std::make_pair(event->Filename(), event->Title())] =
+                event_view;
+        }
+    }
+
+    // Durations are formatted once they're all added up
+    for (TogglTimelineEventView *event_app = first_event; event_app;
+            event_app = reinterpret_cast<TogglTimelineEventView *>(event_app->Next)) {
+        timeline_event_view_update_duration(
+            event_app, event_app->Duration, arena);
+        for (TogglTimelineEventView *ev =
+                    reinterpret_cast<TogglTimelineEventView *>(event_app->Event);
+                ev; ev = reinterpret_cast<TogglTimelineEventView *>(ev->Next)) {
+            timeline_event_view_update_duration(ev, ev->Duration, arena);
+        }
+    }
+
+    return first_event;
 }
 
 TogglTimelineEventView* GUI::SortList(TogglTimelineEventView *head) {
@@ -635,9 +894,9 @@ TogglTimelineEventView* GUI::SortList(TogglTimelineEventView *head) {
 void GUI::DisplayTags(const std::vector<view::Generic> list) {
     logger.debug("DisplayTags");
 
-    TogglGenericView *first = generic_to_view_item_list(list);
+    ViewArena arena;
+    TogglGenericView *first = generic_to_view_item_list(list, &arena);
     on_display_tags_(first);
-    view_list_clear(first);
 }
 
 void GUI::DisplayAutotrackerRules(
@@ -649,12 +908,13 @@ void GUI::DisplayAutotrackerRules(
     }
 
     // FIXME: dont re-render if cached items (models or view) are the same
+    ViewArena arena;
     TogglAutotrackerRuleView *first = nullptr;
     for (std::vector<view::AutotrackerRule>::const_iterator
             it = autotracker_rules.begin();
             it != autotracker_rules.end();
             ++it) {
-        TogglAutotrackerRuleView *item = autotracker_rule_to_view_item(*it);
+        TogglAutotrackerRuleView *item = autotracker_rule_to_view_item(*it, &arena);
         item->Next = first;
         first = item;
     }
@@ -662,33 +922,28 @@ void GUI::DisplayAutotrackerRules(
     uint64_t title_count = titles.size();
     char_t **title_list = new char_t *[title_count];
     for (uint64_t i = 0; i < title_count; i++) {
-        title_list[i] = copy_string(titles[i]);
+        title_list[i] = arena.String(titles[i]);
     }
     on_display_autotracker_rules_(first, title_count, title_list);
-    for (uint64_t i = 0; i < title_count; i++) {
-        free(title_list[i]);
-    }
     delete[] title_list;
-
-    autotracker_view_list_clear(first);
 }
 
 void GUI::DisplayClientSelect(
     const std::vector<view::Generic> &list) {
     logger.debug("DisplayClientSelect");
 
-    TogglGenericView *first = generic_to_view_item_list(list);
+    ViewArena arena;
+    TogglGenericView *first = generic_to_view_item_list(list, &arena);
     on_display_client_select_(first);
-    view_list_clear(first);
 }
 
 void GUI::DisplayWorkspaceSelect(
     const std::vector<view::Generic> &list) {
     logger.debug("DisplayWorkspaceSelect");
 
-    TogglGenericView *first = generic_to_view_item_list(list);
+    ViewArena arena;
+    TogglGenericView *first = generic_to_view_item_list(list, &arena);
     on_display_workspace_select_(first);
-    view_list_clear(first);
 }
 
 void GUI::DisplayTimeEntryEditor(const bool open,
@@ -698,13 +953,11 @@ void GUI::DisplayTimeEntryEditor(const bool open,
     logger.debug(
         "DisplayTimeEntryEditor focused_field_name=" + focused_field_name);
 
-    TogglTimeEntryView *view = time_entry_view_item_init(te);
+    ViewArena arena;
+    TogglTimeEntryView *view = time_entry_view_item_init(te, &arena);
 
-    char_t *field_s = copy_string(focused_field_name);
+    char_t *field_s = arena.String(focused_field_name);
     on_display_time_entry_editor_(open, view, field_s);
-    free(field_s);
-
-    time_entry_view_list_clear(view);
 }
 
 void GUI::DisplayURL(const std::string &URL) {
@@ -767,23 +1020,23 @@ void GUI::DisplaySettings(const bool open,
                           const Proxy &proxy) {
     logger.debug("DisplaySettings");
 
+    ViewArena arena;
     TogglSettingsView *view = settings_view_item_init(
         record_timeline,
         settings,
         use_proxy,
-        proxy);
+        proxy,
+        &arena);
 
     on_display_settings_(open, view);
-
-    settings_view_item_clear(view);
 }
 
 void GUI::DisplayTimerState(
     const view::TimeEntry &te) {
 
-    TogglTimeEntryView *view = time_entry_view_item_init(te);
+    ViewArena arena;
+    TogglTimeEntryView *view = time_entry_view_item_init(te, &arena);
     on_display_timer_state_(view);
-    time_entry_view_list_clear(view);
 
     logger.debug("DisplayTimerState");
 }
@@ -793,6 +1046,25 @@ void GUI::DisplayEmptyTimerState() {
     logger.debug("DisplayEmptyTimerState");
 }
 
+void GUI::DisplayRunningTimer(
+    const std::string &GUID,
+    const Poco::Int64 started,
+    const Poco::Int64 date_duration) {
+    if (!on_display_running_timer_) {
+        return;
+    }
+
+    ViewArena arena;
+    char_t *guid_s = arena.String(GUID);
+    char_t *duration_s = arena.String(
+        Formatter::FormatDurationForDateHeader(date_duration));
+    on_display_running_timer_(
+        guid_s,
+        static_cast<uint64_t>(started),
+        date_duration,
+        duration_s);
+}
+
 void GUI::DisplayIdleNotification(const std::string &guid,
                                   const std::string &since,
                                   const std::string &duration,
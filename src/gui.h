@@ -7,6 +7,7 @@
 #include <string>
 #include <vector>
 
+#include "const.h"
 #include "help_article.h"
 #include "https_client.h"
 #include "proxy.h"
@@ -18,6 +19,7 @@
 #include "onboarding_service.h"
 
 #include <Poco/LocalDateTime.h>
+#include <Poco/Mutex.h>
 
 namespace toggl {
 
@@ -49,6 +51,7 @@ class TOGGL_INTERNAL_EXPORT TimeEntry {
     , DurOnly(false)
     , DateHeader("")
     , DateDuration("")
+    , IsHeader(false)
     , CanAddProjects(false)
     , CanSeeBillable(false)
     , DefaultWID(0)
@@ -88,6 +91,7 @@ class TOGGL_INTERNAL_EXPORT TimeEntry {
     // In case it's a header
     std::string DateHeader;
     std::string DateDuration;
+    bool IsHeader;
     // Additional fields; only when in time entry editor
     bool CanAddProjects;
     bool CanSeeBillable;
@@ -115,6 +119,33 @@ class TOGGL_INTERNAL_EXPORT TimeEntry {
     bool operator == (const TimeEntry& other) const;
 };
 
+// A row of the time entry list that changed, see
+// TogglDisplayTimeEntryListChanges
+class TOGGL_INTERNAL_EXPORT TimeEntryListChange {
+ public:
+    TimeEntryListChange()
+        : Type(kTimeEntryListChangeInsert)
+    , Key("")
+    , Index(0)
+    , Row(nullptr) {}
+
+    uint8_t Type;
+    // GUID, or the group name of a group header
+    std::string Key;
+    // Position in the current list, in the previous one for deletes
+    std::size_t Index;
+    // Row of the current list, nullptr for deletes
+    const TimeEntry *Row;
+};
+
+// Changes turning the previous list into the current one, in the order
+// they can be applied. Rows that stay in the same order relative to
+// each other are not moved.
+TOGGL_INTERNAL_EXPORT void DiffTimeEntryList(
+    const std::vector<TimeEntry> &previous,
+    const std::vector<TimeEntry> &current,
+    std::vector<TimeEntryListChange> *changes);
+
 class TOGGL_INTERNAL_EXPORT Autocomplete {
  public:
     Autocomplete()
@@ -366,6 +397,8 @@ class TOGGL_INTERNAL_EXPORT GUI : public SyncStateMonitor {
     , on_display_pomodoro_(nullptr)
     , on_display_pomodoro_break_(nullptr)
     , on_display_time_entry_list_(nullptr)
+    , on_display_time_entry_list_changes_(nullptr)
+    , on_display_time_entry_list_window_(nullptr)
     , on_display_time_entry_autocomplete_(nullptr)
     , on_display_project_autocomplete_(nullptr)
     , on_display_workspace_select_(nullptr)
@@ -374,6 +407,7 @@ class TOGGL_INTERNAL_EXPORT GUI : public SyncStateMonitor {
     , on_display_time_entry_editor_(nullptr)
     , on_display_settings_(nullptr)
     , on_display_timer_state_(nullptr)
+    , on_display_running_timer_(nullptr)
     , on_display_idle_notification_(nullptr)
     , on_display_mini_timer_autocomplete_(nullptr)
     , on_display_sync_state_(nullptr)
@@ -397,6 +431,9 @@ class TOGGL_INTERNAL_EXPORT GUI : public SyncStateMonitor {
     , lastOnlineState(-1)
     , lastErr(noError)
     , isFirstLaunch(true)
+    , timeEntryListShowLoadMore(false)
+    , timeEntryListWindowFirst(0)
+    , timeEntryListWindowCount(kTimeEntryListWindowRows)
     , time_entry_editor_guid_("")
     , timeline_date_at_(Poco::LocalDateTime()) {}
 
@@ -444,7 +481,7 @@ class TOGGL_INTERNAL_EXPORT GUI : public SyncStateMonitor {
 
     void DisplayTimeline(
         const bool open,
-        const std::vector<const TimelineEvent*> list,
+        const std::vector<const TimelineEvent*> &list,
         const std::vector<view::TimeEntry> &entries_list);
 
     TogglTimelineEventView* SortList(TogglTimelineEventView *head);
@@ -486,6 +523,11 @@ class TOGGL_INTERNAL_EXPORT GUI : public SyncStateMonitor {
 
     void DisplayEmptyTimerState();
 
+    void DisplayRunningTimer(
+        const std::string &GUID,
+        const Poco::Int64 started,
+        const Poco::Int64 date_duration);
+
     void DisplayIdleNotification(const std::string &guid,
                                  const std::string &since,
                                  const std::string &duration,
@@ -578,6 +620,21 @@ class TOGGL_INTERNAL_EXPORT GUI : public SyncStateMonitor {
         on_display_time_entry_list_ = cb;
     }
 
+    void OnDisplayTimeEntryListChanges(TogglDisplayTimeEntryListChanges cb) {
+        on_display_time_entry_list_changes_ = cb;
+    }
+
+    void OnDisplayTimeEntryListWindow(TogglDisplayTimeEntryListWindow cb) {
+        on_display_time_entry_list_window_ = cb;
+    }
+
+    // Remembers the rows the UI shows. Returns true when there
+    // is a list to send them from, see DisplayTimeEntryListWindow
+    bool SetTimeEntryListWindow(const uint64_t first_row, const uint64_t count);
+
+    // Sends the window of the list rendered last again
+    void DisplayTimeEntryListWindow();
+
     void OnDisplayTimeline(TogglDisplayTimeline cb) {
         on_display_timeline_ = cb;
     }
@@ -614,6 +671,10 @@ class TOGGL_INTERNAL_EXPORT GUI : public SyncStateMonitor {
         on_display_timer_state_ = cb;
     }
 
+    void OnDisplayRunningTimer(TogglDisplayRunningTimer cb) {
+        on_display_running_timer_ = cb;
+    }
+
     void OnDisplayIdleNotification(TogglDisplayIdleNotification cb) {
         on_display_idle_notification_  = cb;
     }
@@ -650,6 +711,10 @@ class TOGGL_INTERNAL_EXPORT GUI : public SyncStateMonitor {
         on_display_timeline_ui = cb;
     }
 
+    bool CanDisplayRunningTimer() const {
+        return !!on_display_running_timer_;
+    }
+
     bool CanDisplayUpdate() const {
         return !!on_display_update_;
     }
@@ -712,6 +777,20 @@ class TOGGL_INTERNAL_EXPORT GUI : public SyncStateMonitor {
  private:
     error findMissingCallbacks();
 
+    void displayTimeEntryListChanges(
+        const bool open,
+        const std::vector<view::TimeEntry> &rows,
+        const bool show_load_more_button);
+
+    // Sends the window around the rows the UI shows. The views are
+    // built under time_entry_list_m_, the UI is called without it
+    void displayTimeEntryListWindow(const bool open);
+
+    // Views of the events of one timeline chunk, by app and window title
+    TogglTimelineEventView *timelineChunkEvents(
+        const std::vector<const TimelineEvent *> &events,
+        ViewArena *arena);
+
     TogglDisplayApp on_display_app_;
     TogglDisplayError on_display_error_;
     TogglDisplayOverlay on_display_overlay_;
@@ -722,6 +801,8 @@ class TOGGL_INTERNAL_EXPORT GUI : public SyncStateMonitor {
     TogglDisplayPomodoro on_display_pomodoro_;
     TogglDisplayPomodoroBreak on_display_pomodoro_break_;
     TogglDisplayTimeEntryList on_display_time_entry_list_;
+    TogglDisplayTimeEntryListChanges on_display_time_entry_list_changes_;
+    TogglDisplayTimeEntryListWindow on_display_time_entry_list_window_;
     TogglDisplayAutocomplete on_display_time_entry_autocomplete_;
     TogglDisplayAutocomplete on_display_project_autocomplete_;
     TogglDisplayViewItems on_display_workspace_select_;
@@ -730,6 +811,7 @@ class TOGGL_INTERNAL_EXPORT GUI : public SyncStateMonitor {
     TogglDisplayTimeEntryEditor on_display_time_entry_editor_;
     TogglDisplaySettings on_display_settings_;
     TogglDisplayTimerState on_display_timer_state_;
+    TogglDisplayRunningTimer on_display_running_timer_;
     TogglDisplayIdleNotification on_display_idle_notification_;
     TogglDisplayAutocomplete on_display_mini_timer_autocomplete_;
     TogglDisplaySyncState on_display_sync_state_;
@@ -757,6 +839,14 @@ class TOGGL_INTERNAL_EXPORT GUI : public SyncStateMonitor {
     Poco::Int64 lastOnlineState;
     error lastErr;
     bool isFirstLaunch;
+    // Rows last sent to on_display_time_entry_list_changes_, or the
+    // whole list windows are sent from with on_display_time_entry_list_window_
+    std::vector<view::TimeEntry> lastTimeEntryList;
+    std::vector<uint64_t> timeEntryListHeaders;
+    bool timeEntryListShowLoadMore;
+    uint64_t timeEntryListWindowFirst;
+    uint64_t timeEntryListWindowCount;
+    Poco::Mutex time_entry_list_m_;
 
     // UI state
     std::string time_entry_editor_guid_;
@@ -8,12 +8,11 @@
 #include <sstream>
 #include <memory>
 
-#include "util/formatter.h"
 #include "netconf.h"
+#include "request_body_encoder.h"
 #include "urls.h"
 #include "toggl_api.h"
 
-#include <Poco/DeflatingStream.h>
 #include <Poco/Environment.h>
 #include <Poco/Exception.h>
 #include <Poco/FileStream.h>
@@ -125,6 +124,7 @@ void ServerStatus::runActivity() {
         HTTPRequest req;
         req.host = urls::API();
         req.relative_url = "/api/v9/status";
+        req.priority = kRequestPriorityBackground;
 
         HTTPResponse resp = TogglClient::GetInstance().silentGet(req);
         if (noError != resp.err) {
@@ -174,14 +174,13 @@ void ServerStatus::UpdateStatus(const Poco::Int64 code) {
 }
 
 HTTPClientConfig HTTPClient::Config;
-std::map<std::string, Poco::Timestamp> HTTPClient::banned_until_;
 
 Logger HTTPClient::logger() const {
     return { "HTTPClient" };
 }
 
 bool HTTPClient::isRedirect(const Poco::Int64 status_code) const {
-    return (status_code >= 300 && status_code < 400);
+    return (status_code >= 300 && status_code < 400 && status_code != 304);
 }
 
 error HTTPClient::StatusCodeToError(const Poco::Int64 status_code) {
@@ -189,6 +188,7 @@ error HTTPClient::StatusCodeToError(const Poco::Int64 status_code) {
     case 200:
     case 201:
     case 202:
+    case 304:
         return noError;
     case 400:
         // data that you sending is not valid/acceptable
@@ -266,6 +266,11 @@ HTTPResponse HTTPClient::Put(
 
 HTTPResponse HTTPClient::request(
     HTTPRequest req) const {
+    bool cached = req.cache && req.method == Poco::Net::HTTPRequest::HTTP_GET;
+    if (cached) {
+        req.cache->Prepare(&req);
+    }
+
     HTTPResponse resp = makeHttpRequest(req);
 
     if (kCannotConnectError == resp.err && isRedirect(resp.status_code)) {
@@ -278,6 +283,10 @@ HTTPResponse HTTPClient::request(
         logger().debug("Redirect to URL=", resp.body, " host=", req.host, " relative_url=", req.relative_url);
         resp = makeHttpRequest(req);
     }
+
+    if (cached) {
+        req.cache->Complete(req, &resp);
+    }
     return resp;
 }
 
@@ -296,17 +305,6 @@ HTTPResponse HTTPClient::makeHttpRequest(
         return resp;
     }
 
-    std::map<std::string, Poco::Timestamp>::const_iterator cit =
-        banned_until_.find(req.host);
-    if (cit != banned_until_.end()) {
-        if (cit->second >= Poco::Timestamp()) {
-            logger().warning(
-                "Cannot connect, because we made too many requests");
-            resp.err = kCannotConnectError;
-            return resp;
-        }
-    }
-
     if (req.host.empty()) {
         resp.err = error("Cannot make a HTTP request without a host");
         return resp;
@@ -324,6 +322,16 @@ HTTPResponse HTTPClient::makeHttpRequest(
         return resp;
     }
 
+    // Wait for our turn, higher priority requests to the same host go first
+    error err = RequestScheduler::Instance().Acquire(
+        req.host,
+        req.priority,
+        Poco::Timespan(req.timeout_seconds * Poco::Timespan::SECONDS));
+    if (err != noError) {
+        resp.err = err;
+        return resp;
+    }
+
     try {
         Poco::URI uri(req.host);
 
@@ -351,7 +359,7 @@ HTTPResponse HTTPClient::makeHttpRequest(
             encoded_url = url.getPathAndQuery();
         }
 
-        error err = Netconf::ConfigureProxy(req.host + encoded_url, session.get());
+        err = Netconf::ConfigureProxy(req.host + encoded_url, session.get());
         if (err != noError) {
             resp.err = error("Error while configuring proxy: " + err);
             logger().error(resp.err);
@@ -375,6 +383,10 @@ HTTPResponse HTTPClient::makeHttpRequest(
         }
         poco_req.set("User-Agent", HTTPClient::Config.UserAgent());
 
+        if (!req.if_none_match.empty()) {
+            poco_req.set("If-None-Match", req.if_none_match);
+        }
+
         Poco::Net::HTTPBasicCredentials cred(
             req.basic_auth_username, req.basic_auth_password);
         if (!req.basic_auth_username.empty()
@@ -389,24 +401,31 @@ HTTPResponse HTTPClient::makeHttpRequest(
         poco_req.set("X-Toggl-Client", "desktop");
 
         if (!req.form) {
-            std::istringstream requestStream(req.payload);
-
-            Poco::DeflatingInputStream gzipRequest(
-                requestStream,
-                Poco::DeflatingStreamBuf::STREAM_GZIP);
-            Poco::DeflatingStreamBuf *pBuff = gzipRequest.rdbuf();
+            if (req.method != Poco::Net::HTTPRequest::HTTP_GET) {
+                // Compress once into a per-thread buffer, small
+                // payloads are sent as-is
+                RequestBodyEncoder &encoder =
+                    RequestBodyEncoder::ForCurrentThread();
+                err = encoder.Encode(req.payload);
+                if (err != noError) {
+                    resp.err = err;
+                    logger().error(resp.err);
+                    return resp;
+                }
 
-            Poco::Int64 size =
-                pBuff->pubseekoff(0, std::ios::end, std::ios::in);
-            pBuff->pubseekpos(0, std::ios::in);
+                poco_req.setContentLength(
+                    static_cast<std::streamsize>(encoder.Size()));
+                if (encoder.Compressed()) {
+                    poco_req.set("Content-Encoding", "gzip");
+                }
 
-            if (req.method != Poco::Net::HTTPRequest::HTTP_GET) {
-                poco_req.setContentLength(size);
-                poco_req.set("Content-Encoding", "gzip");
-                poco_req.setChunkedTransferEncoding(true);
+                std::ostream &send = session->sendRequest(poco_req);
+                send.write(encoder.Data(),
+                           static_cast<std::streamsize>(encoder.Size()));
+                send.flush();
+            } else {
+                session->sendRequest(poco_req);
             }
-
-            session->sendRequest(poco_req) << pBuff << std::flush;
         } else {
             req.form->prepareSubmit(poco_req);
             std::ostream& send = session->sendRequest(poco_req);
@@ -428,6 +447,7 @@ HTTPResponse HTTPClient::makeHttpRequest(
         std::istream& is = session->receiveResponse(response);
 
         resp.status_code = response.getStatus();
+        resp.etag = response.get("ETag", "");
 
         {
             std::stringstream ss;
@@ -461,6 +481,10 @@ HTTPResponse HTTPClient::makeHttpRequest(
             Poco::URI::decode(response.get("Location"), decoded_url);
             resp.body = decoded_url;
 
+            // Not modified, there is no body, the cache fills it in
+        } else if (resp.NotModified()) {
+            logger().debug("Not modified since ETag ", req.if_none_match);
+
             // Inflate, if gzip was sent
         } else if (response.has("Content-Encoding") &&
                    "gzip" == response.get("Content-Encoding")) {
@@ -479,13 +503,11 @@ HTTPResponse HTTPClient::makeHttpRequest(
 
         logger().trace(resp.body);
 
-        if (429 == resp.status_code) {
-            Poco::Timestamp ts = Poco::Timestamp() + (60 * kOneSecondInMicros);
-            banned_until_[req.host] = ts;
-
-            logger().debug("Server indicated we're making too many requests to host ", req.host,
-                           ". So we cannot make new requests until ", Formatter::Format8601(ts));
-        }
+        // Slow down or speed up further requests to this host
+        RequestScheduler::Instance().Complete(
+            req.host,
+            resp.status_code,
+            response.get("Retry-After", ""));
 
         resp.err = StatusCodeToError(resp.status_code);
 
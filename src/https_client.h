@@ -10,6 +10,8 @@
 
 #include "const.h"
 #include "proxy.h"
+#include "request_scheduler.h"
+#include "response_cache.h"
 #include "types.h"
 #include "util/logger.h"
 
@@ -115,7 +117,10 @@ class TOGGL_INTERNAL_EXPORT HTTPRequest {
     , basic_auth_password("")
     , form(nullptr)
     , query(nullptr)
-    , timeout_seconds(kHTTPClientTimeoutSeconds) {}
+    , cache(nullptr)
+    , if_none_match("")
+    , timeout_seconds(kHTTPClientTimeoutSeconds)
+    , priority(kRequestPriorityInteractive) {}
     virtual ~HTTPRequest() {}
 
     std::string method;
@@ -126,7 +131,11 @@ class TOGGL_INTERNAL_EXPORT HTTPRequest {
     std::string basic_auth_password;
     Poco::Net::HTMLForm *form;
     Poco::URI::QueryParameters *query;
+    // GET responses are revalidated against and stored in the cache
+    ResponseCache *cache;
+    std::string if_none_match;
     Poco::Int64 timeout_seconds;
+    RequestPriority priority;
 };
 
 class TOGGL_INTERNAL_EXPORT HTTPResponse {
@@ -134,12 +143,18 @@ class TOGGL_INTERNAL_EXPORT HTTPResponse {
     HTTPResponse()
         : body("")
     , err(noError)
-    , status_code(0) {}
+    , status_code(0)
+    , etag("") {}
     virtual ~HTTPResponse() {}
 
+    bool NotModified() const {
+        return status_code == 304;
+    }
+
     std::string body;
     error err;
     Poco::Int64 status_code;
+    std::string etag;
 };
 
 class TOGGL_INTERNAL_EXPORT HTTPClient {
@@ -175,9 +190,6 @@ class TOGGL_INTERNAL_EXPORT HTTPClient {
  private:
     Poco::Net::Context::Ptr context; // share context with many Poco session
 
-    // We only make requests if this timestamp lies in the past.
-    static std::map<std::string, Poco::Timestamp> banned_until_;
-
     error accountLockingError(int remainingLogins) const;
 
     bool isRedirect(const Poco::Int64 status_code) const;
@@ -0,0 +1,187 @@
+// Copyright 2020 Toggl Desktop developers.
+
+#include "instrumented_mutex.h"
+
+#include <algorithm>
+
+#include "util/logger.h"
+
+#include <Poco/Path.h>
+
+#include <json/json.h>  // NOLINT
+
+namespace toggl {
+
+#ifdef TOGGL_LOCK_STATS
+
+namespace {
+
+Poco::FastMutex registry_m;
+
+std::vector<const InstrumentedMutex *> &registry() {
+    static std::vector<const InstrumentedMutex *> mutexes;
+    return mutexes;
+}
+
+Poco::UInt64 micros(const std::chrono::steady_clock::duration &d) {
+    return static_cast<Poco::UInt64>(
+        std::chrono::duration_cast<std::chrono::microseconds>(d).count());
+}
+
+std::string site(const char *file, const int line) {
+    if (!file) {
+        return "";
+    }
+    return Poco::Path(file).getFileName() + ":" + std::to_string(line);
+}
+
+}  // namespace
+
+InstrumentedMutex::InstrumentedMutex(const char *name)
+    : name_(name)
+, depth_(0)
+, holder_(nullptr, 0)
+, acquisitions_(0)
+, contended_(0) {
+    for (std::size_t i = 0; i < kLockStatsBuckets; i++) {
+        waits_[i] = 0;
+        holds_[i] = 0;
+    }
+
+    Poco::FastMutex::ScopedLock lock(registry_m);
+    registry().push_back(this);
+}
+
+InstrumentedMutex::~InstrumentedMutex() {
+    Poco::FastMutex::ScopedLock lock(registry_m);
+    std::vector<const InstrumentedMutex *> &mutexes = registry();
+    mutexes.erase(std::remove(mutexes.begin(), mutexes.end(), this),
+                  mutexes.end());
+}
+
+std::size_t InstrumentedMutex::bucket(const Poco::UInt64 micros) {
+    std::size_t i(0);
+    for (Poco::UInt64 limit = 1; i < kLockStatsBuckets - 1 && micros >= limit;
+            limit *= 10) {
+        i++;
+    }
+    return i;
+}
+
+void InstrumentedMutex::lock(const char *file, const int line) {
+    Poco::UInt64 waited(0);
+    if (!mutex_.tryLock()) {
+        Clock::time_point started = Clock::now();
+        mutex_.lock();
+        waited = micros(Clock::now() - started);
+        contended_.fetch_add(1, std::memory_order_relaxed);
+
+        // Until this thread takes over, holder_ is whoever it waited for
+        if (waited >= kLockStatsSlowWaitMillis * 1000) {
+            Logger("lock_stats").warning(
+                "Waited ", waited / 1000, " ms for ", name_,
+                " at ", site(file, line),
+                ", held by ", site(holder_.first, holder_.second));
+        }
+    }
+
+    // Poco::Mutex is recursive, only the outermost lock counts
+    if (depth_++ > 0) {
+        return;
+    }
+    acquisitions_.fetch_add(1, std::memory_order_relaxed);
+    waits_[bucket(waited)].fetch_add(1, std::memory_order_relaxed);
+    acquired_at_ = Clock::now();
+    holder_ = Site(file, line);
+}
+
+void InstrumentedMutex::unlock() {
+    if (--depth_ > 0) {
+        mutex_.unlock();
+        return;
+    }
+
+    Poco::UInt64 held = micros(Clock::now() - acquired_at_);
+    Site holder = holder_;
+    mutex_.unlock();
+
+    holds_[bucket(held)].fetch_add(1, std::memory_order_relaxed);
+
+    Poco::FastMutex::ScopedLock lock(holders_m_);
+    LockHolderStats &stats = holders_[holder];
+    stats.Acquisitions++;
+    stats.HoldMicros += held;
+    stats.MaxHoldMicros = std::max(stats.MaxHoldMicros, held);
+}
+
+LockStats InstrumentedMutex::stats() const {
+    LockStats result;
+    result.Name = name_;
+    result.Acquisitions = acquisitions_.load(std::memory_order_relaxed);
+    result.Contended = contended_.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < kLockStatsBuckets; i++) {
+        result.WaitHistogram[i] = waits_[i].load(std::memory_order_relaxed);
+        result.HoldHistogram[i] = holds_[i].load(std::memory_order_relaxed);
+    }
+
+    {
+        Poco::FastMutex::ScopedLock lock(holders_m_);
+        for (std::map<Site, LockHolderStats>::const_iterator it =
+                    holders_.begin(); it != holders_.end(); ++it) {
+            LockHolderStats holder = it->second;
+            holder.Site = site(it->first.first, it->first.second);
+            result.Holders.push_back(holder);
+        }
+    }
+
+    std::sort(result.Holders.begin(), result.Holders.end(),
+              [](const LockHolderStats &a, const LockHolderStats &b) {
+        return a.MaxHoldMicros > b.MaxHoldMicros;
+    });
+    if (result.Holders.size() > kLockStatsHolders) {
+        result.Holders.resize(kLockStatsHolders);
+    }
+    return result;
+}
+
+std::vector<LockStats> InstrumentedMutex::Snapshot() {
+    std::vector<LockStats> result;
+    Poco::FastMutex::ScopedLock lock(registry_m);
+    const std::vector<const InstrumentedMutex *> &mutexes = registry();
+    for (std::size_t i = 0; i < mutexes.size(); i++) {
+        result.push_back(mutexes[i]->stats());
+    }
+    return result;
+}
+
+#endif  // TOGGL_LOCK_STATS
+
+std::string LockStatsToJSON(const std::vector<LockStats> &stats) {
+    Json::Value root(Json::arrayValue);
+    for (std::size_t i = 0; i < stats.size(); i++) {
+        const LockStats &s = stats[i];
+        Json::Value n;
+        n["name"] = s.Name;
+        n["acquisitions"] = Json::UInt64(s.Acquisitions);
+        n["contended"] = Json::UInt64(s.Contended);
+        for (std::size_t b = 0; b < s.WaitHistogram.size(); b++) {
+            n["wait_histogram"].append(Json::UInt64(s.WaitHistogram[b]));
+            n["hold_histogram"].append(Json::UInt64(s.HoldHistogram[b]));
+        }
+        n["holders"] = Json::Value(Json::arrayValue);
+        for (std::size_t h = 0; h < s.Holders.size(); h++) {
+            Json::Value holder;
+            holder["site"] = s.Holders[h].Site;
+            holder["acquisitions"] = Json::UInt64(s.Holders[h].Acquisitions);
+            holder["hold_us"] = Json::UInt64(s.Holders[h].HoldMicros);
+            holder["max_hold_us"] = Json::UInt64(s.Holders[h].MaxHoldMicros);
+            n["holders"].append(holder);
+        }
+        root.append(n);
+    }
+
+    Json::FastWriter writer;
+    return writer.write(root);
+}
+
+}  // namespace toggl
@@ -0,0 +1,152 @@
+// Copyright 2020 Toggl Desktop developers.
+
+#ifndef SRC_INSTRUMENTED_MUTEX_H_
+#define SRC_INSTRUMENTED_MUTEX_H_
+
+#include <string>
+#include <vector>
+
+#include "const.h"
+#include "types.h"
+
+#include <Poco/Mutex.h>
+#include <Poco/Types.h>
+
+#ifdef TOGGL_LOCK_STATS
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <utility>
+#endif
+
+namespace toggl {
+
+// The call site that held a lock the longest
+class TOGGL_INTERNAL_EXPORT LockHolderStats {
+ public:
+    LockHolderStats()
+        : Site("")
+    , Acquisitions(0)
+    , HoldMicros(0)
+    , MaxHoldMicros(0) {}
+
+    // file:line of the ScopedLock
+    std::string Site;
+    Poco::UInt64 Acquisitions;
+    // Total time the site held the lock
+    Poco::UInt64 HoldMicros;
+    Poco::UInt64 MaxHoldMicros;
+};
+
+class TOGGL_INTERNAL_EXPORT LockStats {
+ public:
+    LockStats()
+        : Name("")
+    , Acquisitions(0)
+    , Contended(0)
+    , WaitHistogram(kLockStatsBuckets, 0)
+    , HoldHistogram(kLockStatsBuckets, 0) {}
+
+    std::string Name;
+    Poco::UInt64 Acquisitions;
+    // Acquisitions that had to wait for another thread
+    Poco::UInt64 Contended;
+    // Acquisitions by time waited and held: under 1 µs,
+    // under 10 µs and so on, the last one is 1 s and more
+    std::vector<Poco::UInt64> WaitHistogram;
+    std::vector<Poco::UInt64> HoldHistogram;
+    // Longest holding sites first
+    std::vector<LockHolderStats> Holders;
+};
+
+#ifdef TOGGL_LOCK_STATS
+
+/*
+ * A Poco::Mutex that records how often it is locked, how long threads
+ * wait for it and which call sites hold it for how long.
+ *
+ * ScopedLock picks up the call site by itself, so a member declared as
+ * InstrumentedMutex only needs its locks spelt InstrumentedMutex::ScopedLock.
+ * A thread waiting longer than kLockStatsSlowWaitMillis logs the site
+ * that held the lock before it.
+ *
+ * Only built with TOGGL_LOCK_STATS. Otherwise InstrumentedMutex is
+ * a plain Poco::Mutex and Snapshot() is empty.
+ */
+class TOGGL_INTERNAL_EXPORT InstrumentedMutex {
+ public:
+    explicit InstrumentedMutex(const char *name);
+    ~InstrumentedMutex();
+
+    class ScopedLock {
+     public:
+        explicit ScopedLock(InstrumentedMutex &mutex,  // NOLINT
+                            const char *file = __builtin_FILE(),
+                            const int line = __builtin_LINE())
+            : mutex_(mutex) {
+            mutex_.lock(file, line);
+        }
+        ~ScopedLock() {
+            mutex_.unlock();
+        }
+
+     private:
+        ScopedLock(const ScopedLock &);
+        ScopedLock &operator=(const ScopedLock &);
+
+        InstrumentedMutex &mutex_;
+    };
+
+    void lock(const char *file, const int line);
+    void unlock();
+
+    // Statistics of every instrumented mutex alive
+    static std::vector<LockStats> Snapshot();
+
+ private:
+    InstrumentedMutex(const InstrumentedMutex &);
+    InstrumentedMutex &operator=(const InstrumentedMutex &);
+
+    typedef std::chrono::steady_clock Clock;
+    typedef std::pair<const char *, int> Site;
+
+    LockStats stats() const;
+
+    static std::size_t bucket(const Poco::UInt64 micros);
+
+    Poco::Mutex mutex_;
+    std::string name_;
+
+    // Written by the thread holding mutex_ only
+    int depth_;
+    Clock::time_point acquired_at_;
+    Site holder_;
+
+    std::atomic<Poco::UInt64> acquisitions_;
+    std::atomic<Poco::UInt64> contended_;
+    std::atomic<Poco::UInt64> waits_[kLockStatsBuckets];
+    std::atomic<Poco::UInt64> holds_[kLockStatsBuckets];
+
+    mutable Poco::FastMutex holders_m_;
+    std::map<Site, LockHolderStats> holders_;
+};
+
+#else
+
+class TOGGL_INTERNAL_EXPORT InstrumentedMutex : public Poco::Mutex {
+ public:
+    explicit InstrumentedMutex(const char *) {}
+
+    static std::vector<LockStats> Snapshot() {
+        return std::vector<LockStats>();
+    }
+};
+
+#endif  // TOGGL_LOCK_STATS
+
+// Snapshot() as JSON, for the UI and the logs
+std::string LockStatsToJSON(const std::vector<LockStats> &stats);
+
+}  // namespace toggl
+
+#endif  // SRC_INSTRUMENTED_MUTEX_H_
@@ -3,6 +3,9 @@
 
 #include "model/autotracker.h"
 
+#include <algorithm>
+#include <deque>
+
 #include <Poco/UTF8String.h>
 
 #include "const.h"
@@ -54,4 +57,188 @@ std::string AutotrackerRule::ModelURL() const {
     return "";
 }
 
+namespace {
+
+const std::size_t kNoNode = static_cast<std::size_t>(-1);
+
+}  // namespace
+
+AutotrackerMatcher::AutotrackerMatcher() {
+    Build(std::vector<AutotrackerRule *>());
+}
+
+void AutotrackerMatcher::Build(const std::vector<AutotrackerRule *> &rules) {
+    rules_.clear();
+    nodes_.assign(1, Node());
+    nodes_[0].Fail = 0;
+    nodes_[0].First = kNoNode;
+
+    // A trie of the terms, each end remembering the rule
+    for (std::vector<AutotrackerRule *>::const_iterator it = rules.begin();
+            it != rules.end(); ++it) {
+        AutotrackerRule *rule = *it;
+        if (rule->DeletedAt()) {
+            continue;
+        }
+        const std::size_t index = rules_.size();
+        rules_.push_back(rule);
+
+        std::size_t node = 0;
+        const std::string &term = rule->Term();
+        for (std::size_t i = 0; i < term.size(); i++) {
+            const unsigned char byte = static_cast<unsigned char>(term[i]);
+            std::size_t found = child(node, byte);
+            if (kNoNode == found) {
+                found = nodes_.size();
+                Node added;
+                added.Fail = 0;
+                added.First = kNoNode;
+                nodes_.push_back(added);
+
+                std::vector<std::pair<unsigned char, std::size_t> > &next =
+                    nodes_[node].Next;
+                next.insert(std::lower_bound(
+                    next.begin(), next.end(),
+                    std::make_pair(byte, std::size_t(0))),
+                            std::make_pair(byte, found));
+            }
+            node = found;
+        }
+        nodes_[node].First = std::min(nodes_[node].First, index);
+    }
+
+    // Failure links breadth first, so the suffix of a node
+    // is complete before the node itself
+    std::deque<std::size_t> queue;
+    for (std::size_t i = 0; i < nodes_[0].Next.size(); i++) {
+        queue.push_back(nodes_[0].Next[i].second);
+    }
+    while (!queue.empty()) {
+        const std::size_t node = queue.front();
+        queue.pop_front();
+
+        Node &parent = nodes_[node];
+        parent.First = std::min(parent.First, nodes_[parent.Fail].First);
+
+        for (std::size_t i = 0; i < parent.Next.size(); i++) {
+            const unsigned char byte = nodes_[node].Next[i].first;
+            const std::size_t target = nodes_[node].Next[i].second;
+            nodes_[target].Fail = next(nodes_[node].Fail, byte);
+            queue.push_back(target);
+        }
+    }
+}
+
+std::size_t AutotrackerMatcher::child(
+    const std::size_t node,
+    const unsigned char byte) const {
+    const std::vector<std::pair<unsigned char, std::size_t> > &next =
+        nodes_[node].Next;
+    std::vector<std::pair<unsigned char, std::size_t> >::const_iterator it =
+        std::lower_bound(next.begin(), next.end(),
+                         std::make_pair(byte, std::size_t(0)));
+    if (it != next.end() && it->first == byte) {
+        return it->second;
+    }
+    return kNoNode;
+}
+
+std::size_t AutotrackerMatcher::next(
+    std::size_t node,
+    const unsigned char byte) const {
+    for (;;) {
+        const std::size_t found = child(node, byte);
+        if (found != kNoNode) {
+            return found;
+        }
+        if (!node) {
+            return 0;
+        }
+        node = nodes_[node].Fail;
+    }
+}
+
+std::size_t AutotrackerMatcher::scan(
+    const std::string &text,
+    std::size_t first) const {
+    std::size_t node = 0;
+    for (std::size_t i = 0; i < text.size() && first; i++) {
+        node = next(node, static_cast<unsigned char>(text[i]));
+        first = std::min(first, nodes_[node].First);
+    }
+    return first;
+}
+
+AutotrackerRule *AutotrackerMatcher::Find(const TimelineEvent &event) const {
+    if (rules_.empty()) {
+        return nullptr;
+    }
+
+    // Empty terms match anything
+    std::size_t first = nodes_[0].First;
+    first = scan(Poco::UTF8::toLower(event.Filename()), first);
+    first = scan(Poco::UTF8::toLower(event.Title()), first);
+    if (kNoNode == first) {
+        return nullptr;
+    }
+    return rules_[first];
+}
+
+std::string AutotrackerCache::key(
+    const std::string &filename,
+    const std::string &title) {
+    std::string result;
+    result.reserve(filename.size() + 1 + title.size());
+    result.append(filename);
+    result.push_back('\0');
+    result.append(title);
+    return result;
+}
+
+const AutotrackerMatch *AutotrackerCache::Find(
+    const std::string &filename,
+    const std::string &title) {
+    std::unordered_map<std::string, std::list<Entry>::iterator>::iterator
+    found = index_.find(key(filename, title));
+    if (found == index_.end()) {
+        stats_.Misses++;
+        return nullptr;
+    }
+    stats_.Hits++;
+    entries_.splice(entries_.begin(), entries_, found->second);
+    return &found->second->second;
+}
+
+void AutotrackerCache::Insert(
+    const std::string &filename,
+    const std::string &title,
+    const AutotrackerMatch &match) {
+    std::string k = key(filename, title);
+    std::unordered_map<std::string, std::list<Entry>::iterator>::iterator
+    found = index_.find(k);
+    if (found != index_.end()) {
+        found->second->second = match;
+        entries_.splice(entries_.begin(), entries_, found->second);
+        return;
+    }
+
+    if (entries_.size() >= capacity_ && !entries_.empty()) {
+        index_.erase(entries_.back().first);
+        entries_.pop_back();
+    }
+    entries_.push_front(Entry(k, match));
+    index_[k] = entries_.begin();
+}
+
+void AutotrackerCache::Clear() {
+    entries_.clear();
+    index_.clear();
+}
+
+AutotrackerCacheStats AutotrackerCache::Stats() const {
+    AutotrackerCacheStats stats = stats_;
+    stats.Size = entries_.size();
+    return stats;
+}
+
 }  // namespace toggl
@@ -3,8 +3,11 @@
 #ifndef SRC_AUTOTRACKER_H_
 #define SRC_AUTOTRACKER_H_
 
+#include <list>
 #include <string>
 #include <sstream>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <Poco/Types.h>
@@ -14,6 +17,9 @@
 
 namespace toggl {
 
+class Project;
+class Task;
+
 class TOGGL_INTERNAL_EXPORT AutotrackerRule : public BaseModel {
  public:
     AutotrackerRule() : BaseModel() {}
@@ -38,6 +44,106 @@ class TOGGL_INTERNAL_EXPORT AutotrackerRule : public BaseModel {
     std::string ModelURL() const override;
 };
 
+// Finds the first rule whose term occurs in the filename or title of
+// an event, like trying AutotrackerRule::Matches on each rule in turn.
+// The terms are compiled into one Aho-Corasick automaton, so both texts
+// are lowercased once and scanned once, however many rules there are.
+class TOGGL_INTERNAL_EXPORT AutotrackerMatcher {
+ public:
+    AutotrackerMatcher();
+
+    // Compiles the terms of the rules, earlier rules take priority.
+    // The rules must outlive the matcher or the next Build.
+    void Build(const std::vector<AutotrackerRule *> &rules);
+
+    AutotrackerRule *Find(const TimelineEvent &event) const;
+
+ private:
+    struct Node {
+        // Sorted by byte
+        std::vector<std::pair<unsigned char, std::size_t> > Next;
+        // Node of the longest proper suffix that is also in the automaton
+        std::size_t Fail;
+        // Lowest index of a rule whose term ends here, or at a suffix
+        std::size_t First;
+    };
+
+    std::size_t next(std::size_t node, const unsigned char byte) const;
+    std::size_t child(const std::size_t node, const unsigned char byte) const;
+
+    // Lowest rule index seen while scanning the text, at most until
+    // first, which is returned if nothing earlier matches
+    std::size_t scan(const std::string &text, std::size_t first) const;
+
+    std::vector<Node> nodes_;
+    std::vector<AutotrackerRule *> rules_;
+};
+
+// What the autotracker made of a window
+class TOGGL_INTERNAL_EXPORT AutotrackerMatch {
+ public:
+    AutotrackerMatch()
+        : Rule(nullptr)
+    , RuleProject(nullptr)
+    , RuleTask(nullptr) {}
+
+    AutotrackerRule *Rule;
+    // Resolved from the IDs in the rule, nullptr if not found
+    Project *RuleProject;
+    Task *RuleTask;
+};
+
+class TOGGL_INTERNAL_EXPORT AutotrackerCacheStats {
+ public:
+    AutotrackerCacheStats()
+        : Hits(0)
+    , Misses(0)
+    , Size(0) {}
+
+    Poco::UInt64 Hits;
+    Poco::UInt64 Misses;
+    Poco::UInt64 Size;
+};
+
+// The matches of the windows seen last, the same few of them
+// come up over and over during the day. The least recently used
+// window is forgotten when the cache is full.
+class TOGGL_INTERNAL_EXPORT AutotrackerCache {
+ public:
+    explicit AutotrackerCache(const std::size_t capacity = kAutotrackerCacheSize)
+        : capacity_(capacity) {}
+
+    // The cached match of the window, nullptr if there is none
+    const AutotrackerMatch *Find(
+        const std::string &filename,
+        const std::string &title);
+
+    void Insert(
+        const std::string &filename,
+        const std::string &title,
+        const AutotrackerMatch &match);
+
+    // Forgets the matches but keeps counting
+    void Clear();
+
+    AutotrackerCacheStats Stats() const;
+
+ private:
+    static std::string key(
+        const std::string &filename,
+        const std::string &title);
+
+    typedef std::pair<std::string, AutotrackerMatch> Entry;
+
+    const std::size_t capacity_;
+
+    // Most recently used first
+    std::list<Entry> entries_;
+    std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+
+    AutotrackerCacheStats stats_;
+};
+
 };  // namespace toggl
 
 #endif  // SRC_AUTOTRACKER_H_
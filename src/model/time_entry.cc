@@ -425,31 +425,6 @@ void TimeEntry::LoadFromJSON(const Json::Value &data, bool syncServer) {
     auto convertTimeString = [](const Json::Value &json) -> Poco::Int64 {
         return Formatter::Parse8601(json.asString());
     };
-    // Function that checks the JSON for the field in question and updates the property according to both sync server and legacy specs
-    auto updateMergeablePropertyConvert = [this, &data, &syncServer](const std::string &field, auto &property, auto &convert) -> bool {
-        // no member -> no update
-        if (!data.isMember(field))
-            return false;
-        // extract the value using the helper in util/json or any other supplied conversion function
-        auto serverValue = convert(data[field]);
-        // if we're using the sync server and the previous value is the same as what server has, don't change anything
-        if (syncServer && serverValue == property.GetPrevious())
-            return true;
-        // now if the current version is different from the server value, we need to update it
-        if (serverValue != property.Get()) {
-            property.Set(std::move(serverValue), false);
-            SetDirty();
-        }
-        return true;
-    };
-    // This is just a wrapper so we don't have to supply JsonHelper::convert<T> for each call. It determines the type of the property automatically.
-    auto updateMergeableProperty = [&updateMergeablePropertyConvert](const std::string &field, auto &property) -> bool {
-        // decltype(property) gets us Property<T>&
-        // std::remove_reference removes the reference -> Property<T>
-        // Then we need to actually access the Property<T> type and use our own value_type to get T
-        using type = typename std::remove_reference<decltype(property)>::type::value_type;
-        return updateMergeablePropertyConvert(field, property, JsonHelper::convert<type>);
-    };
 
     // No ui_modified_at in server responses.
     // Compare updated_at with ui_modified_at to see if ui has been changed
@@ -461,9 +436,7 @@ void TimeEntry::LoadFromJSON(const Json::Value &data, bool syncServer) {
         updated_at = at.asInt64();
     }
 
-    if (updated_at != 0 &&
-            (UIModifiedAt() >= updated_at ||
-             UpdatedAt() >= updated_at)) {
+    if (updated_at != 0 && UpdatedAt() >= updated_at) {
         std::stringstream ss;
         ss  << "Will not overwrite time entry "
             << "[" << String() << "]"
@@ -473,6 +446,33 @@ void TimeEntry::LoadFromJSON(const Json::Value &data, bool syncServer) {
         return;
     }
 
+    // Local edits made after the server version was saved win the fields both sides changed,
+    // fields edited on one side only are combined
+    bool preferRemote = !UIModifiedAt() || updated_at == 0 || updated_at > UIModifiedAt();
+    bool conflicts = false;
+
+    // Function that checks the JSON for the field in question and merges it into the property
+    auto updateMergeablePropertyConvert = [this, &data, &preferRemote, &conflicts](const std::string &field, auto &property, auto &convert) -> bool {
+        // no member -> no update
+        if (!data.isMember(field))
+            return false;
+        // extract the value using the helper in util/json or any other supplied conversion function
+        auto serverValue = convert(data[field]);
+        if (property.IsDirty() && serverValue != property.GetPrevious() && serverValue != property.Get())
+            conflicts = true;
+        if (property.Merge(serverValue, preferRemote))
+            SetDirty();
+        return true;
+    };
+    // This is just a wrapper so we don't have to supply JsonHelper::convert<T> for each call. It determines the type of the property automatically.
+    auto updateMergeableProperty = [&updateMergeablePropertyConvert](const std::string &field, auto &property) -> bool {
+        // decltype(property) gets us Property<T>&
+        // std::remove_reference removes the reference -> Property<T>
+        // Then we need to actually access the Property<T> type and use our own value_type to get T
+        using type = typename std::remove_reference<decltype(property)>::type::value_type;
+        return updateMergeablePropertyConvert(field, property, JsonHelper::convert<type>);
+    };
+
     // WID should be static
     if (data.isMember("wid")) {
         SetWID(data["wid"].asUInt64());
@@ -487,10 +487,10 @@ void TimeEntry::LoadFromJSON(const Json::Value &data, bool syncServer) {
     updateMergeableProperty("description", Description);
     if (!updateMergeableProperty("project_id", PID))
         if (!updateMergeableProperty("pid", PID))
-            SetPID(0, false);
+            PID.Merge(0, preferRemote);
     if (!updateMergeableProperty("task_id", TID))
         if (!updateMergeableProperty("tid", TID))
-            SetTID(0, false);
+            TID.Merge(0, preferRemote);
     updateMergeableProperty("billable", Billable);
     updateMergeableProperty("duration", DurationInSeconds);
     updateMergeablePropertyConvert("start", StartTime, convertTimeString);
@@ -500,10 +500,33 @@ void TimeEntry::LoadFromJSON(const Json::Value &data, bool syncServer) {
     SetDurOnly(data["duronly"].asBool());
     SetUpdatedAtString(data["at"].asString());
 
-    SetUIModifiedAt(0);
+    if (conflicts) {
+        std::stringstream ss;
+        ss  << "Merged concurrent edits of time entry "
+            << "[" << String() << "]"
+            << (preferRemote ? ", server values won" : ", local values won");
+        logger().debug(ss.str());
+    }
+
+    // Whatever is still dirty after merging is a local edit the server doesn't have yet
+    if (!HasUnpushedChanges()) {
+        SetUIModifiedAt(0);
+    }
     ClearUnsynced();
 }
 
+bool TimeEntry::HasUnpushedChanges() const {
+    return TagNames.IsDirty()
+           || CreatedWith.IsDirty()
+           || Description.IsDirty()
+           || PID.IsDirty()
+           || TID.IsDirty()
+           || Billable.IsDirty()
+           || DurationInSeconds.IsDirty()
+           || StartTime.IsDirty()
+           || StopTime.IsDirty();
+}
+
 Json::Value TimeEntry::SaveToJSON(int apiVersion) const {
     Json::Value n;
     if (ID()) {
@@ -591,6 +614,40 @@ Json::Value TimeEntry::SaveToJSON(int apiVersion) const {
     return n;
 }
 
+Json::Value TimeEntry::SaveChangesToJSON(int apiVersion) const {
+    Json::Value n = SaveToJSON(apiVersion);
+    if (!ID()) {
+        return n;
+    }
+    // The server keeps its own value of anything that is left out, so
+    // fields edited concurrently elsewhere are not overwritten
+    if (!Description.IsDirty()) {
+        n.removeMember("description");
+    }
+    if (!PID.IsDirty() && !ProjectGUID.IsDirty()) {
+        n.removeMember(apiVersion == 8 ? "pid" : "project_id");
+    }
+    if (!TID.IsDirty()) {
+        n.removeMember(apiVersion == 8 ? "tid" : "task_id");
+    }
+    // Start, stop and duration are validated against each other, send them together
+    if (!StartTime.IsDirty() && !StopTime.IsDirty() && !DurationInSeconds.IsDirty()) {
+        n.removeMember("start");
+        n.removeMember("stop");
+        n.removeMember("duration");
+    }
+    if (!Billable.IsDirty()) {
+        n.removeMember("billable");
+    }
+    if (!CreatedWith.IsDirty()) {
+        n.removeMember("created_with");
+    }
+    if (!TagNames.IsDirty()) {
+        n.removeMember("tags");
+    }
+    return n;
+}
+
 Json::Value TimeEntry::SyncMetadata() const {
     Json::Value result;
     if (NeedsPOST()) {
@@ -94,6 +94,11 @@ class TOGGL_INTERNAL_EXPORT TimeEntry : public BaseModel, public TimedEvent {
     virtual bool ResolveError(const error &err) override;
     void LoadFromJSON(const Json::Value &value, bool syncServer);
     Json::Value SaveToJSON(int apiVersion = 8) const override;
+    // Like SaveToJSON, but an entry that exists on the server only gets
+    // the fields that were changed locally since the last sync
+    Json::Value SaveChangesToJSON(int apiVersion = 8) const;
+    // True while some synced field has a local value the server doesn't know yet
+    bool HasUnpushedChanges() const;
     Json::Value SyncMetadata() const override;
     Json::Value SyncPayload() const override;
 
@@ -4,6 +4,7 @@
 
 #include <time.h>
 
+#include <functional>
 #include <sstream>
 
 #include "model/client.h"
@@ -25,7 +26,9 @@
 #include <Poco/Crypto/CipherFactory.h>
 #include <Poco/Crypto/CipherKey.h>
 #include <Poco/Crypto/CryptoStream.h>
+#include <Poco/DateTime.h>
 #include <Poco/DigestStream.h>
+#include <Poco/LocalDateTime.h>
 #include <Poco/Random.h>
 #include <Poco/RandomStream.h>
 #include <Poco/SHA1Engine.h>
@@ -662,15 +665,15 @@ error User::LoadUserUpdateFromJSONString(
         return error("Failed to LoadUserUpdateFromJSONString");
     }
 
-    loadUserUpdateFromJSON(root);
+    LoadUserUpdateFromJSON(root);
 
     return noError;
 }
 
-void User::loadUserUpdateFromJSON(
-    Json::Value node) {
+void User::LoadUserUpdateFromJSON(
+    const Json::Value &node) {
 
-    Json::Value data = node["data"];
+    const Json::Value &data = node["data"];
     std::string model = node["model"].asString();
     std::string action = node["action"].asString();
 
@@ -1122,7 +1125,7 @@ void User::loadUserTimeEntryFromJSON(
 
     TimeEntry* model;
     {
-        Poco::Mutex::ScopedLock lock(loadTimeEntries_m_);
+        InstrumentedMutex::ScopedLock lock(loadTimeEntries_m_);
         model = related.TimeEntryByID(id);
 
         if (!model) {
@@ -1382,20 +1385,105 @@ void User::MarkTimelineBatchAsUploaded(
     }
 }
 
-void User::CompressTimeline() {
-    // Group events by app name into chunks
-    std::map<std::string, TimelineEvent *> compressed;
+bool User::TimelineChunkKey::operator==(const TimelineChunkKey &other) const {
+    return ChunkStart == other.ChunkStart
+           && Idle == other.Idle
+           && Filename == other.Filename
+           && Title == other.Title;
+}
+
+std::size_t User::TimelineChunkKeyHash::operator()(
+    const TimelineChunkKey &key) const {
+    std::size_t hash = std::hash<std::string>()(key.Filename);
+    hash = hash * 31 + std::hash<std::string>()(key.Title);
+    hash = hash * 31 + std::hash<Poco::Int64>()(key.ChunkStart);
+    return hash * 2 + key.Idle;
+}
+
+TimelineEvent *User::foldTimelineEvent(TimelineEvent *event) {
+    TimelineChunkKey key;
+    key.Filename = event->Filename();
+    key.Title = event->Title();
+    key.Idle = event->Idle();
+    key.ChunkStart =
+        (event->Start() / kTimelineChunkSeconds) * kTimelineChunkSeconds;
+
+    // Duration() is never negative
+    Poco::Int64 duration = event->Duration();
+
+    TimelineEvent *&chunk = open_timeline_chunks_[key];
+    if (chunk == event) {
+        return event;
+    }
+    if (chunk) {
+        chunk->SetEndTime(chunk->EndTime() + duration);
+        return chunk;
+    }
+
+    // The event starts a new chunk
+    chunk = event;
+    chunk->SetEndTime(chunk->Start() + duration);
+    return chunk;
+}
+
+bool User::closeTimelineChunks(const Poco::Int64 chunk_up_to) {
+    bool closed = false;
+    for (auto i = open_timeline_chunks_.begin();
+            i != open_timeline_chunks_.end();) {
+        if (i->first.ChunkStart >= chunk_up_to) {
+            ++i;
+            continue;
+        }
+        i->second->SetChunked(true);
+        i = open_timeline_chunks_.erase(i);
+        closed = true;
+    }
+    return closed;
+}
+
+void User::AddTimelineEvent(TimelineEvent *event) {
+    poco_check_ptr(event);
+
+    // Events arrive in order, so chunks before this one are complete
+    closeTimelineChunks(
+        (event->Start() / kTimelineChunkSeconds) * kTimelineChunkSeconds);
+
+    if (foldTimelineEvent(event) != event) {
+        delete event;
+        return;
+    }
+    related.TimelineEvents.push_back(event);
+}
+
+bool User::CloseTimelineChunks() {
+    // Chunks before the current one will get no more events
+    bool changed = closeTimelineChunks(
+        (time(nullptr) / kTimelineChunkSeconds) * kTimelineChunkSeconds);
+
+    // Older events will be deleted
+    Poco::Int64 minimum_time = time(nullptr) - kTimelineSecondsToKeep;
+    for (std::vector<TimelineEvent *>::const_iterator i =
+        related.TimelineEvents.begin();
+            i != related.TimelineEvents.end();
+            ++i) {
+        TimelineEvent *event = *i;
+        if (event->Start() < minimum_time && !event->DeletedAt()) {
+            event->Delete();
+            changed = true;
+        }
+    }
+    return changed;
+}
 
+void User::CompressTimeline() {
     // Older events will be deleted
     Poco::Int64 minimum_time = time(nullptr) - kTimelineSecondsToKeep;
 
     // Find the chunk start time of current time.
-    // then process only events that are older that this chunk start time.
-    // Else we will have no full chunks to compress.
+    // Chunks older than that are complete and get closed.
     Poco::Int64 chunk_up_to =
         (time(nullptr) / kTimelineChunkSeconds) * kTimelineChunkSeconds;
 
-
     time_t start = time(nullptr);
 
     logger().debug("CompressTimeline ",
@@ -1403,6 +1491,10 @@ void User::CompressTimeline() {
                    " chunk_up_to=", chunk_up_to,
                    " number of events=", related.TimelineEvents.size());
 
+    // Rebuild the open chunks from the stored events, which may
+    // have been recorded uncompressed by an earlier version
+    open_timeline_chunks_.clear();
+
     for (std::vector<TimelineEvent *>::iterator i =
         related.TimelineEvents.begin();
             i != related.TimelineEvents.end();
@@ -1416,11 +1508,6 @@ void User::CompressTimeline() {
             event->Delete();
         }
 
-        // Events that do not fit into chunk yet, ignore
-        if (event->Start() >= chunk_up_to) {
-            continue;
-        }
-
         // Ignore deleted events
         if (event->DeletedAt()) {
             continue;
@@ -1431,51 +1518,18 @@ void User::CompressTimeline() {
             continue;
         }
 
-        // Calculate the start time of the chunk
-        // that fits this timeline event
-        time_t chunk_start_time =
-            (event->Start() / kTimelineChunkSeconds)
-            * kTimelineChunkSeconds;
-
-        // Build dictionary key so that the chunk can be accessed later
-        std::stringstream ss;
-        ss << event->Filename();
-        ss << "::";
-        ss << event->Title();
-        ss << "::";
-        ss << event->Idle();
-        ss << "::";
-        ss << chunk_start_time;
-        std::string key = ss.str();
-
-        // Calculate positive value of timeline event duration
-        time_t duration = event->Duration();
-        if (duration < 0) {
-            duration = 0;
-        }
-
-        poco_assert(!event->Uploaded());
-        poco_assert(!event->Chunked());
-
-        TimelineEvent *chunk = nullptr;
-        if (compressed.find(key) == compressed.end()) {
-            // If chunk is not created yet,
-            // turn the timeline event into chunk
-            chunk = event;
-            chunk->SetEndTime(chunk->Start() + duration);
-            chunk->SetChunked(true);
-        } else {
-            // If chunk already exists, add duration
-            // to that junk and delete the original event
-            chunk = compressed[key];
-            chunk->SetEndTime(chunk->EndTime() + duration);
+        // Add the duration to an existing chunk
+        // and delete the original event
+        if (foldTimelineEvent(event) != event) {
             event->Delete();
         }
-        compressed[key] = chunk;
     }
 
+    std::size_t chunks = open_timeline_chunks_.size();
+    closeTimelineChunks(chunk_up_to);
+
     logger().debug("CompressTimeline done in ", (time(nullptr) - start), " seconds, ",
-                   related.TimelineEvents.size(), " compressed into ", compressed.size(), " chunks");
+                   related.TimelineEvents.size(), " compressed into ", chunks, " chunks");
 }
 
 std::vector<const TimelineEvent*> User::CompressedTimelineForUI(const Poco::LocalDateTime *date) const {
@@ -1487,6 +1541,19 @@ std::vector<const TimelineEvent*> User::CompressedTimelineForUpload(const Poco::
 }
 
 std::vector<const TimelineEvent*> User::CompressedTimeline(const Poco::LocalDateTime *date, bool is_for_upload) const {
+    // The date as the UTC times of its first and the next day's midnight
+    Poco::Int64 day_start(0), day_end(0);
+    if (date) {
+        Poco::LocalDateTime midnight(date->year(), date->month(), date->day());
+        Poco::DateTime next_day(
+            Poco::DateTime(date->year(), date->month(), date->day())
+            + Poco::Timespan(1 * Poco::Timespan::DAYS));
+        Poco::LocalDateTime next_midnight(
+            next_day.year(), next_day.month(), next_day.day());
+        day_start = Poco::Timestamp::fromUtcTime(midnight.utcTime()).epochTime();
+        day_end = Poco::Timestamp::fromUtcTime(next_midnight.utcTime()).epochTime();
+    }
+
     std::vector<const TimelineEvent*> list;
     for (std::vector<TimelineEvent *>::const_iterator i =
         related.TimelineEvents.begin();
@@ -1504,16 +1571,9 @@ std::vector<const TimelineEvent*> User::CompressedTimeline(const Poco::LocalDate
             continue;
         }
 
-        if (date) {
-            // Check if timeline event occured on the
-            // required date:
-            Poco::LocalDateTime event_date(
-                Poco::Timestamp::fromEpochTime(event->Start()));
-            if (event_date.year() != date->year() ||
-                    event_date.month() != date->month() ||
-                    event_date.day() != date->day()) {
-                continue;
-            }
+        // Check if timeline event occured on the required date
+        if (date && (event->Start() < day_start || event->Start() >= day_end)) {
+            continue;
         }
         // Make a copy of the timeline event
         list.push_back(event);
@@ -6,10 +6,12 @@
 #include <map>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <json/json.h>  // NOLINT
 
+#include "instrumented_mutex.h"
 #include "model/base_model.h"
 #include "related_data.h"
 #include "types.h"
@@ -140,6 +142,7 @@ class TOGGL_INTERNAL_EXPORT User : public BaseModel {
     void RemoveTaskFromRelatedModels(Poco::UInt64 tid);
 
     error LoadUserUpdateFromJSONString(const std::string &json);
+    void LoadUserUpdateFromJSON(const Json::Value &node);
 
     error LoadUserAndRelatedDataFromJSONString(const std::string &json,
         bool including_related_data, bool syncServer);
@@ -158,6 +161,14 @@ class TOGGL_INTERNAL_EXPORT User : public BaseModel {
         const std::vector<const TimelineEvent*> &events);
     void CompressTimeline();
 
+    // Folds the event into the open chunk of its app and window title,
+    // taking ownership of it. Chunks of earlier periods are closed.
+    void AddTimelineEvent(TimelineEvent *event);
+
+    // Closes the chunks of past periods so they can be uploaded and
+    // deletes events too old to keep. Returns true if anything changed.
+    bool CloseTimelineChunks();
+
     std::vector<const TimelineEvent *> CompressedTimelineForUI(const Poco::LocalDateTime *date) const;
     std::vector<const TimelineEvent *> CompressedTimelineForUpload(const Poco::LocalDateTime *date = nullptr) const;
 
@@ -225,9 +236,6 @@ class TOGGL_INTERNAL_EXPORT User : public BaseModel {
         bool including_related_data,
         bool syncServer);
 
-    void loadUserUpdateFromJSON(
-        Json::Value list);
-
     void loadUserProjectFromJSON(
         Json::Value data,
         std::set<Poco::UInt64> *alive = nullptr,
@@ -268,7 +276,29 @@ class TOGGL_INTERNAL_EXPORT User : public BaseModel {
     std::vector<const TimelineEvent *> CompressedTimeline(
         const Poco::LocalDateTime *date = nullptr, bool is_for_upload = true) const;
 
-    Poco::Mutex loadTimeEntries_m_;
+    struct TimelineChunkKey {
+        std::string Filename;
+        std::string Title;
+        bool Idle;
+        Poco::Int64 ChunkStart;
+
+        bool operator==(const TimelineChunkKey &other) const;
+    };
+
+    struct TimelineChunkKeyHash {
+        std::size_t operator()(const TimelineChunkKey &key) const;
+    };
+
+    // Returns the chunk the event was folded into, or the event itself
+    // if it starts a new chunk
+    TimelineEvent *foldTimelineEvent(TimelineEvent *event);
+    bool closeTimelineChunks(const Poco::Int64 chunk_up_to);
+
+    // Chunks still collecting events, the only ones not marked as chunked
+    std::unordered_map<TimelineChunkKey, TimelineEvent *, TimelineChunkKeyHash>
+    open_timeline_chunks_;
+
+    InstrumentedMutex loadTimeEntries_m_ { "User::loadTimeEntries_m_" };
 };
 
 template<class T>
@@ -276,7 +306,7 @@ bool User::SetModelID(Poco::UInt64 id, T *model) {
     poco_check_ptr(model);
 
     {
-        Poco::Mutex::ScopedLock lock(loadTimeEntries_m_);
+        InstrumentedMutex::ScopedLock lock(loadTimeEntries_m_);
         auto otherModel = related.ModelByID<T>(id);
         if (otherModel && otherModel != model) {
             // this means that somehow we already have a time entry with the ID
@@ -11,6 +11,9 @@
 #include <Poco/Logger.h>
 #include <Poco/Net/HTTPCredentials.h>
 #include <Poco/Net/HTTPClientSession.h>
+#include <Poco/NumberParser.h>
+#include <Poco/String.h>
+#include <Poco/StringTokenizer.h>
 #include <Poco/URI.h>
 #include <Poco/UnicodeConverter.h>
 
@@ -26,6 +29,27 @@
 
 namespace toggl {
 
+Poco::Mutex Netconf::cache_m_;
+std::map<std::string, Netconf::ProxyResolution> Netconf::cache_;
+bool Netconf::environment_loaded_ = false;
+std::string Netconf::environment_proxy_ = "";
+std::string Netconf::no_proxy_ = "";
+
+namespace {
+
+// "https://api.toggl.com/api/v9/me" -> "https://api.toggl.com"
+std::string originOf(const std::string &url) {
+    std::string::size_type start = url.find("://");
+    if (start == std::string::npos) {
+        start = 0;
+    } else {
+        start += 3;
+    }
+    return url.substr(0, url.find_first_of("/?#", start));
+}
+
+}  // namespace
+
 error Netconf::autodetectProxy(
     const std::string &encoded_url,
     std::vector<std::string> *proxy_strings) {
@@ -94,25 +118,19 @@ error Netconf::autodetectProxy(
     return noError;
 }
 
-error Netconf::ConfigureProxy(
+error Netconf::resolveProxy(
     const std::string &encoded_url,
-    Poco::Net::HTTPClientSession *session) {
+    ProxyResolution *resolution) {
+
+    poco_assert(resolution);
 
     Logger logger { "ConfigureProxy" };
 
     std::string proxy_url("");
     if (HTTPClient::Config.AutodetectProxy) {
-        if (Poco::Environment::has("HTTPS_PROXY")) {
-            proxy_url = Poco::Environment::get("HTTPS_PROXY");
-        }
-        if (Poco::Environment::has("https_proxy")) {
-            proxy_url = Poco::Environment::get("https_proxy");
-        }
-        if (Poco::Environment::has("HTTP_PROXY")) {
-            proxy_url = Poco::Environment::get("HTTP_PROXY");
-        }
-        if (Poco::Environment::has("http_proxy")) {
-            proxy_url = Poco::Environment::get("http_proxy");
+        {
+            Poco::Mutex::ScopedLock lock(cache_m_);
+            proxy_url = environment_proxy_;
         }
         if (proxy_url.empty()) {
             std::vector<std::string> proxy_strings;
@@ -135,16 +153,15 @@ error Netconf::ConfigureProxy(
                          " host=", proxy_uri.getHost(),
                          " port=", proxy_uri.getPort());
 
-            session->setProxy(
-                proxy_uri.getHost(),
-                proxy_uri.getPort());
+            resolution->use_proxy = true;
+            resolution->host = proxy_uri.getHost();
+            resolution->port = proxy_uri.getPort();
 
             if (!proxy_uri.getUserInfo().empty()) {
                 Poco::Net::HTTPCredentials credentials;
                 credentials.fromUserInfo(proxy_uri.getUserInfo());
-                session->setProxyCredentials(
-                    credentials.getUsername(),
-                    credentials.getPassword());
+                resolution->username = credentials.getUsername();
+                resolution->password = credentials.getPassword();
 
                 logger.debug("Proxy credentials detected username=",
                              credentials.getUsername());
@@ -155,19 +172,18 @@ error Netconf::ConfigureProxy(
     // Try to use user-configured proxy
     if (proxy_url.empty() && HTTPClient::Config.UseProxy &&
             HTTPClient::Config.ProxySettings.IsConfigured()) {
-        session->setProxy(
-            HTTPClient::Config.ProxySettings.Host(),
-            static_cast<Poco::UInt16>(
-                HTTPClient::Config.ProxySettings.Port()));
+        resolution->use_proxy = true;
+        resolution->host = HTTPClient::Config.ProxySettings.Host();
+        resolution->port = static_cast<Poco::UInt16>(
+            HTTPClient::Config.ProxySettings.Port());
 
         logger.debug("Proxy configured ",
                      " host=", HTTPClient::Config.ProxySettings.Host(),
                      " port=", HTTPClient::Config.ProxySettings.Port());
 
         if (HTTPClient::Config.ProxySettings.HasCredentials()) {
-            session->setProxyCredentials(
-                HTTPClient::Config.ProxySettings.Username(),
-                HTTPClient::Config.ProxySettings.Password());
+            resolution->username = HTTPClient::Config.ProxySettings.Username();
+            resolution->password = HTTPClient::Config.ProxySettings.Password();
 
             logger.debug("Proxy credentials configured username=",
                          HTTPClient::Config.ProxySettings.Username());
@@ -177,4 +193,152 @@ error Netconf::ConfigureProxy(
     return noError;
 }
 
+error Netconf::ConfigureProxy(
+    const std::string &encoded_url,
+    Poco::Net::HTTPClientSession *session) {
+
+    std::string key = originOf(encoded_url);
+
+    ProxyResolution resolution;
+    bool cached(false);
+    std::string no_proxy("");
+    {
+        Poco::Mutex::ScopedLock lock(cache_m_);
+        loadEnvironment();
+        std::map<std::string, ProxyResolution>::const_iterator it =
+            cache_.find(key);
+        if (it != cache_.end()) {
+            resolution = it->second;
+            cached = true;
+        }
+        no_proxy = no_proxy_;
+    }
+
+    if (!cached) {
+        // Autodetection can take a while, so don't hold the lock
+        error err = resolveProxy(encoded_url, &resolution);
+        if (err != noError) {
+            return err;
+        }
+
+        if (resolution.use_proxy && !no_proxy.empty()) {
+            Poco::URI uri(key);
+            if (IsExcludedFromProxy(uri.getHost(), uri.getPort(), no_proxy)) {
+                Logger("ConfigureProxy").debug(
+                    "Not using proxy for ", key, ", excluded by NO_PROXY");
+                resolution = ProxyResolution();
+            }
+        }
+
+        Poco::Mutex::ScopedLock lock(cache_m_);
+        cache_[key] = resolution;
+    }
+
+    if (resolution.use_proxy) {
+        session->setProxy(resolution.host, resolution.port);
+        if (!resolution.username.empty()) {
+            session->setProxyCredentials(
+                resolution.username,
+                resolution.password);
+        }
+    }
+
+    return noError;
+}
+
+void Netconf::InvalidateProxyCache() {
+    Poco::Mutex::ScopedLock lock(cache_m_);
+    cache_.clear();
+    environment_loaded_ = false;
+}
+
+void Netconf::loadEnvironment() {
+    if (environment_loaded_) {
+        return;
+    }
+
+    // Later variables take precedence
+    static const char *kProxyVariables[] = {
+        "HTTPS_PROXY", "https_proxy", "HTTP_PROXY", "http_proxy"
+    };
+    static const char *kNoProxyVariables[] = {
+        "NO_PROXY", "no_proxy"
+    };
+
+    environment_proxy_ = "";
+    for (const char *name : kProxyVariables) {
+        std::string value = Poco::Environment::get(name, "");
+        if (!value.empty()) {
+            environment_proxy_ = value;
+        }
+    }
+    no_proxy_ = "";
+    for (const char *name : kNoProxyVariables) {
+        std::string value = Poco::Environment::get(name, "");
+        if (!value.empty()) {
+            no_proxy_ = value;
+        }
+    }
+
+    environment_loaded_ = true;
+}
+
+bool Netconf::IsExcludedFromProxy(
+    const std::string &host,
+    const Poco::UInt16 port,
+    const std::string &no_proxy) {
+
+    std::string lower_host = Poco::toLower(host);
+
+    Poco::StringTokenizer patterns(
+        no_proxy, ",",
+        Poco::StringTokenizer::TOK_TRIM |
+        Poco::StringTokenizer::TOK_IGNORE_EMPTY);
+    for (Poco::StringTokenizer::Iterator it = patterns.begin();
+            it != patterns.end();
+            ++it) {
+        std::string pattern = Poco::toLower(*it);
+        if ("*" == pattern) {
+            return true;
+        }
+
+        // "host:port" only matches that port. IPv6 addresses have
+        // more than one colon and can't be given a port here.
+        std::string::size_type colon = pattern.find(':');
+        if (colon != std::string::npos && colon == pattern.rfind(':')) {
+            unsigned pattern_port(0);
+            if (!Poco::NumberParser::tryParseUnsigned(
+                    pattern.substr(colon + 1), pattern_port)
+                    || pattern_port != port) {
+                continue;
+            }
+            pattern = pattern.substr(0, colon);
+        }
+
+        // "*.toggl.com", ".toggl.com" and "toggl.com" all match
+        // toggl.com and any of its subdomains
+        if (pattern.find("*.") == 0) {
+            pattern = pattern.substr(1);
+        }
+        if (pattern.find('.') == 0) {
+            pattern = pattern.substr(1);
+        }
+        if (pattern.empty()) {
+            continue;
+        }
+
+        if (lower_host == pattern) {
+            return true;
+        }
+        if (lower_host.size() > pattern.size()
+                && lower_host.compare(lower_host.size() - pattern.size(),
+                                      pattern.size(), pattern) == 0
+                && lower_host[lower_host.size() - pattern.size() - 1] == '.') {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 }   // namespace toggl
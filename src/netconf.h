@@ -3,11 +3,15 @@
 #ifndef SRC_NETCONF_H_
 #define SRC_NETCONF_H_
 
+#include <map>
 #include <string>
 #include <vector>
 
 #include "types.h"
 
+#include <Poco/Mutex.h>
+#include <Poco/Types.h>
+
 namespace Poco {
 
 namespace Net {
@@ -29,10 +33,47 @@ class TOGGL_INTERNAL_EXPORT Netconf {
         const std::string &encoded_url,
         Poco::Net::HTTPClientSession *session);
 
+    // Forget the resolved proxies, so that they're looked up again
+    // on the next request. Call when the network or settings change.
+    static void InvalidateProxyCache();
+
+    // Checks the host against comma separated NO_PROXY patterns
+    static bool IsExcludedFromProxy(
+        const std::string &host,
+        const Poco::UInt16 port,
+        const std::string &no_proxy);
+
  private:
+    class ProxyResolution {
+     public:
+        ProxyResolution()
+            : use_proxy(false)
+        , port(0) {}
+
+        bool use_proxy;
+        std::string host;
+        Poco::UInt16 port;
+        std::string username;
+        std::string password;
+    };
+
+    static error resolveProxy(
+        const std::string &encoded_url,
+        ProxyResolution *resolution);
+
     static error autodetectProxy(
         const std::string &encoded_url,
         std::vector<std::string> *proxy_strings);
+
+    static void loadEnvironment();
+
+    static Poco::Mutex cache_m_;
+    // Resolved proxy by scheme, host and port of the request
+    static std::map<std::string, ProxyResolution> cache_;
+
+    static bool environment_loaded_;
+    static std::string environment_proxy_;
+    static std::string no_proxy_;
 };
 
 }  // namespace toggl
@@ -0,0 +1,65 @@
+// Copyright 2020 Toggl Desktop developers.
+
+#include "outbox.h"
+
+#include <string>
+#include <vector>
+
+namespace toggl {
+
+void Outbox::Reset(const Poco::UInt64 uid) {
+    uid_ = uid;
+    order_.clear();
+    entries_.clear();
+}
+
+void Outbox::Add(
+    const Poco::Int64 seq,
+    const std::string &model_type,
+    const std::string &GUID) {
+
+    std::map<std::string, OutboxEntry>::iterator it = entries_.find(GUID);
+    if (it != entries_.end()) {
+        // Already queued, keep its place in line
+        if (seq > it->second.LastSeq) {
+            it->second.LastSeq = seq;
+        }
+        return;
+    }
+
+    OutboxEntry &entry = entries_[GUID];
+    entry.Seq = seq;
+    entry.LastSeq = seq;
+    entry.ModelType = model_type;
+    entry.GUID = GUID;
+    order_[seq] = GUID;
+}
+
+bool Outbox::Remove(
+    const std::string &GUID,
+    const Poco::Int64 up_to_seq) {
+
+    std::map<std::string, OutboxEntry>::iterator it = entries_.find(GUID);
+    if (it == entries_.end()) {
+        return false;
+    }
+    if (it->second.LastSeq > up_to_seq) {
+        return false;
+    }
+    order_.erase(it->second.Seq);
+    entries_.erase(it);
+    return true;
+}
+
+std::vector<OutboxEntry> Outbox::Entries() const {
+    std::vector<OutboxEntry> result;
+    result.reserve(order_.size());
+    for (std::map<Poco::Int64, std::string>::const_iterator it = order_.begin();
+            it != order_.end();
+            ++it) {
+        result.push_back(entries_.find(it->second)->second);
+    }
+    return result;
+}
+
+}  // namespace toggl
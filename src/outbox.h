@@ -0,0 +1,73 @@
+// Copyright 2020 Toggl Desktop developers.
+
+#ifndef SRC_OUTBOX_H_
+#define SRC_OUTBOX_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "types.h"
+
+#include <Poco/Types.h>
+
+namespace toggl {
+
+class TOGGL_INTERNAL_EXPORT OutboxEntry {
+ public:
+    OutboxEntry()
+        : Seq(0)
+    , LastSeq(0) {}
+
+    // Ordering key of the first edit still waiting to be pushed
+    Poco::Int64 Seq;
+    // Ordering key of the latest edit
+    Poco::Int64 LastSeq;
+    std::string ModelType;
+    std::string GUID;
+};
+
+// In-memory view of the user's outbox table: the models the user has
+// changed and that still need to be pushed, in the order of the first
+// change. Further edits of a queued model are merged into its entry.
+class TOGGL_INTERNAL_EXPORT Outbox {
+ public:
+    Outbox()
+        : uid_(0) {}
+    ~Outbox() {}
+
+    // Empties the queue and ties it to another user
+    void Reset(const Poco::UInt64 uid);
+
+    Poco::UInt64 UID() const {
+        return uid_;
+    }
+
+    void Add(
+        const Poco::Int64 seq,
+        const std::string &model_type,
+        const std::string &GUID);
+
+    // Drops the entry, unless the model was edited again after up_to_seq
+    bool Remove(
+        const std::string &GUID,
+        const Poco::Int64 up_to_seq);
+
+    // Queued entries, oldest first
+    std::vector<OutboxEntry> Entries() const;
+
+    std::size_t Size() const {
+        return entries_.size();
+    }
+
+ private:
+    Poco::UInt64 uid_;
+
+    // First seq -> GUID, gives the push order
+    std::map<Poco::Int64, std::string> order_;
+    std::map<std::string, OutboxEntry> entries_;
+};
+
+}  // namespace toggl
+
+#endif  // SRC_OUTBOX_H_
@@ -29,12 +29,12 @@ void clearList(std::vector<T *> *list) {
 }
 
 void RelatedData::forEachTimeEntries(std::function<void(TimeEntry *)> f) {
-    Poco::Mutex::ScopedLock lock(timeEntries_m_);
+    InstrumentedMutex::ScopedLock lock(timeEntries_m_);
     std::for_each(TimeEntries.begin(), TimeEntries.end(), f);
 }
 
 void RelatedData::pushBackTimeEntry(TimeEntry *timeEntry) {
-    Poco::Mutex::ScopedLock lock(timeEntries_m_);
+    InstrumentedMutex::ScopedLock lock(timeEntries_m_);
     TimeEntries.push_back(timeEntry);
 }
 
@@ -47,6 +47,8 @@ void RelatedData::Clear() {
     clearList(&TimeEntries);
     clearList(&AutotrackerRules);
     clearList(&TimelineEvents);
+    AutotrackerRulesChanged();
+    ProjectsChanged();
 }
 
 error RelatedData::DeleteAutotrackerRule(const Poco::Int64 local_id) {
@@ -62,6 +64,7 @@ error RelatedData::DeleteAutotrackerRule(const Poco::Int64 local_id) {
         if (rule->LocalID() == local_id) {
             rule->MarkAsDeletedOnServer();
             rule->Delete();
+            AutotrackerRulesChanged();
             break;
         }
     }
@@ -70,15 +73,38 @@ error RelatedData::DeleteAutotrackerRule(const Poco::Int64 local_id) {
 
 AutotrackerRule *RelatedData::FindAutotrackerRule(
     const TimelineEvent &event) const {
-    for (std::vector<AutotrackerRule *>::const_iterator it =
-        AutotrackerRules.begin();
-            it != AutotrackerRules.end(); ++it) {
-        AutotrackerRule *rule = *it;
-        if (rule->Matches(event)) {
-            return rule;
-        }
+    if (autotracker_matcher_version_ != autotracker_rules_version_) {
+        autotracker_matcher_.Build(AutotrackerRules);
+        autotracker_matcher_version_ = autotracker_rules_version_;
     }
-    return nullptr;
+    return autotracker_matcher_.Find(event);
+}
+
+AutotrackerMatch RelatedData::MatchAutotrackerEvent(
+    const TimelineEvent &event) const {
+    if (autotracker_cache_rules_version_ != autotracker_rules_version_
+            || autotracker_cache_projects_version_ != projects_version_) {
+        autotracker_cache_.Clear();
+        autotracker_cache_rules_version_ = autotracker_rules_version_;
+        autotracker_cache_projects_version_ = projects_version_;
+    }
+
+    const AutotrackerMatch *cached =
+        autotracker_cache_.Find(event.Filename(), event.Title());
+    if (cached) {
+        return *cached;
+    }
+
+    AutotrackerMatch match;
+    match.Rule = FindAutotrackerRule(event);
+    if (match.Rule && match.Rule->PID()) {
+        match.RuleProject = ProjectByID(match.Rule->PID());
+    }
+    if (match.Rule && match.Rule->TID()) {
+        match.RuleTask = TaskByID(match.Rule->TID());
+    }
+    autotracker_cache_.Insert(event.Filename(), event.Title(), match);
+    return match;
 }
 
 bool RelatedData::HasMatchingAutotrackerRule(
@@ -9,15 +9,15 @@
 #include <map>
 #include <functional>
 
+#include "instrumented_mutex.h"
+#include "model/autotracker.h"
 #include "model/timeline_event.h"
 #include "types.h"
 
-#include <Poco/Mutex.h>
 #include <functional>
 
 namespace toggl {
 
-class AutotrackerRule;
 class Client;
 class Project;
 class Tag;
@@ -37,6 +37,13 @@ T *modelByGUID(const guid GUID, std::vector<T *> const *list);
 
 class TOGGL_INTERNAL_EXPORT RelatedData {
  public:
+    RelatedData()
+        : autotracker_rules_version_(0)
+    , projects_version_(0)
+    , autotracker_matcher_version_(0)
+    , autotracker_cache_rules_version_(0)
+    , autotracker_cache_projects_version_(0) {}
+
     std::vector<Workspace *> Workspaces;
     std::vector<Client *> Clients;
     std::vector<Project *> Projects;
@@ -98,6 +105,28 @@ class TOGGL_INTERNAL_EXPORT RelatedData {
 
     AutotrackerRule *FindAutotrackerRule(const TimelineEvent &event) const;
 
+    // Call after adding, deleting or loading autotracker rules
+    void AutotrackerRulesChanged() {
+        autotracker_rules_version_++;
+    }
+    Poco::UInt64 AutotrackerRulesVersion() const {
+        return autotracker_rules_version_;
+    }
+
+    // Call after projects or tasks have been added, deleted or
+    // have had their IDs changed
+    void ProjectsChanged() {
+        projects_version_++;
+    }
+
+    // The rule for the window with its project and task, remembered
+    // until the rules, projects or tasks change
+    AutotrackerMatch MatchAutotrackerEvent(const TimelineEvent &event) const;
+
+    AutotrackerCacheStats AutotrackerStats() const {
+        return autotracker_cache_.Stats();
+    }
+
     Client *clientByProject(Project *p) const;
 
     void pushBackTimeEntry(TimeEntry  *timeEntry);
@@ -105,7 +134,19 @@ class TOGGL_INTERNAL_EXPORT RelatedData {
     void forEachTimeEntries(std::function<void(TimeEntry *)> f);
 
  private:
-    Poco::Mutex timeEntries_m_;
+    InstrumentedMutex timeEntries_m_ { "RelatedData::timeEntries_m_" };
+
+    Poco::UInt64 autotracker_rules_version_;
+    Poco::UInt64 projects_version_;
+
+    // Compiled rules, rebuilt on first use after they have changed
+    mutable AutotrackerMatcher autotracker_matcher_;
+    mutable Poco::UInt64 autotracker_matcher_version_;
+
+    // Cleared on first use after the rules, projects or tasks changed
+    mutable AutotrackerCache autotracker_cache_;
+    mutable Poco::UInt64 autotracker_cache_rules_version_;
+    mutable Poco::UInt64 autotracker_cache_projects_version_;
 
     void timeEntryAutocompleteItems(
         std::set<std::string> *unique_names,
@@ -0,0 +1,89 @@
+// Copyright 2020 Toggl Desktop developers.
+
+#include "render_dispatcher.h"
+
+namespace toggl {
+
+RenderDispatcher::RenderDispatcher(const Poco::Timespan &interval)
+    : interval_(interval)
+, stopped_(false)
+, waiting_(false)
+, pending_(false) {}
+
+bool RenderDispatcher::Request(const UIElements &what) {
+    Poco::Mutex::ScopedLock lock(mutex_);
+
+    stats_.Requests++;
+
+    if (stopped_ || interval_ == Poco::Timespan(0)) {
+        stats_.Frames++;
+        return true;
+    }
+
+    if (pending_) {
+        frame_.Merge(what);
+        stats_.Merged++;
+        return false;
+    }
+
+    frame_ = what;
+    frame_due_.update();
+    frame_due_ += interval_;
+    pending_ = true;
+
+    wakeup_.signal();
+    return false;
+}
+
+bool RenderDispatcher::Wait(UIElements *frame) {
+    poco_check_ptr(frame);
+
+    Poco::Mutex::ScopedLock lock(mutex_);
+
+    waiting_ = true;
+    while (!stopped_) {
+        if (!pending_) {
+            wakeup_.wait(mutex_);
+            continue;
+        }
+
+        Poco::Timestamp now;
+        if (frame_due_ <= now) {
+            *frame = frame_;
+            frame_ = UIElements();
+            pending_ = false;
+            waiting_ = false;
+            stats_.Frames++;
+            return true;
+        }
+
+        long millis = static_cast<long>((frame_due_ - now) / 1000) + 1;  // NOLINT
+        wakeup_.tryWait(mutex_, millis);
+    }
+
+    waiting_ = false;
+    return false;
+}
+
+void RenderDispatcher::Stop() {
+    Poco::Mutex::ScopedLock lock(mutex_);
+    stopped_ = true;
+    wakeup_.broadcast();
+}
+
+void RenderDispatcher::SetInterval(const Poco::Timespan &interval) {
+    Poco::Mutex::ScopedLock lock(mutex_);
+    interval_ = interval;
+}
+
+bool RenderDispatcher::Idle() {
+    Poco::Mutex::ScopedLock lock(mutex_);
+    return waiting_ && !pending_;
+}
+
+RenderDispatcherStats RenderDispatcher::Stats() {
+    Poco::Mutex::ScopedLock lock(mutex_);
+    return stats_;
+}
+
+}  // namespace toggl
@@ -0,0 +1,85 @@
+// Copyright 2020 Toggl Desktop developers.
+
+#ifndef SRC_RENDER_DISPATCHER_H_
+#define SRC_RENDER_DISPATCHER_H_
+
+#include "const.h"
+#include "types.h"
+#include "ui_elements.h"
+
+#include <Poco/Condition.h>
+#include <Poco/Mutex.h>
+#include <Poco/Timespan.h>
+#include <Poco/Timestamp.h>
+
+namespace toggl {
+
+class TOGGL_INTERNAL_EXPORT RenderDispatcherStats {
+ public:
+    RenderDispatcherStats()
+        : Requests(0)
+    , Frames(0)
+    , Merged(0) {}
+
+    // Render requests received
+    Poco::UInt64 Requests;
+    // Collection passes run for them
+    Poco::UInt64 Frames;
+    // Requests that joined a frame requested before
+    Poco::UInt64 Merged;
+};
+
+/*
+ * Renders the UI at most once a frame.
+ *
+ * The first render request starts a frame, everything requested until
+ * the frame interval is over is merged into it (see UIElements::Merge).
+ * The render thread sleeps in Wait() until a frame is due and then
+ * collects the data and calls the UI callbacks once for all of them.
+ *
+ * With a zero interval, or once the dispatcher is stopped, callers
+ * render their requests right away themselves.
+ */
+class TOGGL_INTERNAL_EXPORT RenderDispatcher {
+ public:
+    explicit RenderDispatcher(
+        const Poco::Timespan &interval = Poco::Timespan(kRenderFrameMillis * Poco::Timespan::MILLISECONDS));
+    ~RenderDispatcher() {}
+
+    // Adds the request to the next frame. Returns true
+    // when the caller has to render it right away instead.
+    bool Request(const UIElements &what);
+
+    // Blocks until a frame is due and hands it out,
+    // returns false once the dispatcher is stopped
+    bool Wait(UIElements *frame);
+
+    // Wakes up Wait() for good
+    void Stop();
+
+    void SetInterval(const Poco::Timespan &interval);
+
+    // Nothing to render, and the render thread is waiting for requests
+    bool Idle();
+
+    RenderDispatcherStats Stats();
+
+ private:
+    Poco::Timespan interval_;
+
+    Poco::Mutex mutex_;
+    Poco::Condition wakeup_;
+
+    bool stopped_;
+    bool waiting_;
+
+    bool pending_;
+    UIElements frame_;
+    Poco::Timestamp frame_due_;
+
+    RenderDispatcherStats stats_;
+};
+
+}  // namespace toggl
+
+#endif  // SRC_RENDER_DISPATCHER_H_
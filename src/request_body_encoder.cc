@@ -0,0 +1,104 @@
+// Copyright 2020 Toggl Desktop developers.
+
+#include "request_body_encoder.h"
+
+#include <string>
+
+// Pulls in zlib.h, either the system one or the copy bundled with Poco
+#include <Poco/DeflatingStream.h>
+
+namespace toggl {
+
+namespace {
+
+const int kGzipWindowBits = 15 + 16;
+const int kMemLevel = 8;
+
+}  // namespace
+
+RequestBodyEncoder::RequestBodyEncoder(const std::size_t threshold)
+    : threshold_(threshold)
+, stream_(nullptr)
+, compressed_(false)
+, data_(nullptr)
+, size_(0) {}
+
+RequestBodyEncoder::~RequestBodyEncoder() {
+    if (stream_) {
+        z_stream *stream = static_cast<z_stream *>(stream_);
+        deflateEnd(stream);
+        delete stream;
+    }
+}
+
+RequestBodyEncoder &RequestBodyEncoder::ForCurrentThread() {
+    static thread_local RequestBodyEncoder encoder;
+    return encoder;
+}
+
+error RequestBodyEncoder::init() {
+    if (stream_) {
+        if (deflateReset(static_cast<z_stream *>(stream_)) != Z_OK) {
+            return error("Failed to reset gzip encoder");
+        }
+        return noError;
+    }
+
+    z_stream *stream = new z_stream;
+    stream->zalloc = Z_NULL;
+    stream->zfree = Z_NULL;
+    stream->opaque = Z_NULL;
+    if (deflateInit2(stream,
+                     Z_DEFAULT_COMPRESSION,
+                     Z_DEFLATED,
+                     kGzipWindowBits,
+                     kMemLevel,
+                     Z_DEFAULT_STRATEGY) != Z_OK) {
+        delete stream;
+        return error("Failed to initialize gzip encoder");
+    }
+    stream_ = stream;
+    return noError;
+}
+
+error RequestBodyEncoder::Encode(const std::string &payload) {
+    compressed_ = false;
+    data_ = payload.data();
+    size_ = payload.size();
+
+    if (payload.size() < threshold_) {
+        return noError;
+    }
+
+    error err = init();
+    if (err != noError) {
+        return err;
+    }
+
+    z_stream *stream = static_cast<z_stream *>(stream_);
+
+    // deflateBound accounts for the gzip wrapper, so a single
+    // Z_FINISH call always fits into the buffer
+    uLong bound = deflateBound(stream, static_cast<uLong>(payload.size()));
+    if (buffer_.size() < bound) {
+        buffer_.resize(bound);
+    }
+
+    stream->next_in = reinterpret_cast<Bytef *>(
+        const_cast<char *>(payload.data()));
+    stream->avail_in = static_cast<uInt>(payload.size());
+    stream->next_out = reinterpret_cast<Bytef *>(buffer_.data());
+    stream->avail_out = static_cast<uInt>(buffer_.size());
+
+    if (deflate(stream, Z_FINISH) != Z_STREAM_END) {
+        return error("Failed to gzip request body");
+    }
+
+    compressed_ = true;
+    data_ = buffer_.data();
+    size_ = stream->total_out;
+
+    return noError;
+}
+
+}  // namespace toggl
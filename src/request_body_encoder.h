@@ -0,0 +1,72 @@
+// Copyright 2020 Toggl Desktop developers.
+
+#ifndef SRC_REQUEST_BODY_ENCODER_H_
+#define SRC_REQUEST_BODY_ENCODER_H_
+
+#include <string>
+#include <vector>
+
+#include "const.h"
+#include "types.h"
+
+#include <Poco/Types.h>
+
+namespace toggl {
+
+/*
+ * Encodes HTTP request bodies for upload.
+ *
+ * Payloads at or above the threshold are gzipped in a single pass into a
+ * buffer owned by the encoder, smaller ones are passed through as they are.
+ * The deflate state and the output buffer are kept between calls, so one
+ * encoder per thread (see ForCurrentThread) avoids reallocating both for
+ * every request.
+ */
+class TOGGL_INTERNAL_EXPORT RequestBodyEncoder {
+ public:
+    explicit RequestBodyEncoder(
+        const std::size_t threshold = kRequestBodyGzipThresholdBytes);
+    ~RequestBodyEncoder();
+
+    RequestBodyEncoder(const RequestBodyEncoder &) = delete;
+    RequestBodyEncoder &operator=(const RequestBodyEncoder &) = delete;
+
+    // Encoder reused by every request made from the calling thread
+    static RequestBodyEncoder &ForCurrentThread();
+
+    // Prepares the payload for sending. The payload must outlive
+    // the following Data() call when it's not compressed.
+    error Encode(const std::string &payload);
+
+    bool Compressed() const {
+        return compressed_;
+    }
+    const char *Data() const {
+        return data_;
+    }
+    std::size_t Size() const {
+        return size_;
+    }
+
+    std::size_t Threshold() const {
+        return threshold_;
+    }
+
+ private:
+    error init();
+
+    std::size_t threshold_;
+
+    // zlib z_stream, kept opaque so zlib headers don't leak into the API
+    void *stream_;
+
+    std::vector<char> buffer_;
+
+    bool compressed_;
+    const char *data_;
+    std::size_t size_;
+};
+
+}  // namespace toggl
+
+#endif  // SRC_REQUEST_BODY_ENCODER_H_
@@ -0,0 +1,238 @@
+// Copyright 2020 Toggl Desktop developers.
+
+#include "request_scheduler.h"
+
+#include <algorithm>
+#include <string>
+
+#include "const.h"
+#include "util/formatter.h"
+
+#include <Poco/DateTime.h>
+#include <Poco/DateTimeFormat.h>
+#include <Poco/DateTimeParser.h>
+#include <Poco/NumberParser.h>
+#include <Poco/String.h>
+
+namespace toggl {
+
+const double RequestScheduler::kDefaultRequestsPerSecond = 10.0;
+const double RequestScheduler::kDefaultBurst = 20.0;
+const double RequestScheduler::kMinRequestsPerSecond = 0.1;
+
+namespace {
+
+// Rate regained with every successful response after being throttled
+const double kRateIncreaseStep = 0.5;
+
+// Ban used when a 429 response didn't say how long to wait,
+// doubled with every consecutive 429 up to kMaxRateLimitBanSeconds
+const Poco::Int64 kDefaultRateLimitBanSeconds = 60;
+const Poco::Int64 kMaxRateLimitBanSeconds = 15 * 60;
+
+}  // namespace
+
+RequestScheduler::RequestScheduler(
+    const double requests_per_second,
+    const double burst)
+    : max_rate_(requests_per_second)
+, burst_(std::max(1.0, burst)) {
+    for (int i = 0; i < kRequestPriorityCount; i++) {
+        delayed_[i] = 0;
+    }
+}
+
+RequestScheduler &RequestScheduler::Instance() {
+    static RequestScheduler instance;
+    return instance;
+}
+
+Logger RequestScheduler::logger() const {
+    return { "RequestScheduler" };
+}
+
+RequestScheduler::HostState &RequestScheduler::host(const std::string &name) {
+    std::map<std::string, HostState>::iterator it = hosts_.find(name);
+    if (it != hosts_.end()) {
+        return it->second;
+    }
+    HostState &state = hosts_[name];
+    state.tokens = burst_;
+    state.rate = max_rate_;
+    state.refilled_at = now();
+    return state;
+}
+
+void RequestScheduler::refill(
+    HostState *state,
+    const Poco::Timestamp &now) const {
+    Poco::Timestamp::TimeDiff elapsed = now - state->refilled_at;
+    if (elapsed <= 0) {
+        return;
+    }
+    state->tokens = std::min(burst_,
+                             state->tokens + state->rate * elapsed / kOneSecondInMicros);
+    state->refilled_at = now;
+}
+
+bool RequestScheduler::isNext(
+    const HostState &state,
+    const Waiter *waiter) const {
+    for (int i = 0; i < waiter->priority; i++) {
+        if (!state.waiting[i].empty()) {
+            return false;
+        }
+    }
+    return state.waiting[waiter->priority].front() == waiter;
+}
+
+void RequestScheduler::dequeue(HostState *state, Waiter *waiter) {
+    state->waiting[waiter->priority].remove(waiter);
+    changed_.broadcast();
+}
+
+void RequestScheduler::wakeWaiters() {
+    Poco::Mutex::ScopedLock lock(mutex_);
+    changed_.broadcast();
+}
+
+error RequestScheduler::Acquire(
+    const std::string &host_name,
+    const RequestPriority priority,
+    const Poco::Timespan &timeout) {
+
+    Poco::Mutex::ScopedLock lock(mutex_);
+
+    HostState &state = host(host_name);
+
+    Poco::Timestamp now = this->now();
+    Poco::Timestamp deadline = now + timeout.totalMicroseconds();
+
+    Waiter waiter;
+    waiter.priority = priority;
+    state.waiting[priority].push_back(&waiter);
+
+    bool delayed = false;
+    while (true) {
+        now = this->now();
+
+        if (state.banned_until > now) {
+            dequeue(&state, &waiter);
+            logger().warning("Cannot connect to ", host_name,
+                             ", because we made too many requests. Banned until ",
+                             Formatter::Format8601(state.banned_until));
+            return kCannotConnectError;
+        }
+
+        refill(&state, now);
+
+        bool next = isNext(state, &waiter);
+        if (next && state.tokens >= 1) {
+            state.tokens -= 1;
+            dequeue(&state, &waiter);
+            return noError;
+        }
+
+        if (now >= deadline) {
+            dequeue(&state, &waiter);
+            logger().warning("Gave up waiting for a request slot to ", host_name,
+                             ", priority ", priority);
+            return kCannotConnectError;
+        }
+
+        if (!delayed) {
+            delayed = true;
+            delayed_[priority]++;
+        }
+
+        // Sleep until the next token is due, or until
+        // someone ahead of us in the queue is done
+        Poco::Timestamp::TimeDiff wait = deadline - now;
+        if (next) {
+            wait = std::min(wait, static_cast<Poco::Timestamp::TimeDiff>(
+                (1 - state.tokens) / state.rate * kOneSecondInMicros));
+        }
+        changed_.tryWait(mutex_, std::max(1L, static_cast<long>(wait / 1000)));
+    }
+}
+
+void RequestScheduler::Complete(
+    const std::string &host_name,
+    const Poco::Int64 status_code,
+    const std::string &retry_after) {
+
+    Poco::Mutex::ScopedLock lock(mutex_);
+
+    HostState &state = host(host_name);
+
+    if (429 == status_code) {
+        state.consecutive_rate_limits++;
+        state.rate = std::max(kMinRequestsPerSecond, state.rate / 2);
+        state.tokens = 0;
+
+        Poco::Timespan ban = ParseRetryAfter(retry_after);
+        if (!ban.totalMicroseconds()) {
+            Poco::Int64 seconds = kDefaultRateLimitBanSeconds
+                                  << std::min(state.consecutive_rate_limits - 1, 4);
+            ban = Poco::Timespan(
+                std::min(seconds, kMaxRateLimitBanSeconds), 0);
+        }
+        state.banned_until = now() + ban.totalMicroseconds();
+
+        logger().debug("Server indicated we're making too many requests to host ", host_name,
+                       ". So we cannot make new requests until ", Formatter::Format8601(state.banned_until),
+                       ", rate lowered to ", state.rate, " requests per second");
+
+        changed_.broadcast();
+        return;
+    }
+
+    if (status_code >= 200 && status_code < 400) {
+        state.consecutive_rate_limits = 0;
+        state.rate = std::min(max_rate_, state.rate + kRateIncreaseStep);
+    }
+}
+
+Poco::Timespan RequestScheduler::BannedFor(const std::string &host_name) {
+    Poco::Mutex::ScopedLock lock(mutex_);
+    Poco::Timestamp::TimeDiff left = host(host_name).banned_until - now();
+    return Poco::Timespan(std::max(left, static_cast<Poco::Timestamp::TimeDiff>(0)));
+}
+
+double RequestScheduler::Rate(const std::string &host_name) {
+    Poco::Mutex::ScopedLock lock(mutex_);
+    return host(host_name).rate;
+}
+
+Poco::UInt64 RequestScheduler::Delayed(const RequestPriority priority) {
+    Poco::Mutex::ScopedLock lock(mutex_);
+    return delayed_[priority];
+}
+
+Poco::Timespan RequestScheduler::ParseRetryAfter(const std::string &value) {
+    std::string trimmed = Poco::trim(value);
+    if (trimmed.empty()) {
+        return Poco::Timespan();
+    }
+
+    // Either delay-seconds..
+    Poco::UInt64 seconds(0);
+    if (Poco::NumberParser::tryParseUnsigned64(trimmed, seconds)) {
+        return Poco::Timespan(static_cast<long>(seconds), 0);
+    }
+
+    // ..or a HTTP-date
+    Poco::DateTime date;
+    int tzd(0);
+    if (Poco::DateTimeParser::tryParse(
+            Poco::DateTimeFormat::HTTP_FORMAT, trimmed, date, tzd)) {
+        Poco::Timestamp::TimeDiff left = date.timestamp() - Poco::Timestamp();
+        if (left > 0) {
+            return Poco::Timespan(left);
+        }
+    }
+
+    return Poco::Timespan();
+}
+
+}  // namespace toggl
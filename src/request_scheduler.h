@@ -0,0 +1,132 @@
+// Copyright 2020 Toggl Desktop developers.
+
+#ifndef SRC_REQUEST_SCHEDULER_H_
+#define SRC_REQUEST_SCHEDULER_H_
+
+#include <list>
+#include <map>
+#include <string>
+
+#include "types.h"
+#include "util/logger.h"
+
+#include <Poco/Condition.h>
+#include <Poco/Mutex.h>
+#include <Poco/Timespan.h>
+#include <Poco/Timestamp.h>
+
+namespace toggl {
+
+// Lower value is served first
+enum RequestPriority {
+    // Something the user is waiting for: login, pushing edits, pulling data
+    kRequestPriorityInteractive = 0,
+    // Secondary sync data that can lag behind a bit
+    kRequestPrioritySync = 1,
+    // Analytics, timeline uploads, update and message checks
+    kRequestPriorityBackground = 2
+};
+
+const int kRequestPriorityCount = 3;
+
+/*
+ * Decides when a HTTP request may be sent.
+ *
+ * Every host gets a token bucket. Each request takes one token, tokens refill
+ * at a rate that is halved when the server answers 429 and grows back slowly
+ * on successful responses. A 429 also bans the host for as long as the
+ * Retry-After header says.
+ *
+ * When requests have to wait for a token, they are let through strictly by
+ * priority and in arrival order within the same priority, so background
+ * traffic never delays the requests the user is waiting for.
+ */
+class TOGGL_INTERNAL_EXPORT RequestScheduler {
+ public:
+    RequestScheduler(
+        const double requests_per_second = kDefaultRequestsPerSecond,
+        const double burst = kDefaultBurst);
+    virtual ~RequestScheduler() {}
+
+    static RequestScheduler &Instance();
+
+    // Blocks until the request may be sent to the host. Fails right away when
+    // the host has banned us, or when the request would wait longer than
+    // the timeout.
+    error Acquire(
+        const std::string &host,
+        const RequestPriority priority,
+        const Poco::Timespan &timeout);
+
+    // Tunes the host's rate from the response. Pass the Retry-After
+    // header value, if the response had any.
+    void Complete(
+        const std::string &host,
+        const Poco::Int64 status_code,
+        const std::string &retry_after = "");
+
+    // Time left until the host accepts requests again, zero if not banned
+    Poco::Timespan BannedFor(const std::string &host);
+
+    // Current refill rate of the host, in requests per second
+    double Rate(const std::string &host);
+
+    // Number of requests that had to wait for a token, by priority
+    Poco::UInt64 Delayed(const RequestPriority priority);
+
+    static Poco::Timespan ParseRetryAfter(const std::string &value);
+
+    static const double kDefaultRequestsPerSecond;
+    static const double kDefaultBurst;
+    static const double kMinRequestsPerSecond;
+
+ protected:
+    // Time the token buckets and bans are measured in
+    virtual Poco::Timestamp now() const {
+        return Poco::Timestamp();
+    }
+
+    // Has the waiting requests look at the time again
+    void wakeWaiters();
+
+ private:
+    struct Waiter {
+        RequestPriority priority;
+    };
+
+    struct HostState {
+        HostState()
+            : tokens(0)
+        , rate(0)
+        , banned_until(0)
+        , consecutive_rate_limits(0) {}
+
+        double tokens;
+        double rate;
+        Poco::Timestamp refilled_at;
+        Poco::Timestamp banned_until;
+        int consecutive_rate_limits;
+        std::list<Waiter *> waiting[kRequestPriorityCount];
+    };
+
+    HostState &host(const std::string &name);
+    void refill(HostState *state, const Poco::Timestamp &now) const;
+    bool isNext(const HostState &state, const Waiter *waiter) const;
+    void dequeue(HostState *state, Waiter *waiter);
+
+    Logger logger() const;
+
+    const double max_rate_;
+    const double burst_;
+
+    Poco::Mutex mutex_;
+    Poco::Condition changed_;
+
+    std::map<std::string, HostState> hosts_;
+
+    Poco::UInt64 delayed_[kRequestPriorityCount];
+};
+
+}  // namespace toggl
+
+#endif  // SRC_REQUEST_SCHEDULER_H_
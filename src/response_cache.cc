@@ -0,0 +1,81 @@
+// Copyright 2020 Toggl Desktop developers.
+
+#include "response_cache.h"
+
+#include <string>
+
+#include "https_client.h"
+
+namespace toggl {
+
+std::string ResponseCache::key(const HTTPRequest &req) {
+    return req.basic_auth_username + " " + req.host + req.relative_url;
+}
+
+void ResponseCache::Prepare(HTTPRequest *req) {
+    Poco::Mutex::ScopedLock lock(mutex_);
+
+    std::map<std::string, Entry>::const_iterator it = entries_.find(key(*req));
+    if (it == entries_.end()) {
+        return;
+    }
+    req->if_none_match = it->second.ETag;
+    cycle_.Requests++;
+    total_.Requests++;
+}
+
+void ResponseCache::Complete(const HTTPRequest &req, HTTPResponse *resp) {
+    Poco::Mutex::ScopedLock lock(mutex_);
+
+    std::string k = key(req);
+
+    if (resp->NotModified()) {
+        std::map<std::string, Entry>::const_iterator it = entries_.find(k);
+        if (it == entries_.end() || req.if_none_match.empty()) {
+            // Nothing to fall back on, shouldn't happen as
+            // we only revalidate what we have
+            resp->err = error(kCannotConnectError);
+            return;
+        }
+        resp->body = it->second.Body;
+        cycle_.NotModified++;
+        cycle_.BytesSaved += resp->body.size();
+        total_.NotModified++;
+        total_.BytesSaved += resp->body.size();
+        return;
+    }
+
+    if (resp->err != noError) {
+        return;
+    }
+    if (resp->etag.empty()) {
+        entries_.erase(k);
+        return;
+    }
+
+    Entry &entry = entries_[k];
+    entry.ETag = resp->etag;
+    entry.Body = resp->body;
+}
+
+void ResponseCache::Clear() {
+    Poco::Mutex::ScopedLock lock(mutex_);
+    entries_.clear();
+}
+
+void ResponseCache::StartCycle() {
+    Poco::Mutex::ScopedLock lock(mutex_);
+    cycle_ = ResponseCacheStats();
+}
+
+ResponseCacheStats ResponseCache::Cycle() {
+    Poco::Mutex::ScopedLock lock(mutex_);
+    return cycle_;
+}
+
+ResponseCacheStats ResponseCache::Total() {
+    Poco::Mutex::ScopedLock lock(mutex_);
+    return total_;
+}
+
+}  // namespace toggl
@@ -0,0 +1,79 @@
+// Copyright 2020 Toggl Desktop developers.
+
+#ifndef SRC_RESPONSE_CACHE_H_
+#define SRC_RESPONSE_CACHE_H_
+
+#include <map>
+#include <string>
+
+#include "types.h"
+
+#include <Poco/Mutex.h>
+#include <Poco/Types.h>
+
+namespace toggl {
+
+class HTTPRequest;
+class HTTPResponse;
+
+class TOGGL_INTERNAL_EXPORT ResponseCacheStats {
+ public:
+    ResponseCacheStats()
+        : Requests(0)
+    , NotModified(0)
+    , BytesSaved(0) {}
+
+    // Conditional requests sent
+    Poco::UInt64 Requests;
+    // How many of them were answered with 304 Not Modified
+    Poco::UInt64 NotModified;
+    // Size of the cached bodies that didn't have to be downloaded again
+    Poco::UInt64 BytesSaved;
+};
+
+// Remembers the last body and ETag of GET responses, so the same
+// document can be revalidated with If-None-Match. An unchanged
+// document then costs a 304 and the cached body is handed out
+// instead, as if it had been downloaded.
+class TOGGL_INTERNAL_EXPORT ResponseCache {
+ public:
+    ResponseCache() {}
+    ~ResponseCache() {}
+
+    // Adds If-None-Match to the request when a cached copy exists
+    void Prepare(HTTPRequest *req);
+
+    // Stores a fresh response, or fills in the cached body
+    // when the server answered 304
+    void Complete(const HTTPRequest &req, HTTPResponse *resp);
+
+    void Clear();
+
+    // Starts counting a new sync cycle
+    void StartCycle();
+
+    // Counters of the current sync cycle
+    ResponseCacheStats Cycle();
+
+    // Counters since the cache was created
+    ResponseCacheStats Total();
+
+ private:
+    class Entry {
+     public:
+        std::string ETag;
+        std::string Body;
+    };
+
+    // Cached documents are specific to the user asking for them
+    static std::string key(const HTTPRequest &req);
+
+    Poco::Mutex mutex_;
+    std::map<std::string, Entry> entries_;
+    ResponseCacheStats cycle_;
+    ResponseCacheStats total_;
+};
+
+}  // namespace toggl
+
+#endif  // SRC_RESPONSE_CACHE_H_
@@ -0,0 +1,167 @@
+// Copyright 2020 Toggl Desktop developers.
+
+#include "sync_scheduler.h"
+
+#include <algorithm>
+
+#include "util/random.h"
+
+namespace toggl {
+
+SyncScheduler::SyncScheduler(
+    const Poco::Timespan &debounce,
+    const Poco::Timespan &min_interval,
+    const Poco::Timespan &max_interval,
+    const Poco::Timespan &min_retry)
+    : debounce_(debounce)
+, min_interval_(min_interval)
+, max_interval_(max_interval)
+, min_retry_(min_retry)
+, stopped_(false)
+, active_(false)
+, pending_(kSyncWorkNone)
+, interval_(min_interval)
+, retry_(0) {
+    periodic_due_ += jitter(interval_);
+}
+
+Poco::Timespan SyncScheduler::jitter(const Poco::Timespan &span) const {
+    // Up to a tenth more, so clients don't all pull at the same time
+    Poco::UInt32 spread = static_cast<Poco::UInt32>(span.totalMilliseconds() / 10);
+    if (!spread) {
+        return span;
+    }
+    return span + Poco::Timespan(
+        static_cast<Poco::Timespan::TimeDiff>(Random::next(spread)) * Poco::Timespan::MILLISECONDS);
+}
+
+void SyncScheduler::Request(const int work) {
+    if (kSyncWorkNone == work) {
+        return;
+    }
+
+    Poco::Mutex::ScopedLock lock(mutex_);
+
+    stats_.Requests++;
+    if (work & kSyncWorkPush) {
+        active_ = true;
+    }
+
+    // Later requests join the first one instead of pushing it back,
+    // they also cut short a retry delay
+    Poco::Timestamp due;
+    due += debounce_;
+    if (kSyncWorkNone == pending_ || due < pending_due_) {
+        pending_due_ = due;
+    }
+    pending_ |= work;
+
+    wakeup_.signal();
+}
+
+void SyncScheduler::Activity() {
+    Poco::Mutex::ScopedLock lock(mutex_);
+
+    active_ = true;
+
+    Poco::Timestamp due;
+    due += min_interval_;
+    if (due < periodic_due_) {
+        periodic_due_ = due;
+        wakeup_.signal();
+    }
+}
+
+int SyncScheduler::Wait() {
+    Poco::Mutex::ScopedLock lock(mutex_);
+
+    while (!stopped_) {
+        Poco::Timestamp now;
+
+        int work = kSyncWorkNone;
+        if (pending_ != kSyncWorkNone && pending_due_ <= now) {
+            work = pending_;
+        }
+        if (periodic_due_ <= now) {
+            work |= pending_ | kSyncWorkPull;
+        }
+        if (work != kSyncWorkNone) {
+            pending_ = kSyncWorkNone;
+            stats_.Cycles++;
+            return work;
+        }
+
+        Poco::Timestamp due = periodic_due_;
+        if (pending_ != kSyncWorkNone && pending_due_ < due) {
+            due = pending_due_;
+        }
+        long millis = static_cast<long>((due - now) / 1000) + 1;  // NOLINT
+        wakeup_.tryWait(mutex_, millis);
+    }
+
+    return kSyncWorkNone;
+}
+
+void SyncScheduler::CycleFinished(const int unfinished_work) {
+    Poco::Mutex::ScopedLock lock(mutex_);
+
+    Poco::Timestamp now;
+
+    if (unfinished_work != kSyncWorkNone) {
+        stats_.Failures++;
+
+        // Offline or the server is struggling, try again later and
+        // a bit later every time
+        if (retry_ == Poco::Timespan(0)) {
+            retry_ = min_retry_;
+        } else {
+            retry_ = std::min(retry_ + retry_, max_interval_);
+        }
+        Poco::Timestamp due = now + jitter(retry_).totalMicroseconds();
+        if (kSyncWorkNone == pending_ || due < pending_due_) {
+            pending_due_ = due;
+        }
+        pending_ |= unfinished_work;
+        periodic_due_ = pending_due_;
+        return;
+    }
+
+    retry_ = 0;
+
+    if (active_) {
+        interval_ = min_interval_;
+    } else {
+        interval_ = std::min(interval_ + interval_, max_interval_);
+    }
+    active_ = false;
+
+    periodic_due_ = now + jitter(interval_).totalMicroseconds();
+}
+
+void SyncScheduler::Stop() {
+    Poco::Mutex::ScopedLock lock(mutex_);
+    stopped_ = true;
+    wakeup_.broadcast();
+}
+
+void SyncScheduler::SetDebounce(const Poco::Timespan &debounce) {
+    Poco::Mutex::ScopedLock lock(mutex_);
+    debounce_ = debounce;
+}
+
+Poco::Timespan SyncScheduler::Interval() {
+    Poco::Mutex::ScopedLock lock(mutex_);
+    return interval_;
+}
+
+Poco::Timespan SyncScheduler::Retry() {
+    Poco::Mutex::ScopedLock lock(mutex_);
+    return retry_;
+}
+
+SyncSchedulerStats SyncScheduler::Stats() {
+    Poco::Mutex::ScopedLock lock(mutex_);
+    return stats_;
+}
+
+}  // namespace toggl
@@ -0,0 +1,117 @@
+// Copyright 2020 Toggl Desktop developers.
+
+#ifndef SRC_SYNC_SCHEDULER_H_
+#define SRC_SYNC_SCHEDULER_H_
+
+#include "const.h"
+#include "types.h"
+
+#include <Poco/Condition.h>
+#include <Poco/Mutex.h>
+#include <Poco/Timespan.h>
+#include <Poco/Timestamp.h>
+
+namespace toggl {
+
+// What a sync cycle has to do, combined as bit flags
+enum SyncWork {
+    kSyncWorkNone = 0,
+    kSyncWorkPull = 1,
+    kSyncWorkPush = 2,
+    // Preferences too, on top of a pull
+    kSyncWorkFull = 4
+};
+
+class TOGGL_INTERNAL_EXPORT SyncSchedulerStats {
+ public:
+    SyncSchedulerStats()
+        : Requests(0)
+    , Cycles(0)
+    , Failures(0) {}
+
+    // Sync and push requests received
+    Poco::UInt64 Requests;
+    // Sync cycles handed out to the syncer, including periodic ones
+    Poco::UInt64 Cycles;
+    // Cycles that left work undone
+    Poco::UInt64 Failures;
+};
+
+/*
+ * Decides when the syncer runs and what it does.
+ *
+ * Requests arriving within the debounce window of the first one are
+ * combined into a single cycle. Without requests the syncer pulls
+ * periodically: right after local or remote changes the interval is
+ * short, and it doubles every quiet cycle up to the maximum. A cycle
+ * that fails leaves its work pending and is retried after a delay that
+ * doubles with every further failure.
+ *
+ * The syncer thread sleeps in Wait() on a condition variable until
+ * there is something to do.
+ */
+class TOGGL_INTERNAL_EXPORT SyncScheduler {
+ public:
+    SyncScheduler(
+        const Poco::Timespan &debounce = Poco::Timespan(kSyncDebounceMillis * Poco::Timespan::MILLISECONDS),
+        const Poco::Timespan &min_interval = Poco::Timespan(kSyncIntervalMinSeconds, 0),
+        const Poco::Timespan &max_interval = Poco::Timespan(kSyncIntervalMaxSeconds, 0),
+        const Poco::Timespan &min_retry = Poco::Timespan(kSyncRetryMinSeconds, 0));
+    ~SyncScheduler() {}
+
+    // Asks for a sync cycle, see SyncWork
+    void Request(const int work);
+
+    // The user changed something, or the server sent changes,
+    // so the next periodic pull should come sooner
+    void Activity();
+
+    // Blocks until a cycle is due and returns what it has to do,
+    // or kSyncWorkNone once the scheduler is stopped
+    int Wait();
+
+    // Reports the work the cycle handed out by Wait() didn't get done
+    void CycleFinished(const int unfinished_work);
+
+    // Wakes up Wait() for good
+    void Stop();
+
+    // Zero starts a cycle as soon as it is requested
+    void SetDebounce(const Poco::Timespan &debounce);
+
+    // Current delay between periodic pulls, jitter not included
+    Poco::Timespan Interval();
+
+    // Current delay before a failed cycle is retried, zero when
+    // the last cycle succeeded
+    Poco::Timespan Retry();
+
+    SyncSchedulerStats Stats();
+
+ private:
+    Poco::Timespan jitter(const Poco::Timespan &span) const;
+
+    Poco::Timespan debounce_;
+    const Poco::Timespan min_interval_;
+    const Poco::Timespan max_interval_;
+    const Poco::Timespan min_retry_;
+
+    Poco::Mutex mutex_;
+    Poco::Condition wakeup_;
+
+    bool stopped_;
+    bool active_;
+
+    int pending_;
+    Poco::Timestamp pending_due_;
+    Poco::Timestamp periodic_due_;
+
+    Poco::Timespan interval_;
+    Poco::Timespan retry_;
+
+    SyncSchedulerStats stats_;
+};
+
+}  // namespace toggl
+
+#endif  // SRC_SYNC_SCHEDULER_H_
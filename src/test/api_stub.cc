@@ -0,0 +1,406 @@
+// Copyright 2020 Toggl Desktop developers.
+
+#include "api_stub.h"
+
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <Poco/DateTimeFormat.h>
+#include <Poco/DateTimeFormatter.h>
+#include <Poco/InflatingStream.h>
+#include <Poco/NumberFormatter.h>
+#include <Poco/NumberParser.h>
+#include <Poco/StreamCopier.h>
+#include <Poco/StringTokenizer.h>
+#include <Poco/Thread.h>
+#include <Poco/Timestamp.h>
+#include <Poco/URI.h>
+#include <Poco/Net/HTTPRequestHandler.h>
+#include <Poco/Net/HTTPRequestHandlerFactory.h>
+#include <Poco/Net/HTTPServerParams.h>
+#include <Poco/Net/ServerSocket.h>
+#include <Poco/Net/SocketAddress.h>
+
+namespace toggl {
+
+namespace test {
+
+namespace {
+
+class ApiRequestHandler : public Poco::Net::HTTPRequestHandler {
+ public:
+    explicit ApiRequestHandler(ApiStub *stub)
+        : stub_(stub) {}
+
+    void handleRequest(
+        Poco::Net::HTTPServerRequest &request,
+        Poco::Net::HTTPServerResponse &response) override {
+        stub_->handle(request, response);
+    }
+
+ private:
+    ApiStub *stub_;
+};
+
+class ApiRequestHandlerFactory
+    : public Poco::Net::HTTPRequestHandlerFactory {
+ public:
+    explicit ApiRequestHandlerFactory(ApiStub *stub)
+        : stub_(stub) {}
+
+    Poco::Net::HTTPRequestHandler *createRequestHandler(
+        const Poco::Net::HTTPServerRequest &) override {
+        return new ApiRequestHandler(stub_);
+    }
+
+ private:
+    ApiStub *stub_;
+};
+
+const char *kModelCollections[] = { "clients", "projects", "time_entries" };
+
+std::vector<std::string> splitPath(const std::string &path) {
+    std::vector<std::string> result;
+    Poco::StringTokenizer tokens(path, "/",
+                                 Poco::StringTokenizer::TOK_IGNORE_EMPTY);
+    for (std::size_t i = 0; i < tokens.count(); i++) {
+        result.push_back(tokens[i]);
+    }
+    return result;
+}
+
+bool isID(const std::string &segment) {
+    Poco::UInt64 id(0);
+    return Poco::NumberParser::tryParseUnsigned64(segment, id);
+}
+
+// Path with IDs replaced, so requests can be counted per endpoint
+std::string endpoint(const std::string &path) {
+    std::string result;
+    std::vector<std::string> segments = splitPath(path);
+    for (std::size_t i = 0; i < segments.size(); i++) {
+        result += "/";
+        if (isID(segments[i])) {
+            result += "{id}";
+        } else if (i && "push" == segments[i - 1]) {
+            result += "{uuid}";
+        } else {
+            result += segments[i];
+        }
+    }
+    return result;
+}
+
+std::string now() {
+    return Poco::DateTimeFormatter::format(
+        Poco::Timestamp(), Poco::DateTimeFormat::ISO8601_FORMAT);
+}
+
+std::string etagOf(const std::string &body) {
+    std::stringstream ss;
+    ss << "\"" << std::hex << std::hash<std::string>()(body) << "\"";
+    return ss.str();
+}
+
+}  // namespace
+
+ApiStub::ApiStub(const std::string &me_json)
+    : server_(nullptr)
+, request_count_(0)
+, next_id_(1000000000) {
+    Json::Value root;
+    Json::Reader reader;
+    if (reader.parse(me_json, root)) {
+        data_ = root.isMember("data") ? root["data"] : root;
+    }
+    for (std::size_t i = 0; i < sizeof(kModelCollections) / sizeof(kModelCollections[0]); i++) {
+        if (!data_.isMember(kModelCollections[i])) {
+            data_[kModelCollections[i]] = Json::Value(Json::arrayValue);
+        }
+    }
+
+    Poco::Net::ServerSocket socket(Poco::Net::SocketAddress("127.0.0.1", 0));
+    Poco::Net::HTTPServerParams *params = new Poco::Net::HTTPServerParams;
+    params->setMaxThreads(8);
+    server_ = new Poco::Net::HTTPServer(
+        new ApiRequestHandlerFactory(this),
+        socket,
+        params);
+    server_->start();
+}
+
+ApiStub::~ApiStub() {
+    server_->stopAll(true);
+    delete server_;
+}
+
+std::string ApiStub::URL() const {
+    return "http://127.0.0.1:"
+           + Poco::NumberFormatter::format(server_->port());
+}
+
+void ApiStub::Configure(const ApiStubConfig &config) {
+    Poco::Mutex::ScopedLock lock(mutex_);
+    config_ = config;
+}
+
+Poco::UInt64 ApiStub::Requests() {
+    Poco::Mutex::ScopedLock lock(mutex_);
+    return request_count_;
+}
+
+Poco::UInt64 ApiStub::Requests(const std::string &path) {
+    Poco::Mutex::ScopedLock lock(mutex_);
+    return requests_[path];
+}
+
+bool ApiStub::WaitForRequests(
+    const std::string &path,
+    const Poco::UInt64 count,
+    const long milliseconds) {
+
+    Poco::Timestamp deadline;
+    deadline += Poco::Timespan(milliseconds * Poco::Timespan::MILLISECONDS);
+
+    Poco::Mutex::ScopedLock lock(mutex_);
+    while (requests_[path] < count) {
+        Poco::Timestamp now;
+        if (now >= deadline) {
+            return false;
+        }
+        served_.tryWait(mutex_, static_cast<long>((deadline - now) / 1000) + 1);
+    }
+    return true;
+}
+
+std::size_t ApiStub::TimeEntryCount() {
+    Poco::Mutex::ScopedLock lock(mutex_);
+    return data_["time_entries"].size();
+}
+
+void ApiStub::count(const std::string &path) {
+    requests_[endpoint(path)]++;
+    served_.broadcast();
+}
+
+void ApiStub::handle(
+    Poco::Net::HTTPServerRequest &request,
+    Poco::Net::HTTPServerResponse &response) {
+
+    std::string body;
+    if (request.get("Content-Encoding", "") == "gzip") {
+        Poco::InflatingInputStream inflater(
+            request.stream(), Poco::InflatingStreamBuf::STREAM_GZIP);
+        Poco::StreamCopier::copyToString(inflater, body);
+    } else {
+        Poco::StreamCopier::copyToString(request.stream(), body);
+    }
+
+    std::string path = Poco::URI(request.getURI()).getPath();
+
+    ApiStubConfig config;
+    Poco::UInt64 n(0);
+    {
+        Poco::Mutex::ScopedLock lock(mutex_);
+        config = config_;
+        n = ++request_count_;
+    }
+
+    if (config.LatencyMillis) {
+        Poco::Thread::sleep(config.LatencyMillis);
+    }
+
+    int status(200);
+    std::string etag;
+    std::string result;
+    if (config.TooManyRequestsEvery && 0 == n % config.TooManyRequestsEvery) {
+        status = 429;
+        response.set("Retry-After", "1");
+    } else if (config.FailEvery && 0 == n % config.FailEvery) {
+        status = 500;
+    } else {
+        result = route(request.getMethod(), path, body,
+                       request.get("If-None-Match", ""), &status, &etag);
+    }
+
+    response.setStatus(static_cast<Poco::Net::HTTPResponse::HTTPStatus>(status));
+    if (!etag.empty()) {
+        response.set("ETag", etag);
+    }
+    if (!result.empty()) {
+        response.setContentType("application/json");
+    }
+    response.setContentLength(static_cast<std::streamsize>(result.size()));
+    response.send() << result;
+
+    Poco::Mutex::ScopedLock lock(mutex_);
+    count(path);
+}
+
+std::string ApiStub::route(
+    const std::string &method,
+    const std::string &path,
+    const std::string &body,
+    const std::string &if_none_match,
+    int *status,
+    std::string *etag) {
+
+    std::vector<std::string> segments = splitPath(path);
+    Json::FastWriter writer;
+    Json::Value payload;
+    if (!body.empty()) {
+        Json::Reader().parse(body, payload);
+    }
+
+    Poco::Mutex::ScopedLock lock(mutex_);
+
+    // Documents the client revalidates
+    std::string document;
+    bool cacheable(false);
+    if ("GET" == method) {
+        if ("/api/v8/me" == path || "/api/v9/me" == path || "/pull" == path) {
+            return writer.write(userData());
+        }
+        if ("/api/v9/me/time_entries" == path) {
+            return writer.write(data_["time_entries"]);
+        }
+        if ("/api/v9/me/workspaces" == path) {
+            document = writer.write(data_["workspaces"]);
+            cacheable = true;
+        } else if ("/api/v9/me/preferences/desktop" == path
+                   || (4 == segments.size() && "workspaces" == segments[2]
+                       && "preferences" == segments[3])) {
+            document = "{}";
+            cacheable = true;
+        }
+    }
+    if (cacheable) {
+        *etag = etagOf(document);
+        if (if_none_match == *etag) {
+            *status = 304;
+            return "";
+        }
+        return document;
+    }
+
+    if ("POST" == method && "/api/v8/timeline" == path) {
+        return "{}";
+    }
+    if ("POST" == method && "/api/v8/timeline_settings" == path) {
+        return "{}";
+    }
+    if ("POST" == method && 2 == segments.size() && "push" == segments[0]) {
+        return writer.write(push(payload));
+    }
+
+    // /api/v9/workspaces/{wid}/{collection}[/{id}]
+    if (segments.size() >= 5 && "workspaces" == segments[2]) {
+        const std::string &collection = segments[4];
+        Poco::UInt64 id(0);
+        if (segments.size() > 5) {
+            Poco::NumberParser::tryParseUnsigned64(segments[5], id);
+        }
+        if ("POST" == method && !id) {
+            return writer.write(saveModel(collection, 0, payload));
+        }
+        if ("PUT" == method && id) {
+            return writer.write(saveModel(collection, id, payload));
+        }
+        if ("DELETE" == method && id) {
+            removeModel(collection, id);
+            return "";
+        }
+    }
+
+    *status = 404;
+    return "";
+}
+
+Json::Value ApiStub::userData() {
+    Json::Value root;
+    root["since"] = Json::Int64(Poco::Timestamp().epochTime());
+    root["data"] = data_;
+    return root;
+}
+
+Json::Value ApiStub::saveModel(
+    const std::string &collection,
+    const Poco::UInt64 id,
+    const Json::Value &payload) {
+
+    Json::Value &list = data_[collection];
+
+    Json::Value *model = nullptr;
+    if (id) {
+        for (Json::Value::ArrayIndex i = 0; i < list.size(); i++) {
+            if (list[i]["id"].asUInt64() == id) {
+                model = &list[i];
+                break;
+            }
+        }
+    }
+    if (!model) {
+        model = &list.append(Json::Value(Json::objectValue));
+        (*model)["id"] = Json::UInt64(id ? id : next_id_++);
+    }
+
+    std::vector<std::string> fields = payload.getMemberNames();
+    for (std::size_t i = 0; i < fields.size(); i++) {
+        if (fields[i] != "id") {
+            (*model)[fields[i]] = payload[fields[i]];
+        }
+    }
+    (*model)["at"] = now();
+    return *model;
+}
+
+void ApiStub::removeModel(
+    const std::string &collection,
+    const Poco::UInt64 id) {
+
+    Json::Value kept(Json::arrayValue);
+    for (Json::Value::ArrayIndex i = 0; i < data_[collection].size(); i++) {
+        if (data_[collection][i]["id"].asUInt64() != id) {
+            kept.append(data_[collection][i]);
+        }
+    }
+    data_[collection] = kept;
+}
+
+Json::Value ApiStub::push(const Json::Value &request) {
+    Json::Value response(Json::objectValue);
+    for (std::size_t c = 0; c < sizeof(kModelCollections) / sizeof(kModelCollections[0]); c++) {
+        std::string collection(kModelCollections[c]);
+        if (!request.isMember(collection)) {
+            continue;
+        }
+        Json::Value results(Json::arrayValue);
+        const Json::Value &items = request[collection];
+        for (Json::Value::ArrayIndex i = 0; i < items.size(); i++) {
+            const Json::Value &item = items[i];
+            Json::Value result;
+            result["type"] = item["type"];
+            result["meta"] = item["meta"];
+            result["payload"]["success"] = true;
+            std::string type = item["type"].asString();
+            if ("create" == type) {
+                result["payload"]["result"] = saveModel(collection, 0, item["payload"]);
+            } else if ("update" == type) {
+                result["payload"]["result"] = saveModel(
+                    collection, item["meta"]["id"].asUInt64(), item["payload"]);
+            } else {
+                removeModel(collection, item["meta"]["id"].asUInt64());
+                result["payload"]["result"] = Json::nullValue;
+            }
+            results.append(result);
+        }
+        response[collection] = results;
+    }
+    return response;
+}
+
+}  // namespace test
+
+}  // namespace toggl
@@ -0,0 +1,115 @@
+// Copyright 2020 Toggl Desktop developers.
+
+#ifndef SRC_TEST_API_STUB_H_
+#define SRC_TEST_API_STUB_H_
+
+#include <map>
+#include <string>
+
+#include <json/json.h>  // NOLINT
+
+#include <Poco/Condition.h>
+#include <Poco/Mutex.h>
+#include <Poco/Types.h>
+#include <Poco/Net/HTTPServer.h>
+#include <Poco/Net/HTTPServerRequest.h>
+#include <Poco/Net/HTTPServerResponse.h>
+
+namespace toggl {
+
+namespace test {
+
+class ApiStubConfig {
+ public:
+    ApiStubConfig()
+        : LatencyMillis(0)
+    , TooManyRequestsEvery(0)
+    , FailEvery(0) {}
+
+    // Added to every response
+    long LatencyMillis;
+    // Every Nth request is answered 429 Too Many Requests, 0 for never
+    int TooManyRequestsEvery;
+    // Every Nth request is answered 500, 0 for never
+    int FailEvery;
+};
+
+// Local stand-in for the Toggl REST and sync servers. Listens on a random
+// port of 127.0.0.1 and serves the user data it was seeded with:
+//   - /api/v8/me and /api/v9/me, /pull of the sync server
+//   - workspaces, workspace and desktop preferences, with ETags
+//   - creating, updating and deleting time entries, projects and clients
+//   - /push of the sync server
+//   - timeline uploads and timeline settings
+// Everything else is answered 404.
+class ApiStub {
+ public:
+    // Seed is a /me?with_related_data=true response, e.g. testdata/me.json
+    explicit ApiStub(const std::string &me_json);
+    ~ApiStub();
+
+    // Pass to urls::SetBackend()
+    std::string URL() const;
+
+    void Configure(const ApiStubConfig &config);
+
+    // Number of requests received so far
+    Poco::UInt64 Requests();
+
+    // Number of requests served for the path (without the query),
+    // IDs in the path are replaced with {id}
+    Poco::UInt64 Requests(const std::string &path);
+
+    // Waits until that many requests were served for the path
+    bool WaitForRequests(
+        const std::string &path,
+        const Poco::UInt64 count,
+        const long milliseconds);
+
+    // Number of time entries the stub holds
+    std::size_t TimeEntryCount();
+
+    // Called from the request handler
+    void handle(
+        Poco::Net::HTTPServerRequest &request,
+        Poco::Net::HTTPServerResponse &response);
+
+ private:
+    std::string route(
+        const std::string &method,
+        const std::string &path,
+        const std::string &body,
+        const std::string &if_none_match,
+        int *status,
+        std::string *etag);
+
+    Json::Value userData();
+    Json::Value saveModel(
+        const std::string &collection,
+        const Poco::UInt64 id,
+        const Json::Value &payload);
+    void removeModel(
+        const std::string &collection,
+        const Poco::UInt64 id);
+    Json::Value push(const Json::Value &request);
+
+    void count(const std::string &path);
+
+    Poco::Net::HTTPServer *server_;
+
+    Poco::Mutex mutex_;
+    Poco::Condition served_;
+    ApiStubConfig config_;
+    Poco::UInt64 request_count_;
+    std::map<std::string, Poco::UInt64> requests_;
+
+    // The "data" of the seed, with the models kept up to date
+    Json::Value data_;
+    Poco::UInt64 next_id_;
+};
+
+}  // namespace test
+
+}  // namespace toggl
+
+#endif  // SRC_TEST_API_STUB_H_
@@ -2,35 +2,74 @@
 
 #include "gtest/gtest.h"
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
 #include <iostream>  // NOLINT
+#include <sstream>
+#include <thread>
+#include <vector>
 
 #include "model/autotracker.h"
 #include "model/client.h"
 #include "const.h"
+#include "context.h"
 #include "database/database.h"
+#include "executor.h"
 #include "util/formatter.h"
+#include "get_focused_window.h"
+#include "gui.h"
+#include "https_client.h"
+#include "instrumented_mutex.h"
 #include "model/project.h"
+#include "netconf.h"
 #include "proxy.h"
+#include "render_dispatcher.h"
+#include "request_body_encoder.h"
+#include "request_scheduler.h"
+#include "response_cache.h"
+#include "sync_scheduler.h"
 #include "model/settings.h"
 #include "model/tag.h"
 #include "model/task.h"
 #include "model/time_entry.h"
 #include "model/timeline_event.h"
+#include "timeline_event_queue.h"
 #include "timeline_uploader.h"
+#include "update_batcher.h"
+#include "urls.h"
+#include "view_arena.h"
 #include "model/user.h"
 #include "model/workspace.h"
+#include "websocket_client.h"
+#include "websocket_stub.h"
 #include "color_convert.h"
 
+#include "dataset_generator.h"
 #include "test_data.h"
 
+#include "Poco/DateTimeFormat.h"
+#include "Poco/DateTimeFormatter.h"
+#include "Poco/Environment.h"
+#include "Poco/Event.h"
 #include "Poco/File.h"
 #include "Poco/FileStream.h"
+#include "Poco/InflatingStream.h"
 #include "Poco/Logger.h"
 #include "Poco/LocalDateTime.h"
+#include "Poco/Net/HTTPClientSession.h"
+#include "Poco/Path.h"
 #include <Poco/SimpleFileChannel.h>
 #include <Poco/FormattingChannel.h>
 #include <Poco/PatternFormatter.h>
 #include <Poco/ConsoleChannel.h>
+#include <Poco/Thread.h>
+#include <Poco/Timestamp.h>
+
+#if defined(__linux__)
+#include <X11/Xlib.h>
+#include <X11/Xatom.h>
+#endif
 
 namespace toggl {
 
@@ -256,6 +295,51 @@ TEST(User, CreateCompressedTimelineBatchForUpload) {
     ASSERT_EQ(std::size_t(0), left_for_upload.size());
 }
 
+TEST(User, FoldsTimelineEventsAsTheyAreAdded) {
+    User user;
+    user.SetID(10);
+
+    // Two chunks ago, so both chunks are complete by now
+    Poco::Int64 now = time(nullptr);
+    Poco::Int64 chunk = now - now % kTimelineChunkSeconds
+                        - 2 * kTimelineChunkSeconds;
+
+    for (int i = 0; i < 10; i++) {
+        TimelineEvent *event = new TimelineEvent();
+        event->SetUID(10);
+        event->SetStartTime(chunk + i * 5);
+        event->SetEndTime(event->Start() + 5);
+        event->SetFilename("Notepad.exe");
+        event->SetTitle(i % 2 ? "notes" : "diary");
+        user.AddTimelineEvent(event);
+    }
+
+    // One event per window title, none ready for upload yet
+    ASSERT_EQ(std::size_t(2), user.related.TimelineEvents.size());
+    ASSERT_EQ(Poco::Int64(25), user.related.TimelineEvents[0]->Duration());
+    ASSERT_EQ(Poco::Int64(25), user.related.TimelineEvents[1]->Duration());
+    ASSERT_TRUE(user.CompressedTimelineForUpload().empty());
+
+    // An event of the next chunk closes the earlier ones
+    TimelineEvent *next = new TimelineEvent();
+    next->SetUID(10);
+    next->SetStartTime(chunk + kTimelineChunkSeconds);
+    next->SetEndTime(next->Start() + 5);
+    next->SetFilename("Notepad.exe");
+    next->SetTitle("notes");
+    user.AddTimelineEvent(next);
+
+    ASSERT_EQ(std::size_t(3), user.related.TimelineEvents.size());
+    ASSERT_EQ(std::size_t(2), user.CompressedTimelineForUpload().size());
+    ASSERT_FALSE(next->Chunked());
+
+    // The periodic check closes the chunks of past periods
+    ASSERT_TRUE(user.CloseTimelineChunks());
+    ASSERT_TRUE(next->Chunked());
+    ASSERT_EQ(std::size_t(3), user.CompressedTimelineForUpload().size());
+    ASSERT_FALSE(user.CloseTimelineChunks());
+}
+
 TEST(Database, Trim) {
     testing::Database db;
     std::string text(" jäääär ");
@@ -340,6 +424,69 @@ TEST(User, UpdatesTimeEntryFromJSON) {
     ASSERT_EQ("Changed", te->Description());
 }
 
+TEST(TimeEntry, MergesConcurrentEditsFieldByField) {
+    User user;
+    ASSERT_EQ(noError,
+              user.LoadUserAndRelatedDataFromJSONString(loadTestData(), true, false));
+
+    TimeEntry *te = user.related.TimeEntryByID(89818605);
+    ASSERT_TRUE(te);
+    ASSERT_FALSE(te->HasUnpushedChanges());
+
+    // Edited locally, not pushed yet
+    te->SetDescription("Local description", true);
+    te->SetUIModified();
+
+    // Meanwhile another client changed the description and the billable flag
+    std::string json = "{\"id\":89818605,\"wid\":123456789,\"pid\":2567324,\"billable\":false,\"description\":\"Remote description\",\"at\":\"2014-01-01T00:00:00+00:00\"}";
+    te->LoadFromJSON(jsonStringToValue(json), false);
+
+    // The newer local edit wins the conflicting field, the other one is taken from the server
+    ASSERT_EQ("Local description", te->Description());
+    ASSERT_FALSE(te->Billable());
+    ASSERT_TRUE(te->HasUnpushedChanges());
+    ASSERT_TRUE(te->UIModifiedAt());
+    ASSERT_TRUE(te->NeedsPush());
+
+    // Only the local edit goes back to the server
+    Json::Value payload = te->SaveChangesToJSON();
+    ASSERT_EQ("Local description", payload["description"].asString());
+    ASSERT_FALSE(payload.isMember("billable"));
+    ASSERT_FALSE(payload.isMember("pid"));
+    ASSERT_FALSE(payload.isMember("start"));
+    ASSERT_FALSE(payload.isMember("tags"));
+
+    // The server accepted it
+    json = "{\"id\":89818605,\"wid\":123456789,\"pid\":2567324,\"billable\":false,\"description\":\"Local description\",\"at\":\"2014-01-02T00:00:00+00:00\"}";
+    te->LoadFromJSON(jsonStringToValue(json), false);
+    ASSERT_EQ("Local description", te->Description());
+    ASSERT_FALSE(te->HasUnpushedChanges());
+    ASSERT_FALSE(te->UIModifiedAt());
+}
+
+TEST(TimeEntry, NewerServerEditWinsConflict) {
+    User user;
+    ASSERT_EQ(noError,
+              user.LoadUserAndRelatedDataFromJSONString(loadTestData(), true, false));
+
+    TimeEntry *te = user.related.TimeEntryByID(89818605);
+    ASSERT_TRUE(te);
+
+    te->SetDescription("Local description", true);
+    te->SetBillable(false, true);
+    te->SetUIModifiedAt(1388534400);  // 2014-01-01
+
+    std::string json = "{\"id\":89818605,\"wid\":123456789,\"pid\":2567324,\"billable\":true,\"description\":\"Remote description\",\"at\":\"2014-01-02T00:00:00+00:00\"}";
+    te->LoadFromJSON(jsonStringToValue(json), false);
+
+    ASSERT_EQ("Remote description", te->Description());
+    // The server didn't touch billable, so the local edit is kept
+    ASSERT_FALSE(te->Billable());
+    ASSERT_TRUE(te->HasUnpushedChanges());
+    ASSERT_FALSE(te->SaveChangesToJSON().isMember("description"));
+    ASSERT_TRUE(te->SaveChangesToJSON().isMember("billable"));
+}
+
 TEST(User, DeletesZombies) {
     User user;
     ASSERT_EQ(noError,
@@ -672,6 +819,64 @@ TEST(Database, SavesModels) {
     ASSERT_EQ(noError, db.instance()->SaveUser(&user, false, &changes));
 }
 
+TEST(Database, QueuesUserChangesInOutbox) {
+    testing::Database db;
+
+    User user;
+    ASSERT_EQ(noError,
+              user.LoadUserAndRelatedDataFromJSONString(loadTestData(), true, false));
+
+    std::vector<ModelChange> changes;
+    ASSERT_EQ(noError, db.instance()->SaveUser(&user, true, &changes));
+
+    // Data from the server has nothing to push
+    std::vector<OutboxEntry> outbox;
+    ASSERT_EQ(noError, db.instance()->LoadOutbox(user.ID(), &outbox));
+    ASSERT_TRUE(outbox.empty());
+
+    TimeEntry *first = user.related.TimeEntries[1];
+    TimeEntry *second = user.related.TimeEntries[0];
+
+    first->SetDescription("first edit", true);
+    first->SetUIModified();
+    ASSERT_EQ(noError, db.instance()->SaveUser(&user, true, &changes));
+
+    second->SetDescription("second edit", true);
+    second->SetUIModified();
+    ASSERT_EQ(noError, db.instance()->SaveUser(&user, true, &changes));
+
+    std::vector<OutboxEntry> pushed;
+    ASSERT_EQ(noError, db.instance()->LoadOutbox(user.ID(), &pushed));
+
+    // Edits of a queued model are merged and keep its place in line
+    first->SetDescription("third edit", true);
+    first->SetUIModified();
+    ASSERT_EQ(noError, db.instance()->SaveUser(&user, true, &changes));
+
+    ASSERT_EQ(noError, db.instance()->LoadOutbox(user.ID(), &outbox));
+    ASSERT_EQ(2u, outbox.size());
+    ASSERT_EQ(first->GUID(), outbox[0].GUID);
+    ASSERT_EQ(kModelTimeEntry, outbox[0].ModelType);
+    ASSERT_LT(outbox[0].Seq, outbox[0].LastSeq);
+    ASSERT_EQ(second->GUID(), outbox[1].GUID);
+
+    Poco::UInt64 n;
+    ASSERT_EQ(noError, db.instance()->UInt("select count(1) from outbox", &n));
+    ASSERT_EQ(uint(3), n);
+
+    // The edit made after loading the pushed entries stays queued
+    ASSERT_EQ(noError, db.instance()->AcknowledgeOutbox(user.ID(), pushed));
+    ASSERT_EQ(noError, db.instance()->LoadOutbox(user.ID(), &outbox));
+    ASSERT_EQ(1u, outbox.size());
+    ASSERT_EQ(first->GUID(), outbox[0].GUID);
+
+    // And survives a restart
+    toggl::Database reopened("test.db");
+    ASSERT_EQ(noError, reopened.LoadOutbox(user.ID(), &outbox));
+    ASSERT_EQ(1u, outbox.size());
+    ASSERT_EQ(first->GUID(), outbox[0].GUID);
+}
+
 TEST(Database, AssignsGUID) {
     std::string json = loadTestData();
     ASSERT_FALSE(json.empty());
@@ -913,6 +1118,37 @@ TEST(User, ParsesAndSavesData) {
     ASSERT_EQ(Poco::UInt64(0), n);
 }
 
+TEST(User, LoadsGeneratedAccount) {
+    test::DatasetSize size(1000);
+    ASSERT_EQ(Poco::UInt64(1), size.Workspaces);
+    ASSERT_EQ(Poco::UInt64(50), size.Projects);
+
+    std::string json = test::GenerateUserJSON(size);
+    ASSERT_EQ(json, test::GenerateUserJSON(size));
+
+    User user;
+    ASSERT_EQ(noError,
+              user.LoadUserAndRelatedDataFromJSONString(json, true, false));
+    ASSERT_EQ(size.Clients, user.related.Clients.size());
+    ASSERT_EQ(size.Projects, user.related.Projects.size());
+    ASSERT_EQ(size.Tasks, user.related.Tasks.size());
+    ASSERT_EQ(size.Tags, user.related.Tags.size());
+    ASSERT_EQ(size.TimeEntries, user.related.VisibleTimeEntries().size());
+
+    // Entries only refer to projects of their own workspace
+    for (std::size_t i = 0; i < user.related.TimeEntries.size(); i++) {
+        TimeEntry *te = user.related.TimeEntries[i];
+        ASSERT_TRUE(user.related.WorkspaceByID(te->WID()));
+        if (te->PID()) {
+            ASSERT_EQ(te->WID(), user.related.ProjectByID(te->PID())->WID());
+        }
+    }
+
+    test::GenerateTimelineEvents(size, &user);
+    user.CompressTimeline();
+    ASSERT_FALSE(user.CompressedTimelineForUpload().empty());
+}
+
 TEST(TimeEntry, ParsesDurationLikeOnTheWeb) {
     TimeEntry te;
 
@@ -1742,6 +1978,1196 @@ TEST(Proxy, String) {
     ASSERT_NE("", p.String());
 }
 
+TEST(Netconf, IsExcludedFromProxy) {
+    ASSERT_FALSE(Netconf::IsExcludedFromProxy("api.toggl.com", 443, ""));
+    ASSERT_TRUE(Netconf::IsExcludedFromProxy("api.toggl.com", 443, "*"));
+    ASSERT_TRUE(Netconf::IsExcludedFromProxy("localhost", 8080, "localhost, 127.0.0.1"));
+    ASSERT_TRUE(Netconf::IsExcludedFromProxy("127.0.0.1", 8080, "localhost, 127.0.0.1"));
+
+    ASSERT_TRUE(Netconf::IsExcludedFromProxy("api.toggl.com", 443, "toggl.com"));
+    ASSERT_TRUE(Netconf::IsExcludedFromProxy("API.Toggl.com", 443, ".toggl.com"));
+    ASSERT_TRUE(Netconf::IsExcludedFromProxy("toggl.com", 443, "*.toggl.com"));
+    ASSERT_FALSE(Netconf::IsExcludedFromProxy("nottoggl.com", 443, "toggl.com"));
+
+    ASSERT_TRUE(Netconf::IsExcludedFromProxy("toggl.com", 443, "example.com,toggl.com:443"));
+    ASSERT_FALSE(Netconf::IsExcludedFromProxy("toggl.com", 80, "example.com,toggl.com:443"));
+}
+
+TEST(Netconf, ConfigureProxyHonoursNoProxy) {
+    Poco::Environment::set("HTTPS_PROXY", "");
+    Poco::Environment::set("https_proxy", "");
+    Poco::Environment::set("HTTP_PROXY", "");
+    Poco::Environment::set("http_proxy", "http://proxy.example.com:3128");
+    Poco::Environment::set("NO_PROXY", "");
+    Poco::Environment::set("no_proxy", "localhost");
+    Netconf::InvalidateProxyCache();
+
+    Poco::Net::HTTPClientSession excluded("localhost", 8080);
+    ASSERT_EQ(noError, Netconf::ConfigureProxy("http://localhost:8080/api/v9/me", &excluded));
+    ASSERT_EQ("", excluded.getProxyHost());
+
+    Poco::Net::HTTPClientSession proxied("api.toggl.com", 443);
+    ASSERT_EQ(noError, Netconf::ConfigureProxy("https://api.toggl.com/api/v9/me", &proxied));
+    ASSERT_EQ("proxy.example.com", proxied.getProxyHost());
+    ASSERT_EQ(3128, proxied.getProxyPort());
+
+    // Environment is only read again after invalidating the cache
+    Poco::Environment::set("http_proxy", "");
+    Poco::Net::HTTPClientSession cached("api.toggl.com", 443);
+    ASSERT_EQ(noError, Netconf::ConfigureProxy("https://api.toggl.com/api/v9/status", &cached));
+    ASSERT_EQ("proxy.example.com", cached.getProxyHost());
+
+    Netconf::InvalidateProxyCache();
+    Poco::Net::HTTPClientSession direct("api.toggl.com", 443);
+    ASSERT_EQ(noError, Netconf::ConfigureProxy("https://api.toggl.com/api/v9/me", &direct));
+    ASSERT_EQ("", direct.getProxyHost());
+
+    Poco::Environment::set("no_proxy", "");
+    Netconf::InvalidateProxyCache();
+}
+
+TEST(UpdateBatcher, CollectsBurstIntoOneBatch) {
+    UpdateBatcher batcher(3);
+    Poco::UInt64 user_id(0);
+    ASSERT_TRUE(batcher.Take(&user_id).empty());
+
+    Json::Value update;
+    update["model"] = "time_entry";
+
+    update["data"]["id"] = 1;
+    ASSERT_EQ(1u, batcher.Add(update, 10));
+    update["data"]["id"] = 2;
+    ASSERT_EQ(2u, batcher.Add(update, 10));
+    update["data"]["id"] = 3;
+    ASSERT_EQ(batcher.MaxBatchSize(), batcher.Add(update, 10));
+
+    std::vector<Json::Value> batch = batcher.Take(&user_id);
+    ASSERT_EQ(3u, batch.size());
+    ASSERT_EQ(10u, user_id);
+    ASSERT_EQ(1, batch[0]["data"]["id"].asInt());
+    ASSERT_EQ(3, batch[2]["data"]["id"].asInt());
+    ASSERT_TRUE(batcher.Take(&user_id).empty());
+
+    ASSERT_EQ(1u, batcher.Add(update, 10));
+    ASSERT_EQ(1u, batcher.Take(&user_id).size());
+
+    UpdateBatchStats stats = batcher.Stats();
+    ASSERT_EQ(2u, stats.Batches);
+    ASSERT_EQ(4u, stats.Updates);
+    ASSERT_EQ(0u, stats.Dropped);
+    ASSERT_EQ(3u, stats.LargestBatch);
+    ASSERT_EQ(1u, stats.LastBatch);
+}
+
+TEST(UpdateBatcher, DropsUpdatesOfThePreviousUser) {
+    UpdateBatcher batcher;
+    Json::Value update;
+    update["model"] = "time_entry";
+
+    // Another user logs in before the batch is applied
+    ASSERT_EQ(1u, batcher.Add(update, 10));
+    ASSERT_EQ(2u, batcher.Add(update, 10));
+    ASSERT_EQ(1u, batcher.Add(update, 20));
+
+    Poco::UInt64 user_id(0);
+    ASSERT_EQ(1u, batcher.Take(&user_id).size());
+    ASSERT_EQ(20u, user_id);
+
+    // Logging out drops what is waiting
+    ASSERT_EQ(1u, batcher.Add(update, 20));
+    batcher.Clear();
+    ASSERT_TRUE(batcher.Take(&user_id).empty());
+
+    ASSERT_EQ(3u, batcher.Stats().Dropped);
+}
+
+TEST(TimelineEventQueue, DropsEventsWhenFull) {
+    TimelineEventQueue queue(3);
+    ASSERT_EQ(4u, queue.Capacity());
+    ASSERT_TRUE(queue.Take().empty());
+
+    for (std::size_t i = 1; i <= 4; i++) {
+        TimelineEvent *event = new TimelineEvent();
+        event->SetTitle(std::to_string(i));
+        ASSERT_EQ(i, queue.Push(event));
+    }
+    TimelineEvent overflow;
+    ASSERT_EQ(0u, queue.Push(&overflow));
+
+    std::vector<TimelineEvent *> batch = queue.Take();
+    ASSERT_EQ(4u, batch.size());
+    ASSERT_EQ("1", batch[0]->Title());
+    ASSERT_EQ("4", batch[3]->Title());
+    for (std::size_t i = 0; i < batch.size(); i++) {
+        delete batch[i];
+    }
+
+    // The slots are free again, left over events go with the queue
+    ASSERT_EQ(1u, queue.Push(new TimelineEvent()));
+
+    TimelineEventQueueStats stats = queue.Stats();
+    ASSERT_EQ(5u, stats.Queued);
+    ASSERT_EQ(1u, stats.Dropped);
+    ASSERT_EQ(1u, stats.Batches);
+    ASSERT_EQ(4u, stats.LargestBatch);
+    ASSERT_EQ(1u, stats.Depth);
+}
+
+TEST(TimelineEventQueue, TakesEventsOfConcurrentProducers) {
+    TimelineEventQueue queue(64);
+    const int producers = 4;
+    const int per_producer = 2000;
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([&queue, p, per_producer]() {
+            for (int i = 0; i < per_producer; i++) {
+                TimelineEvent *event = new TimelineEvent();
+                event->SetStartTime(p * per_producer + i);
+                while (!queue.Push(event)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // Every event arrives once and in order of its producer
+    std::vector<Poco::Int64> last(producers, -1);
+    int taken = 0;
+    while (taken < producers * per_producer) {
+        std::vector<TimelineEvent *> batch = queue.Take();
+        for (std::size_t i = 0; i < batch.size(); i++) {
+            Poco::Int64 start = batch[i]->Start();
+            int p = static_cast<int>(start / per_producer);
+            ASSERT_GT(start, last[p]);
+            last[p] = start;
+            delete batch[i];
+        }
+        taken += static_cast<int>(batch.size());
+    }
+    for (std::size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+
+    ASSERT_EQ(0u, queue.Depth());
+    ASSERT_EQ(Poco::UInt64(producers * per_producer), queue.Stats().Queued);
+}
+
+#if defined(__linux__)
+// Needs an X server to do more than check the fallback, Xvfb will do.
+// Without a window manager the test announces the active window itself.
+TEST(FocusedWindow, ReportsChangesOfTheActiveWindow) {
+    Display *display = XOpenDisplay(nullptr);
+    if (!display) {
+        // The recorder polls when changes can't be waited for
+        ASSERT_FALSE(waitForFocusedWindowChange(1000));
+        return;
+    }
+
+    Window root = DefaultRootWindow(display);
+    Window window = XCreateSimpleWindow(display, root, 0, 0, 10, 10, 0, 0, 0);
+    Atom utf8_string = XInternAtom(display, "UTF8_STRING", False);
+    Atom net_wm_name = XInternAtom(display, "_NET_WM_NAME", False);
+    Atom net_active_window = XInternAtom(display, "_NET_ACTIVE_WINDOW", False);
+
+    auto set_title = [&](const std::string &title) {
+        XChangeProperty(display, window, net_wm_name, utf8_string, 8,
+                        PropModeReplace,
+                        reinterpret_cast<const unsigned char *>(title.c_str()),
+                        static_cast<int>(title.size()));
+        XFlush(display);
+    };
+    set_title("first");
+    XChangeProperty(display, root, net_active_window, XA_WINDOW, 32,
+                    PropModeReplace,
+                    reinterpret_cast<unsigned char *>(&window), 1);
+    XFlush(display);
+
+    std::string title(""), filename("");
+    bool idle(false);
+    ASSERT_EQ(0, getFocusedWindowInfo(&title, &filename, &idle));
+    ASSERT_EQ("first", title);
+
+    // A new title ends the wait long before it times out
+    std::thread changer([&set_title]() {
+        Poco::Thread::sleep(100);
+        set_title("second");
+    });
+    Poco::Timestamp started;
+    ASSERT_TRUE(waitForFocusedWindowChange(10000));
+    changer.join();
+    ASSERT_LT(started.elapsed(), 5 * Poco::Timestamp::resolution());
+    ASSERT_EQ(0, getFocusedWindowInfo(&title, &filename, &idle));
+    ASSERT_EQ("second", title);
+
+    // So does an interruption
+    std::thread interrupter([]() {
+        Poco::Thread::sleep(100);
+        interruptFocusedWindowWait();
+    });
+    started.update();
+    ASSERT_TRUE(waitForFocusedWindowChange(10000));
+    interrupter.join();
+    ASSERT_LT(started.elapsed(), 5 * Poco::Timestamp::resolution());
+
+    XDeleteProperty(display, root, net_active_window);
+    XDestroyWindow(display, window);
+    XCloseDisplay(display);
+}
+#endif
+
+namespace {
+
+// Hands out empty batches and counts how often it was asked
+class CountingTimelineDatasource : public TimelineDatasource {
+ public:
+    CountingTimelineDatasource()
+        : batches_(0) {}
+
+    error StartAutotrackerEvent(const TimelineEvent &) override {
+        return noError;
+    }
+    error StartTimelineEvent(TimelineEvent *) override {
+        return noError;
+    }
+    error CreateCompressedTimelineBatchForUpload(TimelineBatch *) override {
+        batches_++;
+        return noError;
+    }
+    error MarkTimelineBatchAsUploaded(
+        const std::vector<const TimelineEvent*> &) override {
+        return noError;
+    }
+
+    std::atomic<int> batches_;
+};
+
+}  // namespace
+
+TEST(TimelineUploader, StopsWaitingForTheNextUploadOnShutdown) {
+    CountingTimelineDatasource datasource;
+    Executor executor;
+    TimelineUploader uploader(&datasource, &executor);
+
+    // The first batch is made right away
+    for (int i = 0; i < 100 && !datasource.batches_; i++) {
+        Poco::Thread::sleep(10);
+    }
+    ASSERT_EQ(1, datasource.batches_);
+
+    // The next one is a minute away, shutting down doesn't wait for it
+    Poco::Timestamp started;
+    ASSERT_EQ(noError, uploader.Shutdown());
+    ASSERT_LT(started.elapsed(), 200 * 1000);
+    ASSERT_EQ(1, datasource.batches_);
+}
+
+namespace {
+
+// Runs a function, so tests can say what the task does in place
+class FunctionTask : public Poco::Util::TimerTask {
+ public:
+    explicit FunctionTask(std::function<void()> f)
+        : f_(f) {}
+
+    void run() override {
+        f_();
+    }
+
+ private:
+    std::function<void()> f_;
+};
+
+Poco::Timestamp millisFromNow(const Poco::Int64 millis) {
+    return Poco::Timestamp() + millis * Poco::Timespan::MILLISECONDS;
+}
+
+}  // namespace
+
+TEST(Executor, RunsTasksInDeadlineOrderAndNeverEarly) {
+    Executor executor;
+
+    Poco::Mutex m;
+    std::vector<int> order;
+    std::vector<bool> early;
+    Poco::Event done;
+    for (int i = 3; i > 0; i--) {
+        Poco::Timestamp at = millisFromNow(i * 30);
+        executor.Schedule(new FunctionTask([&, i, at]() {
+            Poco::Mutex::ScopedLock lock(m);
+            order.push_back(i);
+            early.push_back(Poco::Timestamp() < at);
+            if (order.size() == 3) {
+                done.set();
+            }
+        }), at);
+    }
+    ASSERT_TRUE(done.tryWait(2000));
+
+    ASSERT_EQ(std::vector<int>({ 1, 2, 3 }), order);
+    ASSERT_EQ(std::vector<bool>(3, false), early);
+
+    // Counted once the last one returned
+    executor.Stop();
+    ASSERT_EQ(3U, executor.Stats().Ran);
+    ASSERT_EQ(0U, executor.Stats().Pending);
+}
+
+TEST(Executor, DropsCancelledTasks) {
+    Executor executor;
+
+    std::atomic<int> runs(0);
+    Poco::Util::TimerTask::Ptr cancelled = new FunctionTask([&]() {
+        runs++;
+    });
+    executor.Schedule(cancelled, millisFromNow(30));
+    executor.Schedule(new FunctionTask([&]() {
+        runs++;
+    }), millisFromNow(1000 * 1000));
+    executor.Cancel(cancelled);
+    ASSERT_EQ(1U, executor.Stats().Pending);
+
+    executor.CancelAll();
+    Poco::Thread::sleep(80);
+    ASSERT_EQ(0, runs);
+
+    ExecutorStats stats = executor.Stats();
+    ASSERT_EQ(2U, stats.Cancelled);
+    ASSERT_EQ(0U, stats.Pending);
+    ASSERT_EQ(0U, stats.Ran);
+}
+
+TEST(Executor, DoesNotWakeUpWhenIdle) {
+    Executor executor;
+    Poco::Thread::sleep(100);
+    ASSERT_GE(1U, executor.Stats().Wakeups);
+
+    // A task far away wakes it once to look, then at most
+    // when its slot of the wheel comes up
+    executor.Schedule(new FunctionTask([]() {}), millisFromNow(60 * 1000));
+    Poco::Thread::sleep(100);
+    ASSERT_GE(3U, executor.Stats().Wakeups);
+}
+
+TEST(Executor, CascadesDistantTasksDownTheWheel) {
+    Executor executor;
+
+    // Beyond the lowest level, moved down before it runs
+    Poco::Timestamp at = millisFromNow(kExecutorTickMillis * 100);
+    Poco::Event ran;
+    std::atomic<bool> early(false);
+    executor.Schedule(new FunctionTask([&]() {
+        early = Poco::Timestamp() < at;
+        ran.set();
+    }), at);
+    ASSERT_TRUE(ran.tryWait(5000));
+
+    ASSERT_FALSE(early);
+    ASSERT_LE(1U, executor.Stats().Cascaded);
+}
+
+TEST(Executor, BlockingTasksDoNotHoldUpTheOthers) {
+    Executor executor(2);
+
+    Poco::Event release;
+    Poco::Event blocking_started;
+    executor.ScheduleBlocking(new FunctionTask([&]() {
+        blocking_started.set();
+        release.wait();
+    }), Poco::Timestamp());
+    ASSERT_TRUE(blocking_started.tryWait(1000));
+
+    // Tasks of the serial lane run one after another meanwhile
+    std::atomic<int> serial(0);
+    std::atomic<int> overlaps(0);
+    std::atomic<int> finished(0);
+    Poco::Event serial_done;
+    for (int i = 0; i < 3; i++) {
+        executor.Schedule(new FunctionTask([&]() {
+            if (serial++ != 0) {
+                overlaps++;
+            }
+            Poco::Thread::sleep(10);
+            serial--;
+            if (++finished == 3) {
+                serial_done.set();
+            }
+        }), Poco::Timestamp());
+    }
+    ASSERT_TRUE(serial_done.tryWait(1000));
+    ASSERT_EQ(0, overlaps);
+    release.set();
+
+    // Waiting for a task that already runs returns once it's done
+    Poco::Event slow_started;
+    std::atomic<bool> slow_done(false);
+    Poco::Util::TimerTask::Ptr slow = new FunctionTask([&]() {
+        slow_started.set();
+        Poco::Thread::sleep(50);
+        slow_done = true;
+    });
+    executor.ScheduleBlocking(slow, Poco::Timestamp());
+    ASSERT_TRUE(slow_started.tryWait(1000));
+    executor.CancelAndWait(slow);
+    ASSERT_TRUE(slow_done);
+}
+
+TEST(Context, NextReminderAt) {
+    Settings settings;
+    settings.reminder = true;
+    settings.reminder_minutes = 10;
+    settings.pomodoro = true;
+    settings.pomodoro_minutes = 25;
+    settings.pomodoro_break = true;
+    settings.pomodoro_break_minutes = 5;
+
+    const Poco::Int64 now = 1600000000;
+
+    // Nothing running, the tracking reminder
+    ASSERT_EQ(now - 60 + 600,
+              Context::NextReminderAt(settings, nullptr, nullptr, now - 60, now));
+    settings.reminder = false;
+    ASSERT_EQ(0, Context::NextReminderAt(settings, nullptr, nullptr, now - 60, now));
+
+    // Running, the pomodoro from when it was started
+    TimeEntry te;
+    te.SetGUID("07fba193-91c4-0ec8-2894-820df0548a8f");
+    te.SetStartTime(now - 120, false);
+    ASSERT_EQ(now - 120 + 25 * 60,
+              Context::NextReminderAt(settings, &te, nullptr, 0, now));
+
+    // Continued duration only entries count from the last start
+    te.SetDurOnly(true);
+    te.SetLastStartAt(now - 30);
+    ASSERT_EQ(now - 30 + 25 * 60,
+              Context::NextReminderAt(settings, &te, nullptr, 0, now));
+    te.SetDurOnly(false);
+
+    te.SetSkipPomodoro(true);
+    ASSERT_EQ(0, Context::NextReminderAt(settings, &te, nullptr, 0, now));
+    te.SetSkipPomodoro(false);
+
+    // Running the break, the end of the break
+    TimeEntry pomodoro_break;
+    pomodoro_break.SetGUID(te.GUID());
+    ASSERT_EQ(now - 120 + 5 * 60,
+              Context::NextReminderAt(settings, &te, &pomodoro_break, 0, now));
+    settings.pomodoro_break = false;
+    ASSERT_EQ(0, Context::NextReminderAt(settings, &te, &pomodoro_break, 0, now));
+
+    // Overdue ones weren't allowed now, looked at again later
+    te.SetStartTime(now - 60 * 60, false);
+    ASSERT_EQ(now + kReminderRecheckSeconds,
+              Context::NextReminderAt(settings, &te, nullptr, 0, now));
+}
+
+TEST(InstrumentedMutex, RecordsWaitsAndTheLongestHolders) {
+    InstrumentedMutex mutex("test_m_");
+
+    // Held for a while by another thread while this one waits
+    Poco::Event locked;
+    std::thread holder([&mutex, &locked]() {
+        InstrumentedMutex::ScopedLock lock(mutex);
+        locked.set();
+        Poco::Thread::sleep(50);
+    });
+    locked.wait();
+    {
+        InstrumentedMutex::ScopedLock lock(mutex);
+        // Locking again from the same thread doesn't count
+        InstrumentedMutex::ScopedLock again(mutex);
+    }
+    holder.join();
+
+    std::vector<LockStats> all = InstrumentedMutex::Snapshot();
+#ifdef TOGGL_LOCK_STATS
+    std::vector<LockStats>::const_iterator stats =
+        std::find_if(all.begin(), all.end(), [](const LockStats &s) {
+        return s.Name == "test_m_";
+    });
+    ASSERT_TRUE(stats != all.end());
+    ASSERT_EQ(2U, stats->Acquisitions);
+    ASSERT_EQ(1U, stats->Contended);
+
+    // One wait took 10 ms or more, the other none at all
+    ASSERT_EQ(1U, stats->WaitHistogram[0]);
+    ASSERT_EQ(1U, stats->WaitHistogram[5] + stats->WaitHistogram[6]
+              + stats->WaitHistogram[7]);
+    Poco::UInt64 holds(0);
+    for (std::size_t i = 0; i < stats->HoldHistogram.size(); i++) {
+        holds += stats->HoldHistogram[i];
+    }
+    ASSERT_EQ(2U, holds);
+
+    ASSERT_EQ(2U, stats->Holders.size());
+    ASSERT_EQ(0U, stats->Holders[0].Site.find("app_test.cc:"));
+    ASSERT_LE(50000U, stats->Holders[0].MaxHoldMicros);
+    ASSERT_GT(stats->Holders[0].MaxHoldMicros,
+              stats->Holders[1].MaxHoldMicros);
+    ASSERT_NE(std::string::npos, LockStatsToJSON(all).find("\"test_m_\""));
+#else
+    ASSERT_TRUE(all.empty());
+    ASSERT_EQ("[]\n", LockStatsToJSON(all));
+#endif
+}
+
+TEST(SyncScheduler, CoalescesRequestsAndAdaptsInterval) {
+    SyncScheduler scheduler(
+        Poco::Timespan(50 * Poco::Timespan::MILLISECONDS),
+        Poco::Timespan(200 * Poco::Timespan::MILLISECONDS),
+        Poco::Timespan(800 * Poco::Timespan::MILLISECONDS),
+        Poco::Timespan(100 * Poco::Timespan::MILLISECONDS));
+
+    // Start, edit, stop in quick succession make one cycle
+    scheduler.Request(kSyncWorkPull);
+    scheduler.Request(kSyncWorkPush);
+    scheduler.Request(kSyncWorkPull);
+    ASSERT_EQ(kSyncWorkPull | kSyncWorkPush, scheduler.Wait());
+    scheduler.CycleFinished(kSyncWorkNone);
+
+    SyncSchedulerStats stats = scheduler.Stats();
+    ASSERT_EQ(3u, stats.Requests);
+    ASSERT_EQ(1u, stats.Cycles);
+
+    // The user was active, the next periodic pull comes soon
+    ASSERT_EQ(Poco::Timespan(200 * Poco::Timespan::MILLISECONDS), scheduler.Interval());
+    Poco::Timestamp started;
+    ASSERT_EQ(kSyncWorkPull, scheduler.Wait());
+    ASSERT_GE(started.elapsed(), 200 * 1000);
+
+    // Nothing happened, back off
+    scheduler.CycleFinished(kSyncWorkNone);
+    ASSERT_EQ(Poco::Timespan(400 * Poco::Timespan::MILLISECONDS), scheduler.Interval());
+
+    // Failed cycles are retried, later every time
+    scheduler.Request(kSyncWorkPush);
+    ASSERT_EQ(kSyncWorkPush, scheduler.Wait());
+    scheduler.CycleFinished(kSyncWorkPush);
+    ASSERT_EQ(Poco::Timespan(100 * Poco::Timespan::MILLISECONDS), scheduler.Retry());
+    ASSERT_EQ(kSyncWorkPush, scheduler.Wait() & kSyncWorkPush);
+    scheduler.CycleFinished(kSyncWorkPush);
+    ASSERT_EQ(Poco::Timespan(200 * Poco::Timespan::MILLISECONDS), scheduler.Retry());
+    ASSERT_EQ(2u, scheduler.Stats().Failures);
+
+    // Stopping wakes up the waiting syncer
+    std::thread stopper([&scheduler]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        scheduler.Stop();
+    });
+    ASSERT_EQ(kSyncWorkNone, scheduler.Wait());
+    stopper.join();
+}
+
+TEST(RenderDispatcher, MergesRequestsOfOneFrame) {
+    RenderDispatcher dispatcher(Poco::Timespan(50 * Poco::Timespan::MILLISECONDS));
+
+    // Save, push and the editor setter of one user action
+    UIElements list;
+    list.display_time_entries = true;
+    list.open_time_entry_list = true;
+    UIElements timer;
+    timer.display_timer_state = true;
+    UIElements editor;
+    editor.display_time_entry_editor = true;
+    editor.open_time_entry_editor = true;
+    editor.time_entry_editor_guid = "07fba193-91c4-0ec8-2894-820df0548a8f";
+
+    Poco::Timestamp started;
+    ASSERT_FALSE(dispatcher.Request(list));
+    ASSERT_FALSE(dispatcher.Request(timer));
+    ASSERT_FALSE(dispatcher.Request(editor));
+
+    UIElements frame;
+    ASSERT_TRUE(dispatcher.Wait(&frame));
+    ASSERT_GE(started.elapsed(), 50 * 1000);
+    ASSERT_TRUE(frame.display_time_entries);
+    ASSERT_TRUE(frame.display_timer_state);
+    ASSERT_TRUE(frame.display_time_entry_editor);
+    ASSERT_EQ(editor.time_entry_editor_guid, frame.time_entry_editor_guid);
+
+    // The editor was opened last
+    ASSERT_TRUE(frame.open_time_entry_editor);
+    ASSERT_FALSE(frame.open_time_entry_list);
+
+    RenderDispatcherStats stats = dispatcher.Stats();
+    ASSERT_EQ(3u, stats.Requests);
+    ASSERT_EQ(1u, stats.Frames);
+    ASSERT_EQ(2u, stats.Merged);
+
+    // Without an interval the caller renders
+    dispatcher.SetInterval(0);
+    ASSERT_TRUE(dispatcher.Request(list));
+
+    // Stopping wakes up the render thread, callers render from then on
+    std::thread stopper([&dispatcher]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        dispatcher.Stop();
+    });
+    ASSERT_FALSE(dispatcher.Wait(&frame));
+    stopper.join();
+    dispatcher.SetInterval(Poco::Timespan(50 * Poco::Timespan::MILLISECONDS));
+    ASSERT_TRUE(dispatcher.Request(list));
+}
+
+TEST(ResponseCache, RevalidatesWithETag) {
+    ResponseCache cache;
+
+    HTTPRequest req;
+    req.host = "https://api.example.com";
+    req.relative_url = "/api/v9/me/workspaces";
+    req.basic_auth_username = "token";
+
+    // Nothing cached yet, plain request
+    cache.Prepare(&req);
+    ASSERT_EQ("", req.if_none_match);
+
+    HTTPResponse resp;
+    resp.status_code = 200;
+    resp.etag = "\"v1\"";
+    resp.body = "[{\"id\":1}]";
+    cache.Complete(req, &resp);
+
+    cache.StartCycle();
+    cache.Prepare(&req);
+    ASSERT_EQ("\"v1\"", req.if_none_match);
+
+    HTTPResponse not_modified;
+    not_modified.status_code = 304;
+    not_modified.err = HTTPClient::StatusCodeToError(304);
+    cache.Complete(req, &not_modified);
+    ASSERT_EQ(noError, not_modified.err);
+    ASSERT_EQ("[{\"id\":1}]", not_modified.body);
+
+    ResponseCacheStats stats = cache.Cycle();
+    ASSERT_EQ(1u, stats.Requests);
+    ASSERT_EQ(1u, stats.NotModified);
+    ASSERT_EQ(resp.body.size(), stats.BytesSaved);
+
+    // Another user doesn't get the cached copy
+    HTTPRequest other(req);
+    other.if_none_match = "";
+    other.basic_auth_username = "other token";
+    cache.Prepare(&other);
+    ASSERT_EQ("", other.if_none_match);
+
+    // Changed document without an ETag is no longer revalidated
+    HTTPRequest again(req);
+    again.if_none_match = "";
+    HTTPResponse changed;
+    changed.status_code = 200;
+    changed.body = "[]";
+    cache.Complete(again, &changed);
+    cache.StartCycle();
+    cache.Prepare(&again);
+    ASSERT_EQ("", again.if_none_match);
+    ASSERT_EQ(0u, cache.Cycle().Requests);
+    ASSERT_EQ(1u, cache.Total().NotModified);
+}
+
+namespace {
+
+Poco::Mutex websocket_message_m;
+Poco::Event websocket_message_received;
+Json::Value websocket_message;
+
+void on_test_websocket_message(void *, const Json::Value &message) {
+    Poco::Mutex::ScopedLock lock(websocket_message_m);
+    websocket_message = message;
+    websocket_message_received.set();
+}
+
+}  // namespace
+
+TEST(WebSocketClient, ReassemblesFragmentedMessages) {
+    std::string ca_cert_path = HTTPClient::Config.CACertPath();
+    HTTPClient::Config.SetCACertPath(
+        Poco::Path(__FILE__).parent().parent().append("ssl/cacert.pem").toString());
+
+    test::WebSocketStub stub;
+    urls::SetWebSocket(stub.URL());
+
+    int ctx(0);
+    WebSocketClient client;
+    client.Start(&ctx, "api token", on_test_websocket_message);
+    ASSERT_TRUE(stub.WaitForClient(5000));
+
+    // Way more than a single receive buffer used to hold
+    Json::Value update;
+    update["action"] = "update";
+    update["model"] = "time_entry";
+    update["data"]["description"] = std::string(200 * 1024, 'x');
+    stub.Send(Json::FastWriter().write(update), 4, true);
+
+    ASSERT_TRUE(websocket_message_received.tryWait(5000));
+    {
+        Poco::Mutex::ScopedLock lock(websocket_message_m);
+        ASSERT_EQ("time_entry", websocket_message["model"].asString());
+        ASSERT_EQ(200u * 1024,
+                  websocket_message["data"]["description"].asString().size());
+    }
+
+    std::string pong("");
+    ASSERT_TRUE(stub.WaitForPong(5000, &pong));
+    ASSERT_EQ("stub", pong);
+
+    // Shutdown must not wait for the server to say something
+    Poco::Timestamp shutdown_started;
+    client.Shutdown();
+    ASSERT_LT(shutdown_started.elapsed(), 2 * kOneSecondInMicros);
+
+    urls::SetWebSocket("");
+    HTTPClient::Config.SetCACertPath(ca_cert_path);
+}
+
+TEST(RequestBodyEncoder, SmallPayloadIsNotCompressed) {
+    RequestBodyEncoder encoder(1024);
+    std::string payload("{\"time_entry\":{}}");
+    ASSERT_EQ(noError, encoder.Encode(payload));
+    ASSERT_FALSE(encoder.Compressed());
+    ASSERT_EQ(payload.size(), encoder.Size());
+    ASSERT_EQ(payload, std::string(encoder.Data(), encoder.Size()));
+}
+
+TEST(RequestBodyEncoder, LargePayloadIsGzipped) {
+    RequestBodyEncoder encoder(1024);
+    for (int round = 0; round < 3; round++) {
+        std::stringstream ss;
+        for (int i = 0; i < 500 * (round + 1); i++) {
+            ss << "{\"description\":\"entry " << i << "\"},";
+        }
+        std::string payload = ss.str();
+
+        ASSERT_EQ(noError, encoder.Encode(payload));
+        ASSERT_TRUE(encoder.Compressed());
+        ASSERT_LT(encoder.Size(), payload.size());
+
+        std::istringstream compressed(
+            std::string(encoder.Data(), encoder.Size()));
+        Poco::InflatingInputStream inflater(
+            compressed, Poco::InflatingStreamBuf::STREAM_GZIP);
+        std::stringstream inflated;
+        inflated << inflater.rdbuf();
+        ASSERT_EQ(payload, inflated.str());
+    }
+}
+
+TEST(RequestScheduler, ParseRetryAfter) {
+    ASSERT_EQ(0, RequestScheduler::ParseRetryAfter("").totalSeconds());
+    ASSERT_EQ(0, RequestScheduler::ParseRetryAfter("soon").totalSeconds());
+    ASSERT_EQ(120, RequestScheduler::ParseRetryAfter(" 120 ").totalSeconds());
+
+    Poco::Timestamp in_a_minute = Poco::Timestamp() + 60 * kOneSecondInMicros;
+    std::string date = Poco::DateTimeFormatter::format(
+        in_a_minute, Poco::DateTimeFormat::HTTP_FORMAT);
+    ASSERT_GT(RequestScheduler::ParseRetryAfter(date).totalSeconds(), 50);
+}
+
+TEST(RequestScheduler, RateLimitBansHost) {
+    RequestScheduler scheduler(10, 10);
+    Poco::Timespan timeout(1, 0);
+
+    ASSERT_EQ(noError, scheduler.Acquire("https://a", kRequestPriorityInteractive, timeout));
+
+    scheduler.Complete("https://a", 429, "30");
+    ASSERT_GT(scheduler.BannedFor("https://a").totalSeconds(), 25);
+    ASSERT_EQ(5, scheduler.Rate("https://a"));
+    ASSERT_EQ(kCannotConnectError, scheduler.Acquire("https://a", kRequestPriorityInteractive, timeout));
+
+    // Other hosts are not affected
+    ASSERT_EQ(0, scheduler.BannedFor("https://b").totalSeconds());
+    ASSERT_EQ(noError, scheduler.Acquire("https://b", kRequestPriorityBackground, timeout));
+
+    // Successful responses bring the rate back up
+    for (int i = 0; i < 20; i++) {
+        scheduler.Complete("https://a", 200);
+    }
+    ASSERT_EQ(10, scheduler.Rate("https://a"));
+}
+
+namespace {
+
+// Scheduler whose clock only moves when told to
+class ManualClockRequestScheduler : public RequestScheduler {
+ public:
+    ManualClockRequestScheduler(
+        const double requests_per_second,
+        const double burst)
+        : RequestScheduler(requests_per_second, burst)
+    , now_(Poco::Timestamp().epochMicroseconds()) {}
+
+    void Advance(const Poco::Timestamp::TimeDiff micros) {
+        now_ += micros;
+        wakeWaiters();
+    }
+
+ protected:
+    Poco::Timestamp now() const override {
+        return Poco::Timestamp(now_.load());
+    }
+
+ private:
+    std::atomic<Poco::Timestamp::TimeVal> now_;
+};
+
+// Blocks until the condition holds, without assuming how long it takes
+template <typename Condition>
+void waitFor(Condition condition) {
+    while (!condition()) {
+        Poco::Thread::yield();
+    }
+}
+
+}  // namespace
+
+TEST(RequestScheduler, InteractiveRequestsGoFirst) {
+    ManualClockRequestScheduler scheduler(10, 1);
+    Poco::Timespan timeout(5, 0);
+
+    // Use up the only token, the clock stands still until it's advanced
+    ASSERT_EQ(noError, scheduler.Acquire("https://a", kRequestPriorityBackground, timeout));
+
+    Poco::Mutex order_m;
+    std::vector<RequestPriority> order;
+    auto acquire = [&](RequestPriority priority) {
+        ASSERT_EQ(noError, scheduler.Acquire("https://a", priority, timeout));
+        Poco::Mutex::ScopedLock lock(order_m);
+        order.push_back(priority);
+    };
+    auto served = [&]() {
+        Poco::Mutex::ScopedLock lock(order_m);
+        return order.size();
+    };
+
+    // Both wait, the background request arrived first
+    std::thread background(acquire, kRequestPriorityBackground);
+    waitFor([&]() {
+        return 1 == scheduler.Delayed(kRequestPriorityBackground);
+    });
+    std::thread interactive(acquire, kRequestPriorityInteractive);
+    waitFor([&]() {
+        return 1 == scheduler.Delayed(kRequestPriorityInteractive);
+    });
+
+    // One token at a time
+    scheduler.Advance(100 * 1000);
+    waitFor([&]() {
+        return 1 == served();
+    });
+    scheduler.Advance(100 * 1000);
+    background.join();
+    interactive.join();
+
+    ASSERT_EQ(2, order.size());
+    ASSERT_EQ(kRequestPriorityInteractive, order[0]);
+    ASSERT_EQ(kRequestPriorityBackground, order[1]);
+    ASSERT_EQ(1, scheduler.Delayed(kRequestPriorityBackground));
+}
+
+namespace {
+
+view::TimeEntry listRow(const std::string &guid, const std::string &description) {
+    view::TimeEntry row;
+    row.GUID = guid;
+    row.Description = description;
+    return row;
+}
+
+// Applies the changes like a frontend would, to the keys of the rows
+std::vector<std::string> applyListChanges(
+    const std::vector<view::TimeEntry> &previous,
+    const std::vector<view::TimeEntryListChange> &changes) {
+    std::vector<std::string> keys;
+    for (std::size_t i = 0; i < previous.size(); i++) {
+        keys.push_back(previous[i].GUID);
+    }
+    for (std::size_t i = 0; i < changes.size(); i++) {
+        if (kTimeEntryListChangeDelete == changes[i].Type) {
+            EXPECT_EQ(changes[i].Key, keys[changes[i].Index]);
+            keys.erase(keys.begin() + changes[i].Index);
+        } else if (kTimeEntryListChangeMove == changes[i].Type) {
+            keys.erase(std::find(keys.begin(), keys.end(), changes[i].Key));
+        }
+    }
+    for (std::size_t i = 0; i < changes.size(); i++) {
+        if (kTimeEntryListChangeInsert == changes[i].Type
+                || kTimeEntryListChangeMove == changes[i].Type) {
+            keys.insert(keys.begin() + changes[i].Index, changes[i].Key);
+        }
+    }
+    for (std::size_t i = 0; i < changes.size(); i++) {
+        if (kTimeEntryListChangeUpdate == changes[i].Type) {
+            EXPECT_EQ(changes[i].Key, keys[changes[i].Index]);
+        }
+    }
+    return keys;
+}
+
+}  // namespace
+
+TEST(GUI, DiffsTimeEntryList) {
+    std::vector<view::TimeEntry> previous;
+    previous.push_back(listRow("a", "one"));
+    previous.push_back(listRow("b", "two"));
+    previous.push_back(listRow("c", "three"));
+    previous.push_back(listRow("d", "four"));
+    previous.push_back(listRow("e", "five"));
+
+    std::vector<view::TimeEntryListChange> changes;
+    view::DiffTimeEntryList(previous, previous, &changes);
+    ASSERT_TRUE(changes.empty());
+
+    // One edited row is one update
+    std::vector<view::TimeEntry> current(previous);
+    current[2].Description = "edited";
+    view::DiffTimeEntryList(previous, current, &changes);
+    ASSERT_EQ(std::size_t(1), changes.size());
+    ASSERT_EQ(kTimeEntryListChangeUpdate, changes[0].Type);
+    ASSERT_EQ("c", changes[0].Key);
+    ASSERT_EQ(std::size_t(2), changes[0].Index);
+    ASSERT_EQ("edited", changes[0].Row->Description);
+
+    // A new entry on top, one deleted and one that moved
+    current.clear();
+    current.push_back(listRow("f", "six"));
+    current.push_back(listRow("a", "one"));
+    current.push_back(listRow("d", "four"));
+    current.push_back(listRow("c", "three"));
+    current.push_back(listRow("e", "five"));
+    changes.clear();
+    view::DiffTimeEntryList(previous, current, &changes);
+    ASSERT_EQ(std::size_t(3), changes.size());
+    ASSERT_EQ(kTimeEntryListChangeDelete, changes[0].Type);
+    ASSERT_EQ("b", changes[0].Key);
+    ASSERT_EQ(kTimeEntryListChangeInsert, changes[1].Type);
+    ASSERT_EQ("f", changes[1].Key);
+    ASSERT_EQ(kTimeEntryListChangeMove, changes[2].Type);
+    ASSERT_FALSE(changes[2].Row == nullptr);
+
+    std::vector<std::string> keys = applyListChanges(previous, changes);
+    ASSERT_EQ(current.size(), keys.size());
+    for (std::size_t i = 0; i < current.size(); i++) {
+        ASSERT_EQ(current[i].GUID, keys[i]);
+    }
+
+    // Group headers are told apart by their group name
+    current = previous;
+    view::TimeEntry group = listRow("a", "one");
+    group.Group = true;
+    group.GroupName = "one group";
+    current.insert(current.begin(), group);
+    changes.clear();
+    view::DiffTimeEntryList(previous, current, &changes);
+    ASSERT_EQ(std::size_t(1), changes.size());
+    ASSERT_EQ(kTimeEntryListChangeInsert, changes[0].Type);
+    ASSERT_EQ("one group", changes[0].Key);
+    ASSERT_EQ(std::size_t(0), changes[0].Index);
+
+    // Everything is new the first time
+    std::vector<view::TimeEntry> empty;
+    changes.clear();
+    view::DiffTimeEntryList(empty, previous, &changes);
+    ASSERT_EQ(previous.size(), changes.size());
+    keys = applyListChanges(empty, changes);
+    ASSERT_EQ(previous.size(), keys.size());
+}
+
+namespace {
+
+struct ListWindow {
+    std::vector<std::string> GUIDs;
+    uint64_t FirstRow;
+    uint64_t TotalRows;
+    std::vector<uint64_t> HeaderRows;
+} list_window;
+
+void on_time_entry_list_window(
+    const bool_t,
+    TogglTimeEntryView *first,
+    const uint64_t first_row,
+    const uint64_t total_rows,
+    const uint64_t *header_rows,
+    const uint64_t header_row_count,
+    const bool_t) {
+    list_window.GUIDs.clear();
+    for (TogglTimeEntryView *it = first; it;
+            it = reinterpret_cast<TogglTimeEntryView *>(it->Next)) {
+        list_window.GUIDs.push_back(to_string(it->GUID));
+    }
+    list_window.FirstRow = first_row;
+    list_window.TotalRows = total_rows;
+    list_window.HeaderRows.assign(header_rows, header_rows + header_row_count);
+}
+
+}  // namespace
+
+TEST(GUI, SendsTimeEntryListWindow) {
+    GUI gui;
+    gui.OnDisplayTimeEntryListWindow(on_time_entry_list_window);
+
+    // The list comes oldest first, ten entries a day
+    std::vector<view::TimeEntry> list;
+    for (int i = 0; i < 200; i++) {
+        view::TimeEntry te = listRow(std::to_string(i), "entry");
+        te.Started = time(nullptr);
+        te.DateHeader = "day " + std::to_string(i / 10);
+        list.push_back(te);
+    }
+    gui.DisplayTimeEntryList(true, list, false);
+
+    ASSERT_EQ(200, list_window.TotalRows);
+    ASSERT_EQ(0, list_window.FirstRow);
+    ASSERT_EQ(std::size_t(kTimeEntryListWindowRows
+                          + kTimeEntryListWindowMargin),
+              list_window.GUIDs.size());
+    ASSERT_EQ("199", list_window.GUIDs.front());
+    ASSERT_EQ(std::size_t(20), list_window.HeaderRows.size());
+    ASSERT_EQ(0, list_window.HeaderRows[0]);
+    ASSERT_EQ(10, list_window.HeaderRows[1]);
+
+    // Scrolling only remembers the window, the UI is called with
+    // the next render. Then it gets the rows around the new window.
+    ASSERT_TRUE(gui.SetTimeEntryListWindow(100, 20));
+    ASSERT_EQ(0, list_window.FirstRow);
+    gui.DisplayTimeEntryListWindow();
+    ASSERT_EQ(100 - kTimeEntryListWindowMargin, list_window.FirstRow);
+    ASSERT_EQ(std::size_t(20 + 2 * kTimeEntryListWindowMargin),
+              list_window.GUIDs.size());
+    ASSERT_EQ(std::to_string(199 - list_window.FirstRow),
+              list_window.GUIDs.front());
+
+    // Past the end only the last rows are left
+    ASSERT_TRUE(gui.SetTimeEntryListWindow(195, 20));
+    gui.DisplayTimeEntryListWindow();
+    ASSERT_EQ(195 - kTimeEntryListWindowMargin, list_window.FirstRow);
+    ASSERT_EQ(std::size_t(5 + kTimeEntryListWindowMargin),
+              list_window.GUIDs.size());
+    ASSERT_EQ("0", list_window.GUIDs.back());
+}
+
+namespace {
+
+// Chunks with activity, as "start: app duration (title duration, ...)"
+std::vector<std::string> timeline_chunks;
+
+std::string timelineEventSummary(TogglTimelineEventView *ev) {
+    std::stringstream ss;
+    ss << to_string(ev->Filename) << " " << ev->Duration << " (";
+    for (TogglTimelineEventView *sub =
+                reinterpret_cast<TogglTimelineEventView *>(ev->Event);
+            sub; sub = reinterpret_cast<TogglTimelineEventView *>(sub->Next)) {
+        ss << to_string(sub->Title) << " " << to_string(sub->DurationString);
+        if (sub->Next) {
+            ss << ", ";
+        }
+    }
+    ss << ")";
+    return ss.str();
+}
+
+void on_timeline(
+    const bool_t,
+    const char_t *,
+    TogglTimelineChunkView *first,
+    TogglTimeEntryView *,
+    const uint64_t,
+    const uint64_t) {
+    timeline_chunks.clear();
+    for (TogglTimelineChunkView *chunk = first; chunk;
+            chunk = reinterpret_cast<TogglTimelineChunkView *>(chunk->Next)) {
+        for (TogglTimelineEventView *ev =
+                    reinterpret_cast<TogglTimelineEventView *>(chunk->FirstEvent);
+                ev; ev = reinterpret_cast<TogglTimelineEventView *>(ev->Next)) {
+            std::stringstream ss;
+            ss << chunk->Started << ": " << timelineEventSummary(ev);
+            timeline_chunks.push_back(ss.str());
+        }
+    }
+}
+
+TimelineEvent *timelineEvent(
+    const Poco::Int64 start,
+    const Poco::Int64 duration,
+    const std::string &filename,
+    const std::string &title) {
+    TimelineEvent *event = new TimelineEvent();
+    event->SetStartTime(start);
+    event->SetEndTime(start + duration);
+    event->SetFilename(filename);
+    event->SetTitle(title);
+    return event;
+}
+
+}  // namespace
+
+TEST(GUI, GroupsTimelineEventsByChunk) {
+    GUI gui;
+    gui.OnDisplayTimeline(on_timeline);
+
+    Poco::LocalDateTime now;
+    Poco::LocalDateTime midnight(now.year(), now.month(), now.day());
+    Poco::Int64 chunk =
+        Poco::Timestamp::fromUtcTime(midnight.utcTime()).epochTime() + 36000;
+    chunk -= chunk % kTimelineChunkSeconds;
+
+    User user;
+    std::vector<TimelineEvent *> &events = user.related.TimelineEvents;
+    events.push_back(timelineEvent(chunk, 10, "editor", "one"));
+    events.push_back(timelineEvent(chunk + 10, 20, "editor", "two"));
+    events.push_back(timelineEvent(chunk + 30, 3, "browser", "page"));
+    events.push_back(timelineEvent(chunk + 33, 5, "editor", "one"));
+    // Without a duration it's left out, unless the app is already there
+    events.push_back(timelineEvent(chunk + 38, 0, "terminal", "shell"));
+    events.push_back(timelineEvent(chunk + 900, 7, "editor", "one"));
+    // Another day
+    events.push_back(timelineEvent(chunk - 86400, 60, "editor", "one"));
+
+    gui.DisplayTimeline(false, user.CompressedTimelineForUI(&now),
+                        std::vector<view::TimeEntry>());
+
+    ASSERT_EQ(std::size_t(3), timeline_chunks.size());
+    ASSERT_EQ(std::to_string(chunk + 900)
+              + ": editor 7 (one 00:07)", timeline_chunks[0]);
+    ASSERT_EQ(std::to_string(chunk)
+              + ": editor 35 (two 00:20, one 00:15)", timeline_chunks[1]);
+    ASSERT_EQ(std::to_string(chunk)
+              + ": browser 3 (page 00:03)", timeline_chunks[2]);
+}
+
+TEST(ViewArena, PacksReservedViewsIntoOneBlock) {
+    std::vector<view::TimeEntry> rows;
+    for (int i = 0; i < 500; i++) {
+        view::TimeEntry row = listRow(std::to_string(i), "entry");
+        row.Tags = i % 2 ? "tag" : "";
+        row.Error = i % 3 ? noError : "failed";
+        rows.push_back(row);
+    }
+
+    ViewArena arena;
+    TogglTimeEntryView *first =
+        time_entry_view_list_init(rows, 100, 300, &arena);
+    ASSERT_EQ(std::size_t(1), arena.Blocks());
+
+    std::size_t count(0);
+    for (TogglTimeEntryView *it = first; it;
+            it = reinterpret_cast<TogglTimeEntryView *>(it->Next)) {
+        const view::TimeEntry &row = rows[100 + count];
+        ASSERT_EQ(row.GUID, to_string(it->GUID));
+        ASSERT_EQ("entry", to_string(it->Description));
+        ASSERT_EQ(row.Tags.empty(), !it->Tags);
+        ASSERT_EQ(row.Error == noError, !it->Error);
+        count++;
+    }
+    ASSERT_EQ(std::size_t(200), count);
+
+    // Without a reservation the arena grows
+    std::string text(1000, 'x');
+    for (int i = 0; i < 20; i++) {
+        ASSERT_EQ(text, to_string(arena.String(text)));
+    }
+    ASSERT_LT(std::size_t(1), arena.Blocks());
+    ASSERT_GT(std::size_t(6), arena.Blocks());
+}
+
 TEST(AutotrackerRule, Matches) {
     AutotrackerRule a;
     a.SetTerm("work");
@@ -1760,6 +3186,140 @@ TEST(AutotrackerRule, Matches) {
     ASSERT_FALSE(a.Matches(ev));
 }
 
+TEST(AutotrackerMatcher, FindsTheFirstMatchingRuleLikeMatches) {
+    const char *terms[] = {
+        "work", "orking", "mail", "ail", "a", "notes.txt", "ä", "terminal", ""
+    };
+    const std::size_t count = sizeof(terms) / sizeof(terms[0]);
+
+    // Deleted rules are never found
+    AutotrackerRule deleted;
+    deleted.SetTerm("deleted");
+    deleted.Delete();
+
+    std::vector<AutotrackerRule *> rules;
+    rules.push_back(&deleted);
+    for (std::size_t i = 0; i < count; i++) {
+        AutotrackerRule *rule = new AutotrackerRule();
+        rule->SetTerm(terms[i]);
+        rules.push_back(rule);
+    }
+
+    const char *texts[][2] = {
+        { "", "" },
+        { "Terminal", "deleted" },
+        { "Thunderbird", "Inbox - MAIL" },
+        { "gedit", "Notes.txt" },
+        { "code", "I was WORKING late" },
+        { "firefox", "Ärzte" },
+        { "xyz", "qrs" }
+    };
+
+    AutotrackerMatcher matcher;
+    TimelineEvent event;
+    event.SetTitle("work");
+    ASSERT_EQ(nullptr, matcher.Find(event));
+
+    // Every suffix of the rules, so each rule gets to be the first one
+    for (std::size_t from = 0; from < rules.size(); from++) {
+        std::vector<AutotrackerRule *> subset(rules.begin() + from, rules.end());
+        matcher.Build(subset);
+        for (std::size_t t = 0; t < sizeof(texts) / sizeof(texts[0]); t++) {
+            event.SetFilename(texts[t][0]);
+            event.SetTitle(texts[t][1]);
+
+            AutotrackerRule *expected = nullptr;
+            for (std::size_t i = 0; i < subset.size(); i++) {
+                if (!subset[i]->DeletedAt() && subset[i]->Matches(event)) {
+                    expected = subset[i];
+                    break;
+                }
+            }
+            ASSERT_EQ(expected, matcher.Find(event))
+                    << "from rule " << from << ", " << event.String();
+        }
+    }
+
+    for (std::size_t i = 1; i < rules.size(); i++) {
+        delete rules[i];
+    }
+}
+
+TEST(AutotrackerCache, ForgetsTheLeastRecentlyUsedWindow) {
+    AutotrackerCache cache(2);
+    AutotrackerRule rule;
+    AutotrackerMatch match;
+    match.Rule = &rule;
+
+    ASSERT_EQ(nullptr, cache.Find("code", "main.cc"));
+    cache.Insert("code", "main.cc", match);
+    cache.Insert("code", "main.h", AutotrackerMatch());
+    ASSERT_EQ(&rule, cache.Find("code", "main.cc")->Rule);
+
+    // The filename and title are told apart
+    ASSERT_EQ(nullptr, cache.Find("codemain.cc", ""));
+
+    cache.Insert("gedit", "notes", AutotrackerMatch());
+    ASSERT_EQ(nullptr, cache.Find("code", "main.h"));
+    ASSERT_TRUE(cache.Find("code", "main.cc"));
+    ASSERT_TRUE(cache.Find("gedit", "notes"));
+
+    AutotrackerCacheStats stats = cache.Stats();
+    ASSERT_EQ(3u, stats.Hits);
+    ASSERT_EQ(3u, stats.Misses);
+    ASSERT_EQ(2u, stats.Size);
+
+    cache.Clear();
+    ASSERT_EQ(0u, cache.Stats().Size);
+    ASSERT_EQ(3u, cache.Stats().Hits);
+}
+
+TEST(RelatedData, RemembersAutotrackerMatchesUntilTheyChange) {
+    RelatedData related;
+
+    Project *project = new Project();
+    project->SetID(10);
+    related.Projects.push_back(project);
+    related.ProjectsChanged();
+
+    AutotrackerRule *rule = new AutotrackerRule();
+    rule->SetTerm("work");
+    rule->SetPID(10);
+    rule->SetTID(20);
+    related.AutotrackerRules.push_back(rule);
+    related.AutotrackerRulesChanged();
+
+    TimelineEvent event;
+    event.SetTitle("Working");
+    AutotrackerMatch match = related.MatchAutotrackerEvent(event);
+    ASSERT_EQ(rule, match.Rule);
+    ASSERT_EQ(project, match.RuleProject);
+    ASSERT_EQ(nullptr, match.RuleTask);
+
+    match = related.MatchAutotrackerEvent(event);
+    ASSERT_EQ(1u, related.AutotrackerStats().Hits);
+    ASSERT_EQ(1u, related.AutotrackerStats().Misses);
+
+    // The task turns up
+    Task *task = new Task();
+    task->SetID(20);
+    related.Tasks.push_back(task);
+    related.ProjectsChanged();
+    ASSERT_EQ(task, related.MatchAutotrackerEvent(event).RuleTask);
+
+    // An earlier rule wins over the remembered one
+    AutotrackerRule *first = new AutotrackerRule();
+    first->SetTerm("ork");
+    related.AutotrackerRules.insert(related.AutotrackerRules.begin(), first);
+    related.AutotrackerRulesChanged();
+    ASSERT_EQ(first, related.MatchAutotrackerEvent(event).Rule);
+
+    ASSERT_EQ(1u, related.AutotrackerStats().Hits);
+    ASSERT_EQ(3u, related.AutotrackerStats().Misses);
+
+    related.Clear();
+}
+
 TEST(Settings, IsSame) {
     Settings s1;
     Settings s2;
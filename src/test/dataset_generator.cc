@@ -0,0 +1,262 @@
+// Copyright 2020 Toggl Desktop developers.
+
+#include "dataset_generator.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <string>
+
+#include "const.h"
+#include "model/timeline_event.h"
+#include "model/user.h"
+
+#include <Poco/DateTimeFormat.h>
+#include <Poco/DateTimeFormatter.h>
+#include <Poco/Timestamp.h>
+
+namespace toggl {
+
+namespace test {
+
+namespace {
+
+const Poco::UInt64 kUserID = 10000;
+const Poco::UInt64 kFirstWorkspaceID = 1000;
+const Poco::UInt64 kFirstClientID = 100000;
+const Poco::UInt64 kFirstProjectID = 2000000;
+const Poco::UInt64 kFirstTaskID = 3000000;
+const Poco::UInt64 kFirstTagID = 4000000;
+const Poco::UInt64 kFirstTimeEntryID = 10000000;
+
+const char *kApps[] = {
+    "Google Chrome", "Slack", "Visual Studio Code", "Terminal", "Mail",
+    "Calendar", "Figma", "Spotify", "Zoom", "Notes"
+};
+
+std::string iso8601(const Poco::Int64 epoch) {
+    return Poco::DateTimeFormatter::format(
+        Poco::Timestamp::fromEpochTime(static_cast<std::time_t>(epoch)),
+        Poco::DateTimeFormat::ISO8601_FORMAT);
+}
+
+std::string guidOf(const Poco::UInt64 kind, const Poco::UInt64 index) {
+    char buf[40];
+    snprintf(buf, sizeof(buf), "%08llx-0000-4000-8000-%012llx",
+             static_cast<unsigned long long>(kind),  // NOLINT
+             static_cast<unsigned long long>(index));  // NOLINT
+    return buf;
+}
+
+// Index below count of an item belonging to the same workspace as
+// the item with the given index, collections are spread over
+// workspaces round robin
+Poco::UInt64 inWorkspace(
+    const Poco::UInt64 pick,
+    const Poco::UInt64 count,
+    const Poco::UInt64 workspace,
+    const Poco::UInt64 workspaces) {
+    Poco::UInt64 index = pick % count;
+    index = index - index % workspaces + workspace;
+    if (index >= count) {
+        index -= workspaces;
+    }
+    return index;
+}
+
+}  // namespace
+
+DatasetSize::DatasetSize(const Poco::UInt64 time_entries)
+    : Workspaces(std::max<Poco::UInt64>(1, time_entries / 10000))
+, Clients(std::max<Poco::UInt64>(Workspaces, time_entries / 100))
+, Projects(std::max<Poco::UInt64>(Workspaces, time_entries / 20))
+, Tasks(time_entries / 10)
+, Tags(std::max<Poco::UInt64>(Workspaces, time_entries / 50))
+, TimeEntries(time_entries)
+, Descriptions(std::max<Poco::UInt64>(1, time_entries / 10))
+, TimelineEvents(time_entries) {}
+
+Json::Value GenerateUserData(const DatasetSize &size) {
+    Poco::Int64 now = time(nullptr);
+    Poco::Int64 today = now - now % 86400;
+    // Stamped with the day instead of the second, so the same size
+    // makes the same data all day long
+    Poco::Int64 updated_at = today;
+
+    Json::Value data;
+    data["id"] = Json::UInt64(kUserID);
+    data["api_token"] = "0123456789abcdef0123456789abcdef";
+    data["default_wid"] = Json::UInt64(kFirstWorkspaceID);
+    data["email"] = "large.account@toggl.com";
+    data["fullname"] = "Large Account";
+    data["store_start_and_stop_time"] = true;
+    data["beginning_of_week"] = 1;
+    data["record_timeline"] = true;
+    data["at"] = iso8601(updated_at);
+
+    Json::Value &workspaces = data["workspaces"];
+    for (Poco::UInt64 i = 0; i < size.Workspaces; i++) {
+        Json::Value ws;
+        ws["id"] = Json::UInt64(kFirstWorkspaceID + i);
+        ws["name"] = "Workspace " + std::to_string(i);
+        ws["premium"] = true;
+        ws["admin"] = true;
+        ws["at"] = iso8601(updated_at);
+        workspaces.append(ws);
+    }
+
+    Json::Value &clients = data["clients"];
+    for (Poco::UInt64 i = 0; i < size.Clients; i++) {
+        Json::Value c;
+        c["id"] = Json::UInt64(kFirstClientID + i);
+        c["guid"] = guidOf(1, i);
+        c["wid"] = Json::UInt64(kFirstWorkspaceID + i % size.Workspaces);
+        c["name"] = "Client " + std::to_string(i);
+        c["at"] = iso8601(updated_at);
+        clients.append(c);
+    }
+
+    Json::Value &projects = data["projects"];
+    for (Poco::UInt64 i = 0; i < size.Projects; i++) {
+        Poco::UInt64 ws = i % size.Workspaces;
+        Json::Value p;
+        p["id"] = Json::UInt64(kFirstProjectID + i);
+        p["guid"] = guidOf(2, i);
+        p["wid"] = Json::UInt64(kFirstWorkspaceID + ws);
+        // Every third project is internal, without a client
+        if (i % 3) {
+            p["cid"] = Json::UInt64(kFirstClientID
+                                    + inWorkspace(i * 7, size.Clients, ws, size.Workspaces));
+        }
+        p["name"] = "Project " + std::to_string(i);
+        p["billable"] = (i % 2) == 0;
+        p["is_private"] = false;
+        p["active"] = (i % 10) != 0;
+        p["color"] = std::to_string(i % 14);
+        p["at"] = iso8601(updated_at);
+        projects.append(p);
+    }
+
+    // Task i belongs to project i % Projects
+    Json::Value &tasks = data["tasks"];
+    for (Poco::UInt64 i = 0; i < size.Tasks; i++) {
+        Poco::UInt64 project = i % size.Projects;
+        Json::Value t;
+        t["id"] = Json::UInt64(kFirstTaskID + i);
+        t["name"] = "Task " + std::to_string(i);
+        t["wid"] = Json::UInt64(kFirstWorkspaceID + project % size.Workspaces);
+        t["pid"] = Json::UInt64(kFirstProjectID + project);
+        t["active"] = true;
+        t["at"] = iso8601(updated_at);
+        tasks.append(t);
+    }
+
+    Json::Value &tags = data["tags"];
+    for (Poco::UInt64 i = 0; i < size.Tags; i++) {
+        Json::Value t;
+        t["id"] = Json::UInt64(kFirstTagID + i);
+        t["guid"] = guidOf(3, i);
+        t["wid"] = Json::UInt64(kFirstWorkspaceID + i % size.Workspaces);
+        t["name"] = "tag " + std::to_string(i);
+        t["at"] = iso8601(updated_at);
+        tags.append(t);
+    }
+
+    // Eight entries a working day, the newest first
+    Json::Value &time_entries = data["time_entries"];
+    for (Poco::UInt64 i = 0; i < size.TimeEntries; i++) {
+        Poco::Int64 start = today - static_cast<Poco::Int64>(i / 8) * 86400
+                            + 8 * 3600 + static_cast<Poco::Int64>(i % 8) * 3600;
+        Poco::Int64 duration = 1800 + static_cast<Poco::Int64>(i * 37 % 1700);
+
+        Json::Value te;
+        te["id"] = Json::UInt64(kFirstTimeEntryID + i);
+        te["guid"] = guidOf(4, i);
+        te["description"] = "Working on item "
+                            + std::to_string((i * 7919) % size.Descriptions);
+        te["billable"] = (i % 4) == 0;
+        te["duronly"] = false;
+        te["start"] = iso8601(start);
+        te["stop"] = iso8601(start + duration);
+        te["duration"] = Json::Int64(duration);
+        te["at"] = iso8601(start + duration);
+
+        // Every fifth entry has no project
+        Poco::UInt64 ws = i % size.Workspaces;
+        if (i % 5) {
+            Poco::UInt64 project = (i * 31) % size.Projects;
+            ws = project % size.Workspaces;
+            te["pid"] = Json::UInt64(kFirstProjectID + project);
+            if (i % 3 == 0 && project < size.Tasks) {
+                te["tid"] = Json::UInt64(kFirstTaskID + project);
+            }
+        }
+        te["wid"] = Json::UInt64(kFirstWorkspaceID + ws);
+
+        Json::Value entry_tags(Json::arrayValue);
+        for (Poco::UInt64 t = 0; t < i % 3; t++) {
+            Poco::UInt64 tag = inWorkspace(i * 13 + t * size.Workspaces,
+                                           size.Tags, ws, size.Workspaces);
+            entry_tags.append("tag " + std::to_string(tag));
+        }
+        te["tags"] = entry_tags;
+
+        time_entries.append(te);
+    }
+
+    Json::Value root;
+    root["since"] = Json::Int64(updated_at);
+    root["data"] = data;
+    return root;
+}
+
+std::string GenerateUserJSON(const DatasetSize &size) {
+    return Json::FastWriter().write(GenerateUserData(size));
+}
+
+void GenerateTimelineEvents(const DatasetSize &size, User *user) {
+    // Five seconds each, ending where the current chunk starts so
+    // all of them can be compressed
+    Poco::Int64 now = time(nullptr);
+    Poco::Int64 end = now - now % kTimelineChunkSeconds;
+    Poco::Int64 start = end - static_cast<Poco::Int64>(size.TimelineEvents) * 5;
+
+    const Poco::UInt64 apps = sizeof(kApps) / sizeof(kApps[0]);
+    for (Poco::UInt64 i = 0; i < size.TimelineEvents; i++) {
+        TimelineEvent *event = new TimelineEvent();
+        event->SetUID(user->ID());
+        event->SetStartTime(start + static_cast<Poco::Int64>(i) * 5);
+        event->SetEndTime(event->Start() + 5);
+        // Mostly the same app for a while, then something else
+        Poco::UInt64 app = (i / 12 + i % 3) % apps;
+        event->SetFilename(kApps[app]);
+        event->SetTitle(std::string(kApps[app]) + " - window " + std::to_string(i % 7));
+        event->SetIdle(i % 97 == 0);
+        user->related.TimelineEvents.push_back(event);
+    }
+}
+
+void GenerateTimelineActivity(const Poco::UInt64 days, User *user) {
+    Poco::Int64 now = time(nullptr);
+    Poco::Int64 end = now - now % kTimelineChunkSeconds;
+    Poco::Int64 start = end - static_cast<Poco::Int64>(days) * 86400;
+
+    const Poco::UInt64 apps = sizeof(kApps) / sizeof(kApps[0]);
+    Poco::UInt64 i(0);
+    for (Poco::Int64 at = start; at < end; i++) {
+        TimelineEvent *event = new TimelineEvent();
+        event->SetUID(user->ID());
+        event->SetStartTime(at);
+        event->SetEndTime(std::min(end, at + 1 + static_cast<Poco::Int64>(i % 9)));
+        Poco::UInt64 app = (i / 12 + i % 3) % apps;
+        event->SetFilename(kApps[app]);
+        event->SetTitle(std::string(kApps[app]) + " - window " + std::to_string(i % 7));
+        event->SetIdle(i % 97 == 0);
+        user->related.TimelineEvents.push_back(event);
+        at = event->EndTime();
+    }
+}
+
+}  // namespace test
+
+}  // namespace toggl
@@ -0,0 +1,53 @@
+// Copyright 2020 Toggl Desktop developers.
+
+#ifndef SRC_TEST_DATASET_GENERATOR_H_
+#define SRC_TEST_DATASET_GENERATOR_H_
+
+#include <string>
+
+#include <json/json.h>  // NOLINT
+
+#include <Poco/Types.h>
+
+namespace toggl {
+
+class User;
+
+namespace test {
+
+// How big a generated account is. The other collections are derived
+// from the number of time entries, roughly like a busy team account.
+class DatasetSize {
+ public:
+    explicit DatasetSize(const Poco::UInt64 time_entries);
+
+    Poco::UInt64 Workspaces;
+    Poco::UInt64 Clients;
+    Poco::UInt64 Projects;
+    Poco::UInt64 Tasks;
+    Poco::UInt64 Tags;
+    Poco::UInt64 TimeEntries;
+    // Distinct time entry descriptions
+    Poco::UInt64 Descriptions;
+    Poco::UInt64 TimelineEvents;
+};
+
+// A /me?with_related_data=true response for a user with that much data,
+// in the shape of testdata/me.json. The same size always gives the same
+// data. Time entries go back from today, a working day at a time.
+Json::Value GenerateUserData(const DatasetSize &size);
+std::string GenerateUserJSON(const DatasetSize &size);
+
+// Adds recorded timeline events from the last few hours to the user,
+// none of them compressed or uploaded yet
+void GenerateTimelineEvents(const DatasetSize &size, User *user);
+
+// Adds that many days of recorded activity up to the current chunk,
+// switching windows every one to nine seconds
+void GenerateTimelineActivity(const Poco::UInt64 days, User *user);
+
+}  // namespace test
+
+}  // namespace toggl
+
+#endif  // SRC_TEST_DATASET_GENERATOR_H_
@@ -0,0 +1,422 @@
+// Copyright 2020 Toggl Desktop developers.
+
+// Loading, saving and presenting a user's data with generated accounts of
+// 1k, 10k and 100k time entries (see dataset_generator.h).
+//
+// The 100k runs take minutes, pick what to run with --benchmark_filter.
+// To compare against a baseline, write the results as JSON:
+//   TogglRelatedDataBenchmark --benchmark_out=new.json --benchmark_out_format=json
+// and compare them with tools/compare.py from Google Benchmark:
+//   compare.py benchmarks baseline.json new.json
+
+#include <benchmark/benchmark.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <json/json.h>  // NOLINT
+
+#include "database/database.h"
+#include "gui.h"
+#include "model/autotracker.h"
+#include "model/project.h"
+#include "model/time_entry.h"
+#include "model/timeline_event.h"
+#include "model/user.h"
+#include "model_change.h"
+#include "related_data.h"
+
+#include "dataset_generator.h"
+
+#include <Poco/File.h>
+#include <Poco/LocalDateTime.h>
+#include <Poco/Path.h>
+#include <Poco/Timespan.h>
+
+namespace toggl {
+
+namespace {
+
+// Generating the bigger accounts takes a while, so every size is
+// generated once and shared between the benchmarks
+const Json::Value &dataset(const Poco::UInt64 time_entries) {
+    static std::map<Poco::UInt64, Json::Value> datasets;
+    std::map<Poco::UInt64, Json::Value>::const_iterator it =
+        datasets.find(time_entries);
+    if (it == datasets.end()) {
+        it = datasets.insert(std::make_pair(
+            time_entries,
+            test::GenerateUserData(test::DatasetSize(time_entries)))).first;
+    }
+    return it->second;
+}
+
+User *loadedUser(const benchmark::State &state) {
+    User *user = new User();
+    user->LoadUserAndRelatedDataFromJSON(
+        dataset(static_cast<Poco::UInt64>(state.range(0))), true, false);
+    return user;
+}
+
+// Users loaded once for the benchmarks that only read them
+const User *sharedUser(const benchmark::State &state) {
+    static std::map<Poco::UInt64, User *> users;
+    Poco::UInt64 time_entries = static_cast<Poco::UInt64>(state.range(0));
+    User *&user = users[time_entries];
+    if (!user) {
+        user = loadedUser(state);
+    }
+    return user;
+}
+
+std::string databasePath() {
+    return Poco::Path::temp() + "toggl_related_data_benchmark.db";
+}
+
+Database *emptyDatabase() {
+    Poco::File f(databasePath());
+    if (f.exists()) {
+        f.remove(false);
+    }
+    return new Database(databasePath());
+}
+
+void setCounters(benchmark::State &state) {
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+}  // namespace
+
+static void BM_User_LoadUserAndRelatedDataFromJSON(benchmark::State &state) {
+    const Json::Value &root = dataset(static_cast<Poco::UInt64>(state.range(0)));
+    for (auto _ : state) {
+        state.PauseTiming();
+        User *user = new User();
+        state.ResumeTiming();
+
+        user->LoadUserAndRelatedDataFromJSON(root, true, false);
+
+        state.PauseTiming();
+        delete user;
+        state.ResumeTiming();
+    }
+    setCounters(state);
+}
+BENCHMARK(BM_User_LoadUserAndRelatedDataFromJSON)
+->Arg(1000)->Arg(10000)->Arg(100000)
+->Unit(benchmark::kMillisecond);
+
+// A freshly pulled account saved into an empty database
+static void BM_Database_SaveUser(benchmark::State &state) {
+    for (auto _ : state) {
+        state.PauseTiming();
+        Database *db = emptyDatabase();
+        User *user = loadedUser(state);
+        std::vector<ModelChange> changes;
+        state.ResumeTiming();
+
+        error err = db->SaveUser(user, true, &changes);
+
+        state.PauseTiming();
+        if (err != noError) {
+            state.SkipWithError(err.c_str());
+        }
+        delete user;
+        delete db;
+        state.ResumeTiming();
+    }
+    setCounters(state);
+}
+BENCHMARK(BM_Database_SaveUser)
+->Arg(1000)->Arg(10000)->Arg(100000)
+->Unit(benchmark::kMillisecond);
+
+// What happens on every app start
+static void BM_Database_LoadUserByID(benchmark::State &state) {
+    Database *db = emptyDatabase();
+    User *saved = loadedUser(state);
+    std::vector<ModelChange> changes;
+    error err = db->SaveUser(saved, true, &changes);
+    if (err != noError) {
+        state.SkipWithError(err.c_str());
+    }
+
+    for (auto _ : state) {
+        User *user = new User();
+        err = db->LoadUserByID(saved->ID(), user);
+
+        state.PauseTiming();
+        if (err != noError) {
+            state.SkipWithError(err.c_str());
+        }
+        delete user;
+        state.ResumeTiming();
+    }
+    setCounters(state);
+
+    delete saved;
+    delete db;
+}
+BENCHMARK(BM_Database_LoadUserByID)
+->Arg(1000)->Arg(10000)->Arg(100000)
+->Unit(benchmark::kMillisecond);
+
+static void BM_RelatedData_TimeEntryAutocompleteItems(benchmark::State &state) {
+    const User *user = sharedUser(state);
+    for (auto _ : state) {
+        std::vector<view::Autocomplete> items;
+        user->related.TimeEntryAutocompleteItems(&items);
+        benchmark::DoNotOptimize(items.data());
+    }
+    setCounters(state);
+}
+BENCHMARK(BM_RelatedData_TimeEntryAutocompleteItems)
+->Arg(1000)->Arg(10000)->Arg(100000)
+->Unit(benchmark::kMillisecond);
+
+static void BM_RelatedData_MinitimerAutocompleteItems(benchmark::State &state) {
+    const User *user = sharedUser(state);
+    for (auto _ : state) {
+        std::vector<view::Autocomplete> items;
+        user->related.MinitimerAutocompleteItems(&items);
+        benchmark::DoNotOptimize(items.data());
+    }
+    setCounters(state);
+}
+BENCHMARK(BM_RelatedData_MinitimerAutocompleteItems)
+->Arg(1000)->Arg(10000)->Arg(100000)
+->Unit(benchmark::kMillisecond);
+
+static void BM_RelatedData_ProjectAutocompleteItems(benchmark::State &state) {
+    const User *user = sharedUser(state);
+    for (auto _ : state) {
+        std::vector<view::Autocomplete> items;
+        user->related.ProjectAutocompleteItems(&items);
+        benchmark::DoNotOptimize(items.data());
+    }
+    setCounters(state);
+}
+BENCHMARK(BM_RelatedData_ProjectAutocompleteItems)
+->Arg(1000)->Arg(10000)->Arg(100000)
+->Unit(benchmark::kMillisecond);
+
+static void BM_RelatedData_VisibleTimeEntries(benchmark::State &state) {
+    const User *user = sharedUser(state);
+    for (auto _ : state) {
+        std::vector<TimeEntry *> visible = user->related.VisibleTimeEntries();
+        benchmark::DoNotOptimize(visible.data());
+    }
+    setCounters(state);
+}
+BENCHMARK(BM_RelatedData_VisibleTimeEntries)
+->Arg(1000)->Arg(10000)->Arg(100000)
+->Unit(benchmark::kMillisecond);
+
+// Total of the newest day, as shown in the time entry list header
+static void BM_RelatedData_TotalDurationForDate(benchmark::State &state) {
+    const User *user = sharedUser(state);
+    const TimeEntry *newest = user->related.TimeEntries.front();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(user->related.TotalDurationForDate(newest));
+    }
+    setCounters(state);
+}
+BENCHMARK(BM_RelatedData_TotalDurationForDate)
+->Arg(1000)->Arg(10000)->Arg(100000)
+->Unit(benchmark::kMillisecond);
+
+// As many timeline events as time entries, recorded in five second steps.
+// Compression only looks at the timeline, so the user has no other data.
+static void BM_User_CompressTimeline(benchmark::State &state) {
+    test::DatasetSize size(static_cast<Poco::UInt64>(state.range(0)));
+    for (auto _ : state) {
+        state.PauseTiming();
+        User *user = new User();
+        user->SetID(10000);
+        test::GenerateTimelineEvents(size, user);
+        state.ResumeTiming();
+
+        user->CompressTimeline();
+
+        state.PauseTiming();
+        delete user;
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * size.TimelineEvents);
+}
+BENCHMARK(BM_User_CompressTimeline)
+->Arg(1000)->Arg(10000)->Arg(100000)
+->Unit(benchmark::kMillisecond);
+
+// The same events, folded into their chunks one by one as they are recorded
+static void BM_User_AddTimelineEvent(benchmark::State &state) {
+    test::DatasetSize size(static_cast<Poco::UInt64>(state.range(0)));
+    for (auto _ : state) {
+        state.PauseTiming();
+        User *user = new User();
+        user->SetID(10000);
+        test::GenerateTimelineEvents(size, user);
+        std::vector<TimelineEvent *> events;
+        events.swap(user->related.TimelineEvents);
+        state.ResumeTiming();
+
+        for (std::size_t i = 0; i < events.size(); i++) {
+            user->AddTimelineEvent(events[i]);
+        }
+        user->CloseTimelineChunks();
+
+        state.PauseTiming();
+        delete user;
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * size.TimelineEvents);
+}
+BENCHMARK(BM_User_AddTimelineEvent)
+->Arg(1000)->Arg(10000)->Arg(100000)
+->Unit(benchmark::kMillisecond);
+
+namespace {
+
+// A week of activity recorded to the second, of which one full day
+// (yesterday) is rendered. Nothing is compressed yet.
+const User *timelineUser() {
+    static User *user = nullptr;
+    if (!user) {
+        user = new User();
+        user->SetID(10000);
+        test::GenerateTimelineActivity(7, user);
+    }
+    return user;
+}
+
+Poco::LocalDateTime yesterday() {
+    return Poco::LocalDateTime() - Poco::Timespan(1 * Poco::Timespan::DAYS);
+}
+
+void on_timeline(const bool_t, const char_t *, TogglTimelineChunkView *,
+                 TogglTimeEntryView *, const uint64_t, const uint64_t) {}
+
+}  // namespace
+
+static void BM_User_CompressedTimelineForUI(benchmark::State &state) {
+    const User *user = timelineUser();
+    Poco::LocalDateTime date = yesterday();
+    for (auto _ : state) {
+        std::vector<const TimelineEvent *> events =
+            user->CompressedTimelineForUI(&date);
+        benchmark::DoNotOptimize(events.data());
+    }
+    state.SetItemsProcessed(
+        state.iterations() * user->related.TimelineEvents.size());
+}
+BENCHMARK(BM_User_CompressedTimelineForUI)
+->Unit(benchmark::kMillisecond);
+
+static void BM_GUI_DisplayTimeline(benchmark::State &state) {
+    const User *user = timelineUser();
+    GUI gui;
+    gui.OnDisplayTimeline(on_timeline);
+    gui.SetTimelineDateAt(yesterday());
+    Poco::LocalDateTime date = gui.TimelineDateAt();
+    std::vector<const TimelineEvent *> events =
+        user->CompressedTimelineForUI(&date);
+    std::vector<view::TimeEntry> time_entries;
+    for (auto _ : state) {
+        gui.DisplayTimeline(false, events, time_entries);
+    }
+    state.SetItemsProcessed(state.iterations() * events.size());
+}
+BENCHMARK(BM_GUI_DisplayTimeline)
+->Unit(benchmark::kMillisecond);
+
+
+namespace {
+
+// Rules for as many projects as asked for, only the last one matches
+void addAutotrackerRules(const std::size_t count, RelatedData *related) {
+    for (std::size_t i = 0; i < count; i++) {
+        AutotrackerRule *rule = new AutotrackerRule();
+        rule->SetTerm("project " + std::to_string(count - i));
+        rule->SetPID(i + 1);
+        related->AutotrackerRules.push_back(rule);
+    }
+    related->AutotrackerRulesChanged();
+}
+
+// One project per rule
+void addProjects(const std::size_t count, RelatedData *related) {
+    for (std::size_t i = 0; i < count; i++) {
+        Project *project = new Project();
+        project->SetID(i + 1);
+        related->Projects.push_back(project);
+    }
+    related->ProjectsChanged();
+}
+
+void focusWindow(TimelineEvent *event) {
+    event->SetFilename("code");
+    event->SetTitle("Project 1 - main.cc - Visual Studio Code");
+}
+
+}  // namespace
+
+// Trying every rule on its own, as rule lookup used to work
+static void BM_AutotrackerRule_MatchEach(benchmark::State &state) {
+    RelatedData related;
+    addAutotrackerRules(static_cast<std::size_t>(state.range(0)), &related);
+    TimelineEvent event;
+    focusWindow(&event);
+    for (auto _ : state) {
+        AutotrackerRule *found = nullptr;
+        for (std::size_t i = 0; i < related.AutotrackerRules.size(); i++) {
+            if (related.AutotrackerRules[i]->Matches(event)) {
+                found = related.AutotrackerRules[i];
+                break;
+            }
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_AutotrackerRule_MatchEach)
+->Arg(10)->Arg(100)->Arg(1000);
+
+static void BM_RelatedData_FindAutotrackerRule(benchmark::State &state) {
+    RelatedData related;
+    addAutotrackerRules(static_cast<std::size_t>(state.range(0)), &related);
+    TimelineEvent event;
+    focusWindow(&event);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(related.FindAutotrackerRule(event));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RelatedData_FindAutotrackerRule)
+->Arg(10)->Arg(100)->Arg(1000);
+
+
+// The autotracker notification for the same window again, looked up
+// anew every time (first arg 0) or remembered (1)
+static void BM_RelatedData_MatchAutotrackerEvent(benchmark::State &state) {
+    RelatedData related;
+    const std::size_t rules = static_cast<std::size_t>(state.range(0));
+    addAutotrackerRules(rules, &related);
+    addProjects(rules, &related);
+    TimelineEvent event;
+    focusWindow(&event);
+    for (auto _ : state) {
+        if (!state.range(1)) {
+            related.ProjectsChanged();
+        }
+        benchmark::DoNotOptimize(related.MatchAutotrackerEvent(event));
+    }
+    AutotrackerCacheStats stats = related.AutotrackerStats();
+    state.counters["hits"] = static_cast<double>(stats.Hits);
+    state.counters["misses"] = static_cast<double>(stats.Misses);
+}
+BENCHMARK(BM_RelatedData_MatchAutotrackerEvent)
+->Args({10, 0})->Args({10, 1})
+->Args({1000, 0})->Args({1000, 1});
+
+}  // namespace toggl
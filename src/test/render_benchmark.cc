@@ -0,0 +1,661 @@
+// Copyright 2020 Toggl Desktop developers.
+
+// What the UI gets to render, and how soon, for a generated account
+// (see dataset_generator.h) of 1k and 10k time entries. The GUI callbacks
+// do nothing but count; every benchmark reports per iteration:
+//   - <path>_calls: callbacks of that render path
+//   - <path>_ms: time from the user action until its last callback
+//   - callbacks: callbacks of any kind
+//   - allocations: heap allocations made for the views passed to the UI
+//   - frames: render passes, merged: render requests that joined one
+// Autocompletes are rendered on the timer thread after a time entry changes,
+// so they show up as counters of the start, stop, edit and sync actions.
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include <json/json.h>  // NOLINT
+
+#include "context.h"
+#include "gui.h"
+#include "toggl_api.h"
+#include "toggl_api_private.h"
+#include "urls.h"
+
+#include "dataset_generator.h"
+#include "toggl_api_test.h"
+#include "websocket_stub.h"
+
+#include <Poco/Condition.h>
+#include <Poco/DateTimeFormat.h>
+#include <Poco/DateTimeFormatter.h>
+#include <Poco/File.h>
+#include <Poco/Mutex.h>
+#include <Poco/Path.h>
+#include <Poco/Timestamp.h>
+
+namespace toggl {
+
+namespace {
+
+enum RenderPath {
+    kRenderTimeEntryList = 0,
+    kRenderTimeline,
+    kRenderTimeEntryAutocomplete,
+    kRenderMiniTimerAutocomplete,
+    kRenderProjectAutocomplete,
+    kRenderTimeEntryEditor,
+    kRenderSettings,
+    kRenderTimerState,
+    kRenderOther,
+    kRenderPathCount
+};
+
+const char *kRenderPathNames[kRenderPathCount] = {
+    "list",
+    "timeline",
+    "te_autocomplete",
+    "mt_autocomplete",
+    "project_autocomplete",
+    "editor",
+    "settings",
+    "timer_state",
+    "other"
+};
+
+// Everything the callbacks saw so far
+Poco::Mutex sink_m;
+Poco::Condition sink_c;
+Poco::UInt64 sink_calls[kRenderPathCount] = {};
+Poco::Timestamp sink_last[kRenderPathCount];
+Poco::Timestamp sink_last_any;
+// Newest time entry in the last rendered list. Entries get their GUIDs
+// when they're loaded, so the ones in the generated data don't count.
+std::string sink_newest_guid;
+
+void rendered(const RenderPath path) {
+    Poco::Mutex::ScopedLock lock(sink_m);
+    sink_calls[path]++;
+    sink_last[path].update();
+    sink_last_any.update();
+    sink_c.broadcast();
+}
+
+void on_app(const bool_t) {
+    rendered(kRenderOther);
+}
+void on_int(const int64_t) {
+    rendered(kRenderOther);
+}
+void on_text(const char_t *) {
+    rendered(kRenderOther);
+}
+void on_error(const char_t *, const bool_t) {
+    rendered(kRenderOther);
+}
+void on_login(const bool_t, const uint64_t) {
+    rendered(kRenderOther);
+}
+void on_reminder(const char_t *, const char_t *) {
+    rendered(kRenderOther);
+}
+void on_help_articles(TogglHelpArticleView *) {
+    rendered(kRenderOther);
+}
+void on_time_entry_list(
+    const bool_t, TogglTimeEntryView *first, const bool_t) {
+    for (TogglTimeEntryView *it = first; it;
+            it = reinterpret_cast<TogglTimeEntryView *>(it->Next)) {
+        if (!it->Group && it->GUID) {
+            Poco::Mutex::ScopedLock lock(sink_m);
+            sink_newest_guid = to_string(it->GUID);
+            break;
+        }
+    }
+    rendered(kRenderTimeEntryList);
+}
+void on_time_entry_list_changes(
+    const bool_t, TogglTimeEntryListChangeView *first, const bool_t) {
+    for (TogglTimeEntryListChangeView *it = first; it;
+            it = reinterpret_cast<TogglTimeEntryListChangeView *>(it->Next)) {
+        if (!it->Index && it->Item && !it->Item->Group) {
+            Poco::Mutex::ScopedLock lock(sink_m);
+            sink_newest_guid = to_string(it->Item->GUID);
+            break;
+        }
+    }
+    rendered(kRenderTimeEntryList);
+}
+void on_time_entry_list_window(
+    const bool_t, TogglTimeEntryView *first, const uint64_t first_row,
+    const uint64_t, const uint64_t *, const uint64_t, const bool_t) {
+    for (TogglTimeEntryView *it = first; it && !first_row;
+            it = reinterpret_cast<TogglTimeEntryView *>(it->Next)) {
+        if (!it->Group && it->GUID) {
+            Poco::Mutex::ScopedLock lock(sink_m);
+            sink_newest_guid = to_string(it->GUID);
+            break;
+        }
+    }
+    rendered(kRenderTimeEntryList);
+}
+void on_timeline(const bool_t, const char_t *, TogglTimelineChunkView *,
+                 TogglTimeEntryView *, const uint64_t, const uint64_t) {
+    rendered(kRenderTimeline);
+}
+void on_time_entry_autocomplete(TogglAutocompleteView *) {
+    rendered(kRenderTimeEntryAutocomplete);
+}
+void on_mini_timer_autocomplete(TogglAutocompleteView *) {
+    rendered(kRenderMiniTimerAutocomplete);
+}
+void on_project_autocomplete(TogglAutocompleteView *) {
+    rendered(kRenderProjectAutocomplete);
+}
+void on_generic(TogglGenericView *) {
+    rendered(kRenderOther);
+}
+void on_time_entry_editor(const bool_t, TogglTimeEntryView *, const char_t *) {
+    rendered(kRenderTimeEntryEditor);
+}
+void on_settings(const bool_t, TogglSettingsView *) {
+    rendered(kRenderSettings);
+}
+void on_timer_state(TogglTimeEntryView *) {
+    rendered(kRenderTimerState);
+}
+void on_idle_notification(
+    const char_t *, const char_t *, const char_t *,
+    const int64_t, const char_t *, const char_t *,
+    const char_t *, const char_t *) {
+    rendered(kRenderOther);
+}
+void on_project_colors(string_list_t, const uint64_t) {
+    rendered(kRenderOther);
+}
+
+// How the UI gets the time entry list
+enum ListMode {
+    kListWhole,
+    kListChanges,
+    kListWindow
+};
+
+// Context logged in with a generated account, offline except for
+// a local websocket server. The time entry list is rendered as a whole,
+// as the rows that changed or as the rows around a window.
+class RenderFixture {
+ public:
+    explicit RenderFixture(
+        const Poco::UInt64 time_entries,
+        const ListMode list_mode = kListWhole)
+        : ctx_(nullptr)
+    , logged_in_(false)
+    , db_path_(Poco::Path::temp() + "toggl_render_benchmark.db")
+    , data_(test::GenerateUserData(test::DatasetSize(time_entries))) {
+        urls::SetWebSocket(ws_stub_.URL());
+
+        if (Poco::File(db_path_).exists()) {
+            Poco::File(db_path_).remove();
+        }
+
+        toggl_set_log_path(STR("render_benchmark.log"));
+        ctx_ = toggl_context_init(STR("benchmark"), STR("0.1"));
+        toggl_set_environment(ctx_, STR("test"));
+        toggl_set_db_path(ctx_, to_char_t(db_path_));
+        toggl_set_cacert_path(ctx_, to_char_t(
+            Poco::Path(__FILE__).parent().parent().append("ssl/cacert.pem").toString()));
+
+        toggl_on_show_app(ctx_, on_app);
+        toggl_on_sync_state(ctx_, on_int);
+        toggl_on_unsynced_items(ctx_, on_int);
+        toggl_on_update(ctx_, on_text);
+        toggl_on_error(ctx_, on_error);
+        toggl_on_online_state(ctx_, on_int);
+        toggl_on_login(ctx_, on_login);
+        toggl_on_url(ctx_, on_text);
+        toggl_on_reminder(ctx_, on_reminder);
+        toggl_on_pomodoro(ctx_, on_reminder);
+        toggl_on_pomodoro_break(ctx_, on_reminder);
+        toggl_on_help_articles(ctx_, on_help_articles);
+        toggl_on_time_entry_list(ctx_, on_time_entry_list);
+        if (kListChanges == list_mode) {
+            toggl_on_time_entry_list_changes(ctx_, on_time_entry_list_changes);
+        } else if (kListWindow == list_mode) {
+            toggl_on_time_entry_list_window(ctx_, on_time_entry_list_window);
+        }
+        toggl_on_timeline(ctx_, on_timeline);
+        toggl_on_time_entry_autocomplete(ctx_, on_time_entry_autocomplete);
+        toggl_on_mini_timer_autocomplete(ctx_, on_mini_timer_autocomplete);
+        toggl_on_project_autocomplete(ctx_, on_project_autocomplete);
+        toggl_on_workspace_select(ctx_, on_generic);
+        toggl_on_client_select(ctx_, on_generic);
+        toggl_on_tags(ctx_, on_generic);
+        toggl_on_time_entry_editor(ctx_, on_time_entry_editor);
+        toggl_on_settings(ctx_, on_settings);
+        toggl_on_timer_state(ctx_, on_timer_state);
+        toggl_on_idle_notification(ctx_, on_idle_notification);
+        toggl_on_project_colors(ctx_, on_project_colors);
+
+        toggl_ui_start(ctx_);
+
+        logged_in_ = testing_set_logged_in_user(
+            ctx_, Json::FastWriter().write(data_).c_str());
+        Settle();
+    }
+
+    ~RenderFixture() {
+        toggl_context_clear(ctx_);
+        urls::SetWebSocket("");
+        Poco::File(db_path_).remove();
+    }
+
+    // Waits until no frame is due or being rendered,
+    // and nothing has been rendered for a while
+    void Settle() {
+        Poco::Mutex::ScopedLock lock(sink_m);
+        while (!sink_last_any.isElapsed(200 * Poco::Timespan::MILLISECONDS)
+                || !app(ctx_)->RenderIdle()) {
+            sink_c.tryWait(sink_m, 50);
+        }
+    }
+
+    std::string NewestGUID() const {
+        Poco::Mutex::ScopedLock lock(sink_m);
+        return sink_newest_guid;
+    }
+
+    void *ctx_;
+    bool logged_in_;
+    std::string db_path_;
+    Json::Value data_;
+    test::WebSocketStub ws_stub_;
+};
+
+// Collects what one user action made the UI do
+class RenderMeter {
+ public:
+    RenderMeter(benchmark::State *state, void *ctx)
+        : state_(state)
+    , ctx_(ctx)
+    , allocations_(0)
+    , allocations_at_start_(0)
+    , frames_(0)
+    , merged_(0) {
+        for (int i = 0; i < kRenderPathCount; i++) {
+            calls_[i] = 0;
+            millis_[i] = 0;
+            calls_at_start_[i] = 0;
+        }
+    }
+
+    void Start() {
+        Poco::Mutex::ScopedLock lock(sink_m);
+        started_.update();
+        for (int i = 0; i < kRenderPathCount; i++) {
+            calls_at_start_[i] = sink_calls[i];
+        }
+        allocations_at_start_ = view_allocation_count();
+        render_at_start_ = app(ctx_)->RenderStats();
+    }
+
+    // Waits until every path has been rendered since Start()
+    bool WaitFor(const std::vector<RenderPath> &paths) {
+        Poco::Mutex::ScopedLock lock(sink_m);
+        for (std::size_t i = 0; i < paths.size(); i++) {
+            while (sink_calls[paths[i]] == calls_at_start_[paths[i]]) {
+                if (started_.isElapsed(10 * Poco::Timespan::SECONDS)) {
+                    return false;
+                }
+                sink_c.tryWait(sink_m, 100);
+            }
+        }
+        return true;
+    }
+
+    void Stop() {
+        Poco::Mutex::ScopedLock lock(sink_m);
+        for (int i = 0; i < kRenderPathCount; i++) {
+            Poco::UInt64 calls = sink_calls[i] - calls_at_start_[i];
+            if (calls) {
+                calls_[i] += calls;
+                millis_[i] += static_cast<double>(sink_last[i] - started_) / 1000;
+            }
+        }
+        allocations_ += view_allocation_count() - allocations_at_start_;
+        RenderDispatcherStats render = app(ctx_)->RenderStats();
+        frames_ += render.Frames - render_at_start_.Frames;
+        merged_ += render.Merged - render_at_start_.Merged;
+    }
+
+    void Report() {
+        Poco::UInt64 callbacks(0);
+        for (int i = 0; i < kRenderPathCount; i++) {
+            if (!calls_[i]) {
+                continue;
+            }
+            callbacks += calls_[i];
+            std::string name(kRenderPathNames[i]);
+            state_->counters[name + "_calls"] = benchmark::Counter(
+                static_cast<double>(calls_[i]), benchmark::Counter::kAvgIterations);
+            if (kRenderOther != i) {
+                state_->counters[name + "_ms"] = benchmark::Counter(
+                    millis_[i], benchmark::Counter::kAvgIterations);
+            }
+        }
+        state_->counters["callbacks"] = benchmark::Counter(
+            static_cast<double>(callbacks), benchmark::Counter::kAvgIterations);
+        state_->counters["allocations"] = benchmark::Counter(
+            static_cast<double>(allocations_), benchmark::Counter::kAvgIterations);
+        state_->counters["frames"] = benchmark::Counter(
+            static_cast<double>(frames_), benchmark::Counter::kAvgIterations);
+        state_->counters["merged"] = benchmark::Counter(
+            static_cast<double>(merged_), benchmark::Counter::kAvgIterations);
+    }
+
+ private:
+    benchmark::State *state_;
+    void *ctx_;
+    Poco::Timestamp started_;
+    Poco::UInt64 calls_[kRenderPathCount];
+    double millis_[kRenderPathCount];
+    Poco::UInt64 calls_at_start_[kRenderPathCount];
+    Poco::UInt64 allocations_;
+    Poco::UInt64 allocations_at_start_;
+    Poco::UInt64 frames_;
+    Poco::UInt64 merged_;
+    RenderDispatcherStats render_at_start_;
+};
+
+// Runs the action every iteration, until the paths have been rendered.
+// Whatever prepare does is neither timed nor counted.
+template <typename Prepare, typename Action>
+void measure(
+    benchmark::State &state,
+    RenderFixture *fixture,
+    const std::vector<RenderPath> &paths,
+    Prepare prepare,
+    Action action) {
+
+    if (!fixture->logged_in_) {
+        state.SkipWithError("login failed");
+        return;
+    }
+
+    RenderMeter meter(&state, fixture->ctx_);
+    for (auto _ : state) {
+        state.PauseTiming();
+        prepare();
+        fixture->Settle();
+        meter.Start();
+        state.ResumeTiming();
+
+        action();
+        if (!meter.WaitFor(paths)) {
+            state.SkipWithError("render path was not rendered");
+            break;
+        }
+
+        state.PauseTiming();
+        fixture->Settle();
+        meter.Stop();
+        state.ResumeTiming();
+    }
+    meter.Report();
+}
+
+template <typename Action>
+void measure(
+    benchmark::State &state,
+    RenderFixture *fixture,
+    const std::vector<RenderPath> &paths,
+    Action action) {
+    measure(state, fixture, paths, []() {}, action);
+}
+
+Poco::UInt64 scale(const benchmark::State &state) {
+    return static_cast<Poco::UInt64>(state.range(0));
+}
+
+}  // namespace
+
+// Only turning the rows into the views the UI gets, without a context
+static void BM_GUI_DisplayTimeEntryList(benchmark::State &state) {
+    std::vector<view::TimeEntry> list;
+    for (int64_t i = 0; i < state.range(0); i++) {
+        view::TimeEntry te;
+        te.GUID = "07fba193-91c4-0ec8-2894-" + std::to_string(100000000000 + i);
+        te.Description = "time entry " + std::to_string(i);
+        te.ProjectAndTaskLabel = "project . task";
+        te.ProjectLabel = "project";
+        te.TaskLabel = "task";
+        te.ClientLabel = "client";
+        te.Color = "#4dc3ff";
+        te.Duration = "0:15:00";
+        te.StartTimeString = "10:00";
+        te.EndTimeString = "10:15";
+        te.DateHeader = "Day " + std::to_string(i / 10);
+        te.DateDuration = "2:30:00";
+        te.Started = time(nullptr);
+        list.push_back(te);
+    }
+
+    GUI gui;
+    gui.OnDisplayTimeEntryList(on_time_entry_list);
+    gui.DisplayTimeEntryList(false, list, false);
+
+    uint64_t allocations = view_allocation_count();
+    for (auto _ : state) {
+        gui.DisplayTimeEntryList(false, list, false);
+    }
+    state.counters["allocations"] = benchmark::Counter(
+        static_cast<double>(view_allocation_count() - allocations),
+        benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GUI_DisplayTimeEntryList)
+->Arg(20)->Arg(1000)->Arg(10000)
+->Unit(benchmark::kMicrosecond);
+
+static void BM_Render_TimeEntryList(benchmark::State &state) {
+    RenderFixture fixture(scale(state));
+    measure(state, &fixture, { kRenderTimeEntryList }, [&]() {
+        toggl_view_time_entry_list(fixture.ctx_);
+    });
+}
+BENCHMARK(BM_Render_TimeEntryList)
+->Arg(1000)->Arg(10000)
+->Unit(benchmark::kMillisecond)
+->UseRealTime();
+
+// Same, with only the first rows sent to the UI
+static void BM_Render_TimeEntryListWindow(benchmark::State &state) {
+    RenderFixture fixture(scale(state), kListWindow);
+    measure(state, &fixture, { kRenderTimeEntryList }, [&]() {
+        toggl_view_time_entry_list(fixture.ctx_);
+    });
+}
+BENCHMARK(BM_Render_TimeEntryListWindow)
+->Arg(1000)->Arg(10000)
+->Unit(benchmark::kMillisecond)
+->UseRealTime();
+
+// Scrolling the windowed list by a page
+static void BM_Render_TimeEntryListScroll(benchmark::State &state) {
+    RenderFixture fixture(scale(state), kListWindow);
+    // The first list after login has the last days only
+    toggl_view_time_entry_list(fixture.ctx_);
+    uint64_t first_row(0);
+    measure(state, &fixture, { kRenderTimeEntryList }, [&]() {
+        first_row = (first_row + 20) % 500;
+        toggl_set_time_entry_list_window(fixture.ctx_, first_row, 20);
+    });
+}
+// Settling after every page takes far longer than the page itself
+BENCHMARK(BM_Render_TimeEntryListScroll)
+->Arg(1000)->Arg(10000)
+->Iterations(50)
+->Unit(benchmark::kMillisecond)
+->UseRealTime();
+
+static void BM_Render_Timeline(benchmark::State &state) {
+    RenderFixture fixture(scale(state));
+    measure(state, &fixture, { kRenderTimeline }, [&]() {
+        toggl_view_timeline_data(fixture.ctx_);
+    });
+}
+BENCHMARK(BM_Render_Timeline)
+->Arg(1000)->Arg(10000)
+->Unit(benchmark::kMillisecond)
+->UseRealTime();
+
+static void BM_Render_TimeEntryEditor(benchmark::State &state) {
+    RenderFixture fixture(scale(state));
+    std::string guid = fixture.NewestGUID();
+    // Editing the entry in the editor again would close it
+    measure(state, &fixture, { kRenderTimeEntryEditor },
+    [&]() {
+        toggl_view_time_entry_list(fixture.ctx_);
+    },
+    [&]() {
+        toggl_edit(fixture.ctx_, to_char_t(guid), false, STR(""));
+    });
+}
+BENCHMARK(BM_Render_TimeEntryEditor)
+->Arg(1000)->Arg(10000)
+->Unit(benchmark::kMillisecond)
+->UseRealTime();
+
+static void BM_Render_Settings(benchmark::State &state) {
+    RenderFixture fixture(scale(state));
+    measure(state, &fixture, { kRenderSettings }, [&]() {
+        toggl_edit_preferences(fixture.ctx_);
+    });
+}
+BENCHMARK(BM_Render_Settings)
+->Arg(1000)->Arg(10000)
+->Unit(benchmark::kMillisecond)
+->UseRealTime();
+
+static void BM_Action_Start(benchmark::State &state) {
+    RenderFixture fixture(scale(state));
+    measure(state, &fixture,
+    { kRenderTimerState, kRenderTimeEntryAutocomplete, kRenderMiniTimerAutocomplete },
+    [&]() {
+        toggl_stop(fixture.ctx_, true);
+    },
+    [&]() {
+        toggl_start(fixture.ctx_, STR("benchmark"), STR(""),
+                    0, 0, nullptr, nullptr, true, 0, 0);
+    });
+}
+BENCHMARK(BM_Action_Start)
+->Arg(1000)->Arg(10000)
+->Unit(benchmark::kMillisecond)
+->UseRealTime();
+
+static void BM_Action_Stop(benchmark::State &state) {
+    RenderFixture fixture(scale(state));
+    measure(state, &fixture,
+    { kRenderTimerState, kRenderTimeEntryList, kRenderTimeEntryAutocomplete },
+    [&]() {
+        toggl_start(fixture.ctx_, STR("benchmark"), STR(""),
+                    0, 0, nullptr, nullptr, true, 0, 0);
+    },
+    [&]() {
+        toggl_stop(fixture.ctx_, true);
+    });
+}
+BENCHMARK(BM_Action_Stop)
+->Arg(1000)->Arg(10000)
+->Unit(benchmark::kMillisecond)
+->UseRealTime();
+
+static void BM_Action_Edit(benchmark::State &state) {
+    RenderFixture fixture(scale(state));
+    std::string guid = fixture.NewestGUID();
+    int n(0);
+    measure(state, &fixture,
+    { kRenderTimeEntryList, kRenderTimeEntryAutocomplete },
+    [&]() {
+        std::string description = "edited " + std::to_string(++n);
+        toggl_set_time_entry_description(
+            fixture.ctx_, to_char_t(guid), to_char_t(description));
+    });
+}
+BENCHMARK(BM_Action_Edit)
+->Arg(1000)->Arg(10000)
+->Unit(benchmark::kMillisecond)
+->UseRealTime();
+
+// Same, with only the edited row of the list sent to the UI
+static void BM_Action_EditListChanges(benchmark::State &state) {
+    RenderFixture fixture(scale(state), kListChanges);
+    std::string guid = fixture.NewestGUID();
+    int n(0);
+    measure(state, &fixture,
+    { kRenderTimeEntryList, kRenderTimeEntryAutocomplete },
+    [&]() {
+        std::string description = "edited " + std::to_string(++n);
+        toggl_set_time_entry_description(
+            fixture.ctx_, to_char_t(guid), to_char_t(description));
+    });
+}
+BENCHMARK(BM_Action_EditListChanges)
+->Arg(1000)->Arg(10000)
+->Unit(benchmark::kMillisecond)
+->UseRealTime();
+
+// Same, with only the rows around the window sent to the UI
+static void BM_Action_EditListWindow(benchmark::State &state) {
+    RenderFixture fixture(scale(state), kListWindow);
+    std::string guid = fixture.NewestGUID();
+    int n(0);
+    measure(state, &fixture,
+    { kRenderTimeEntryList, kRenderTimeEntryAutocomplete },
+    [&]() {
+        std::string description = "edited " + std::to_string(++n);
+        toggl_set_time_entry_description(
+            fixture.ctx_, to_char_t(guid), to_char_t(description));
+    });
+}
+BENCHMARK(BM_Action_EditListWindow)
+->Arg(1000)->Arg(10000)
+->Unit(benchmark::kMillisecond)
+->UseRealTime();
+
+// A time entry changed elsewhere arriving over the websocket. Includes
+// the time websocket updates are collected before they're applied.
+static void BM_Action_Sync(benchmark::State &state) {
+    RenderFixture fixture(scale(state));
+    if (!fixture.ws_stub_.WaitForClient(10000)) {
+        state.SkipWithError("websocket client did not connect");
+        return;
+    }
+
+    Json::Value update;
+    update["action"] = "update";
+    update["model"] = "time_entry";
+    update["data"] = fixture.data_["data"]["time_entries"][0];
+
+    // Every update has to be newer than the last one to be applied
+    Poco::Timestamp at;
+    int n(0);
+    measure(state, &fixture,
+    { kRenderTimeEntryList, kRenderTimeEntryAutocomplete },
+    [&]() {
+        at += Poco::Timespan::SECONDS;
+        update["data"]["description"] = "synced " + std::to_string(++n);
+        update["data"]["at"] = Poco::DateTimeFormatter::format(
+            at, Poco::DateTimeFormat::ISO8601_FORMAT);
+        fixture.ws_stub_.Send(Json::FastWriter().write(update));
+    });
+}
+BENCHMARK(BM_Action_Sync)
+->Arg(1000)->Arg(10000)
+->Unit(benchmark::kMillisecond)
+->UseRealTime();
+
+}  // namespace toggl
@@ -0,0 +1,63 @@
+// Copyright 2020 Toggl Desktop developers.
+
+#include <benchmark/benchmark.h>
+
+#include <sstream>
+#include <string>
+
+#include "request_body_encoder.h"
+
+#include <Poco/DeflatingStream.h>
+
+namespace toggl {
+
+namespace {
+
+// Something resembling a batch of pushed time entries
+std::string payloadOfSize(const std::size_t size) {
+    std::stringstream ss;
+    ss << "[";
+    for (int i = 0; ss.tellp() < static_cast<std::streamoff>(size); i++) {
+        ss << "{\"description\":\"Time entry " << i << "\","
+           << "\"wid\":123456,\"pid\":" << (i % 17) << ","
+           << "\"start\":\"2020-05-12T09:00:00Z\",\"duration\":3600},";
+    }
+    std::string payload = ss.str();
+    payload.resize(size);
+    return payload;
+}
+
+}  // namespace
+
+// What HTTPClient used to do: measure by deflating, then deflate again to send
+static void BM_RequestBody_DeflatingStream(benchmark::State &state) {
+    std::string payload = payloadOfSize(state.range(0));
+    for (auto _ : state) {
+        std::istringstream requestStream(payload);
+        Poco::DeflatingInputStream gzipRequest(
+            requestStream,
+            Poco::DeflatingStreamBuf::STREAM_GZIP);
+        Poco::DeflatingStreamBuf *pBuff = gzipRequest.rdbuf();
+        Poco::Int64 size = pBuff->pubseekoff(0, std::ios::end, std::ios::in);
+        pBuff->pubseekpos(0, std::ios::in);
+        std::stringstream sent;
+        sent << pBuff;
+        benchmark::DoNotOptimize(size);
+    }
+    state.SetBytesProcessed(state.iterations() * payload.size());
+}
+BENCHMARK(BM_RequestBody_DeflatingStream)->Arg(128)->Arg(16 << 10)->Arg(1 << 20);
+
+static void BM_RequestBody_Encoder(benchmark::State &state) {
+    std::string payload = payloadOfSize(state.range(0));
+    RequestBodyEncoder encoder;
+    for (auto _ : state) {
+        encoder.Encode(payload);
+        benchmark::DoNotOptimize(encoder.Data());
+    }
+    state.SetBytesProcessed(state.iterations() * payload.size());
+    state.counters["ratio"] = static_cast<double>(encoder.Size()) / payload.size();
+}
+BENCHMARK(BM_RequestBody_Encoder)->Arg(128)->Arg(16 << 10)->Arg(1 << 20);
+
+}  // namespace toggl
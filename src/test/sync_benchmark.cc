@@ -0,0 +1,435 @@
+// Copyright 2020 Toggl Desktop developers.
+
+// End to end sync benchmarks: a real context talks to a local stub of the
+// Toggl API (see api_stub.h) and websocket server, seeded with
+// testdata/me.json or a generated account.
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+#include <json/json.h>  // NOLINT
+
+#include "context.h"
+#include "toggl_api.h"
+#include "toggl_api_private.h"
+#include "urls.h"
+
+#include "api_stub.h"
+#include "dataset_generator.h"
+#include "test_data.h"
+#include "toggl_api_test.h"
+#include "websocket_stub.h"
+
+#include <Poco/DateTimeFormat.h>
+#include <Poco/DateTimeFormatter.h>
+#include <Poco/DirectoryIterator.h>
+#include <Poco/Event.h>
+#include <Poco/File.h>
+#include <Poco/FileStream.h>
+#include <Poco/Path.h>
+#include <Poco/Thread.h>
+#include <Poco/Timestamp.h>
+
+namespace toggl {
+
+namespace {
+
+Poco::Event time_entry_list_shown;
+
+void on_app(const bool_t) {}
+void on_sync_state(const int64_t) {}
+void on_unsynced_items(const int64_t) {}
+void on_update(const char_t *) {}
+void on_error(const char_t *, const bool_t) {}
+void on_online_state(const int64_t) {}
+void on_url(const char_t *) {}
+void on_login(const bool_t, const uint64_t) {}
+void on_reminder(const char_t *, const char_t *) {}
+void on_pomodoro(const char_t *, const char_t *) {}
+void on_help_articles(TogglHelpArticleView *) {}
+void on_time_entry_list(const bool_t, TogglTimeEntryView *, const bool_t) {
+    time_entry_list_shown.set();
+}
+void on_autocomplete(TogglAutocompleteView *) {}
+void on_generic(TogglGenericView *) {}
+void on_time_entry_editor(const bool_t, TogglTimeEntryView *, const char_t *) {}
+void on_settings(const bool_t, TogglSettingsView *) {}
+void on_timer_state(TogglTimeEntryView *) {}
+void on_idle_notification(
+    const char_t *, const char_t *, const char_t *,
+    const int64_t, const char_t *, const char_t *,
+    const char_t *, const char_t *) {}
+void on_project_colors(string_list_t, const uint64_t) {}
+
+// Context with the GUI callbacks wired up, logged in against the stubs
+class SyncFixture {
+ public:
+    explicit SyncFixture(const std::string &me_json = loadTestData())
+        : ctx_(nullptr)
+    , db_path_(Poco::Path::temp() + "toggl_sync_benchmark.db")
+    , stub_(me_json) {
+        urls::SetBackend(stub_.URL());
+        urls::SetWebSocket(ws_stub_.URL());
+
+        if (Poco::File(db_path_).exists()) {
+            Poco::File(db_path_).remove();
+        }
+
+        toggl_set_log_path(STR("sync_benchmark.log"));
+        ctx_ = toggl_context_init(STR("benchmark"), STR("0.1"));
+        toggl_set_db_path(ctx_, to_char_t(db_path_));
+        toggl_set_cacert_path(ctx_, to_char_t(
+            Poco::Path(__FILE__).parent().parent().append("ssl/cacert.pem").toString()));
+
+        toggl_on_show_app(ctx_, on_app);
+        toggl_on_sync_state(ctx_, on_sync_state);
+        toggl_on_unsynced_items(ctx_, on_unsynced_items);
+        toggl_on_update(ctx_, on_update);
+        toggl_on_error(ctx_, on_error);
+        toggl_on_online_state(ctx_, on_online_state);
+        toggl_on_login(ctx_, on_login);
+        toggl_on_url(ctx_, on_url);
+        toggl_on_reminder(ctx_, on_reminder);
+        toggl_on_pomodoro(ctx_, on_pomodoro);
+        toggl_on_pomodoro_break(ctx_, on_pomodoro);
+        toggl_on_help_articles(ctx_, on_help_articles);
+        toggl_on_time_entry_list(ctx_, on_time_entry_list);
+        toggl_on_time_entry_autocomplete(ctx_, on_autocomplete);
+        toggl_on_mini_timer_autocomplete(ctx_, on_autocomplete);
+        toggl_on_project_autocomplete(ctx_, on_autocomplete);
+        toggl_on_workspace_select(ctx_, on_generic);
+        toggl_on_client_select(ctx_, on_generic);
+        toggl_on_tags(ctx_, on_generic);
+        toggl_on_time_entry_editor(ctx_, on_time_entry_editor);
+        toggl_on_settings(ctx_, on_settings);
+        toggl_on_timer_state(ctx_, on_timer_state);
+        toggl_on_idle_notification(ctx_, on_idle_notification);
+        toggl_on_project_colors(ctx_, on_project_colors);
+
+        toggl_ui_start(ctx_);
+
+        // Sync right away instead of collecting requests first
+        app(ctx_)->SetSyncDebounce(0);
+    }
+
+    ~SyncFixture() {
+        toggl_context_clear(ctx_);
+        urls::SetBackend("");
+        urls::SetWebSocket("");
+        Poco::File(db_path_).remove();
+    }
+
+    bool Login() {
+        return toggl_login(ctx_, STR("foo@bar.com"), STR("secret"));
+    }
+
+    // Waits until the requests set off by login or the previous
+    // benchmark step have been served
+    void Settle() {
+        Poco::UInt64 served(0);
+        do {
+            served = stub_.Requests();
+            Poco::Thread::sleep(250);
+        } while (served != stub_.Requests());
+    }
+
+    void *ctx_;
+    std::string db_path_;
+    test::ApiStub stub_;
+    test::WebSocketStub ws_stub_;
+};
+
+void configure(test::ApiStub *stub, const benchmark::State &state) {
+    test::ApiStubConfig config;
+    config.LatencyMillis = static_cast<long>(state.range(0));
+    config.TooManyRequestsEvery = static_cast<int>(state.range(1));
+    stub->Configure(config);
+}
+
+// Times the threads of this process whose name starts with the prefix
+// were switched in, summed over them, or zero where the kernel doesn't tell
+Poco::UInt64 contextSwitches(const std::string &name_prefix) {
+    Poco::UInt64 total(0);
+    try {
+        Poco::DirectoryIterator end;
+        for (Poco::DirectoryIterator it(std::string("/proc/self/task")); it != end; ++it) {
+            Poco::FileInputStream in(it.path().toString() + "/status");
+            Poco::UInt64 switches(0);
+            bool named(false);
+            std::string line;
+            while (std::getline(in, line)) {
+                if (line.compare(0, 5, "Name:") == 0) {
+                    std::string name = line.substr(5);
+                    name.erase(0, name.find_first_not_of(" \t"));
+                    named = name.compare(0, name_prefix.size(), name_prefix) == 0;
+                } else if (line.find("ctxt_switches:") != std::string::npos) {
+                    switches += std::stoull(line.substr(line.find(':') + 1));
+                }
+            }
+            if (named) {
+                total += switches;
+            }
+        }
+    } catch(const Poco::Exception &) {
+        return 0;
+    }
+    return total;
+}
+
+}  // namespace
+
+// Fetching and storing the user with all related data
+static void BM_Sync_Login(benchmark::State &state) {
+    SyncFixture fixture;
+    configure(&fixture.stub_, state);
+
+    for (auto _ : state) {
+        if (!fixture.Login()) {
+            state.SkipWithError("login failed");
+            break;
+        }
+        state.PauseTiming();
+        fixture.Settle();
+        toggl_logout(fixture.ctx_);
+        state.ResumeTiming();
+    }
+}
+BENCHMARK(BM_Sync_Login)
+->Args({0, 0})
+->Args({50, 0})
+->Unit(benchmark::kMillisecond)
+->UseRealTime();
+
+// Same with a generated account of that many time entries
+static void BM_Sync_LoginGeneratedAccount(benchmark::State &state) {
+    SyncFixture fixture(test::GenerateUserJSON(
+        test::DatasetSize(static_cast<Poco::UInt64>(state.range(0)))));
+
+    for (auto _ : state) {
+        if (!fixture.Login()) {
+            state.SkipWithError("login failed");
+            break;
+        }
+        state.PauseTiming();
+        fixture.Settle();
+        toggl_logout(fixture.ctx_);
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Sync_LoginGeneratedAccount)
+->Arg(1000)
+->Arg(10000)
+->Unit(benchmark::kMillisecond)
+->UseRealTime();
+
+// A full sync cycle, from the request until the last preferences
+// have been pulled
+static void BM_Sync_FullSync(benchmark::State &state) {
+    SyncFixture fixture;
+    if (!fixture.Login()) {
+        state.SkipWithError("login failed");
+        return;
+    }
+    fixture.Settle();
+    configure(&fixture.stub_, state);
+
+    const std::string last("/api/v9/me/preferences/desktop");
+    for (auto _ : state) {
+        Poco::UInt64 pulled = fixture.stub_.Requests(last);
+        toggl_fullsync(fixture.ctx_);
+        if (!fixture.stub_.WaitForRequests(last, pulled + 1, 30000)) {
+            state.SkipWithError("full sync did not finish");
+            break;
+        }
+    }
+}
+BENCHMARK(BM_Sync_FullSync)
+->Args({0, 0})
+->Args({50, 0})
+->Unit(benchmark::kMillisecond)
+->UseRealTime();
+
+// Time entries started and stopped locally until the server has all of them.
+// With rate limiting this includes the delay before the failed push is retried.
+static void BM_Sync_PushThroughput(benchmark::State &state) {
+    SyncFixture fixture;
+    if (!fixture.Login()) {
+        state.SkipWithError("login failed");
+        return;
+    }
+    fixture.Settle();
+    configure(&fixture.stub_, state);
+
+    const int entries(20);
+    for (auto _ : state) {
+        std::size_t stored = fixture.stub_.TimeEntryCount();
+        for (int i = 0; i < entries; i++) {
+            toggl_start(fixture.ctx_, STR("benchmark"), STR(""),
+                        0, 0, nullptr, nullptr, false, 0, 0);
+            toggl_stop(fixture.ctx_, false);
+        }
+        Poco::Timestamp started;
+        while (fixture.stub_.TimeEntryCount() < stored + entries) {
+            if (started.isElapsed(120 * Poco::Timespan::SECONDS)) {
+                break;
+            }
+            Poco::Thread::sleep(1);
+        }
+        if (fixture.stub_.TimeEntryCount() < stored + entries) {
+            state.SkipWithError("time entries were not pushed");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * entries);
+}
+BENCHMARK(BM_Sync_PushThroughput)
+->Args({0, 0})
+->Args({20, 0})
+->Args({0, 25})
+->Unit(benchmark::kMillisecond)
+->UseRealTime();
+
+// Time from the websocket server sending a changed time entry until
+// the time entry list has been rendered again
+static void BM_Sync_WebSocketUpdateLatency(benchmark::State &state) {
+    SyncFixture fixture;
+    if (!fixture.Login()) {
+        state.SkipWithError("login failed");
+        return;
+    }
+    if (!fixture.ws_stub_.WaitForClient(10000)) {
+        state.SkipWithError("websocket client did not connect");
+        return;
+    }
+    fixture.Settle();
+
+    Json::Value seed;
+    Json::Reader().parse(loadTestData(), seed);
+    Json::Value update;
+    update["action"] = "update";
+    update["model"] = "time_entry";
+    const Json::Value &entries = seed["data"]["time_entries"];
+    for (Json::Value::ArrayIndex i = 0; i < entries.size(); i++) {
+        if (!entries[i].isMember("server_deleted_at")) {
+            update["data"] = entries[i];
+            break;
+        }
+    }
+
+    // Every update has to be newer than the last one to be applied
+    Poco::Timestamp at;
+    int n(0);
+    for (auto _ : state) {
+        at += Poco::Timespan::SECONDS;
+        update["data"]["description"] = "update " + std::to_string(++n);
+        update["data"]["at"] = Poco::DateTimeFormatter::format(
+            at, Poco::DateTimeFormat::ISO8601_FORMAT);
+        time_entry_list_shown.reset();
+        fixture.ws_stub_.Send(Json::FastWriter().write(update));
+        if (!time_entry_list_shown.tryWait(10000)) {
+            state.SkipWithError("time entry list was not updated");
+            break;
+        }
+    }
+}
+BENCHMARK(BM_Sync_WebSocketUpdateLatency)
+->Unit(benchmark::kMillisecond)
+->UseRealTime();
+
+// Cost of handing a focus change over from the window change recorder,
+// with the events stored in the background
+static void BM_Sync_RecordTimelineEvent(benchmark::State &state) {
+    SyncFixture fixture;
+    if (!fixture.Login()) {
+        state.SkipWithError("login failed");
+        return;
+    }
+    toggl_timeline_toggle_recording(fixture.ctx_, true);
+    fixture.Settle();
+
+    Context *context = app(fixture.ctx_);
+    Poco::Int64 at = time(nullptr) - 86400;
+    int n(0);
+    for (auto _ : state) {
+        TimelineEvent *event = new TimelineEvent();
+        event->SetStartTime(at);
+        event->SetEndTime(at + 10);
+        event->SetFilename("terminal");
+        event->SetTitle("window " + std::to_string(++n % 7));
+        context->StartTimelineEvent(event);
+        at += 10;
+    }
+
+    // Wait until everything is stored
+    while (context->TimelineEventStats().Depth) {
+        Poco::Thread::sleep(10);
+    }
+    TimelineEventQueueStats stats = context->TimelineEventStats();
+    state.counters["queued"] = static_cast<double>(stats.Queued);
+    state.counters["dropped"] = static_cast<double>(stats.Dropped);
+    state.counters["batches"] = static_cast<double>(stats.Batches);
+}
+BENCHMARK(BM_Sync_RecordTimelineEvent)
+->Iterations(1000)
+->Unit(benchmark::kMicrosecond);
+
+// How often the background threads of a logged in, idle app wake up.
+// Only the library's own threads count, not the stub servers or the
+// benchmark itself. The window recorder polls the focused window, so
+// it's counted on its own.
+static void BM_Sync_IdleWakeups(benchmark::State &state) {
+    SyncFixture fixture;
+    if (!fixture.Login()) {
+        state.SkipWithError("login failed");
+        return;
+    }
+    toggl_timeline_toggle_recording(fixture.ctx_, true);
+    fixture.Settle();
+
+    if (!contextSwitches("")) {
+        state.SkipWithError("no context switch counts");
+        return;
+    }
+
+    const std::string recorder = std::string(kThreadNamePrefix) + "recorder";
+
+    // Wait for what the login left to do, such as the first timeline
+    // upload, until the threads were quiet for three seconds
+    int quiet(0);
+    for (int i = 0; i < 20 && quiet < 3; i++) {
+        Poco::UInt64 before = contextSwitches(kThreadNamePrefix)
+                              - contextSwitches(recorder);
+        Poco::Thread::sleep(1000);
+        if (before == contextSwitches(kThreadNamePrefix)
+                - contextSwitches(recorder)) {
+            quiet++;
+        } else {
+            quiet = 0;
+        }
+    }
+
+    Poco::UInt64 switches(0);
+    Poco::UInt64 recorder_switches(0);
+    Poco::Timestamp started;
+    for (auto _ : state) {
+        Poco::UInt64 before = contextSwitches(kThreadNamePrefix);
+        Poco::UInt64 recorder_before = contextSwitches(recorder);
+        Poco::Thread::sleep(10000);
+        Poco::UInt64 recorder_after = contextSwitches(recorder);
+        recorder_switches += recorder_after - recorder_before;
+        switches += contextSwitches(kThreadNamePrefix) - before
+                    - (recorder_after - recorder_before);
+    }
+    double minutes = static_cast<double>(started.elapsed()) / 60000000.0;
+    state.counters["wakeups_per_minute"] = static_cast<double>(switches) / minutes;
+    state.counters["recorder_wakeups_per_minute"] =
+        static_cast<double>(recorder_switches) / minutes;
+}
+BENCHMARK(BM_Sync_IdleWakeups)
+->Iterations(1)
+->Unit(benchmark::kSecond)
+->UseRealTime();
+
+}  // namespace toggl
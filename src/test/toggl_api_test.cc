@@ -5,6 +5,7 @@
 #include "gtest/gtest.h"
 
 #include "toggl_api_test.h"
+#include "context.h"
 #include "https_client.h"
 #include "proxy.h"
 #include "model/settings.h"
@@ -16,10 +17,13 @@
 
 #include <iostream>   // NOLINT
 
+#include "Poco/AtomicCounter.h"
 #include "Poco/DateTime.h"
+#include "Poco/Event.h"
 #include "Poco/File.h"
 #include "Poco/FileStream.h"
 #include "Poco/LocalDateTime.h"
+#include "Poco/Mutex.h"
 #include "Poco/Path.h"
 #include "Poco/Runnable.h"
 #include "Poco/Thread.h"
@@ -68,6 +72,20 @@ std::vector<std::string> clients;
 
 // on_time_entry_list
 std::vector<TimeEntry> time_entries;
+// Renders by the thread that reported the running timer
+Poco::AtomicCounter running_timer_list_renders;
+
+// on_running_timer
+Poco::FastMutex running_timer_m;
+Poco::Event running_timer_changed;
+Poco::Thread::TID running_timer_thread(0);
+std::string running_timer_guid("");
+uint64_t running_timer_started(0);
+int64_t running_timer_duration(0);
+
+// on_autotracker_notification
+Poco::Event autotracker_notified;
+uint64_t autotracker_project_id(0);
 
 // on_project_colors
 std::vector<std::string> project_colors;
@@ -161,6 +179,13 @@ void on_time_entry_list(
     const bool_t open,
     TogglTimeEntryView *first,
     const bool_t show_load_more) {
+    {
+        Poco::FastMutex::ScopedLock lock(testing::testresult::running_timer_m);
+        if (testing::testresult::running_timer_thread
+                == Poco::Thread::currentTid()) {
+            ++testing::testresult::running_timer_list_renders;
+        }
+    }
     testing::testresult::time_entries.clear();
     TogglTimeEntryView *it = first;
     while (it) {
@@ -285,6 +310,29 @@ void on_display_timer_state(TogglTimeEntryView *te) {
     }
 }
 
+void on_running_timer(
+    const char_t *guid,
+    const uint64_t started,
+    const int64_t date_duration_in_seconds,
+    const char_t *date_duration) {
+    {
+        Poco::FastMutex::ScopedLock lock(testing::testresult::running_timer_m);
+        testing::testresult::running_timer_guid = to_string(guid);
+        testing::testresult::running_timer_started = started;
+        testing::testresult::running_timer_duration = date_duration_in_seconds;
+        testing::testresult::running_timer_thread = Poco::Thread::currentTid();
+    }
+    testing::testresult::running_timer_changed.set();
+}
+
+void on_autotracker_notification(
+    const char_t *project_name,
+    const uint64_t project_id,
+    const uint64_t task_id) {
+    testing::testresult::autotracker_project_id = project_id;
+    testing::testresult::autotracker_notified.set();
+}
+
 void on_display_idle_notification(
     const char_t *guid,
     const char_t *since,
@@ -314,6 +362,9 @@ class App {
 
         ctx_ = toggl_context_init(STR("tests"), STR("0.1"));
 
+        // The tests look at the callbacks right after each call
+        app(ctx_)->SetRenderInterval(0);
+
         poco_assert(toggl_set_db_path(ctx_, STR("test.db")));
 
         Poco::Path path(std::string(SRCDIR) + "ssl/cacert.pem");
@@ -1235,6 +1286,42 @@ TEST(toggl_api, toggl_stop) {
     ASSERT_TRUE(testing::testresult::timer_state.GUID().empty());
 }
 
+TEST(toggl_api, toggl_on_running_timer) {
+    testing::App app;
+    std::string json = loadTestData();
+    ASSERT_TRUE(testing_set_logged_in_user(app.ctx(), json.c_str()));
+
+    toggl_on_running_timer(app.ctx(), testing::on_running_timer);
+    testing::testresult::running_timer_changed.reset();
+    testing::testresult::running_timer_list_renders = 0;
+
+    char_t *guid = toggl_start(app.ctx(), STR("test"), STR(""), 0, 0, 0, 0, false, 0, 0);
+    ASSERT_TRUE(guid);
+    std::string running_guid(to_string(guid));
+    free(guid);
+
+    ASSERT_TRUE(testing::testresult::running_timer_changed.tryWait(5000));
+    {
+        Poco::FastMutex::ScopedLock lock(testing::testresult::running_timer_m);
+        ASSERT_EQ(running_guid, testing::testresult::running_timer_guid);
+        ASSERT_EQ(testing::testresult::timer_state.StartTime(),
+                  testing::testresult::running_timer_started);
+        ASSERT_LE(0, testing::testresult::running_timer_duration);
+    }
+
+    ASSERT_TRUE(toggl_stop(app.ctx(), false));
+
+    ASSERT_TRUE(testing::testresult::running_timer_changed.tryWait(5000));
+    {
+        Poco::FastMutex::ScopedLock lock(testing::testresult::running_timer_m);
+        ASSERT_TRUE(testing::testresult::running_timer_guid.empty());
+    }
+
+    // The updater has been through both changes by now,
+    // and left the list to the callback each time
+    ASSERT_EQ(0, testing::testresult::running_timer_list_renders.value());
+}
+
 TEST(toggl_api, toggl_with_default_project) {
     testing::App app;
     std::string json = loadTestData();
@@ -1861,6 +1948,33 @@ TEST(toggl_api, toggl_autotracker_add_rule) {
     ASSERT_TRUE(rule_id);
 }
 
+TEST(toggl_api, toggl_autotracker_notification) {
+    testing::App app;
+    std::string json = loadTestData();
+    ASSERT_TRUE(testing_set_logged_in_user(app.ctx(), json.c_str()));
+    ASSERT_TRUE(toggl_stop(app.ctx(), false));
+
+    toggl_on_autotracker_notification(app.ctx(),
+                                      testing::on_autotracker_notification);
+    ASSERT_TRUE(toggl_set_settings_autotrack(app.ctx(), true));
+
+    const uint64_t existing_project_id = 2598305;
+    ASSERT_TRUE(toggl_autotracker_add_rule(
+        app.ctx(), STR("delfi"), existing_project_id, 0));
+
+    // The recorder only hands the window over, it's matched later
+    testing::testresult::autotracker_notified.reset();
+    testing::testresult::autotracker_project_id = 0;
+    TimelineEvent event;
+    event.SetTitle("Delfi - news");
+    event.SetStartTime(time(nullptr) - 10);
+    event.SetEndTime(time(nullptr));
+    ASSERT_EQ(noError, ::app(app.ctx())->StartAutotrackerEvent(event));
+
+    ASSERT_TRUE(testing::testresult::autotracker_notified.tryWait(5000));
+    ASSERT_EQ(existing_project_id, testing::testresult::autotracker_project_id);
+}
+
 TEST(toggl_api, toggl_set_default_project) {
     testing::App app;
     std::string json = loadTestData();
@@ -0,0 +1,75 @@
+// Copyright 2020 Toggl Desktop developers.
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+#include <json/json.h>  // NOLINT
+
+#include "https_client.h"
+#include "urls.h"
+#include "websocket_client.h"
+#include "websocket_stub.h"
+
+#include <Poco/Event.h>
+#include <Poco/Path.h>
+
+namespace toggl {
+
+namespace {
+
+Poco::Event message_received;
+
+void on_message(void *, const Json::Value &) {
+    message_received.set();
+}
+
+// Time entry update with a description padded to the requested size
+std::string updateOfSize(const std::size_t size) {
+    Json::Value update;
+    update["action"] = "update";
+    update["model"] = "time_entry";
+    update["data"]["id"] = 1;
+    update["data"]["description"] = std::string(size, 'x');
+    return Json::FastWriter().write(update);
+}
+
+}  // namespace
+
+// Time from the server sending an update until it reaches the context
+static void BM_WebSocket_MessageLatency(benchmark::State &state) {
+    HTTPClient::Config.SetCACertPath(
+        Poco::Path(__FILE__).parent().parent().append("ssl/cacert.pem").toString());
+
+    test::WebSocketStub stub;
+    urls::SetWebSocket(stub.URL());
+
+    int ctx(0);
+    WebSocketClient client;
+    client.Start(&ctx, "api token", on_message);
+    if (!stub.WaitForClient(10000)) {
+        state.SkipWithError("websocket client did not connect");
+        return;
+    }
+
+    std::string message = updateOfSize(state.range(0));
+    int fragments = static_cast<int>(state.range(1));
+    for (auto _ : state) {
+        stub.Send(message, fragments);
+        if (!message_received.tryWait(10000)) {
+            state.SkipWithError("message was not delivered");
+            break;
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * message.size());
+
+    client.Shutdown();
+    urls::SetWebSocket("");
+}
+BENCHMARK(BM_WebSocket_MessageLatency)
+->Args({128, 1})
+->Args({64 << 10, 1})
+->Args({1 << 20, 16})
+->UseRealTime();
+
+}  // namespace toggl
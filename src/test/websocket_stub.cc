@@ -0,0 +1,184 @@
+// Copyright 2020 Toggl Desktop developers.
+
+#include "websocket_stub.h"
+
+#include <algorithm>
+#include <string>
+
+#include <Poco/Buffer.h>
+#include <Poco/Exception.h>
+#include <Poco/Net/HTTPRequestHandler.h>
+#include <Poco/Net/HTTPRequestHandlerFactory.h>
+#include <Poco/Net/HTTPServerParams.h>
+#include <Poco/Net/HTTPServerRequest.h>
+#include <Poco/Net/HTTPServerResponse.h>
+#include <Poco/Net/ServerSocket.h>
+#include <Poco/Net/SocketAddress.h>
+#include <Poco/NumberFormatter.h>
+
+namespace toggl {
+
+namespace test {
+
+namespace {
+
+class StubRequestHandler : public Poco::Net::HTTPRequestHandler {
+ public:
+    explicit StubRequestHandler(WebSocketStub *stub)
+        : stub_(stub) {}
+
+    void handleRequest(
+        Poco::Net::HTTPServerRequest &request,
+        Poco::Net::HTTPServerResponse &response) override {
+        try {
+            Poco::Net::WebSocket ws(request, response);
+            stub_->serve(&ws);
+        } catch(const Poco::Exception &) {
+            if (!response.sent()) {
+                response.setStatusAndReason(
+                    Poco::Net::HTTPResponse::HTTP_BAD_REQUEST);
+                response.setContentLength(0);
+                response.send();
+            }
+        }
+    }
+
+ private:
+    WebSocketStub *stub_;
+};
+
+class StubRequestHandlerFactory
+    : public Poco::Net::HTTPRequestHandlerFactory {
+ public:
+    explicit StubRequestHandlerFactory(WebSocketStub *stub)
+        : stub_(stub) {}
+
+    Poco::Net::HTTPRequestHandler *createRequestHandler(
+        const Poco::Net::HTTPServerRequest &) override {
+        return new StubRequestHandler(stub_);
+    }
+
+ private:
+    WebSocketStub *stub_;
+};
+
+const long kStubReceiveTimeoutMillis = 100;
+
+}  // namespace
+
+WebSocketStub::WebSocketStub()
+    : server_(nullptr)
+, client_(nullptr)
+, connected_(false)
+, stopping_(false) {
+    Poco::Net::ServerSocket socket(Poco::Net::SocketAddress("127.0.0.1", 0));
+    server_ = new Poco::Net::HTTPServer(
+        new StubRequestHandlerFactory(this),
+        socket,
+        new Poco::Net::HTTPServerParams);
+    server_->start();
+}
+
+WebSocketStub::~WebSocketStub() {
+    stopping_ = true;
+    server_->stopAll(true);
+    delete server_;
+}
+
+std::string WebSocketStub::URL() const {
+    return "http://127.0.0.1:"
+           + Poco::NumberFormatter::format(server_->port());
+}
+
+bool WebSocketStub::WaitForClient(const long milliseconds) {
+    return connected_.tryWait(milliseconds);
+}
+
+void WebSocketStub::Send(
+    const std::string &message,
+    const int fragments,
+    const bool ping_between_fragments) {
+
+    Poco::Mutex::ScopedLock lock(mutex_);
+    if (!client_) {
+        throw Poco::IllegalStateException("No websocket client connected");
+    }
+
+    std::size_t step = message.size() / fragments + 1;
+    for (int i = 0; i < fragments; i++) {
+        std::size_t offset = std::min(message.size(), i * step);
+        std::size_t length = std::min(message.size() - offset, step);
+
+        int flags = i ? Poco::Net::WebSocket::FRAME_OP_CONT
+                    : Poco::Net::WebSocket::FRAME_OP_TEXT;
+        if (i == fragments - 1) {
+            flags |= Poco::Net::WebSocket::FRAME_FLAG_FIN;
+        }
+        client_->sendFrame(message.data() + offset,
+                           static_cast<int>(length), flags);
+
+        if (ping_between_fragments && i < fragments - 1) {
+            client_->sendFrame("stub", 4,
+                               Poco::Net::WebSocket::FRAME_FLAG_FIN
+                               | Poco::Net::WebSocket::FRAME_OP_PING);
+        }
+    }
+}
+
+bool WebSocketStub::WaitForPong(
+    const long milliseconds,
+    std::string *payload) {
+    if (!ponged_.tryWait(milliseconds)) {
+        return false;
+    }
+    Poco::Mutex::ScopedLock lock(mutex_);
+    *payload = pong_;
+    return true;
+}
+
+void WebSocketStub::serve(Poco::Net::WebSocket *ws) {
+    ws->setReceiveTimeout(
+        Poco::Timespan(kStubReceiveTimeoutMillis * Poco::Timespan::MILLISECONDS));
+
+    Poco::Buffer<char> buffer(0);
+    while (!stopping_) {
+        int flags = 0;
+        int n = 0;
+        buffer.resize(0);
+        try {
+            n = ws->receiveFrame(buffer, flags);
+        } catch(const Poco::TimeoutException &) {
+            continue;
+        } catch(const Poco::Exception &) {
+            break;
+        }
+        if (n <= 0 && !flags) {
+            break;
+        }
+
+        int opcode = flags & Poco::Net::WebSocket::FRAME_OP_BITMASK;
+        if (Poco::Net::WebSocket::FRAME_OP_CLOSE == opcode) {
+            break;
+        }
+        if (Poco::Net::WebSocket::FRAME_OP_PONG == opcode) {
+            Poco::Mutex::ScopedLock lock(mutex_);
+            pong_.assign(buffer.begin(), buffer.size());
+            ponged_.set();
+            continue;
+        }
+
+        // The first data frame is the client authenticating itself
+        Poco::Mutex::ScopedLock lock(mutex_);
+        if (!client_) {
+            client_ = ws;
+            connected_.set();
+        }
+    }
+
+    Poco::Mutex::ScopedLock lock(mutex_);
+    client_ = nullptr;
+}
+
+}  // namespace test
+
+}  // namespace toggl
@@ -0,0 +1,58 @@
+// Copyright 2020 Toggl Desktop developers.
+
+#ifndef SRC_TEST_WEBSOCKET_STUB_H_
+#define SRC_TEST_WEBSOCKET_STUB_H_
+
+#include <atomic>
+#include <string>
+
+#include <Poco/Event.h>
+#include <Poco/Mutex.h>
+#include <Poco/Net/HTTPServer.h>
+#include <Poco/Net/WebSocket.h>
+
+namespace toggl {
+
+namespace test {
+
+// Local stand-in for the Toggl websocket server. Listens on a random port
+// of 127.0.0.1, accepts one client and lets the test push messages to it.
+class WebSocketStub {
+ public:
+    WebSocketStub();
+    ~WebSocketStub();
+
+    // Pass to urls::SetWebSocket()
+    std::string URL() const;
+
+    // Waits until a client has connected and sent its authentication
+    bool WaitForClient(const long milliseconds);
+
+    // Sends a message split into the given number of frames, with a
+    // ping control frame in between the fragments if asked to
+    void Send(const std::string &message,
+              const int fragments = 1,
+              const bool ping_between_fragments = false);
+
+    // Payload of the last pong the client sent
+    bool WaitForPong(const long milliseconds, std::string *payload);
+
+    // Called from the request handler
+    void serve(Poco::Net::WebSocket *ws);
+
+ private:
+    Poco::Net::HTTPServer *server_;
+
+    Poco::Mutex mutex_;
+    Poco::Net::WebSocket *client_;
+    Poco::Event connected_;
+    Poco::Event ponged_;
+    std::string pong_;
+    std::atomic<bool> stopping_;
+};
+
+}  // namespace test
+
+}  // namespace toggl
+
+#endif  // SRC_TEST_WEBSOCKET_STUB_H_
@@ -0,0 +1,120 @@
+// Copyright 2020 Toggl Desktop developers.
+
+#include "timeline_event_queue.h"
+
+#include <vector>
+
+#include "model/timeline_event.h"
+
+namespace toggl {
+
+const std::size_t TimelineEventQueue::kDefaultCapacity = 1024;
+
+TimelineEventQueue::TimelineEventQueue(const std::size_t capacity)
+    : slots_(nullptr)
+, mask_(0)
+, push_at_(0)
+, take_at_(0)
+, queued_(0)
+, dropped_(0)
+, batches_(0)
+, largest_batch_(0) {
+    std::size_t size(2);
+    while (size < capacity) {
+        size *= 2;
+    }
+    mask_ = size - 1;
+
+    // A slot is free for the producer whose position matches its sequence
+    slots_ = new Slot[size];
+    for (std::size_t i = 0; i < size; i++) {
+        slots_[i].Sequence.store(i, std::memory_order_relaxed);
+        slots_[i].Event = nullptr;
+    }
+}
+
+TimelineEventQueue::~TimelineEventQueue() {
+    std::vector<TimelineEvent *> left = Take();
+    for (std::size_t i = 0; i < left.size(); i++) {
+        delete left[i];
+    }
+    delete[] slots_;
+}
+
+std::size_t TimelineEventQueue::Push(TimelineEvent *event) {
+    std::size_t position = push_at_.load(std::memory_order_relaxed);
+    Slot *slot = nullptr;
+    for (;;) {
+        slot = &slots_[position & mask_];
+        std::size_t sequence = slot->Sequence.load(std::memory_order_acquire);
+        if (sequence == position) {
+            // Claim the slot, on failure position is reloaded
+            if (push_at_.compare_exchange_weak(
+                        position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (sequence < position) {
+            // The consumer has not emptied this slot since the last round
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return 0;
+        } else {
+            // Another producer claimed it first
+            position = push_at_.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->Event = event;
+    slot->Sequence.store(position + 1, std::memory_order_release);
+    queued_.fetch_add(1, std::memory_order_relaxed);
+
+    // The consumer may have taken the event already
+    std::size_t taken = take_at_.load();
+    return taken > position ? 1 : position + 1 - taken;
+}
+
+std::vector<TimelineEvent *> TimelineEventQueue::Take() {
+    std::vector<TimelineEvent *> batch;
+
+    std::size_t position = take_at_.load(std::memory_order_relaxed);
+    for (;;) {
+        Slot *slot = &slots_[position & mask_];
+        // Stop at the first slot that is claimed but not filled yet
+        if (slot->Sequence.load(std::memory_order_acquire) != position + 1) {
+            break;
+        }
+        batch.push_back(slot->Event);
+        slot->Event = nullptr;
+        slot->Sequence.store(position + mask_ + 1, std::memory_order_release);
+        position++;
+    }
+    take_at_.store(position);
+
+    if (!batch.empty()) {
+        batches_.fetch_add(1, std::memory_order_relaxed);
+        Poco::UInt64 size = batch.size();
+        Poco::UInt64 largest = largest_batch_.load(std::memory_order_relaxed);
+        while (size > largest
+                && !largest_batch_.compare_exchange_weak(
+                    largest, size, std::memory_order_relaxed)) {}
+    }
+
+    return batch;
+}
+
+std::size_t TimelineEventQueue::Depth() const {
+    std::size_t taken = take_at_.load();
+    std::size_t pushed = push_at_.load();
+    return pushed > taken ? pushed - taken : 0;
+}
+
+TimelineEventQueueStats TimelineEventQueue::Stats() const {
+    TimelineEventQueueStats stats;
+    stats.Queued = queued_.load(std::memory_order_relaxed);
+    stats.Dropped = dropped_.load(std::memory_order_relaxed);
+    stats.Batches = batches_.load(std::memory_order_relaxed);
+    stats.LargestBatch = largest_batch_.load(std::memory_order_relaxed);
+    stats.Depth = Depth();
+    return stats;
+}
+
+}  // namespace toggl
@@ -0,0 +1,90 @@
+// Copyright 2020 Toggl Desktop developers.
+
+#ifndef SRC_TIMELINE_EVENT_QUEUE_H_
+#define SRC_TIMELINE_EVENT_QUEUE_H_
+
+#include <atomic>
+#include <vector>
+
+#include "types.h"
+
+#include <Poco/Types.h>
+
+namespace toggl {
+
+class TimelineEvent;
+
+class TOGGL_INTERNAL_EXPORT TimelineEventQueueStats {
+ public:
+    TimelineEventQueueStats()
+        : Queued(0)
+    , Dropped(0)
+    , Batches(0)
+    , LargestBatch(0)
+    , Depth(0) {}
+
+    // Events accepted so far
+    Poco::UInt64 Queued;
+    // Events thrown away because the queue was full
+    Poco::UInt64 Dropped;
+    Poco::UInt64 Batches;
+    Poco::UInt64 LargestBatch;
+    // Events waiting right now
+    Poco::UInt64 Depth;
+};
+
+// Hands timeline events from the recorders over to the thread that
+// stores them, without the recorders ever waiting for a lock.
+//
+// A fixed ring of slots, each with a sequence number telling whether
+// it is free for the next producer or filled for the consumer. Any
+// number of threads can Push, only one may Take at a time.
+class TOGGL_INTERNAL_EXPORT TimelineEventQueue {
+ public:
+    // Capacity is rounded up to a power of two
+    explicit TimelineEventQueue(
+        const std::size_t capacity = kDefaultCapacity);
+    ~TimelineEventQueue();
+
+    // Queues the event and takes ownership of it. Returns the number
+    // of events now waiting, or zero if the queue was full and the
+    // event was not queued, in which case it stays with the caller.
+    std::size_t Push(TimelineEvent *event);
+
+    // Hands over the events queued so far, oldest first
+    std::vector<TimelineEvent *> Take();
+
+    std::size_t Depth() const;
+
+    std::size_t Capacity() const {
+        return mask_ + 1;
+    }
+
+    TimelineEventQueueStats Stats() const;
+
+    static const std::size_t kDefaultCapacity;
+
+ private:
+    TimelineEventQueue(const TimelineEventQueue &);
+    TimelineEventQueue &operator=(const TimelineEventQueue &);
+
+    struct Slot {
+        std::atomic<std::size_t> Sequence;
+        TimelineEvent *Event;
+    };
+
+    Slot *slots_;
+    std::size_t mask_;
+
+    std::atomic<std::size_t> push_at_;
+    std::atomic<std::size_t> take_at_;
+
+    std::atomic<Poco::UInt64> queued_;
+    std::atomic<Poco::UInt64> dropped_;
+    std::atomic<Poco::UInt64> batches_;
+    std::atomic<Poco::UInt64> largest_batch_;
+};
+
+}  // namespace toggl
+
+#endif  // SRC_TIMELINE_EVENT_QUEUE_H_
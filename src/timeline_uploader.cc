@@ -10,8 +10,8 @@
 #include "urls.h"
 
 #include <Poco/Foundation.h>
-#include <Poco/Thread.h>
 #include <Poco/Util/Application.h>
+#include <Poco/Util/TimerTaskAdapter.h>
 
 #include <json/json.h>  // NOLINT
 
@@ -21,30 +21,32 @@ Logger TimelineUploader::logger() const {
     return { "timeline_uploader" };
 }
 
-void TimelineUploader::sleep() {
-    // Sleep in increments for faster shutdown.
-    for (unsigned int i = 0; i < current_upload_interval_seconds_*4; i++) {
-        if (uploading_.isStopped()) {
-            return;
-        }
-        Poco::Thread::sleep(250);
+void TimelineUploader::onUpload(Poco::Util::TimerTask& task) {  // NOLINT
+    error err = process();
+    if (err != noError) {
+        logger().error(err);
     }
-}
 
-void TimelineUploader::upload_loop_activity() {
-    while (!uploading_.isStopped()) {
-        error err = process();
-        if (err != noError) {
-            logger().error(err);
-        }
-        sleep();
+    Poco::Mutex::ScopedLock lock(mutex_);
+    if (stopped_ || upload_task_.get() != &task) {
+        return;
     }
+    Poco::Timestamp next;
+    next += static_cast<Poco::Timestamp::TimeDiff>(
+        current_upload_interval_seconds_) * Poco::Timestamp::resolution();
+    schedule(next);
+}
+
+void TimelineUploader::schedule(const Poco::Timestamp &at) {
+    upload_task_ = new Poco::Util::TimerTaskAdapter<TimelineUploader>(
+        *this, &TimelineUploader::onUpload);
+    executor_->ScheduleBlocking(upload_task_, at);
 }
 
 error TimelineUploader::process() {
-    logger().debug("upload_loop_activity (current interval ", current_upload_interval_seconds_, "s)");
+    logger().debug("onUpload (current interval ", current_upload_interval_seconds_, "s)");
 
-    if (uploading_.isStopped()) {
+    if (stopped_) {
         return noError;
     }
 
@@ -59,7 +61,7 @@ error TimelineUploader::process() {
         return noError;
     }
 
-    if (uploading_.isStopped()) {
+    if (stopped_) {
         return noError;
     }
 
@@ -91,6 +93,7 @@ error TimelineUploader::upload(TimelineBatch *batch) {
     req.payload = json;
     req.basic_auth_username = batch->APIToken();
     req.basic_auth_password = "api_token";
+    req.priority = kRequestPriorityBackground;
 
     return TogglClient::GetInstance().silentPost(req).err;
 }
@@ -130,24 +133,23 @@ void TimelineUploader::reset_backoff() {
 }
 
 error TimelineUploader::start() {
-    try {
-        uploading_.start();
-    } catch(const Poco::Exception& exc) {
-        return exc.displayText();
-    } catch(const std::exception& ex) {
-        return ex.what();
-    } catch(const std::string & ex) {
-        return ex;
-    }
+    Poco::Mutex::ScopedLock lock(mutex_);
+    schedule(Poco::Timestamp());
     return noError;
 }
 
 error TimelineUploader::Shutdown() {
+    Poco::Util::TimerTask::Ptr task;
+    {
+        Poco::Mutex::ScopedLock lock(mutex_);
+        stopped_ = true;
+        task = upload_task_;
+        upload_task_ = nullptr;
+    }
+
+    // Not under mutex_, the upload takes it to schedule the next one
     try {
-        if (uploading_.isRunning()) {
-            uploading_.stop();
-            uploading_.wait();
-        }
+        executor_->CancelAndWait(task);
     } catch(const Poco::Exception& exc) {
         return exc.displayText();
     } catch(const std::exception& ex) {
@@ -3,15 +3,19 @@
 #ifndef SRC_TIMELINE_UPLOADER_H_
 #define SRC_TIMELINE_UPLOADER_H_
 
+#include <atomic>
 #include <string>
 #include <vector>
 
+#include "executor.h"
 #include "model/timeline_event.h"
 #include "timeline_notifications.h"
 #include "types.h"
 #include "util/logger.h"
 
-#include <Poco/Activity.h>
+#include <Poco/Mutex.h>
+#include <Poco/Timestamp.h>
+#include <Poco/Util/TimerTask.h>
 
 namespace toggl {
 
@@ -19,12 +23,16 @@ std::string convertTimelineToJSON(
     const std::vector<const TimelineEvent*> &timeline_events,
     const std::string &desktop_id);
 
+// Uploads the recorded timeline every kTimelineUploadIntervalSeconds,
+// backing off while uploads fail. Each upload is a blocking task on the
+// executor, so it doesn't hold up the tasks that run one at a time.
 class TOGGL_INTERNAL_EXPORT TimelineUploader {
  public:
-    explicit TimelineUploader(TimelineDatasource *ds)
+    TimelineUploader(TimelineDatasource *ds, Executor *executor)
         : current_upload_interval_seconds_(kTimelineUploadIntervalSeconds)
     , timeline_datasource_(ds)
-    , uploading_(this, &TimelineUploader::upload_loop_activity) {
+    , executor_(executor)
+    , stopped_(false) {
         start();
     }
 
@@ -32,11 +40,12 @@ class TOGGL_INTERNAL_EXPORT TimelineUploader {
         Shutdown();
     }
 
+    // Cancels the next upload and waits for one in progress
     error Shutdown();
 
  protected:
-    // Activity callback
-    void upload_loop_activity();
+    // Executor callback
+    void onUpload(Poco::Util::TimerTask& task);  // NOLINT
 
  private:
     error start();
@@ -52,13 +61,18 @@ class TOGGL_INTERNAL_EXPORT TimelineUploader {
     Logger logger() const;
 
     error process();
-    void sleep();
+
+    // Schedules the next upload, mutex_ has to be locked
+    void schedule(const Poco::Timestamp &at);
 
     TimelineDatasource *timeline_datasource_;
 
-    // An Activity is a possibly long running void/no arguments
-    // member function running in its own thread.
-    Poco::Activity<TimelineUploader> uploading_;
+    Executor *executor_;
+
+    Poco::Mutex mutex_;
+    // Set by Shutdown(), no upload is scheduled afterwards
+    std::atomic<bool> stopped_;
+    Poco::Util::TimerTask::Ptr upload_task_;
 };
 
 }  // namespace toggl
@@ -1298,6 +1298,25 @@ void toggl_on_time_entry_list(
     app(context)->UI()->OnDisplayTimeEntryList(cb);
 }
 
+void toggl_on_time_entry_list_changes(
+    void *context,
+    TogglDisplayTimeEntryListChanges cb) {
+    app(context)->UI()->OnDisplayTimeEntryListChanges(cb);
+}
+
+void toggl_on_time_entry_list_window(
+    void *context,
+    TogglDisplayTimeEntryListWindow cb) {
+    app(context)->UI()->OnDisplayTimeEntryListWindow(cb);
+}
+
+void toggl_set_time_entry_list_window(
+    void *context,
+    const uint64_t first_row,
+    const uint64_t count) {
+    app(context)->SetTimeEntryListWindow(first_row, count);
+}
+
 void toggl_on_timeline(
     void *context,
     TogglDisplayTimeline cb) {
@@ -1340,6 +1359,12 @@ void toggl_on_timer_state(
     app(context)->UI()->OnDisplayTimerState(cb);
 }
 
+void toggl_on_running_timer(
+    void *context,
+    TogglDisplayRunningTimer cb) {
+    app(context)->UI()->OnDisplayRunningTimer(cb);
+}
+
 void toggl_on_idle_notification(
     void *context,
     TogglDisplayIdleNotification cb) {
@@ -1413,6 +1438,11 @@ char_t *toggl_check_view_struct_size(
     return nullptr;
 }
 
+char_t *toggl_get_lock_stats(
+    void *context) {
+    return copy_string(app(context)->LockStats());
+}
+
 void toggl_set_idle_seconds(
     void *context,
     const uint64_t idle_seconds) {
@@ -42,6 +42,11 @@ extern "C" {
 
 #define kPromotionJoinBetaChannel 1
 
+#define kTimeEntryListChangeInsert 0
+#define kTimeEntryListChangeUpdate 1
+#define kTimeEntryListChangeMove 2
+#define kTimeEntryListChangeDelete 3
+
 // Models
 
     typedef struct {
@@ -94,6 +99,19 @@ extern "C" {
         void *Next;
     } TogglTimeEntryView;
 
+    typedef struct {
+        // kTimeEntryListChange*
+        uint8_t Type;
+        // GUID of the time entry, or GroupName of a group header
+        char_t *Key;
+        // Position in the list, in the previous list for deletes
+        uint64_t Index;
+        // The row as it's shown now, nullptr for deletes
+        TogglTimeEntryView *Item;
+        // Next in list
+        void *Next;
+    } TogglTimeEntryListChangeView;
+
     typedef struct {
         char_t *Title;
         char_t *Filename;
@@ -309,6 +327,30 @@ typedef enum {
         TogglTimeEntryView *first,
         const bool_t show_load_more_button);
 
+    // Only the rows changed since the previous call, the first call
+    // inserts every row. Changes come in the order they can be applied:
+    //   - deletes, from the last row to the first
+    //   - inserts and moves, from the first row to the last; moved rows
+    //     are taken out and put back in at their new position
+    //   - updates of rows that stayed where they were
+    typedef void (*TogglDisplayTimeEntryListChanges)(
+        const bool_t open,
+        TogglTimeEntryListChangeView *first,
+        const bool_t show_load_more_button);
+
+    // Rows of the time entry list around the window the UI shows, see
+    // toggl_set_time_entry_list_window. first_row is the position of the
+    // first row passed in the whole list of total_rows rows. header_rows
+    // are the positions of all rows starting a date, to size the scrollbar.
+    typedef void (*TogglDisplayTimeEntryListWindow)(
+        const bool_t open,
+        TogglTimeEntryView *first,
+        const uint64_t first_row,
+        const uint64_t total_rows,
+        const uint64_t *header_rows,
+        const uint64_t header_row_count,
+        const bool_t show_load_more_button);
+
     typedef void (*TogglDisplayTimeline)(
         const bool_t open,
         const char_t *date,
@@ -338,6 +380,15 @@ typedef enum {
     typedef void (*TogglDisplayTimerState)(
         TogglTimeEntryView *te);
 
+    // The running time entry and the total of its date, whenever the
+    // date header would show another total. The GUID is empty once
+    // nothing is running anymore.
+    typedef void (*TogglDisplayRunningTimer)(
+        const char_t *guid,
+        const uint64_t started,
+        const int64_t date_duration_in_seconds,
+        const char_t *date_duration);
+
     typedef void (*TogglContinueSignIn)(
     );
 
@@ -530,6 +581,25 @@ typedef enum {
         void *context,
         TogglDisplayTimeEntryList cb);
 
+    // When set, the time entry list is rendered with this
+    // instead of the toggl_on_time_entry_list callback
+    TOGGL_EXPORT void toggl_on_time_entry_list_changes(
+        void *context,
+        TogglDisplayTimeEntryListChanges cb);
+
+    // When set, the time entry list is rendered with this, only
+    // the rows around the window the UI reports are sent
+    TOGGL_EXPORT void toggl_on_time_entry_list_window(
+        void *context,
+        TogglDisplayTimeEntryListWindow cb);
+
+    // The UI shows count rows of the time entry list from first_row on.
+    // The rows around them are sent again with the next render.
+    TOGGL_EXPORT void toggl_set_time_entry_list_window(
+        void *context,
+        const uint64_t first_row,
+        const uint64_t count);
+
     TOGGL_EXPORT void toggl_toggle_entries_group(
         void *context,
         const char_t *name);
@@ -578,6 +648,12 @@ typedef enum {
         void *context,
         TogglDisplayTimerState cb);
 
+    // When set, the time entry list is not rendered again
+    // just because the date total of the running entry changed
+    TOGGL_EXPORT void toggl_on_running_timer(
+        void *context,
+        TogglDisplayRunningTimer cb);
+
     TOGGL_EXPORT void toggl_on_idle_notification(
         void *context,
         TogglDisplayIdleNotification cb);
@@ -1165,6 +1241,13 @@ typedef enum {
         const int settings_size,
         const int autotracker_view_item_size);
 
+    // Acquisitions, wait and hold time histograms and the longest
+    // holding call sites of the library locks, as a JSON list.
+    // An empty list unless the library is built with TOGGL_LOCK_STATS,
+    // you must free() the result
+    TOGGL_EXPORT char_t *toggl_get_lock_stats(
+        void *context);
+
     TOGGL_EXPORT int64_t toggl_autotracker_add_rule(
         void *context,
         const char_t *term,
@@ -2,6 +2,7 @@
 
 #include "toggl_api_private.h"
 
+#include <atomic>
 #include <cstdlib>
 
 #include "model/client.h"
@@ -14,82 +15,98 @@
 
 #include <Poco/UnicodeConverter.h>
 
-TogglAutocompleteView *autocomplete_item_init(const toggl::view::Autocomplete &item) {
-    TogglAutocompleteView *result = new TogglAutocompleteView();
-    result->Description = copy_string(item.Description);
-    result->Text = copy_string(item.Text);
-    result->ProjectAndTaskLabel = copy_string(item.ProjectAndTaskLabel);
-    result->TaskLabel = copy_string(item.TaskLabel);
-    result->ProjectLabel = copy_string(item.ProjectLabel);
-    result->ClientLabel = copy_string(item.ClientLabel);
-    result->ProjectColor = copy_string(item.ProjectColor);
-    result->ProjectGUID = copy_string(item.ProjectGUID);
+namespace {
+
+void reserve_autocomplete_view(
+    const toggl::view::Autocomplete &item,
+    toggl::ViewArena *arena) {
+    arena->Reserve<TogglAutocompleteView>();
+    arena->Reserve(item.Description);
+    arena->Reserve(item.Text);
+    arena->Reserve(item.ProjectAndTaskLabel);
+    arena->Reserve(item.TaskLabel);
+    arena->Reserve(item.ProjectLabel);
+    arena->Reserve(item.ClientLabel);
+    arena->Reserve(item.ProjectColor);
+    arena->Reserve(item.ProjectGUID);
+    arena->Reserve(item.Tags);
+    arena->Reserve(item.WorkspaceName);
+}
+
+void reserve_generic_view(
+    const toggl::view::Generic &c,
+    toggl::ViewArena *arena) {
+    arena->Reserve<TogglGenericView>();
+    arena->Reserve(c.GUID);
+    arena->Reserve(c.Name);
+    arena->Reserve(c.WorkspaceName);
+}
+
+void reserve_time_entry_view(
+    const toggl::view::TimeEntry &te,
+    toggl::ViewArena *arena) {
+    arena->Reserve<TogglTimeEntryView>();
+    arena->Reserve(te.Description);
+    arena->Reserve(te.GUID);
+    arena->Reserve(te.Duration);
+    arena->Reserve(te.WorkspaceName);
+    arena->Reserve(te.ProjectAndTaskLabel);
+    arena->Reserve(te.TaskLabel);
+    arena->Reserve(te.ProjectLabel);
+    arena->Reserve(te.ClientLabel);
+    arena->Reserve(te.Color);
+    arena->Reserve(te.StartTimeString);
+    arena->Reserve(te.EndTimeString);
+    arena->Reserve(te.DateDuration);
+    arena->Reserve(te.Tags);
+    arena->Reserve(te.DateHeader);
+    arena->Reserve(te.Error);
+    arena->Reserve(te.GroupName);
+    arena->Reserve(te.GroupDuration);
+}
+
+}  // namespace
+
+TogglAutocompleteView *autocomplete_item_init(
+    const toggl::view::Autocomplete &item,
+    toggl::ViewArena *arena) {
+    TogglAutocompleteView *result = arena->New<TogglAutocompleteView>();
+    result->Description = arena->String(item.Description);
+    result->Text = arena->String(item.Text);
+    result->ProjectAndTaskLabel = arena->String(item.ProjectAndTaskLabel);
+    result->TaskLabel = arena->String(item.TaskLabel);
+    result->ProjectLabel = arena->String(item.ProjectLabel);
+    result->ClientLabel = arena->String(item.ClientLabel);
+    result->ProjectColor = arena->String(item.ProjectColor);
+    result->ProjectGUID = arena->String(item.ProjectGUID);
     result->TaskID = static_cast<unsigned int>(item.TaskID);
     result->ProjectID = static_cast<unsigned int>(item.ProjectID);
     result->WorkspaceID = static_cast<unsigned int>(item.WorkspaceID);
     result->Type = static_cast<unsigned int>(item.Type);
-    result->Tags = copy_string(item.Tags);
-    result->WorkspaceName = copy_string(item.WorkspaceName);
+    result->Tags = arena->String(item.Tags);
+    result->WorkspaceName = arena->String(item.WorkspaceName);
     result->ClientID = static_cast<unsigned int>(item.ClientID);
     result->Billable = item.Billable;
     result->Next = nullptr;
     return result;
 }
 
-void autocomplete_item_clear(TogglAutocompleteView *item) {
-    if (!item) {
-        return;
-    }
-
-    free(item->Text);
-    item->Text = nullptr;
-
-    free(item->ProjectAndTaskLabel);
-    item->ProjectAndTaskLabel = nullptr;
-
-    free(item->TaskLabel);
-    item->TaskLabel = nullptr;
-
-    free(item->ProjectLabel);
-    item->ProjectLabel = nullptr;
-
-    free(item->ClientLabel);
-    item->ClientLabel = nullptr;
-
-    free(item->Description);
-    item->Description = nullptr;
-
-    free(item->ProjectColor);
-    item->ProjectColor = nullptr;
-
-    free(item->ProjectGUID);
-    item->ProjectGUID = nullptr;
-
-    free(item->Tags);
-    item->Tags = nullptr;
-
-    free(item->WorkspaceName);
-    item->WorkspaceName = nullptr;
-
-    delete item;
-}
-
-void autocomplete_list_clear(TogglAutocompleteView *first) {
-    while (first) {
-        TogglAutocompleteView *next = reinterpret_cast<TogglAutocompleteView *>(first->Next);
-        autocomplete_item_clear(first);
-        first = next;
+TogglGenericView *generic_to_view_item_list(
+    const std::vector<toggl::view::Generic> &list,
+    toggl::ViewArena *arena) {
+    for (std::vector<toggl::view::Generic>::const_iterator
+            it = list.begin();
+            it != list.end();
+            ++it) {
+        reserve_generic_view(*it, arena);
     }
-}
 
-TogglGenericView *generic_to_view_item_list(
-    const std::vector<toggl::view::Generic> &list) {
     TogglGenericView *first = nullptr;
     for (std::vector<toggl::view::Generic>::const_iterator
             it = list.begin();
             it != list.end();
             ++it) {
-        TogglGenericView *item = generic_to_view_item(*it);
+        TogglGenericView *item = generic_to_view_item(*it, arena);
         item->Next = first;
         first = item;
     }
@@ -97,114 +114,30 @@ TogglGenericView *generic_to_view_item_list(
 }
 
 TogglGenericView *generic_to_view_item(
-    const toggl::view::Generic &c) {
-    TogglGenericView *result = new TogglGenericView();
+    const toggl::view::Generic &c,
+    toggl::ViewArena *arena) {
+    TogglGenericView *result = arena->New<TogglGenericView>();
     result->ID = static_cast<unsigned int>(c.ID);
     result->WID = static_cast<unsigned int>(c.WID);
-    result->GUID = copy_string(c.GUID);
-    result->Name = copy_string(c.Name);
-    result->WorkspaceName = copy_string(c.WorkspaceName);
+    result->GUID = arena->String(c.GUID);
+    result->Name = arena->String(c.Name);
+    result->WorkspaceName = arena->String(c.WorkspaceName);
     result->Premium = c.Premium;
     return result;
 }
 
-TogglAutotrackerRuleView *autotracker_rule_to_view_item(const toggl::view::AutotrackerRule &model) {
-    TogglAutotrackerRuleView *view = new TogglAutotrackerRuleView();
+TogglAutotrackerRuleView *autotracker_rule_to_view_item(
+    const toggl::view::AutotrackerRule &model,
+    toggl::ViewArena *arena) {
+    TogglAutotrackerRuleView *view = arena->New<TogglAutotrackerRuleView>();
     // Autotracker settings are not saved to DB,
     // so the ID will be 0 always. But will have local ID
     view->ID = static_cast<int>(model.ID);
-    view->Term = copy_string(model.Term);
-    view->ProjectAndTaskLabel = copy_string(model.ProjectName);
+    view->Term = arena->String(model.Term);
+    view->ProjectAndTaskLabel = arena->String(model.ProjectName);
     return view;
 }
 
-void autotracker_view_item_clear(TogglAutotrackerRuleView *view) {
-    if (!view) {
-        return;
-    }
-
-    view->ID = 0;
-
-    free(view->Term);
-    view->Term = nullptr;
-
-    free(view->ProjectAndTaskLabel);
-    view->ProjectAndTaskLabel = nullptr;
-
-    delete view;
-}
-
-void autotracker_view_list_clear(TogglAutotrackerRuleView *first) {
-    while (first) {
-        TogglAutotrackerRuleView *next = reinterpret_cast<TogglAutotrackerRuleView *>(first->Next);
-        autotracker_view_item_clear(first);
-        first = next;
-    }
-}
-
-void view_item_clear(TogglGenericView *item) {
-    if (!item) {
-        return;
-    }
-
-    free(item->Name);
-    item->Name = nullptr;
-
-    free(item->GUID);
-    item->GUID = nullptr;
-
-    free(item->WorkspaceName);
-    item->WorkspaceName = nullptr;
-
-    delete item;
-}
-
-void view_list_clear(TogglGenericView *first) {
-    while (first) {
-        TogglGenericView *next = reinterpret_cast<TogglGenericView*>(first->Next);
-        view_item_clear(first);
-        first = next;
-    }
-}
-
-void country_item_clear(TogglCountryView *item) {
-    if (!item) {
-        return;
-    }
-
-    item->ID = 0;
-
-    free(item->Name);
-    item->Name = nullptr;
-
-    free(item->VatPercentage);
-    item->VatPercentage = nullptr;
-
-    free(item->VatRegex);
-    item->VatRegex = nullptr;
-
-    free(item->Code);
-    item->Code = nullptr;
-
-    delete item;
-}
-
-void country_list_clear(TogglCountryView *first) {
-    while (first) {
-        TogglCountryView *next = reinterpret_cast<TogglCountryView *>(first->Next);
-        country_item_clear(first);
-        first = next;
-    }
-}
-
-void country_list_delete_item(TogglCountryView *first) {
-    while (first) {
-        TogglCountryView *next = reinterpret_cast<TogglCountryView *>(first->Next);
-        delete first; // Only delete TogglCountryView pointer without deleting its variables because they are holding by other references
-        first = next;
-    }
-}
-
 std::string to_string(const char_t *s) {
     if (!s) {
         return std::string("");
@@ -242,7 +175,10 @@ const char_t *to_char_t(const std::string &s) {
 #endif
 }
 
+static std::atomic<uint64_t> copied_strings_(0);
+
 char_t *copy_string(const std::string &s) {
+    copied_strings_.fetch_add(1, std::memory_order_relaxed);
 #if defined(_WIN32) || defined(WIN32)
     std::wstring ws;
     Poco::UnicodeConverter::toUTF16(s, ws);
@@ -252,6 +188,14 @@ char_t *copy_string(const std::string &s) {
 #endif
 }
 
+uint64_t copied_string_count() {
+    return copied_strings_.load(std::memory_order_relaxed);
+}
+
+uint64_t view_allocation_count() {
+    return copied_string_count() + toggl::ViewArena::AllocatedBlocks();
+}
+
 int compare_string(const char_t *s1, const char_t *s2) {
 #if defined(_WIN32) || defined(WIN32)
     return wcscmp(s1, s2);
@@ -261,15 +205,15 @@ int compare_string(const char_t *s1, const char_t *s2) {
 }
 
 TogglCountryView *country_list_init(
-    std::vector<TogglCountryView> *items) {
+    std::vector<TogglCountryView> *items,
+    toggl::ViewArena *arena) {
 
     TogglCountryView *first = nullptr;
     for (std::vector<TogglCountryView>::const_iterator
             it = items->begin();
             it != items->end();
             ++it) {
-        TogglCountryView *item = new TogglCountryView();
-        poco_check_ptr(item);
+        TogglCountryView *item = arena->New<TogglCountryView>();
 
         item->ID = it->ID;
         item->Name = it->Name;
@@ -284,59 +228,59 @@ TogglCountryView *country_list_init(
     return first;
 }
 
-TogglCountryView *country_view_item_init(
-    const Json::Value v) {
+TogglCountryView country_view_item_init(
+    const Json::Value v,
+    toggl::ViewArena *arena) {
 
-    TogglCountryView *item = new TogglCountryView();
-    poco_check_ptr(item);
+    TogglCountryView item = TogglCountryView();
 
-    item->ID = v["id"].asInt64();
-    item->Name = copy_string(v["name"].asString());
-    item->VatApplicable = v["vat_applicable"].asBool();
-    item->VatRegex = copy_string(v["vat_regex"].asString());
-    item->VatPercentage = copy_string(v["vat_percentage"].asString());
-    item->Code = copy_string(v["country_code"].asString());
+    item.ID = v["id"].asInt64();
+    item.Name = arena->String(v["name"].asString());
+    item.VatApplicable = v["vat_applicable"].asBool();
+    item.VatRegex = arena->String(v["vat_regex"].asString());
+    item.VatPercentage = arena->String(v["vat_percentage"].asString());
+    item.Code = arena->String(v["country_code"].asString());
 
-    item->Next = nullptr;
+    item.Next = nullptr;
 
     return item;
 }
 
 TogglTimeEntryView *time_entry_view_item_init(
-    const toggl::view::TimeEntry &te) {
+    const toggl::view::TimeEntry &te,
+    toggl::ViewArena *arena) {
 
-    TogglTimeEntryView *view_item = new TogglTimeEntryView();
-    poco_check_ptr(view_item);
+    TogglTimeEntryView *view_item = arena->New<TogglTimeEntryView>();
 
     view_item->ID = static_cast<unsigned int>(te.ID);
     view_item->DurationInSeconds = static_cast<int>(te.DurationInSeconds);
-    view_item->Description = copy_string(te.Description);
-    view_item->GUID = copy_string(te.GUID);
+    view_item->Description = arena->String(te.Description);
+    view_item->GUID = arena->String(te.GUID);
     view_item->WID = static_cast<unsigned int>(te.WID);
     view_item->TID = static_cast<unsigned int>(te.TID);
     view_item->PID = static_cast<unsigned int>(te.PID);
-    view_item->Duration = copy_string(te.Duration);
+    view_item->Duration = arena->String(te.Duration);
     view_item->Started = static_cast<unsigned int>(te.Started);
     view_item->Ended = static_cast<unsigned int>(te.Ended);
-    view_item->WorkspaceName = copy_string(te.WorkspaceName);
-    view_item->ProjectAndTaskLabel = copy_string(te.ProjectAndTaskLabel);
-    view_item->TaskLabel = copy_string(te.TaskLabel);
-    view_item->ProjectLabel = copy_string(te.ProjectLabel);
-    view_item->ClientLabel = copy_string(te.ClientLabel);
-    view_item->Color = copy_string(te.Color);
-    view_item->StartTimeString = copy_string(te.StartTimeString);
-    view_item->EndTimeString = copy_string(te.EndTimeString);
-    view_item->DateDuration = copy_string(te.DateDuration);
+    view_item->WorkspaceName = arena->String(te.WorkspaceName);
+    view_item->ProjectAndTaskLabel = arena->String(te.ProjectAndTaskLabel);
+    view_item->TaskLabel = arena->String(te.TaskLabel);
+    view_item->ProjectLabel = arena->String(te.ProjectLabel);
+    view_item->ClientLabel = arena->String(te.ClientLabel);
+    view_item->Color = arena->String(te.Color);
+    view_item->StartTimeString = arena->String(te.StartTimeString);
+    view_item->EndTimeString = arena->String(te.EndTimeString);
+    view_item->DateDuration = arena->String(te.DateDuration);
     view_item->Billable = te.Billable;
     if (te.Tags.empty()) {
         view_item->Tags = nullptr;
     } else {
-        view_item->Tags = copy_string(te.Tags.c_str());
+        view_item->Tags = arena->String(te.Tags);
     }
     view_item->UpdatedAt = static_cast<unsigned int>(te.UpdatedAt);
-    view_item->DateHeader = copy_string(te.DateHeader);
+    view_item->DateHeader = arena->String(te.DateHeader);
     view_item->DurOnly = te.DurOnly;
-    view_item->IsHeader = false;
+    view_item->IsHeader = te.IsHeader;
 
     view_item->CanAddProjects = te.CanAddProjects;
     view_item->CanSeeBillable = te.CanSeeBillable;
@@ -346,15 +290,15 @@ TogglTimeEntryView *time_entry_view_item_init(
     view_item->Locked = te.Locked;
 
     if (te.Error != toggl::noError) {
-        view_item->Error = copy_string(te.Error);
+        view_item->Error = arena->String(te.Error);
     } else {
         view_item->Error = nullptr;
     }
 
     view_item->Group = te.Group;
     view_item->GroupOpen = te.GroupOpen;
-    view_item->GroupName = copy_string(te.GroupName);
-    view_item->GroupDuration = copy_string(te.GroupDuration);
+    view_item->GroupName = arena->String(te.GroupName);
+    view_item->GroupDuration = arena->String(te.GroupDuration);
     view_item->GroupItemCount = te.GroupItemCount;
 
     view_item->RoundedStart = te.RoundedStart;
@@ -365,81 +309,63 @@ TogglTimeEntryView *time_entry_view_item_init(
     return view_item;
 }
 
-void time_entry_view_item_clear(
-    TogglTimeEntryView *item) {
-    if (!item) {
-        return;
+TogglTimeEntryView *time_entry_view_list_init(
+    const std::vector<toggl::view::TimeEntry> &rows,
+    const std::size_t begin,
+    const std::size_t end,
+    toggl::ViewArena *arena) {
+    for (std::size_t i = begin; i < end; i++) {
+        reserve_time_entry_view(rows[i], arena);
     }
-    free(item->Description);
-    item->Description = nullptr;
-
-    free(item->WorkspaceName);
-    item->WorkspaceName = nullptr;
-
-    free(item->ProjectAndTaskLabel);
-    item->ProjectAndTaskLabel = nullptr;
-
-    free(item->TaskLabel);
-    item->TaskLabel = nullptr;
-
-    free(item->ProjectLabel);
-    item->ProjectLabel = nullptr;
-
-    free(item->ClientLabel);
-    item->ClientLabel = nullptr;
-
-    free(item->Duration);
-    item->Duration = nullptr;
-
-    free(item->Color);
-    item->Color = nullptr;
 
-    free(item->GUID);
-    item->GUID = nullptr;
-
-    free(item->Tags);
-    item->Tags = nullptr;
-
-    free(item->DateHeader);
-    item->DateHeader = nullptr;
-
-    free(item->DateDuration);
-    item->DateDuration = nullptr;
-
-    free(item->StartTimeString);
-    item->StartTimeString = nullptr;
-
-    free(item->EndTimeString);
-    item->EndTimeString = nullptr;
-
-    if (item->Error) {
-        free(item->Error);
-        item->Error = nullptr;
+    TogglTimeEntryView *first = nullptr;
+    for (std::size_t i = end; i > begin; i--) {
+        TogglTimeEntryView *item = time_entry_view_item_init(rows[i - 1], arena);
+        item->Next = first;
+        first = item;
     }
+    return first;
+}
 
-    free(item->GroupName);
-    item->GroupName = nullptr;
+TogglTimeEntryListChangeView *time_entry_list_change_view_list_init(
+    const std::vector<toggl::view::TimeEntryListChange> &changes,
+    toggl::ViewArena *arena) {
+    for (std::size_t i = 0; i < changes.size(); i++) {
+        arena->Reserve<TogglTimeEntryListChangeView>();
+        arena->Reserve(changes[i].Key);
+        if (changes[i].Row) {
+            reserve_time_entry_view(*changes[i].Row, arena);
+        }
+    }
 
-    free(item->GroupDuration);
-    item->GroupDuration = nullptr;
+    TogglTimeEntryListChangeView *first = nullptr;
+    for (std::size_t i = changes.size(); i > 0; i--) {
+        const toggl::view::TimeEntryListChange &change = changes[i - 1];
 
-    delete item;
-}
+        TogglTimeEntryListChangeView *view_item =
+            arena->New<TogglTimeEntryListChangeView>();
+        view_item->Type = change.Type;
+        view_item->Key = arena->String(change.Key);
+        view_item->Index = change.Index;
+        if (change.Row) {
+            view_item->Item = time_entry_view_item_init(*change.Row, arena);
+        } else {
+            view_item->Item = nullptr;
+        }
 
-void time_entry_view_list_clear(TogglTimeEntryView *first) {
-    while (first) {
-        TogglTimeEntryView *next = reinterpret_cast<TogglTimeEntryView *>(first->Next);
-        time_entry_view_item_clear(first);
-        first = next;
+        view_item->Next = first;
+        first = view_item;
     }
+    return first;
 }
 
 TogglSettingsView *settings_view_item_init(
     const bool_t record_timeline,
     const toggl::Settings &settings,
     const bool_t use_proxy,
-    const toggl::Proxy &proxy) {
-    TogglSettingsView *view = new TogglSettingsView();
+    const toggl::Proxy &proxy,
+    toggl::ViewArena *arena) {
+    TogglSettingsView *view = arena->New<TogglSettingsView>();
 
     view->RecordTimeline = record_timeline;
 
@@ -459,10 +385,10 @@ TogglSettingsView *settings_view_item_init(
 
     view->UseProxy = use_proxy;
 
-    view->ProxyHost = copy_string(proxy.Host());
+    view->ProxyHost = arena->String(proxy.Host());
     view->ProxyPort = proxy.Port();
-    view->ProxyUsername = copy_string(proxy.Username());
-    view->ProxyPassword = copy_string(proxy.Password());
+    view->ProxyUsername = arena->String(proxy.Username());
+    view->ProxyPassword = arena->String(proxy.Password());
 
     view->RemindMon = settings.remind_mon;
     view->RemindTue = settings.remind_tue;
@@ -472,8 +398,8 @@ TogglSettingsView *settings_view_item_init(
     view->RemindSat = settings.remind_sat;
     view->RemindSun = settings.remind_sun;
 
-    view->RemindStarts = copy_string(settings.remind_starts);
-    view->RemindEnds = copy_string(settings.remind_ends);
+    view->RemindStarts = arena->String(settings.remind_starts);
+    view->RemindEnds = arena->String(settings.remind_ends);
 
     view->Pomodoro = settings.pomodoro;
     view->PomodoroMinutes = settings.pomodoro_minutes;
@@ -487,27 +413,22 @@ TogglSettingsView *settings_view_item_init(
     return view;
 }
 
-void settings_view_item_clear(TogglSettingsView *view) {
-    poco_check_ptr(view);
-
-    free(view->ProxyHost);
-    free(view->ProxyUsername);
-    free(view->ProxyPassword);
-
-    free(view->RemindStarts);
-    free(view->RemindEnds);
-
-    delete view;
-}
-
 TogglAutocompleteView *autocomplete_list_init(
-    std::vector<toggl::view::Autocomplete> *items) {
+    std::vector<toggl::view::Autocomplete> *items,
+    toggl::ViewArena *arena) {
+    for (std::vector<toggl::view::Autocomplete>::const_iterator it =
+        items->begin();
+            it != items->end();
+            ++it) {
+        reserve_autocomplete_view(*it, arena);
+    }
+
     TogglAutocompleteView *first = nullptr;
     for (std::vector<toggl::view::Autocomplete>::const_reverse_iterator it =
         items->rbegin();
             it != items->rend();
             ++it) {
-        TogglAutocompleteView *item = autocomplete_item_init(*it);
+        TogglAutocompleteView *item = autocomplete_item_init(*it, arena);
         item->Next = first;
         first = item;
     }
@@ -515,47 +436,35 @@ TogglAutocompleteView *autocomplete_list_init(
 }
 
 TogglHelpArticleView *help_article_init(
-    const toggl::HelpArticle &item) {
-    TogglHelpArticleView *result = new TogglHelpArticleView();
-    result->Category = copy_string(item.Type);
-    result->Name = copy_string(item.Name);
-    result->URL = copy_string(item.URL);
+    const toggl::HelpArticle &item,
+    toggl::ViewArena *arena) {
+    TogglHelpArticleView *result = arena->New<TogglHelpArticleView>();
+    result->Category = arena->String(item.Type);
+    result->Name = arena->String(item.Name);
+    result->URL = arena->String(item.URL);
     result->Next = nullptr;
     return result;
 }
 
-void help_article_item_clear(TogglHelpArticleView *view) {
-    if (!view) {
-        return;
+TogglHelpArticleView *help_article_list_init(
+    const std::vector<toggl::HelpArticle> &items,
+    toggl::ViewArena *arena) {
+    for (std::vector<toggl::HelpArticle>::const_iterator it =
+        items.begin();
+            it != items.end();
+            ++it) {
+        arena->Reserve<TogglHelpArticleView>();
+        arena->Reserve(it->Type);
+        arena->Reserve(it->Name);
+        arena->Reserve(it->URL);
     }
 
-    free(view->Category);
-    view->Category = nullptr;
-
-    free(view->Name);
-    view->Name = nullptr;
-
-    free(view->URL);
-    view->URL = nullptr;
-
-    delete view;
-}
-
-void help_article_list_clear(TogglHelpArticleView *first) {
-    while (first) {
-        TogglHelpArticleView *next = reinterpret_cast<TogglHelpArticleView *>(first->Next);
-        help_article_item_clear(first);
-        first = next;
-    }
-}
-
-TogglHelpArticleView *help_article_list_init(const std::vector<toggl::HelpArticle> &items) {
     TogglHelpArticleView *first = nullptr;
     for (std::vector<toggl::HelpArticle>::const_reverse_iterator it =
         items.rbegin();
             it != items.rend();
             ++it) {
-        TogglHelpArticleView *item = help_article_init(*it);
+        TogglHelpArticleView *item = help_article_init(*it, arena);
         item->Next = first;
         first = item;
     }
@@ -563,97 +472,37 @@ TogglHelpArticleView *help_article_list_init(const std::vector<toggl::HelpArticl
 }
 
 TogglTimelineChunkView *timeline_chunk_view_init(
-    const time_t &start) {
-    TogglTimelineChunkView *chunk_view = new TogglTimelineChunkView();
+    const time_t &start,
+    toggl::ViewArena *arena) {
+    TogglTimelineChunkView *chunk_view = arena->New<TogglTimelineChunkView>();
     chunk_view->Started = static_cast<unsigned int>(start);
-    chunk_view->StartTimeString = copy_string(
+    chunk_view->StartTimeString = arena->String(
         toggl::Formatter::FormatTimeForTimeEntryEditor(start));
     chunk_view->Next = nullptr;
     chunk_view->FirstEvent = nullptr;
     return chunk_view;
 }
 
-void timeline_chunk_view_list_clear(TogglTimelineChunkView *first) {
-    while (first) {
-        TogglTimelineChunkView *next = reinterpret_cast<TogglTimelineChunkView *>(first->Next);
-        timeline_chunk_view_clear(first);
-        first = next;
-    }
-}
-
-void timeline_chunk_view_clear(
-    TogglTimelineChunkView *chunk_view) {
-    if (!chunk_view) {
-        return;
-    }
-    if (chunk_view->StartTimeString) {
-        free(chunk_view->StartTimeString);
-        chunk_view->StartTimeString = nullptr;
-    }
-    if (chunk_view->EndTimeString) {
-        free(chunk_view->EndTimeString);
-        chunk_view->EndTimeString = nullptr;
-    }
-    if (chunk_view->FirstEvent) {
-        TogglTimelineEventView *firstEvent = reinterpret_cast<TogglTimelineEventView *>(chunk_view->FirstEvent);
-        timeline_event_view_list_clear(firstEvent);
-        chunk_view->FirstEvent = nullptr;
-    }
-    delete chunk_view;
-}
-
 TogglTimelineEventView *timeline_event_view_init(
-    const toggl::TimelineEvent *event) {
-    TogglTimelineEventView *event_view = new TogglTimelineEventView();
-    event_view->Title = copy_string(event->Title());
-    event_view->Filename = copy_string(event->Filename());
+    const toggl::TimelineEvent *event,
+    toggl::ViewArena *arena) {
+    TogglTimelineEventView *event_view = arena->New<TogglTimelineEventView>();
+    event_view->Title = arena->String(event->Title());
+    event_view->Filename = arena->String(event->Filename());
     event_view->Duration = event->EndTime() - event->Start();
-    event_view->DurationString = copy_string(toggl::Formatter::FormatDuration(event_view->Duration, toggl::Format::ImprovedOnlyMinAndSec));
+    event_view->DurationString = arena->String(toggl::Formatter::FormatDuration(event_view->Duration, toggl::Format::ImprovedOnlyMinAndSec));
     event_view->Header = false;
     event_view->Next = nullptr;
     return event_view;
 }
 
-void timeline_event_view_update_duration(TogglTimelineEventView *event_view, const int64_t duration) {
+void timeline_event_view_update_duration(
+    TogglTimelineEventView *event_view,
+    const int64_t duration,
+    toggl::ViewArena *arena) {
     event_view->Duration = duration;
-    if (event_view->DurationString) {
-        free(event_view->DurationString);
-        event_view->DurationString = nullptr;
-    }
-    event_view->DurationString = copy_string(toggl::Formatter::FormatDuration(duration, toggl::Format::ImprovedOnlyMinAndSec));
-}
-
-void timeline_event_view_list_clear(TogglTimelineEventView *first) {
-    while (first) {
-        TogglTimelineEventView *next = reinterpret_cast<TogglTimelineEventView *>(first->Next);
-        timeline_event_view_clear(first);
-        first = next;
-    }
-}
-
-void timeline_event_view_clear(
-    TogglTimelineEventView *event_view) {
-    if (!event_view) {
-        return;
-    }
-    if (event_view->Title) {
-        free(event_view->Title);
-        event_view->Title = nullptr;
-    }
-    if (event_view->Filename) {
-        free(event_view->Filename);
-        event_view->Filename = nullptr;
-    }
-    if (event_view->DurationString) {
-        free(event_view->DurationString);
-        event_view->DurationString = nullptr;
-    }
-    if (event_view->Event) {
-        TogglTimelineEventView *event = reinterpret_cast<TogglTimelineEventView *>(event_view->Event);
-        timeline_event_view_list_clear(event);
-        event_view->Event = nullptr;
-    }
-    delete event_view;
+    // The previous string stays in the arena until the timeline is rendered
+    event_view->DurationString = arena->String(toggl::Formatter::FormatDuration(duration, toggl::Format::ImprovedOnlyMinAndSec));
 }
 
 toggl::Context *app(void *context) {
@@ -12,6 +12,7 @@
 #include "model/settings.h"
 #include "toggl_api.h"
 #include "util/logger.h"
+#include "view_arena.h"
 
 namespace toggl {
 class Client;
@@ -23,12 +24,18 @@ class AutotrackerRule;
 class Generic;
 class HelpArticle;
 class TimeEntry;
+class TimeEntryListChange;
 }
 }  // namespace toggl
 
 TOGGL_INTERNAL_EXPORT int compare_string(const char_t *s1, const char_t *s2);
 TOGGL_INTERNAL_EXPORT const char_t* to_char_t(const std::string &s);
 TOGGL_INTERNAL_EXPORT char_t *copy_string(const std::string &s);
+// Number of strings copy_string has allocated for the UI so far
+TOGGL_INTERNAL_EXPORT uint64_t copied_string_count();
+// Number of allocations made for the UI so far, copied strings
+// and view arena blocks
+TOGGL_INTERNAL_EXPORT uint64_t view_allocation_count();
 TOGGL_INTERNAL_EXPORT std::string to_string(const char_t *s);
 
 /**
@@ -42,84 +49,75 @@ TOGGL_INTERNAL_EXPORT std::string to_string(const char_t *s);
  */
 std::string trim_whitespace(const std::string &str);
 
+// The views below are made in the arena, they are released together
+// with it once the UI callback has returned
+
 TogglGenericView *generic_to_view_item(
-    const toggl::view::Generic &c);
+    const toggl::view::Generic &c,
+    toggl::ViewArena *arena);
 
 TogglGenericView *generic_to_view_item_list(
-    const std::vector<toggl::view::Generic> &list);
+    const std::vector<toggl::view::Generic> &list,
+    toggl::ViewArena *arena);
 
 TogglAutotrackerRuleView *autotracker_rule_to_view_item(
-    const toggl::view::AutotrackerRule &model);
-
-void autotracker_view_item_clear(TogglAutotrackerRuleView *view);
-
-void autotracker_view_list_clear(TogglAutotrackerRuleView *first);
+    const toggl::view::AutotrackerRule &model,
+    toggl::ViewArena *arena);
 
 TogglAutocompleteView *autocomplete_item_init(
-    const toggl::view::Autocomplete &item);
-
-void view_item_clear(TogglGenericView *item);
-
-void view_list_clear(TogglGenericView *first);
+    const toggl::view::Autocomplete &item,
+    toggl::ViewArena *arena);
 
-void autocomplete_item_clear(TogglAutocompleteView *item);
-
-void autocomplete_list_clear(TogglAutocompleteView *first);
+TogglAutocompleteView *autocomplete_list_init(
+    std::vector<toggl::view::Autocomplete> *items,
+    toggl::ViewArena *arena);
 
 TogglCountryView *country_list_init(
-    std::vector<TogglCountryView> *items);
-
-void country_item_clear(TogglCountryView *item);
-
-void country_list_clear(TogglCountryView *first);
-
-void country_list_delete_item(TogglCountryView *first);
+    std::vector<TogglCountryView> *items,
+    toggl::ViewArena *arena);
 
-TogglCountryView *country_view_item_init(
-    const Json::Value v);
+TogglCountryView country_view_item_init(
+    const Json::Value v,
+    toggl::ViewArena *arena);
 
 TogglTimeEntryView *time_entry_view_item_init(
-    const toggl::view::TimeEntry &te);
+    const toggl::view::TimeEntry &te,
+    toggl::ViewArena *arena);
 
-void time_entry_view_item_clear(TogglTimeEntryView *item);
+// Rows begin to end, reserved up front so they take one allocation
+TogglTimeEntryView *time_entry_view_list_init(
+    const std::vector<toggl::view::TimeEntry> &rows,
+    const std::size_t begin,
+    const std::size_t end,
+    toggl::ViewArena *arena);
 
-void time_entry_view_list_clear(TogglTimeEntryView *first);
+TogglTimeEntryListChangeView *time_entry_list_change_view_list_init(
+    const std::vector<toggl::view::TimeEntryListChange> &changes,
+    toggl::ViewArena *arena);
 
 TogglSettingsView *settings_view_item_init(
     const bool_t record_timeline,
     const toggl::Settings &settings,
     const bool_t use_proxy,
-    const toggl::Proxy &proxy);
-
-void settings_view_item_clear(TogglSettingsView *view);
-
-TogglAutocompleteView *autocomplete_list_init(
-    std::vector<toggl::view::Autocomplete> *items);
+    const toggl::Proxy &proxy,
+    toggl::ViewArena *arena);
 
 TogglHelpArticleView *help_article_list_init(
-    const std::vector<toggl::HelpArticle> &items);
-
-void help_article_item_clear(TogglHelpArticleView *view);
-
-void help_article_list_clear(TogglHelpArticleView *first);
+    const std::vector<toggl::HelpArticle> &items,
+    toggl::ViewArena *arena);
 
 TogglTimelineChunkView *timeline_chunk_view_init(
-    const time_t &start);
-
-void timeline_chunk_view_clear(
-    TogglTimelineChunkView *first);
+    const time_t &start,
+    toggl::ViewArena *arena);
 
 TogglTimelineEventView *timeline_event_view_init(
-    const toggl::TimelineEvent *event);
-
-void timeline_chunk_view_list_clear(TogglTimelineChunkView *first);
-
-void timeline_event_view_update_duration(TogglTimelineEventView *event_view, const int64_t duration);
-
-void timeline_event_view_clear(
-    TogglTimelineEventView *event_view);
+    const toggl::TimelineEvent *event,
+    toggl::ViewArena *arena);
 
-void timeline_event_view_list_clear(TogglTimelineEventView *first);
+void timeline_event_view_update_duration(
+    TogglTimelineEventView *event_view,
+    const int64_t duration,
+    toggl::ViewArena *arena);
 
 toggl::Logger logger();
 
@@ -0,0 +1,203 @@
+// Copyright 2014 Toggl Desktop developers.
+
+#include "ui_elements.h"
+
+#include <sstream>
+
+#include "const.h"
+
+namespace toggl {
+
+UIElements UIElements::Reset() {
+    UIElements render;
+    render.first_load = true;
+    render.display_time_entries = true;
+    render.display_time_entry_autocomplete = true;
+    render.display_mini_timer_autocomplete = true;
+    render.display_project_autocomplete = true;
+    render.display_client_select = true;
+    render.display_workspace_select = true;
+    render.display_timer_state = true;
+    render.display_time_entry_editor = true;
+    render.display_autotracker_rules = true;
+    render.display_settings = true;
+    render.display_unsynced_items = true;
+
+    render.open_time_entry_list = true;
+    render.display_timeline = true;
+
+    return render;
+}
+
+std::string UIElements::String() const {
+    std::stringstream ss;
+    if (display_time_entries) {
+        ss << "display_time_entries ";
+    }
+    if (display_time_entry_list_window) {
+        ss << "display_time_entry_list_window ";
+    }
+    if (display_time_entry_autocomplete) {
+        ss << "display_time_entry_autocomplete ";
+    }
+    if (display_mini_timer_autocomplete) {
+        ss << "display_mini_timer_autocomplete ";
+    }
+    if (display_project_autocomplete) {
+        ss << "display_project_autocomplete ";
+    }
+    if (display_client_select) {
+        ss << "display_client_select ";
+    }
+    if (display_client_select) {
+        ss << "display_client_select ";
+    }
+    if (display_workspace_select) {
+        ss << "display_workspace_select ";
+    }
+    if (display_timer_state) {
+        ss << "display_timer_state ";
+    }
+    if (display_time_entry_editor) {
+        ss << "display_time_entry_editor ";
+    }
+    if (open_settings) {
+        ss << "open_settings ";
+    }
+    if (open_time_entry_list) {
+        ss << "open_time_entry_list ";
+    }
+    if (open_time_entry_editor) {
+        ss << "open_time_entry_editor ";
+    }
+    if (display_autotracker_rules) {
+        ss << "display_autotracker_rules ";
+    }
+    if (display_settings) {
+        ss << "display_settings ";
+    }
+    if (!time_entry_editor_guid.empty()) {
+        ss << "time_entry_editor_guid=" << time_entry_editor_guid << " ";
+    }
+    if (!time_entry_editor_field.empty()) {
+        ss << "time_entry_editor_field=" << time_entry_editor_field << " ";
+    }
+    if (display_unsynced_items) {
+        ss << "display_unsynced_items ";
+    }
+    if (display_timeline) {
+        ss << " display_timeline=" << display_timeline;
+    }
+    if (open_timeline) {
+        ss << " open_timeline=" << open_timeline;
+    }
+    return ss.str();
+}
+
+void UIElements::ApplyChanges(
+    const std::string &editor_guid,
+    const std::vector<ModelChange> &changes) {
+
+    time_entry_editor_guid = editor_guid;
+
+    // Check what needs to be updated in UI
+    for (std::vector<ModelChange>::const_iterator it =
+        changes.begin();
+            it != changes.end();
+            ++it) {
+        ModelChange ch = *it;
+
+        if (ch.ModelType() == kModelWorkspace
+                || ch.ModelType() == kModelClient
+                || ch.ModelType() == kModelProject
+                || ch.ModelType() == kModelTask
+                || ch.ModelType() == kModelTimeEntry) {
+            display_time_entry_autocomplete = true;
+            display_time_entries = true;
+            display_mini_timer_autocomplete = true;
+        }
+
+        if (ch.ModelType() == kModelWorkspace
+                || ch.ModelType() == kModelClient
+                || ch.ModelType() == kModelProject
+                || ch.ModelType() == kModelTask) {
+            display_project_autocomplete = true;
+        }
+
+        if (ch.ModelType() == kModelClient
+                || ch.ModelType() == kModelWorkspace) {
+            display_client_select = true;
+        }
+
+        // Check if time entry editor needs to be updated
+        if (ch.ModelType() == kModelTimeEntry) {
+            display_timer_state = true;
+            // If time entry was edited, check further
+            if (time_entry_editor_guid == ch.GUID()) {
+                // If time entry was deleted, close editor
+                // and open list view
+                if (ch.ChangeType() == kChangeTypeDelete) {
+                    open_time_entry_list = true;
+                    display_time_entries = true;
+                } else {
+                    display_time_entry_editor = true;
+                }
+            }
+        }
+
+        if (ch.ModelType() == kModelAutotrackerRule) {
+            display_autotracker_rules = true;
+        }
+
+        if (ch.ModelType() == kModelSettings) {
+            display_settings = true;
+        }
+
+        if (ch.ModelType() == kModelTimelineEvent && ch.ChangeType() == kChangeTypeInsert) {
+            display_timeline = true;
+        }
+    }
+}
+
+void UIElements::Merge(const UIElements &later) {
+    first_load = first_load || later.first_load;
+    display_time_entries =
+        display_time_entries || later.display_time_entries;
+    display_time_entry_list_window =
+        display_time_entry_list_window || later.display_time_entry_list_window;
+    display_time_entry_autocomplete =
+        display_time_entry_autocomplete || later.display_time_entry_autocomplete;
+    display_mini_timer_autocomplete =
+        display_mini_timer_autocomplete || later.display_mini_timer_autocomplete;
+    display_project_autocomplete =
+        display_project_autocomplete || later.display_project_autocomplete;
+    display_client_select =
+        display_client_select || later.display_client_select;
+    display_workspace_select =
+        display_workspace_select || later.display_workspace_select;
+    display_timer_state = display_timer_state || later.display_timer_state;
+    display_time_entry_editor =
+        display_time_entry_editor || later.display_time_entry_editor;
+    display_autotracker_rules =
+        display_autotracker_rules || later.display_autotracker_rules;
+    display_settings = display_settings || later.display_settings;
+    display_unsynced_items =
+        display_unsynced_items || later.display_unsynced_items;
+    display_timeline = display_timeline || later.display_timeline;
+
+    open_settings = open_settings || later.open_settings;
+    if (later.open_time_entry_list
+            || later.open_time_entry_editor
+            || later.open_timeline) {
+        open_time_entry_list = later.open_time_entry_list;
+        open_time_entry_editor = later.open_time_entry_editor;
+        open_timeline = later.open_timeline;
+    }
+
+    if (!later.time_entry_editor_guid.empty()) {
+        time_entry_editor_guid = later.time_entry_editor_guid;
+        time_entry_editor_field = later.time_entry_editor_field;
+    }
+}
+
+}  // namespace toggl
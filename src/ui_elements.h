@@ -0,0 +1,76 @@
+// Copyright 2014 Toggl Desktop developers.
+
+#ifndef SRC_UI_ELEMENTS_H_
+#define SRC_UI_ELEMENTS_H_
+
+#include <string>
+#include <vector>
+
+#include "model_change.h"
+#include "types.h"
+
+namespace toggl {
+
+// What the UI has to render
+class TOGGL_INTERNAL_EXPORT UIElements {
+ public:
+    UIElements()
+        : first_load(false)
+    , display_time_entries(false)
+    , display_time_entry_list_window(false)
+    , display_time_entry_autocomplete(false)
+    , display_mini_timer_autocomplete(false)
+    , display_project_autocomplete(false)
+    , display_client_select(false)
+    , display_workspace_select(false)
+    , display_timer_state(false)
+    , display_time_entry_editor(false)
+    , open_settings(false)
+    , open_time_entry_list(false)
+    , open_time_entry_editor(false)
+    , display_autotracker_rules(false)
+    , display_settings(false)
+    , time_entry_editor_guid("")
+    , time_entry_editor_field("")
+    , display_unsynced_items(false)
+    , display_timeline(false)
+    , open_timeline(false) {}
+
+    static UIElements Reset();
+
+    std::string String() const;
+
+    void ApplyChanges(
+        const std::string &editor_guid,
+        const std::vector<ModelChange> &changes);
+
+    // Adds what a later request asks for. Of the views sharing the
+    // main window, the one opened last wins.
+    void Merge(const UIElements &later);
+
+    bool first_load;
+    bool display_time_entries;
+    // Only the window of the list rendered last, after scrolling
+    bool display_time_entry_list_window;
+    bool display_time_entry_autocomplete;
+    bool display_mini_timer_autocomplete;
+    bool display_project_autocomplete;
+    bool display_client_select;
+    bool display_workspace_select;
+    bool display_timer_state;
+    bool display_time_entry_editor;
+    bool open_settings;
+    bool open_time_entry_list;
+    bool open_time_entry_editor;
+    bool display_autotracker_rules;
+    bool display_settings;
+    std::string time_entry_editor_guid;
+    std::string time_entry_editor_field;
+    bool display_unsynced_items;
+    bool display_timeline;
+    bool open_timeline;
+};
+
+}  // namespace toggl
+
+#endif  // SRC_UI_ELEMENTS_H_
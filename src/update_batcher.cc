@@ -0,0 +1,69 @@
+// Copyright 2020 Toggl Desktop developers.
+
+#include "update_batcher.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <Poco/Bugcheck.h>
+
+namespace toggl {
+
+const std::size_t UpdateBatcher::kDefaultMaxBatchSize = 500;
+
+std::size_t UpdateBatcher::Add(
+    const Json::Value &update,
+    const Poco::UInt64 user_id) {
+    Poco::Mutex::ScopedLock lock(mutex_);
+
+    if (user_id != user_id_) {
+        stats_.Dropped += pending_.size();
+        pending_.clear();
+        user_id_ = user_id;
+    }
+
+    if (pending_.empty()) {
+        oldest_at_.update();
+    }
+    pending_.push_back(update);
+
+    return pending_.size();
+}
+
+std::vector<Json::Value> UpdateBatcher::Take(Poco::UInt64 *user_id) {
+    poco_check_ptr(user_id);
+
+    std::vector<Json::Value> batch;
+
+    Poco::Mutex::ScopedLock lock(mutex_);
+
+    *user_id = user_id_;
+
+    if (pending_.empty()) {
+        return batch;
+    }
+
+    batch.swap(pending_);
+
+    stats_.Batches++;
+    stats_.Updates += batch.size();
+    stats_.LastBatch = batch.size();
+    stats_.LargestBatch = std::max(stats_.LargestBatch, stats_.LastBatch);
+    stats_.LastBatchLatencyMicros = oldest_at_.elapsed();
+
+    return batch;
+}
+
+void UpdateBatcher::Clear() {
+    Poco::Mutex::ScopedLock lock(mutex_);
+    stats_.Dropped += pending_.size();
+    pending_.clear();
+    user_id_ = 0;
+}
+
+UpdateBatchStats UpdateBatcher::Stats() {
+    Poco::Mutex::ScopedLock lock(mutex_);
+    return stats_;
+}
+
+}  // namespace toggl
@@ -0,0 +1,82 @@
+// Copyright 2020 Toggl Desktop developers.
+
+#ifndef SRC_UPDATE_BATCHER_H_
+#define SRC_UPDATE_BATCHER_H_
+
+#include <vector>
+
+#include <json/json.h>  // NOLINT
+
+#include "types.h"
+
+#include <Poco/Mutex.h>
+#include <Poco/Timestamp.h>
+
+namespace toggl {
+
+class TOGGL_INTERNAL_EXPORT UpdateBatchStats {
+ public:
+    UpdateBatchStats()
+        : Batches(0)
+    , Updates(0)
+    , Dropped(0)
+    , LargestBatch(0)
+    , LastBatch(0)
+    , LastBatchLatencyMicros(0) {}
+
+    // Number of batches taken so far
+    Poco::UInt64 Batches;
+    // Number of updates in all of them
+    Poco::UInt64 Updates;
+    // Updates thrown away because the user changed before they were applied
+    Poco::UInt64 Dropped;
+    Poco::UInt64 LargestBatch;
+    Poco::UInt64 LastBatch;
+    // Time the oldest update of the last batch spent waiting
+    Poco::Timestamp::TimeDiff LastBatchLatencyMicros;
+};
+
+// Gathers model updates coming in from the websocket, so a burst
+// of them can be applied and saved together. A batch belongs to
+// the user the updates were received for.
+class TOGGL_INTERNAL_EXPORT UpdateBatcher {
+ public:
+    explicit UpdateBatcher(const std::size_t max_batch_size = kDefaultMaxBatchSize)
+        : max_batch_size_(max_batch_size)
+    , user_id_(0) {}
+    ~UpdateBatcher() {}
+
+    // Queues the update, returns the number of updates now waiting.
+    // One means a new batch was started, reaching MaxBatchSize() means
+    // the batch should be applied without waiting any longer.
+    // Updates still waiting for another user are dropped.
+    std::size_t Add(const Json::Value &update, const Poco::UInt64 user_id);
+
+    // Hands over everything queued so far, oldest first,
+    // and the user they were received for
+    std::vector<Json::Value> Take(Poco::UInt64 *user_id);
+
+    // Drops the updates waiting, when the user logs out or changes
+    void Clear();
+
+    UpdateBatchStats Stats();
+
+    std::size_t MaxBatchSize() const {
+        return max_batch_size_;
+    }
+
+    static const std::size_t kDefaultMaxBatchSize;
+
+ private:
+    const std::size_t max_batch_size_;
+
+    Poco::Mutex mutex_;
+    std::vector<Json::Value> pending_;
+    Poco::UInt64 user_id_;
+    Poco::Timestamp oldest_at_;
+    UpdateBatchStats stats_;
+};
+
+}  // namespace toggl
+
+#endif  // SRC_UPDATE_BATCHER_H_
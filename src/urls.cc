@@ -20,6 +20,12 @@ static bool im_a_teapot_ = false;
 // Whether requests are allowed at all (like in tests)
 static bool requests_allowed_ = true;
 
+// Websocket server to use instead of the default one
+static std::string websocket_url_("");
+
+// Backend to use instead of the default ones
+static std::string backend_url_("");
+
 void SetUseStagingAsBackend(const bool value) {
     use_staging_as_backend = value;
 }
@@ -36,6 +42,9 @@ std::string Main() {
 }
 
 std::string API() {
+    if (!backend_url_.empty()) {
+        return backend_url_;
+    }
     if (use_staging_as_backend) {
         return "https://desktop.track.toggl.space";
     }
@@ -43,6 +52,9 @@ std::string API() {
 }
 
 std::string SyncAPI() {
+    if (!backend_url_.empty()) {
+        return backend_url_;
+    }
     if (use_staging_as_backend) {
         return "https://sync.toggl.space/";
     }
@@ -50,6 +62,9 @@ std::string SyncAPI() {
 }
 
 std::string TimelineUpload() {
+    if (!backend_url_.empty()) {
+        return backend_url_;
+    }
     if (use_staging_as_backend) {
         return "https://desktop.track.toggl.space";
     }
@@ -57,12 +72,23 @@ std::string TimelineUpload() {
 }
 
 std::string WebSocket() {
+    if (!websocket_url_.empty()) {
+        return websocket_url_;
+    }
     if (use_staging_as_backend) {
         return "https://desktop.track.toggl.space";
     }
     return "https://desktop.track.toggl.com";
 }
 
+void SetWebSocket(const std::string &url) {
+    websocket_url_ = url;
+}
+
+void SetBackend(const std::string &url) {
+    backend_url_ = url;
+}
+
 bool ImATeapot() {
     return im_a_teapot_;
 }
@@ -15,6 +15,13 @@ std::string SyncAPI();
 std::string TimelineUpload();
 std::string WebSocket();
 
+// Points the websocket client elsewhere, empty restores the default
+void SetWebSocket(const std::string &url);
+
+// Points the REST, sync and timeline requests elsewhere (like a local
+// stub server), empty restores the default
+void SetBackend(const std::string &url);
+
 void SetUseStagingAsBackend(const bool value);
 
 bool IsUsingStagingAsBackend();
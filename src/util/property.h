@@ -39,25 +39,30 @@ public:
         previous_ = current_;
     }
     /* Setters */
+    // A dirty change keeps the last synced value in previous_, so it can serve
+    // as the common base when merging with the server (see Merge below)
     bool Set(const T& value, bool makeDirty = true) {
         if (value == current_) {
-            previous_ = value;
+            if (!makeDirty)
+                previous_ = value;
             return false;
         }
-        if (makeDirty)
-            previous_ = std::move(current_);
-        else
+        if (!makeDirty)
             previous_ = value;
+        else if (!IsDirty())
+            previous_ = std::move(current_);
         current_ = value;
         return true;
     }
     bool Set(const T&& value, bool makeDirty = true) {
         if (value == current_) {
-            previous_ = std::move(value);
+            if (!makeDirty)
+                previous_ = std::move(value);
             return false;
         }
         if (makeDirty) {
-            previous_ = std::move(current_);
+            if (!IsDirty())
+                previous_ = std::move(current_);
             current_ = std::move(value);
         }
         else {
@@ -66,6 +71,25 @@ public:
         }
         return true;
     }
+    /* Three-way merge */
+    // Merges a value received from the server, previous_ being the base both sides last agreed on:
+    //   - the server still has the base value: the local edit (if any) stays
+    //   - there's no local edit, or both sides made the same one: the server value is taken
+    //   - both sides changed it differently: the server value wins only when preferRemote is set,
+    //     otherwise the local edit stays dirty on top of the new base and gets pushed
+    // Returns true if the current value changed.
+    bool Merge(const T& remote, bool preferRemote) {
+        if (remote == previous_)
+            return false;
+        if (!IsDirty() || current_ == remote || preferRemote) {
+            bool changed = current_ != remote;
+            current_ = remote;
+            previous_ = remote;
+            return changed;
+        }
+        previous_ = remote;
+        return false;
+    }
     /* Setters for current values only (previous value stays) */
     void SetCurrent(const T& current) {
         current_ = current;
@@ -0,0 +1,53 @@
+// Copyright 2020 Toggl Desktop developers.
+
+#include "util/thread_name.h"
+
+#include "const.h"
+
+#if defined(__linux__)
+#include <sys/prctl.h>
+#elif defined(__APPLE__)
+#include <pthread.h>
+#endif
+
+namespace toggl {
+
+namespace {
+
+std::string currentName() {
+#if defined(__linux__)
+    char name[16] = { 0 };
+    if (0 == prctl(PR_GET_NAME, name, 0, 0, 0)) {
+        return name;
+    }
+#elif defined(__APPLE__)
+    char name[64] = { 0 };
+    if (0 == pthread_getname_np(pthread_self(), name, sizeof(name))) {
+        return name;
+    }
+#endif
+    return "";
+}
+
+void setCurrentName(const std::string &name) {
+#if defined(__linux__)
+    prctl(PR_SET_NAME, name.substr(0, 15).c_str(), 0, 0, 0);
+#elif defined(__APPLE__)
+    pthread_setname_np(name.c_str());
+#else
+    (void) name;
+#endif
+}
+
+}  // namespace
+
+ScopedThreadName::ScopedThreadName(const std::string &name)
+    : previous_(currentName()) {
+    setCurrentName(kThreadNamePrefix + name);
+}
+
+ScopedThreadName::~ScopedThreadName() {
+    setCurrentName(previous_);
+}
+
+}  // namespace toggl
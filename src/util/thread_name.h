@@ -0,0 +1,35 @@
+// Copyright 2020 Toggl Desktop developers.
+
+#ifndef SRC_UTIL_THREAD_NAME_H_
+#define SRC_UTIL_THREAD_NAME_H_
+
+#include <string>
+
+#include "types.h"
+
+namespace toggl {
+
+/*
+ * Names the calling thread kThreadNamePrefix and the name while in
+ * scope, then gives it its previous name back. Threads of the
+ * Poco::ThreadPool run other work later. The prefix tells the threads
+ * of the library apart from those of the app in debuggers, top and
+ * /proc/<pid>/task. Linux keeps 15 characters of the name.
+ *
+ * Only Linux and macOS name threads, elsewhere this does nothing.
+ */
+class TOGGL_INTERNAL_EXPORT ScopedThreadName {
+ public:
+    explicit ScopedThreadName(const std::string &name);
+    ~ScopedThreadName();
+
+ private:
+    ScopedThreadName(const ScopedThreadName &);
+    ScopedThreadName &operator=(const ScopedThreadName &);
+
+    std::string previous_;
+};
+
+}  // namespace toggl
+
+#endif  // SRC_UTIL_THREAD_NAME_H_
@@ -0,0 +1,94 @@
+// Copyright 2020 Toggl Desktop developers.
+
+#include "view_arena.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+#include "const.h"
+
+#include <Poco/Bugcheck.h>
+#include <Poco/UnicodeConverter.h>
+
+namespace toggl {
+
+namespace {
+
+std::atomic<uint64_t> allocated_blocks(0);
+
+}  // namespace
+
+ViewArena::ViewArena()
+    : first_(nullptr)
+, next_(nullptr)
+, end_(nullptr)
+, reserved_(0)
+, grow_(kViewArenaBlockBytes)
+, blocks_(0) {}
+
+ViewArena::~ViewArena() {
+    while (first_) {
+        Block *next = first_->Next;
+        free(first_);
+        first_ = next;
+    }
+}
+
+uint64_t ViewArena::AllocatedBlocks() {
+    return allocated_blocks.load(std::memory_order_relaxed);
+}
+
+std::size_t ViewArena::aligned(const std::size_t size) {
+    const std::size_t alignment = alignof(std::max_align_t);
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+void ViewArena::Reserve(const std::string &s) {
+    // A UTF-16 string never has more units than its UTF-8 bytes
+    reserved_ += aligned((s.size() + 1) * sizeof(char_t));
+}
+
+char_t *ViewArena::String(const std::string &s) {
+#if defined(_WIN32) || defined(WIN32)
+    std::wstring ws;
+    Poco::UnicodeConverter::toUTF16(s, ws);
+    char_t *result = static_cast<char_t *>(
+        allocate((ws.size() + 1) * sizeof(char_t)));
+    memcpy(result, ws.c_str(), (ws.size() + 1) * sizeof(char_t));
+#else
+    char_t *result = static_cast<char_t *>(allocate(s.size() + 1));
+    memcpy(result, s.c_str(), s.size() + 1);
+#endif
+    return result;
+}
+
+void *ViewArena::allocate(const std::size_t size) {
+    const std::size_t needed = aligned(size);
+    if (static_cast<std::size_t>(end_ - next_) < needed) {
+        std::size_t capacity = std::max(needed, reserved_);
+        if (!reserved_) {
+            capacity = std::max(capacity, grow_);
+            grow_ *= 2;
+        }
+        reserved_ = 0;
+
+        const std::size_t header = aligned(sizeof(Block));
+        Block *block = static_cast<Block *>(malloc(header + capacity));
+        poco_check_ptr(block);
+        block->Next = first_;
+        first_ = block;
+        blocks_++;
+        allocated_blocks.fetch_add(1, std::memory_order_relaxed);
+
+        next_ = reinterpret_cast<char *>(block) + header;
+        end_ = next_ + capacity;
+    }
+
+    void *result = next_;
+    next_ += needed;
+    return result;
+}
+
+}  // namespace toggl
@@ -0,0 +1,79 @@
+// Copyright 2020 Toggl Desktop developers.
+
+#ifndef SRC_VIEW_ARENA_H_
+#define SRC_VIEW_ARENA_H_
+
+#include <cstddef>
+#include <new>
+#include <string>
+
+#include "toggl_api.h"
+#include "types.h"
+
+namespace toggl {
+
+/*
+ * Memory for the views of one UI callback.
+ *
+ * The UI only reads the views while the callback runs, so the structs
+ * and their strings are packed together and released all at once when
+ * the arena goes out of scope, instead of one allocation per string.
+ *
+ * Whatever is reserved before the first allocation fits into the first
+ * block, so a list reserved up front takes a single allocation. Without
+ * (enough of) a reservation the arena grows by blocks of doubling size.
+ */
+class TOGGL_INTERNAL_EXPORT ViewArena {
+ public:
+    ViewArena();
+    ~ViewArena();
+
+    // Room for a view made later
+    template <typename T>
+    void Reserve() {
+        reserved_ += aligned(sizeof(T));
+    }
+
+    // Room for a string made later
+    void Reserve(const std::string &s);
+
+    // Zeroed view, valid until the arena is destroyed
+    template <typename T>
+    T *New() {
+        return new (allocate(sizeof(T))) T();
+    }
+
+    // The string converted for the UI, valid until the arena is destroyed
+    char_t *String(const std::string &s);
+
+    // Blocks allocated by this arena
+    std::size_t Blocks() const {
+        return blocks_;
+    }
+
+    // Blocks allocated by all arenas so far
+    static uint64_t AllocatedBlocks();
+
+ private:
+    ViewArena(const ViewArena &);
+    ViewArena &operator=(const ViewArena &);
+
+    struct Block {
+        Block *Next;
+    };
+
+    static std::size_t aligned(const std::size_t size);
+
+    void *allocate(const std::size_t size);
+
+    Block *first_;
+    char *next_;
+    char *end_;
+    std::size_t reserved_;
+    std::size_t grow_;
+    std::size_t blocks_;
+};
+
+}  // namespace toggl
+
+#endif  // SRC_VIEW_ARENA_H_
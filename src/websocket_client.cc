@@ -25,6 +25,7 @@
 #include "https_client.h"
 #include "netconf.h"
 #include "util/random.h"
+#include "util/thread_name.h"
 #include "urls.h"
 
 namespace toggl {
@@ -52,6 +53,7 @@ void WebSocketClient::Start(
         return;
     }
 
+    stop_requested_.reset();
     activity_.start();
 
     ctx_ = ctx;
@@ -66,6 +68,8 @@ void WebSocketClient::Shutdown() {
         return;
     }
     activity_.stop();  // request stop
+    stop_requested_.set();
+    wakeUp();
     activity_.wait();  // wait until activity actually stops
 
     deleteSession();
@@ -128,7 +132,6 @@ error WebSocketClient::createSession() {
         req_->set("User-Agent", HTTPClient::Config.UserAgent());
         res_ = new Poco::Net::HTTPResponse();
         ws_ = new Poco::Net::WebSocket(*session_, *req_, *res_);
-        ws_->setBlocking(false);
         ws_->setReceiveTimeout(Poco::Timespan(3 * Poco::Timespan::SECONDS));
         ws_->setSendTimeout(Poco::Timespan(3 * Poco::Timespan::SECONDS));
 
@@ -159,85 +162,104 @@ void WebSocketClient::authenticate() {
                    Poco::Net::WebSocket::FRAME_BINARY);
 }
 
-std::string WebSocketClient::parseWebSocketMessageType(
-    const std::string &json) {
+error WebSocketClient::receiveFrame(bool *complete) {
+    *complete = false;
 
-    if (json.empty()) {
-        return "";
+    // Control frames may arrive in between the fragments of a message,
+    // so remember where the message ended before this frame
+    std::size_t message_size = frame_buffer_.size();
+
+    int flags = 0;
+    int n = ws_->receiveFrame(frame_buffer_, flags);
+    if (n <= 0 && !flags) {
+        return error("WebSocket closed the connection");
     }
 
-    Json::Value root;
-    Json::Reader reader;
-    if (!reader.parse(json, root)) {
-        return "";
+    switch (flags & Poco::Net::WebSocket::FRAME_OP_BITMASK) {
+    case Poco::Net::WebSocket::FRAME_OP_CLOSE:
+        return error("WebSocket closed the connection");
+    case Poco::Net::WebSocket::FRAME_OP_PING:
+        ws_->sendFrame(frame_buffer_.begin() + message_size,
+                       static_cast<int>(frame_buffer_.size() - message_size),
+                       Poco::Net::WebSocket::FRAME_FLAG_FIN
+                       | Poco::Net::WebSocket::FRAME_OP_PONG);
+        frame_buffer_.resize(message_size);
+        return noError;
+    case Poco::Net::WebSocket::FRAME_OP_PONG:
+        frame_buffer_.resize(message_size);
+        return noError;
     }
 
-    if (root.isMember("type")) {
-        return root["type"].asString();
+    if (frame_buffer_.size() > kWebsocketMaxMessageBytes) {
+        return error("WebSocket message is too large");
     }
 
-    return "data";
+    *complete = (flags & Poco::Net::WebSocket::FRAME_FLAG_FIN) != 0;
+    return noError;
 }
 
-const int kWebsocketBufSize = 1024 * 10;
+const std::string kPong("{\"type\": \"pong\"}");
 
-error WebSocketClient::receiveWebSocketMessage(std::string *message) {
-    int flags = Poco::Net::WebSocket::FRAME_BINARY;
-    std::string json("");
-    try {
-        char buf[kWebsocketBufSize];
-        int n = ws_->receiveFrame(buf, kWebsocketBufSize, flags);
-        if (n > 0) {
-            json.append(buf, static_cast<unsigned>(n));
+error WebSocketClient::handleMessage() {
+    if (frame_buffer_.empty()) {
+        return noError;
+    }
+
+    const char *begin = frame_buffer_.begin();
+    const char *end = begin + frame_buffer_.size();
+
+    logger().trace("WebSocket message: ", std::string(begin, end));
+
+    // The message is parsed here once and handed over as is
+    Json::Value root;
+    if (!reader_.parse(begin, end, root, false)) {
+        return noError;
+    }
+
+    if (root.isMember("type")) {
+        if ("ping" == root["type"].asString()) {
+            ws_->sendFrame(kPong.data(),
+                           static_cast<int>(kPong.size()),
+                           Poco::Net::WebSocket::FRAME_BINARY);
         }
-    } catch(const Poco::Exception& exc) {
-        return error(exc.displayText());
-    } catch(const std::exception& ex) {
-        return error(ex.what());
-    } catch(const std::string & ex) {
-        return error(ex);
+        return noError;
     }
-    *message = json;
+
+    if (activity_.isStopped()) {
+        return noError;
+    }
+
+    on_websocket_message_(ctx_, root);
+
     return noError;
 }
 
-const std::string kPong("{\"type\": \"pong\"}");
-
-error WebSocketClient::poll() {
+error WebSocketClient::poll(const Poco::Timespan &timeout) {
     try {
-        Poco::Timespan span(250 * Poco::Timespan::MILLISECONDS);
-        if (!ws_->poll(span, Poco::Net::Socket::SELECT_READ)) {
+        // Sleeps until the server sends something, the connection
+        // needs a restart or wakeUp() is called
+        // TLS and the handshake may have buffered data the socket
+        // itself will not report as readable anymore
+        if (ws_->available() <= 0
+                && !ws_->poll(timeout, Poco::Net::Socket::SELECT_READ)) {
             return noError;
         }
 
-        std::string json("");
-        error err = receiveWebSocketMessage(&json);
+        bool complete(false);
+        error err = receiveFrame(&complete);
         if (err != noError) {
             return err;
         }
-        if (json.empty()) {
-            return error("WebSocket closed the connection");
-        }
-        logger().trace("WebSocket message: ", json);
 
         last_connection_at_ = time(nullptr);
 
-        std::string type = parseWebSocketMessageType(json);
-
-        if (activity_.isStopped()) {
+        if (!complete) {
             return noError;
         }
 
-        if ("ping" == type) {
-            ws_->sendFrame(kPong.data(),
-                           static_cast<int>(kPong.size()),
-                           Poco::Net::WebSocket::FRAME_BINARY);
-            return noError;
-        }
-
-        if ("data" == type) {
-            on_websocket_message_(ctx_, json);
-        }
+        err = handleMessage();
+        frame_buffer_.resize(0);
+        return err;
     } catch(const Poco::Exception& exc) {
         return error(exc.displayText());
     } catch(const std::exception& ex) {
@@ -248,52 +270,76 @@ error WebSocketClient::poll() {
     return noError;
 }
 
+bool WebSocketClient::waitForRetry() {
+    logger().debug("will sleep for 10 sec");
+    if (stop_requested_.tryWait(10 * 1000)) {
+        return false;
+    }
+    logger().debug("sleep done");
+    return !activity_.isStopped();
+}
+
 void WebSocketClient::runActivity() {
+    ScopedThreadName name("websocket");
+
     int restart_interval = nextWebsocketRestartInterval();
     while (!activity_.isStopped()) {
-        if (ws_) {
-            error err = poll();
+        std::time_t restart_in =
+            last_connection_at_ + restart_interval - time(nullptr);
+
+        if (ws_ && restart_in > 0) {
+            error err = poll(Poco::Timespan(static_cast<long>(restart_in), 0));
             if (err != noError) {
+                if (activity_.isStopped()) {
+                    break;
+                }
                 logger().error(err);
                 logger().debug("encountered an error and will delete session");
                 deleteSession();
-                logger().debug("will sleep for 10 sec");
-                for (int i = 0; i < 20; i++) {
-                    if (activity_.isStopped()) {
-                        return;
-                    }
-                    Poco::Thread::sleep(500);
+                if (!waitForRetry()) {
+                    break;
                 }
-                logger().debug("sleep done");
             }
+            continue;
         }
 
-        if (time(nullptr) - last_connection_at_ > restart_interval) {
-            restart_interval = nextWebsocketRestartInterval();
-            logger().debug("restarting");
-            error err = createSession();
-            if (err != noError) {
-                logger().error(err);
-                for (int i = 0; i < 20; i++) {
-                    if (activity_.isStopped()) {
-                        return;
-                    }
-                    Poco::Thread::sleep(500);
-                }
+        restart_interval = nextWebsocketRestartInterval();
+        logger().debug("restarting");
+        error err = createSession();
+        if (err != noError) {
+            logger().error(err);
+            if (!waitForRetry()) {
+                break;
             }
         }
-
-        Poco::Thread::sleep(1000);
     }
 
     logger().debug("activity finished");
 }
 
+void WebSocketClient::wakeUp() {
+    Poco::Mutex::ScopedLock lock(mutex_);
+
+    if (!ws_) {
+        return;
+    }
+
+    // Shut the shared descriptor down directly, the TLS socket
+    // implementations ignore shutdown requests
+    try {
+        ws_->impl()->Poco::Net::SocketImpl::shutdown();
+    } catch(const Poco::Exception& exc) {
+        logger().debug("wakeUp: ", exc.displayText());
+    }
+}
+
 void WebSocketClient::deleteSession() {
     logger().debug("deleteSession");
 
     Poco::Mutex::ScopedLock lock(mutex_);
 
+    frame_buffer_.resize(0);
+
     if (ws_) {
         delete ws_;
         ws_ = nullptr;
@@ -7,7 +7,11 @@
 #include <vector>
 #include <ctime>
 
+#include <json/json.h>  // NOLINT
+
 #include <Poco/Activity.h>
+#include <Poco/Buffer.h>
+#include <Poco/Event.h>
 #include <Poco/Net/HTTPClientSession.h>
 
 #include "types.h"
@@ -26,7 +30,7 @@ namespace toggl {
 
 typedef void (*WebSocketMessageCallback)(
     void *callback,
-    std::string json);
+    const Json::Value &message);
 
 class TOGGL_INTERNAL_EXPORT WebSocketClient {
  public:
@@ -36,6 +40,8 @@ class TOGGL_INTERNAL_EXPORT WebSocketClient {
     req_(nullptr),
     res_(nullptr),
     ws_(nullptr),
+    frame_buffer_(0),
+    stop_requested_(false),
     on_websocket_message_(nullptr),
     ctx_(nullptr),
     last_connection_at_(0),
@@ -56,14 +62,20 @@ class TOGGL_INTERNAL_EXPORT WebSocketClient {
 
     void authenticate();
 
-    error poll();
+    error poll(const Poco::Timespan &timeout);
 
-    std::string parseWebSocketMessageType(const std::string &json);
+    error receiveFrame(bool *complete);
 
-    error receiveWebSocketMessage(std::string *message);
+    error handleMessage();
 
     void deleteSession();
 
+    // Unblocks a receive loop waiting on the socket
+    void wakeUp();
+
+    // Returns false if shutdown was requested while waiting
+    bool waitForRetry();
+
     int nextWebsocketRestartInterval();
 
     Logger logger() const;
@@ -73,6 +85,13 @@ class TOGGL_INTERNAL_EXPORT WebSocketClient {
     Poco::Net::HTTPRequest *req_;
     Poco::Net::HTTPResponse *res_;
     Poco::Net::WebSocket *ws_;
+
+    // Payload of the message being received, kept between messages
+    // so its capacity is reused. Fragmented messages are reassembled here.
+    Poco::Buffer<char> frame_buffer_;
+    Json::Reader reader_;
+
+    Poco::Event stop_requested_;
     WebSocketMessageCallback on_websocket_message_;
     void *ctx_;
 
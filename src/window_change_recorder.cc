@@ -6,8 +6,10 @@
 
 #include "get_focused_window.h"
 #include "const.h"
+#include "util/thread_name.h"
 
 #include <Poco/Thread.h>
+#include <Poco/Timestamp.h>
 
 #if defined(__APPLE__)
 extern bool isCatalinaOSX(void);
@@ -128,8 +130,11 @@ void WindowChangeRecorder::inspectFocusedWindow() {
 }
 
 #define kWindowRecorderSleepMillis 250
+#define kWindowRecorderMaxWaitMillis 10000
 
 void WindowChangeRecorder::recordLoop() {
+    ScopedThreadName name("recorder");
+
     while (!recording_.isStopped()) {
         {
             Poco::Mutex::ScopedLock lock(shutdown_m_);
@@ -138,12 +143,24 @@ void WindowChangeRecorder::recordLoop() {
             }
         }
 
+        Poco::Timestamp inspected_at;
         inspectFocusedWindow();
 
         if (recording_.isStopped()) {
             break;
         }
 
+        // Where focus changes are reported, sleep until there is one
+        if (waitForFocusedWindowChange(kWindowRecorderMaxWaitMillis)) {
+            // A title that keeps changing is looked at once per interval
+            Poco::Timestamp::TimeDiff left =
+                kWindowRecorderSleepMillis * 1000 - inspected_at.elapsed();
+            if (left > 0) {
+                Poco::Thread::sleep(static_cast<long>(left / 1000));  // NOLINT
+            }
+            continue;
+        }
+
         Poco::Thread::sleep(kWindowRecorderSleepMillis);
 
         if (recording_.isStopped()) {
@@ -160,6 +177,7 @@ error WindowChangeRecorder::Shutdown() {
             Poco::Mutex::ScopedLock lock(shutdown_m_);
             shutdown_ = true;
         }
+        interruptFocusedWindowWait();
         if (recording_.isRunning()) {
             recording_.stop();
             recording_.wait(5);
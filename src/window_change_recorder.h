@@ -6,6 +6,7 @@
 #include <string>
 #include <map>
 
+#include "get_focused_window.h"
 #include "timeline_notifications.h"
 #include "types.h"
 #include "util/logger.h"
@@ -46,13 +47,19 @@ class TOGGL_INTERNAL_EXPORT WindowChangeRecorder {
     }
 
     void SetIsLocked(bool isLocked) {
-        Poco::Mutex::ScopedLock lock(isLocked_m_);
-        isLocked_ = isLocked;
+        {
+            Poco::Mutex::ScopedLock lock(isLocked_m_);
+            isLocked_ = isLocked;
+        }
+        interruptFocusedWindowWait();
     }
 
     void SetIsSleeping(bool isSleeping) {
-        Poco::Mutex::ScopedLock lock(isSleeping_m_);
-        isSleeping_ = isSleeping;
+        {
+            Poco::Mutex::ScopedLock lock(isSleeping_m_);
+            isSleeping_ = isSleeping;
+        }
+        interruptFocusedWindowWait();
     }
 
     error Shutdown();